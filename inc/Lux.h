@@ -87,6 +87,7 @@ namespace input
 
 #include "input/InputSystem.h"
 #include "input/InputDevice.h"
+#include "input/InputRecording.h"
 #include "input/Keycodes.h"
 
 #include "video/Color.h"
@@ -114,6 +115,7 @@ namespace input
 
 #include "video/images/Image.h"
 #include "video/images/ImageSystem.h"
+#include "video/images/TextureAtlas.h"
 
 #include "logic/Logic.h"
 
@@ -126,12 +128,16 @@ namespace input
 #include "scene/Node.h"
 
 #include "scene/Curve.h"
+#include "scene/Animation.h"
 
 #include "core/lxSignal.h"
 
 #include "video/mesh/Geometry.h"
 #include "video/mesh/VideoMesh.h"
 #include "video/mesh/MeshSystem.h"
+#include "video/mesh/Skeleton.h"
+#include "video/mesh/MeshOptimizer.h"
+#include "video/mesh/MeshLOD.h"
 
 #include "gui/GUISkin.h"
 #include "gui/GUIEnvironment.h"
@@ -22,6 +22,11 @@ namespace core
 {
 class TimerManager;
 }
+namespace input
+{
+class InputRecorder;
+class InputReplay;
+}
 namespace video
 {
 class VideoDriver;
@@ -105,6 +110,21 @@ public:
 		SimpleFrameLoopCallback* callback = nullptr;
 
 		scene::Scene* scene = nullptr;
+
+		//! Time passed to each frame in seconds, 0 to use the measured time.
+		float fixedTimeStep = 0.0f;
+
+		//! Records the input events and frame times, may be null.
+		input::InputRecorder* recorder = nullptr;
+
+		//! Replays recorded input in place of the real devices, may be null.
+		/**
+		The frames run as fast as possible with the recorded frame times, or
+		the fixed time step if set, and the loop ends with the recording.
+		Together with a fixed time step every run performs the same work,
+		which makes runs comparable for performance measurements.
+		*/
+		input::InputReplay* replay = nullptr;
 	};
 
 	//! Runs a simple frame loop.
@@ -137,20 +137,47 @@ class AttributeListInternal : public ReferenceCounted
 {
 	friend class AttributeListBuilder;
 public:
-	using ConstIterator = core::HashMap<core::String, StrongRef<Attribute>>::ConstKeyIterator;
+	using ConstIterator = core::FlatHashMap<core::String, int>::ConstKeyIterator;
 public:
 	ConstIterator First() const { return m_ObjectMap.Keys().First(); }
 	ConstIterator End() const { return m_ObjectMap.Keys().End(); }
 
 	AttributePtr Pointer(const core::StringView& name) const
+	{
+		return Pointer(FindSlot(name));
+	}
+
+	//! Resolve the name of an attribute into a slot.
+	/**
+	The attributes of the base list keep their slot in all derived lists.
+	\return The slot of the attribute, or -1 if it doesn't exist.
+	*/
+	int FindSlot(const core::StringView& name) const
 	{
 		auto itOpt = m_ObjectMap.Find(name);
 		if(!itOpt.HasValue()) {
 			if(m_Base)
-				return m_Base->Pointer(name);
-			return AttributePtr(nullptr);
+				return m_Base->FindSlot(name);
+			return -1;
 		}
-		return AttributePtr(itOpt.GetValue()->value);
+		return itOpt.GetValue()->value;
+	}
+
+	AttributePtr Pointer(int slot) const
+	{
+		if(slot < 0 || slot >= m_Slots.Size())
+			return AttributePtr(nullptr);
+		return AttributePtr(m_Slots[slot]);
+	}
+
+	Attribute* GetAttribute(int slot) const
+	{
+		return m_Slots[slot];
+	}
+
+	int GetSlotCount() const
+	{
+		return m_Slots.Size();
 	}
 
 	AttributeListInternal* GetBase() const
@@ -159,7 +186,8 @@ public:
 	}
 
 private:
-	core::HashMap<core::String, StrongRef<core::Attribute>> m_ObjectMap;
+	core::FlatHashMap<core::String, int> m_ObjectMap;
+	core::Array<StrongRef<core::Attribute>> m_Slots;
 	StrongRef<AttributeListInternal> m_Base;
 };
 
@@ -186,9 +214,24 @@ public:
 		m_Internal->Pointer(name)->SetValue(value);
 	}
 
+	template <typename T>
+	const T& GetValue(int slot) const
+	{
+		return m_Internal->GetAttribute(slot)->GetValue<T>();
+	}
+	template <typename T>
+	void SetValue(int slot, const T& value)
+	{
+		m_Internal->GetAttribute(slot)->SetValue(value);
+	}
+
 	ConstIterator First() const { return m_Internal->First(); }
 	ConstIterator End() const { return m_Internal->End(); }
 	AttributePtr Pointer(const core::StringView& name) const { return m_Internal->Pointer(name); }
+	AttributePtr Pointer(int slot) const { return m_Internal->Pointer(slot); }
+	Attribute* GetAttribute(int slot) const { return m_Internal->GetAttribute(slot); }
+	int FindSlot(const core::StringView& name) const { return m_Internal->FindSlot(name); }
+	int GetSlotCount() const { return m_Internal->GetSlotCount(); }
 	AttributeList GetBase() const { return m_Internal->GetBase(); }
 	bool IsValid() const { return m_Internal != nullptr; }
 	bool operator==(AttributeList other) const { return m_Internal == other.m_Internal; }
@@ -208,14 +251,15 @@ public:
 		auto type = core::TemplType<T>::Get();
 		auto itOpt = Objects().Find(name);
 		if(itOpt.HasValue()) {
-			if(itOpt.GetValue()->value->GetType() != type)
+			auto& attrb = m_List->m_Slots[itOpt.GetValue()->value];
+			if(attrb->GetType() != type)
 				throw core::InvalidOperationException("Attribute is already defined with diffrent type");
-			itOpt.GetValue()->value->SetValue(value);
-			ptr = AttributePtr(itOpt.GetValue()->value);
+			attrb->SetValue(value);
+			ptr = AttributePtr(attrb);
 		} else {
 			StrongRef<Attribute> p = LUX_NEW(AttributeAnyImpl<T>)(name, type, value);
-			Objects().SetAndReplace(name, p);
-			Objects()[name] = p;
+			Objects().SetAndReplace(name, m_List->m_Slots.Size());
+			m_List->m_Slots.PushBack(p);
 			ptr = AttributePtr(p);
 		}
 
@@ -230,11 +274,13 @@ public:
 		auto type = attrb->GetType();
 		auto itOpt = Objects().Find(name);
 		if(itOpt.HasValue()) {
-			if(itOpt.GetValue()->value->GetType() != type)
+			auto& slot = m_List->m_Slots[itOpt.GetValue()->value];
+			if(slot->GetType() != type)
 				throw core::InvalidOperationException("Attribute is already defined with diffrent type");
-			itOpt.GetValue()->value = attrb;
+			slot = attrb;
 		} else {
-			Objects()[name] = attrb;
+			Objects()[name] = m_List->m_Slots.Size();
+			m_List->m_Slots.PushBack(attrb);
 		}
 
 		return AttributePtr(attrb);
@@ -247,6 +293,21 @@ public:
 	
 	AttributeList BuildAndReset()
 	{
+		Objects();
+		if(m_Base) {
+			// The slots of the base list come first, so slots resolved
+			// with the base list are also valid in the new one.
+			int baseCount = m_Base->m_Slots.Size();
+			core::Array<StrongRef<Attribute>> slots;
+			slots.Reserve(baseCount + m_List->m_Slots.Size());
+			for(auto& a : m_Base->m_Slots)
+				slots.PushBack(a);
+			for(auto& a : m_List->m_Slots)
+				slots.PushBack(a);
+			for(auto& v : m_List->m_ObjectMap.Values())
+				v += baseCount;
+			m_List->m_Slots = std::move(slots);
+		}
 		m_List->m_Base = m_Base;
 		auto out = m_List;
 		m_List = nullptr;
@@ -255,7 +316,7 @@ public:
 	}
 
 private:
-	core::HashMap<core::String, StrongRef<Attribute>>& Objects()
+	core::FlatHashMap<core::String, int>& Objects()
 	{
 		if(!m_List)
 			m_List = LUX_NEW(AttributeListInternal)();
@@ -0,0 +1,463 @@
+#ifndef INCLUDED_LX_BASIC_FLAT_HASH_SET_H
+#define INCLUDED_LX_BASIC_FLAT_HASH_SET_H
+#include "core/LuxBase.h"
+#include <cstring>
+#include <utility>
+
+#if defined(LUX_CORE_NO_SIMD)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LUX_FLAT_HASH_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace lux
+{
+namespace core
+{
+
+//! Open addressing hash set with a control byte per slot
+/**
+Has the same interface as BasicHashSet and can be used as base of HashMap and
+HashSet.
+The values are stored densely in insertion order, like in BasicHashSet.
+The table only stores the index of the value and a control byte per slot,
+which contains 7 bits of the hash or marks the slot as empty or deleted.
+A lookup compares the control bytes of 16 slots at once, and only touches
+values whose control byte matches.
+The table size is always a power of two, the maximal load factor is 7/8.
+*/
+template <typename T, typename HasherT, typename ComparerT>
+class BasicFlatHashSet
+{
+	static const int INVALID_ID = -1;
+	static const int GROUP_SIZE = 16;
+	static const u8 CTRL_EMPTY = 0x80;
+	static const u8 CTRL_DELETED = 0xFE;
+	using HashT = unsigned int;
+
+	//! Bitmask with one bit per slot of a group.
+	class GroupMask
+	{
+	public:
+		explicit GroupMask(u32 bits) :
+			m_Bits(bits)
+		{
+		}
+		bool HasValue() const { return m_Bits != 0; }
+		int Lowest() const
+		{
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, m_Bits);
+			return int(index);
+#else
+			return __builtin_ctz(m_Bits);
+#endif
+		}
+		void RemoveLowest() { m_Bits &= m_Bits - 1; }
+
+	private:
+		u32 m_Bits;
+	};
+
+	//! The control bytes of 16 consecutive slots.
+	struct Group
+	{
+#ifdef LUX_FLAT_HASH_SSE
+		explicit Group(const u8* ctrl) :
+			bytes(_mm_loadu_si128((const __m128i*)ctrl))
+		{
+		}
+		GroupMask Match(u8 h2) const
+		{
+			return GroupMask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)h2), bytes)));
+		}
+		GroupMask MatchEmpty() const
+		{
+			return Match(CTRL_EMPTY);
+		}
+		GroupMask MatchEmptyOrDeleted() const
+		{
+			// Only empty and deleted slots have the highest bit set.
+			return GroupMask(_mm_movemask_epi8(bytes));
+		}
+
+		__m128i bytes;
+#else
+		explicit Group(const u8* ctrl) :
+			bytes(ctrl)
+		{
+		}
+		GroupMask Match(u8 h2) const
+		{
+			u32 bits = 0;
+			for(int i = 0; i < GROUP_SIZE; ++i)
+				bits |= u32(bytes[i] == h2) << i;
+			return GroupMask(bits);
+		}
+		GroupMask MatchEmpty() const
+		{
+			return Match(CTRL_EMPTY);
+		}
+		GroupMask MatchEmptyOrDeleted() const
+		{
+			u32 bits = 0;
+			for(int i = 0; i < GROUP_SIZE; ++i)
+				bits |= u32(bytes[i] >> 7) << i;
+			return GroupMask(bits);
+		}
+
+		const u8* bytes;
+#endif
+	};
+
+	struct SlotResult
+	{
+		int slot;
+		int id;
+	};
+
+public:
+	enum class EAddOption
+	{
+		Replace,
+		FailOnDuplicate,
+	};
+	struct AddResult
+	{
+		int id;
+		bool addedNew;
+	};
+	struct FindResult
+	{
+		int id;
+		int slot;
+		bool IsValid() const { return id != INVALID_ID; }
+	};
+	struct EraseResult
+	{
+		bool removed;
+	};
+
+	BasicFlatHashSet() {}
+	BasicFlatHashSet(const HasherT& hasher, const ComparerT& comparer) :
+		m_Hasher(hasher),
+		m_Comparer(comparer)
+	{
+	}
+	BasicFlatHashSet(const BasicFlatHashSet& other)
+	{
+		*this = other;
+	}
+	BasicFlatHashSet(BasicFlatHashSet&& old)
+	{
+		*this = std::move(old);
+	}
+	~BasicFlatHashSet()
+	{
+		Clear();
+		Free(m_Values);
+		m_Values = nullptr;
+		m_Allocated = 0;
+		Free(m_Ctrl);
+		m_Ctrl = nullptr;
+		Free(m_Slots);
+		m_Slots = nullptr;
+		m_SlotCount = 0;
+	}
+
+	BasicFlatHashSet& operator=(const BasicFlatHashSet& other)
+	{
+		if(this == &other)
+			return *this;
+
+		Clear();
+		if(m_Allocated < other.m_Size) {
+			Free(m_Values);
+			m_Values = (T*)Alloc(sizeof(T)*other.m_Size);
+			m_Allocated = other.m_Size;
+		}
+		if(m_SlotCount != other.m_SlotCount) {
+			Free(m_Ctrl);
+			Free(m_Slots);
+			m_Ctrl = other.m_SlotCount ? (u8*)Alloc(other.m_SlotCount + GROUP_SIZE) : nullptr;
+			m_Slots = other.m_SlotCount ? (int*)Alloc(sizeof(int)*other.m_SlotCount) : nullptr;
+			m_SlotCount = other.m_SlotCount;
+		}
+
+		for(int i = 0; i < other.m_Size; ++i)
+			new (m_Values + i) T(other.m_Values[i]);
+		if(m_SlotCount) {
+			std::memcpy(m_Ctrl, other.m_Ctrl, m_SlotCount + GROUP_SIZE);
+			std::memcpy(m_Slots, other.m_Slots, sizeof(int)*m_SlotCount);
+		}
+
+		m_Size = other.m_Size;
+		m_Deleted = other.m_Deleted;
+
+		m_Hasher = other.m_Hasher;
+		m_Comparer = other.m_Comparer;
+		return *this;
+	}
+	BasicFlatHashSet& operator=(BasicFlatHashSet&& old)
+	{
+		if(this == &old)
+			return *this;
+		std::swap(m_Values, old.m_Values);
+		std::swap(m_Allocated, old.m_Allocated);
+		std::swap(m_Size, old.m_Size);
+
+		std::swap(m_Ctrl, old.m_Ctrl);
+		std::swap(m_Slots, old.m_Slots);
+		std::swap(m_SlotCount, old.m_SlotCount);
+		std::swap(m_Deleted, old.m_Deleted);
+
+		std::swap(m_Hasher, old.m_Hasher);
+		std::swap(m_Comparer, old.m_Comparer);
+		return *this;
+	}
+
+	void Clear()
+	{
+		for(int i = 0; i < m_Size; ++i)
+			m_Values[i].~T();
+		m_Size = 0;
+		m_Deleted = 0;
+		if(m_SlotCount)
+			std::memset(m_Ctrl, CTRL_EMPTY, m_SlotCount + GROUP_SIZE);
+	}
+
+	template <typename T2, typename T3>
+	AddResult Add(const T2& keyValue, EAddOption option, const T3& setValue)
+	{
+		HashT hash = m_Hasher(keyValue);
+		if(m_Size != 0) {
+			auto result = FindSlot(hash, keyValue);
+			if(result.id != INVALID_ID) {
+				if(option == EAddOption::Replace)
+					m_Values[result.id] = setValue;
+				return {result.id, false};
+			}
+		}
+
+		if(m_Size == m_Allocated || !HasFreeSlot())
+			ReserveAndRehash(m_Size + 1);
+
+		// Place value in list
+		int id = m_Size;
+		new (m_Values + id) T(setValue);
+		m_Size += 1;
+
+		int slot = FindInsertSlot(hash);
+		if(m_Ctrl[slot] == CTRL_DELETED)
+			--m_Deleted;
+		SetCtrl(slot, H2(hash));
+		m_Slots[slot] = id;
+		return {id, true};
+	}
+
+	template <typename T2>
+	FindResult Find(const T2& value) const
+	{
+		if(m_Size == 0)
+			return {INVALID_ID, INVALID_ID};
+
+		auto result = FindSlot(m_Hasher(value), value);
+		return {result.id, result.slot};
+	}
+
+	EraseResult Erase(const FindResult& value)
+	{
+		if(!value.IsValid())
+			return {false};
+
+		SetCtrl(value.slot, CTRL_DELETED);
+		++m_Deleted;
+
+		int last = m_Size - 1;
+		if(value.id != last) {
+			// Move the last value into the gap and redirect its slot.
+			m_Slots[FindSlotOfId(m_Hasher(m_Values[last]), last)] = value.id;
+			m_Values[value.id] = std::move(m_Values[last]);
+		}
+		m_Values[last].~T();
+		m_Size--;
+
+		return {true};
+	}
+
+	const T& GetValue(int id) const { return m_Values[id]; }
+	T& GetValue(int id) { return m_Values[id]; }
+
+	int GetSize() const { return m_Size; }
+	int GetAllocated() const { return m_Allocated; }
+
+	void Reserve(int count)
+	{
+		ReserveAndRehash(count);
+	}
+
+private:
+	static u8 H2(HashT hash) { return u8(hash & 0x7F); }
+	static int H1(HashT hash) { return int(hash >> 7); }
+	static int MaxLoad(int slotCount) { return slotCount - slotCount / 8; }
+
+	bool HasFreeSlot() const
+	{
+		return m_Size + m_Deleted + 1 <= MaxLoad(m_SlotCount);
+	}
+
+	void SetCtrl(int slot, u8 value)
+	{
+		m_Ctrl[slot] = value;
+		// The first group is mirrored behind the end of the table, so a group
+		// can be loaded from every slot without wrapping around.
+		if(slot < GROUP_SIZE)
+			m_Ctrl[m_SlotCount + slot] = value;
+	}
+
+	// Visits the groups at pos, pos+16, pos+48, pos+96, ...
+	// Since the table size is a power of two, this reaches every slot.
+	template <typename T2>
+	SlotResult FindSlot(HashT hash, const T2& value) const
+	{
+		int mask = m_SlotCount - 1;
+		int pos = H1(hash) & mask;
+		u8 h2 = H2(hash);
+		for(int step = GROUP_SIZE;; step += GROUP_SIZE) {
+			Group group(m_Ctrl + pos);
+			for(auto match = group.Match(h2); match.HasValue(); match.RemoveLowest()) {
+				int slot = (pos + match.Lowest()) & mask;
+				int id = m_Slots[slot];
+				if(m_Comparer.Equal(m_Values[id], value))
+					return {slot, id};
+			}
+			if(group.MatchEmpty().HasValue())
+				return {INVALID_ID, INVALID_ID};
+			pos = (pos + step) & mask;
+		}
+	}
+
+	int FindSlotOfId(HashT hash, int id) const
+	{
+		int mask = m_SlotCount - 1;
+		int pos = H1(hash) & mask;
+		u8 h2 = H2(hash);
+		for(int step = GROUP_SIZE;; step += GROUP_SIZE) {
+			Group group(m_Ctrl + pos);
+			for(auto match = group.Match(h2); match.HasValue(); match.RemoveLowest()) {
+				int slot = (pos + match.Lowest()) & mask;
+				if(m_Slots[slot] == id)
+					return slot;
+			}
+			pos = (pos + step) & mask;
+		}
+	}
+
+	int FindInsertSlot(HashT hash) const
+	{
+		int mask = m_SlotCount - 1;
+		int pos = H1(hash) & mask;
+		for(int step = GROUP_SIZE;; step += GROUP_SIZE) {
+			auto match = Group(m_Ctrl + pos).MatchEmptyOrDeleted();
+			if(match.HasValue())
+				return (pos + match.Lowest()) & mask;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	int CalculateNewSize(int minSize) const
+	{
+		int v;
+		if(m_Size == 0)
+			v = 8;
+		else
+			v = m_Size * 2;
+		if(v <= m_Allocated)
+			v = m_Allocated;
+		if(v < minSize)
+			v = minSize;
+		return v;
+	}
+	int CalculateNewSlotCount(int minSize) const
+	{
+		int v = GROUP_SIZE;
+		while(MaxLoad(v) < minSize)
+			v *= 2;
+		return v;
+	}
+
+	void ReserveAndRehash(int minSize)
+	{
+		if(minSize > m_Allocated) {
+			int newSize = CalculateNewSize(minSize);
+			T* newValues = (T*)Alloc(sizeof(T) * newSize);
+			for(int i = 0; i < m_Size; ++i) {
+				new (newValues + i) T(std::move(m_Values[i]));
+				m_Values[i].~T();
+			}
+			Free(m_Values);
+			m_Values = newValues;
+			m_Allocated = newSize;
+		}
+
+		int newSlotCount = CalculateNewSlotCount(minSize);
+		if(newSlotCount <= m_SlotCount) {
+			newSlotCount = m_SlotCount;
+			if(minSize + m_Deleted <= MaxLoad(m_SlotCount))
+				return;
+			// The table is only full of deleted markers, rebuilding it removes them.
+			// If it's nearly full anyway, grow it to avoid rebuilding it again soon.
+			if(minSize > MaxLoad(m_SlotCount) / 4 * 3)
+				newSlotCount *= 2;
+		}
+
+		if(newSlotCount != m_SlotCount) {
+			Free(m_Ctrl);
+			Free(m_Slots);
+			m_Ctrl = (u8*)Alloc(newSlotCount + GROUP_SIZE);
+			m_Slots = (int*)Alloc(sizeof(int) * newSlotCount);
+			m_SlotCount = newSlotCount;
+		}
+		std::memset(m_Ctrl, CTRL_EMPTY, m_SlotCount + GROUP_SIZE);
+		m_Deleted = 0;
+
+		for(int i = 0; i < m_Size; ++i) {
+			HashT hash = m_Hasher(m_Values[i]);
+			int slot = FindInsertSlot(hash);
+			SetCtrl(slot, H2(hash));
+			m_Slots[slot] = i;
+		}
+	}
+
+	void* Alloc(size_t bytes)
+	{
+		return ::operator new(bytes);
+	}
+	void Free(void* ptr)
+	{
+		::operator delete(ptr);
+	}
+
+private:
+	T* m_Values = nullptr;
+	int m_Allocated = 0;
+	int m_Size = 0;
+
+	u8* m_Ctrl = nullptr;
+	int* m_Slots = nullptr;
+	int m_SlotCount = 0;
+	int m_Deleted = 0;
+
+	mutable HasherT m_Hasher;
+	mutable ComparerT m_Comparer;
+};
+
+} // namespace core
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LX_BASIC_FLAT_HASH_SET_H
@@ -173,21 +173,37 @@ struct TimerSettings
 	}
 };
 
-/*
-I reimplemented the linked list instead of using core::List because
-it is nicer to use pointers instead of iterators and the implementation is
-really easy.
+class TimerWheel;
+
+//! The state of a single timer, owned by the timer manager
+/**
+Each timer is always in exactly one intrusive list of the timer manager,
+which allows removing it in constant time.
 */
 struct InternalTimer
 {
+	enum class EState : u8
+	{
+		Scheduled, //!< In the timing wheel
+		Due, //!< Expires in the current tick of the wheel
+		Inactive, //!< Paused
+		Finished, //!< All repeats done
+		Firing, //!< Part of the currently fired batch
+	};
+
 	core::Signal<> event;
-	Duration remain;
+	Duration deadline; //!< Absolute time of the next expiration
+	Duration remain; //!< Remaining time while paused
 	Duration period;
 	int repeatCount;
 	bool paused;
+	bool killed;
+	bool level0; //!< In the first level of the wheel
+	EState state;
 
+	TimerWheel* wheel;
 	InternalTimer* next;
-	InternalTimer* prev;
+	InternalTimer** prevNext;
 };
 
 class Timer : private Uncopyable
@@ -219,80 +235,54 @@ public:
 			Kill();
 	}
 
-	void Kill()
-	{
-		m_Timer->period = Duration(std::numeric_limits<Duration::BaseType>::max());
-		m_Timer = nullptr;
-	}
-
-	void Pause(bool b = true) { m_Timer->paused = b; }
-	void Resume(bool b = true) { m_Timer->paused = !b; }
+	inline void Kill();
+	inline void Pause(bool b = true);
+	void Resume(bool b = true) { Pause(!b); }
 	bool IsPaused() const { return m_Timer->paused; }
 	bool IsValid() const { return m_Timer != nullptr; }
 	Signal<>& Event() { return m_Timer->event; }
-	Duration GetRemainingTime() const { return m_Timer->remain; }
-	Duration GetElapsedTime() const { return m_Timer->period - m_Timer->remain; }
+	inline Duration GetRemainingTime() const;
+	Duration GetElapsedTime() const { return m_Timer->period - GetRemainingTime(); }
 
 private:
 	InternalTimer* m_Timer;
 };
 
+//! Creates and updates timers
+/**
+The timers are kept in a hierarchical timing wheel with a resolution of
+one millisecond. Creating, killing and pausing a timer takes constant time,
+and the cost of a tick only depends on the number of expiring timers and
+the number of passed milliseconds, not on the number of timers.
+All timers expiring in the same tick are fired as one batch, ordered by
+their expiration time.
+A timer fires at most once per tick.
+*/
 class TimerManager : private Uncopyable
 {
+	friend class Timer;
 public:
 	TimerManager() :
-		m_FirstTimer(nullptr),
-		m_TimerCount(0)
+		m_Wheel(nullptr),
+		m_AbortLoop(false)
 	{
 	}
 	TimerManager(TimerManager&& old) :
-		m_FirstTimer(old.m_FirstTimer),
-		m_TimerCount(old.m_TimerCount)
+		m_Wheel(old.m_Wheel),
+		m_AbortLoop(false)
 	{
-		old.m_FirstTimer = nullptr;
-		old.m_TimerCount = 0;
+		old.m_Wheel = nullptr;
 	}
 	LUX_API ~TimerManager();
 
 	TimerManager& operator=(TimerManager&& old)
 	{
-		this->~TimerManager();
-		m_FirstTimer = old.m_FirstTimer;
-		m_TimerCount = old.m_TimerCount;
-		old.m_FirstTimer = nullptr;
-		old.m_TimerCount = 0;
+		std::swap(m_Wheel, old.m_Wheel);
 		return *this;
 	}
 
-	LUX_API void Tick(Duration passed)
-	{
-		for(InternalTimer* it = m_FirstTimer; it != nullptr;) {
-			auto& t = *it;
-			bool deleteTimer = (t.period.Count() == std::numeric_limits<Duration::BaseType>::max());
-			if(!t.paused) {
-				if(t.remain > passed) {
-					t.remain -= passed;
-				} else {
-					t.remain = Duration(0);
-				}
-				if(t.remain.Count() == 0 && !deleteTimer) {
-					t.event.Broadcast();
-					// Maybe the timer was deleted in the broadcast
-					deleteTimer = (t.period.Count() == std::numeric_limits<Duration::BaseType>::max());
-					t.remain = t.period;
-					if(t.repeatCount > 0) {
-						t.repeatCount--;
-						if(t.repeatCount == 0)
-							deleteTimer = true;
-					}
-				}
-			}
-			if(deleteTimer)
-				it = DestroyInternalTimer(it);
-			else
-				it = it->next;
-		}
-	}
+	//! Advance the time and fire all expired timers.
+	LUX_API void Tick(Duration passed);
 
 	LUX_API void RunLoop(Duration stepSize);
 	void AbortLoop() { m_AbortLoop = true; }
@@ -300,18 +290,35 @@ public:
 	LUX_API Timer CreateTimer(const TimerSettings& settings);
 	LUX_API Timer CreateTimer(Duration period);
 
-	int GetTimerCount() const { return m_TimerCount; }
+	//! The number of timers, which are running or paused.
+	LUX_API int GetTimerCount() const;
 
 private:
-	InternalTimer* CreateInternalTimer(const TimerSettings& settings);
-	InternalTimer* DestroyInternalTimer(InternalTimer* t);
+	LUX_API static void KillTimer(InternalTimer* t);
+	LUX_API static void PauseTimer(InternalTimer* t, bool pause);
+	LUX_API static Duration GetRemainingTime(const InternalTimer* t);
 
 private:
-	InternalTimer* m_FirstTimer;
-	int m_TimerCount;
+	TimerWheel* m_Wheel;
 	bool m_AbortLoop;
 };
 
+inline void Timer::Kill()
+{
+	TimerManager::KillTimer(m_Timer);
+	m_Timer = nullptr;
+}
+
+inline void Timer::Pause(bool b)
+{
+	TimerManager::PauseTimer(m_Timer, b);
+}
+
+inline Duration Timer::GetRemainingTime() const
+{
+	return TimerManager::GetRemainingTime(m_Timer);
+}
+
 } // namespace core
 } // namespace lux
 
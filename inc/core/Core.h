@@ -11,6 +11,8 @@
 #include "core/Logic.h"
 #include "core/LuxBase.h"
 #include "core/lxAlgorithm.h"
+#include "core/lxAllocator.h"
+#include "core/lxArena.h"
 #include "core/lxArray.h"
 #include "core/lxAssert.h"
 #include "core/lxDeque.h"
@@ -28,6 +30,7 @@
 #include "core/lxOrderedMap.h"
 #include "core/lxOrderedSet.h"
 #include "core/lxPool.h"
+#include "core/lxProfiler.h"
 #include "core/lxRandom.h"
 #include "core/lxRedBlack.h"
 #include "core/lxSignal.h"
@@ -59,6 +59,13 @@ public:
 	//! Exits the logger, happens automatically.
 	virtual void Exit() = 0;
 
+	//! A single log entry, see PrintSync.
+	struct Entry
+	{
+		core::String text;
+		ELogLevel level;
+	};
+
 	//! Finish a entry and flush it.
 	/**
 	This function is threadsafe
@@ -67,9 +74,25 @@ public:
 	{
 		std::lock_guard<std::mutex> _(m_PrinterLock);
 		Print(s, ll);
+		Flush();
+	}
+
+	//! Print multiple entries and flush only once at the end.
+	/**
+	This function is threadsafe
+	*/
+	void PrintSync(const Entry* entries, int count)
+	{
+		std::lock_guard<std::mutex> _(m_PrinterLock);
+		for(int i = 0; i < count; ++i)
+			Print(entries[i].text, entries[i].level);
+		Flush();
 	}
+
 protected:
 	virtual void Print(const core::String& s, ELogLevel ll) = 0;
+	//! Write all buffered data to the output.
+	virtual void Flush() {}
 
 private:
 	std::mutex m_PrinterLock;
@@ -80,6 +103,60 @@ LUX_API ELogLevel GetLogLevel();
 LUX_API void SetPrinter(Printer* p);
 LUX_API Printer* GetPrinter();
 
+//! Enable or disable asynchronous logging.
+/**
+In asynchronous mode a log call only formats the message and pushes it into a
+lock-free buffer of the calling thread. A background thread collects the
+messages and passes them to the printer in batches.
+Disabling the mode prints all pending messages before returning.
+Messages of different threads may be reordered.
+*/
+LUX_API void SetAsyncLogging(bool enable);
+LUX_API bool IsAsyncLogging();
+
+//! Wait until all messages logged before this call are printed.
+LUX_API void FlushLog();
+
+//! Limit the number of printed messages per second in asynchronous mode.
+/**
+Further messages are dropped, their number is reported once the next second starts.
+\param messagesPerSecond The maximal number of messages, 0 for no limit.
+*/
+LUX_API void SetLogRateLimit(int messagesPerSecond);
+
+//! Collapse directly repeated messages in asynchronous mode.
+/**
+Repetitions of the last printed message are counted and reported as a single line.
+Disabled by default.
+*/
+LUX_API void SetLogDeduplication(bool enable);
+
+namespace Impl
+{
+//! A per-thread string used to format log messages without allocating.
+/**
+Log calls made while formatting the arguments of another log call get
+their own string, so they don't overwrite the outer message.
+*/
+class ThreadBufferScope : core::Uncopyable
+{
+public:
+	LUX_API ThreadBufferScope();
+	LUX_API ~ThreadBufferScope();
+
+	core::String& Get() { return *m_Buffer; }
+
+private:
+	core::String* m_Buffer;
+};
+
+//! Queues a message for the background thread.
+/**
+\return False if asynchronous logging is disabled.
+*/
+LUX_API bool PushAsync(core::StringView s, ELogLevel ll);
+}
+
 /*
 Loggers are functors instead of pure function, to allow
 easier future extensions.
@@ -107,16 +184,41 @@ public:
 			return;
 
 		if(curLogLevel <= m_MyLogLevel && curLogLevel != ELogLevel::None) {
+			Impl::ThreadBufferScope buffer;
+			auto& out = buffer.Get();
 			ifconst(sizeof...(data))
 			{
-				core::String out;
 				core::StringSink sink(out);
 				format::format(sink, format::Slice((size_t)format.Size(), format.Data()), data...);
-
-				printer->PrintSync(out, m_MyLogLevel);
 			} else {
-				printer->PrintSync(format, m_MyLogLevel);
+				out.Append(format);
 			}
+
+			if(!Impl::PushAsync(out.AsView(), m_MyLogLevel))
+				printer->PrintSync(out, m_MyLogLevel);
+		}
+	}
+
+	//! Write a message using a format plan.
+	/**
+	The format string isn't parsed again for each message.
+	*/
+	template <int N, typename... T>
+	void Write(const format::FormatPlan<N>& plan, const T&... data)
+	{
+		auto printer = GetPrinter();
+		auto curLogLevel = GetLogLevel();
+		if(!printer)
+			return;
+
+		if(curLogLevel <= m_MyLogLevel && curLogLevel != ELogLevel::None) {
+			Impl::ThreadBufferScope buffer;
+			auto& out = buffer.Get();
+			core::StringSink sink(out);
+			format::format(sink, plan, data...);
+
+			if(!Impl::PushAsync(out.AsView(), m_MyLogLevel))
+				printer->PrintSync(out, m_MyLogLevel);
 		}
 	}
 
@@ -126,6 +228,12 @@ public:
 		Write(format, data...);
 	}
 
+	template <int N, typename... T>
+	void operator()(const format::FormatPlan<N>& plan, const T&... data)
+	{
+		Write(plan, data...);
+	}
+
 private:
 	const ELogLevel m_MyLogLevel;
 };
@@ -26,6 +26,10 @@
 #define LUX_ENABLE_ASSERTS
 #endif
 
+#if !defined(NDEBUG) || defined(LUX_COMPILE_WITH_PROFILER)
+#define LUX_ENABLE_PROFILER
+#endif
+
 #include "lxAssert.h"
 #include <cstdint>
 #include <cstddef>
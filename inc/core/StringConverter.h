@@ -30,8 +30,14 @@ inline String& Append(String& str, short num) { return AppendIntToString(str, nu
 inline String& Append(String& str, char num) { return AppendIntToString(str, num); }
 
 //! Convert a float to a string
+/**
+The shortest string which reads back as the same float is written.
+*/
 LUX_API String& Append(String& str, float value);
-//! Convert a float to a string
+//! Convert a double to a string
+/**
+The shortest string which reads back as the same double is written.
+*/
 LUX_API String& Append(String& str, double value);
 //! Convert a date to a string
 LUX_API String& Append(String& str, const DateAndTime& value);
@@ -72,6 +78,8 @@ enum class EParseError
 
 //! Create a float from a string
 /**
+The result is correctly rounded. Accepts decimal numbers with optional
+exponent, inf, infinity and nan.
 \param str The string to convert
 \param errorValue The value which is returned if an error occurs
 \param [out] nextChar The first character after the number, only written if not null
@@ -90,6 +98,30 @@ LUX_API float ParseFloat(StringView str, float errorValue = 0.0f, int* nextChar
 */
 LUX_API int ParseInt(StringView str, int errorValue = 0, int* nextChar = nullptr, EParseError* error = nullptr);
 
+//! Create multiple floats from a string
+/**
+The values are separated by whitespace and optionally a single comma.
+Parsing stops at the first character which isn't part of a value.
+\param str The string to convert
+\param [out] out The parsed values
+\param count The maximal number of values to parse
+\param [out] nextChar The first character after the last parsed value, only written if not null
+\return The number of parsed values
+*/
+LUX_API int ParseFloatArray(StringView str, float* out, int count, int* nextChar = nullptr);
+
+//! Create multiple integers from a string
+/**
+The values are separated by whitespace and optionally a single comma.
+Parsing stops at the first character which isn't part of a value.
+\param str The string to convert
+\param [out] out The parsed values
+\param count The maximal number of values to parse
+\param [out] nextChar The first character after the last parsed value, only written if not null
+\return The number of parsed values
+*/
+LUX_API int ParseIntArray(StringView str, int* out, int count, int* nextChar = nullptr);
+
 //! Create a boolean from a string
 /**
 \param str The string to convert
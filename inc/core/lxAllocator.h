@@ -0,0 +1,39 @@
+#ifndef INCLUDED_LUX_ALLOCATOR_H
+#define INCLUDED_LUX_ALLOCATOR_H
+#include "core/LuxBase.h"
+
+namespace lux
+{
+namespace core
+{
+
+//! Interface for memory sources of containers
+/**
+Containers without an allocator use the global heap.
+An allocator must outlive all containers using it.
+*/
+class Allocator
+{
+public:
+	virtual ~Allocator() {}
+
+	//! Allocate memory
+	/**
+	\param bytes The number of bytes to allocate.
+	\param align The alignment of the memory, a power of two.
+	\return The allocated memory, never null.
+	*/
+	virtual void* Allocate(size_t bytes, size_t align) = 0;
+
+	//! Free memory returned by Allocate
+	/**
+	\param ptr The memory to free.
+	\param bytes The number of bytes passed to Allocate.
+	*/
+	virtual void Free(void* ptr, size_t bytes) = 0;
+};
+
+} // namespace core
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_ALLOCATOR_H
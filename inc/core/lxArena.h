@@ -0,0 +1,165 @@
+#ifndef INCLUDED_LUX_ARENA_H
+#define INCLUDED_LUX_ARENA_H
+#include "core/LuxBase.h"
+#include "core/HelperTemplates.h"
+#include "core/lxAssert.h"
+#include "core/lxAllocator.h"
+#include <new>
+
+namespace lux
+{
+namespace core
+{
+
+//! Linear allocator
+/**
+Memory is handed out by moving a pointer forward and can only be freed all at
+once with Reset.
+Destructors of objects placed in the arena are never called by the arena.
+*/
+class Arena : core::Uncopyable
+{
+public:
+	//! Create an arena
+	/**
+	\param blockSize The size of the memory blocks requested from the heap.
+	*/
+	LUX_API explicit Arena(size_t blockSize = 64 * 1024);
+	LUX_API ~Arena();
+
+	//! Allocate memory
+	/**
+	\param bytes The number of bytes to allocate.
+	\param align The alignment of the memory, must be a power of two.
+	\return The allocated memory, valid until the next Reset.
+	*/
+	void* Allocate(size_t bytes, size_t align = alignof(double))
+	{
+		lxAssert((align & (align - 1)) == 0);
+		size_t cur = (m_Cursor + align - 1) & ~(align - 1);
+		if(cur + bytes > m_End)
+			return AllocateSlow(bytes, align);
+		m_Cursor = cur + bytes;
+		return (void*)cur;
+	}
+
+	//! Allocate uninitialized memory for an array
+	template <typename T>
+	T* AllocateArray(int count)
+	{
+		return (T*)Allocate(sizeof(T) * count, alignof(T));
+	}
+
+	//! Frees all allocated memory at once.
+	/**
+	The heap blocks are kept for the next allocations.
+	*/
+	LUX_API void Reset();
+
+	//! The number of bytes handed out since the last reset.
+	size_t GetUsedBytes() const { return m_UsedBefore + (m_Cursor - m_Begin); }
+	//! The number of bytes requested from the heap.
+	size_t GetReservedBytes() const { return m_Reserved; }
+
+private:
+	struct Block;
+
+	LUX_API void* AllocateSlow(size_t bytes, size_t align);
+	void FreeBlocks();
+
+private:
+	Block* m_Current;
+	size_t m_BlockSize;
+	size_t m_Reserved;
+	size_t m_UsedBefore;
+
+	size_t m_Begin;
+	size_t m_Cursor;
+	size_t m_End;
+};
+
+//! Memory for transient data of a single frame
+/**
+Each thread has its own arena, so allocations never need a lock.
+A frame is opened with BeginFrame, usually with a FrameScope, frames can be
+nested. The arena of a thread is reset when its outermost frame ends, all
+memory handed out in the frame must not be used anymore.
+*/
+class FrameArena
+{
+public:
+	//! The frame arena of the calling thread.
+	LUX_API static Arena& Get();
+
+	//! Open a frame on the calling thread.
+	LUX_API static void BeginFrame();
+	//! Close a frame on the calling thread, the outermost one resets the arena.
+	LUX_API static void EndFrame();
+	//! Is a frame open on the calling thread.
+	LUX_API static bool IsFrameOpen();
+};
+
+//! Keeps a frame of the frame arena open for the lifetime of the object
+/**
+Is used by the engine loop for each frame and by Scene::DrawScene, so
+scenes drawn from a custom main loop don't grow the arena forever.
+*/
+class FrameScope : core::Uncopyable
+{
+public:
+	FrameScope() { FrameArena::BeginFrame(); }
+	~FrameScope() { FrameArena::EndFrame(); }
+};
+
+//! Allocator handing out memory of an arena
+/**
+Freeing memory does nothing, it's released with the next reset of the arena.
+*/
+class ArenaAllocator : public Allocator
+{
+public:
+	explicit ArenaAllocator(Arena& arena) :
+		m_Arena(arena)
+	{
+	}
+
+	void* Allocate(size_t bytes, size_t align) override
+	{
+		return m_Arena.Allocate(bytes, align);
+	}
+	void Free(void* ptr, size_t bytes) override
+	{
+		LUX_UNUSED(ptr);
+		LUX_UNUSED(bytes);
+	}
+
+private:
+	Arena& m_Arena;
+};
+
+//! Allocator handing out memory of the frame arena of the calling thread
+/**
+The memory is only valid until the end of the current frame.
+Must only be used while a frame is open.
+*/
+class FrameAllocator : public Allocator
+{
+public:
+	LUX_API static FrameAllocator& Instance();
+
+	void* Allocate(size_t bytes, size_t align) override
+	{
+		lxAssert(FrameArena::IsFrameOpen());
+		return FrameArena::Get().Allocate(bytes, align);
+	}
+	void Free(void* ptr, size_t bytes) override
+	{
+		LUX_UNUSED(ptr);
+		LUX_UNUSED(bytes);
+	}
+};
+
+} // namespace core
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_ARENA_H
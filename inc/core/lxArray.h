@@ -6,15 +6,69 @@
 #include "core/lxIterator.h"
 #include "core/lxTypes.h"
 #include "core/lxOptional.h"
+#include "core/lxAllocator.h"
+#include "core/lxArena.h"
 #include <initializer_list>
 #include <type_traits>
+#include <cstring>
 
 namespace lux
 {
 namespace core
 {
 
+//! Can objects of the type be moved to another address with memcpy
+/**
+Arrays of such types move their elements with memcpy when growing, instead of
+move constructing and destroying each element.
+Specialize this for types which don't store pointers to themselves.
+*/
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T>
+{
+};
+
+class String;
+template <>
+struct IsTriviallyRelocatable<String> : std::true_type
+{
+};
+
+namespace impl_array
+{
+//! Allocator handing out a fixed buffer once, and heap memory if it's in use or too small.
+template <typename T, int N>
+class InlineStorage : public Allocator
+{
+public:
+	void* Allocate(size_t bytes, size_t align) override
+	{
+		LUX_UNUSED(align);
+		if(!m_InUse && bytes <= sizeof(m_Buffer)) {
+			m_InUse = true;
+			return m_Buffer;
+		}
+		return ::operator new(bytes);
+	}
+	void Free(void* ptr, size_t bytes) override
+	{
+		LUX_UNUSED(bytes);
+		if(ptr == m_Buffer)
+			m_InUse = false;
+		else
+			::operator delete(ptr);
+	}
+
+private:
+	alignas(T) char m_Buffer[N * sizeof(T)];
+	bool m_InUse = false;
+};
+} // namespace impl_array
+
 //! A template dynamic array
+/**
+The memory is taken from the heap or from an allocator set at construction.
+*/
 template <typename T>
 class Array
 {
@@ -31,6 +85,16 @@ public:
 	{
 	}
 
+	//! Create an empty array using an allocator
+	/**
+	\param allocator The memory of the array is taken from here, null for the heap.
+		The allocator must outlive the array.
+	*/
+	explicit Array(Allocator* allocator) :
+		m_Allocator(allocator)
+	{
+	}
+
 	Array(std::initializer_list<T> init)
 	{
 		*this = init;
@@ -51,21 +115,34 @@ public:
 	//! Move constructor
 	Array(Array<T>&& old)
 	{
-		m_Data = old.m_Data;
-		m_Used = old.m_Used;
-		m_Alloc = old.m_Alloc;
-		old.m_Data = nullptr;
-		old.m_Used = 0;
-		old.m_Alloc = 0;
+		*this = std::move(old);
 	}
 
 	//! Move assignment 
+	/**
+	The memory is only taken over if both arrays use the same allocator,
+	otherwise the elements are moved one by one.
+	*/
 	Array<T>& operator=(Array<T>&& old)
 	{
-		if(this != &old) {
-			std::swap(m_Data, old.m_Data);
-			std::swap(m_Used, old.m_Used);
-			std::swap(m_Alloc, old.m_Alloc);
+		if(this == &old)
+			return *this;
+
+		if(m_Allocator == old.m_Allocator) {
+			Destroy();
+			m_Data = old.m_Data;
+			m_Used = old.m_Used;
+			m_Alloc = old.m_Alloc;
+			old.m_Data = nullptr;
+			old.m_Used = 0;
+			old.m_Alloc = 0;
+		} else {
+			Clear();
+			Reserve(old.m_Used);
+			for(int i = 0; i < old.m_Used; ++i)
+				new ((void*)(m_Data + i)) T(std::move(old.m_Data[i]));
+			m_Used = old.m_Used;
+			old.Clear();
 		}
 
 		return *this;
@@ -288,13 +365,19 @@ public:
 	}
 
 	//! Remove all elements from the list
+	/**
+	Arrays using the heap release their memory with the next allocation.
+	Arrays with an allocator, i.e. FrameArray and SmallArray, keep it for
+	new elements.
+	*/
 	void Clear()
 	{
 		for(int i = 0; i < m_Used; ++i)
 			m_Data[i].~T();
 
 		m_Used = 0;
-		m_Alloc = 0;
+		if(!m_Allocator)
+			m_Alloc = 0;
 	}
 
 	//! Release unused memory
@@ -466,6 +549,12 @@ public:
 		return m_Alloc;
 	}
 
+	//! The allocator of the array, null if the heap is used.
+	Allocator* GetAllocator() const
+	{
+		return m_Allocator;
+	}
+
 	//! Access a single element
 	const T& operator[](int entry) const
 	{
@@ -545,14 +634,30 @@ public:
 	}
 
 
+protected:
+	void Destroy()
+	{
+		Clear();
+		FreeData(m_Data, m_Alloc);
+		m_Data = nullptr;
+		m_Alloc = 0;
+	}
+
 private:
-	static void* ArrayAllocate(int bytes)
+	T* AllocateData(int count)
 	{
-		return ::operator new(bytes);
+		if(m_Allocator)
+			return (T*)m_Allocator->Allocate(count * sizeof(T), alignof(T));
+		return (T*)::operator new(count * sizeof(T));
 	}
-	static void ArrayFree(void* ptr)
+	void FreeData(T* ptr, int count)
 	{
-		::operator delete(ptr);
+		if(!ptr)
+			return;
+		if(m_Allocator)
+			m_Allocator->Free(ptr, count * sizeof(T));
+		else
+			::operator delete(ptr);
 	}
 
 	void BasicErase(int from, int count, bool holdOrder)
@@ -608,22 +713,20 @@ private:
 		return ptr;
 	}
 
-	void Destroy()
-	{
-		Clear();
-		ArrayFree(Data());
-		m_Data = nullptr;
-	}
-
 	void ForceReserve(int newAlloc)
 	{
 		lxAssert(newAlloc >= m_Used);
-		T* newEntries = (T*)ArrayAllocate(newAlloc * sizeof(T));
-		for(int i = 0; i < m_Used; ++i) {
-			new ((void*)&newEntries[i]) T(std::move(m_Data[i]));
-			m_Data[i].~T();
+		T* newEntries = AllocateData(newAlloc);
+		ifconst(IsTriviallyRelocatable<T>::value) {
+			if(m_Used)
+				std::memcpy((void*)newEntries, (const void*)m_Data, m_Used * sizeof(T));
+		} else {
+			for(int i = 0; i < m_Used; ++i) {
+				new ((void*)&newEntries[i]) T(std::move(m_Data[i]));
+				m_Data[i].~T();
+			}
 		}
-		ArrayFree(m_Data);
+		FreeData(m_Data, m_Alloc);
 
 		m_Data = newEntries;
 		m_Alloc = newAlloc;
@@ -634,6 +737,117 @@ private:
 	T* m_Data = nullptr;
 	int m_Used = 0;
 	int m_Alloc = 0;
+	Allocator* m_Allocator = nullptr;
+};
+
+//! Array which stores up to N elements without allocating memory
+/**
+Only if the array grows bigger than N, memory is allocated from the heap.
+Can be passed everywhere an Array is expected.
+*/
+template <typename T, int N>
+class SmallArray : private impl_array::InlineStorage<T, N>, public Array<T>
+{
+	using StorageT = impl_array::InlineStorage<T, N>;
+
+public:
+	SmallArray() :
+		Array<T>(static_cast<StorageT*>(this))
+	{
+		this->Reserve(N);
+	}
+
+	SmallArray(std::initializer_list<T> init) :
+		SmallArray()
+	{
+		Array<T>::operator=(init);
+	}
+
+	SmallArray(const SmallArray& other) :
+		SmallArray()
+	{
+		Array<T>::operator=(other);
+	}
+
+	SmallArray(SmallArray&& old) :
+		SmallArray()
+	{
+		Array<T>::operator=(std::move(old));
+	}
+
+	SmallArray(const Array<T>& other) :
+		SmallArray()
+	{
+		Array<T>::operator=(other);
+	}
+
+	SmallArray(Array<T>&& old) :
+		SmallArray()
+	{
+		Array<T>::operator=(std::move(old));
+	}
+
+	~SmallArray()
+	{
+		// Must happen while the inline storage still exists.
+		this->Destroy();
+	}
+
+	SmallArray& operator=(const Array<T>& other)
+	{
+		Array<T>::operator=(other);
+		return *this;
+	}
+
+	SmallArray& operator=(const SmallArray& other)
+	{
+		Array<T>::operator=(other);
+		return *this;
+	}
+
+	SmallArray& operator=(SmallArray&& old)
+	{
+		Array<T>::operator=(std::move(old));
+		return *this;
+	}
+
+	SmallArray& operator=(Array<T>&& old)
+	{
+		Array<T>::operator=(std::move(old));
+		return *this;
+	}
+};
+
+//! Array allocated in the frame arena
+/**
+Use it for temporary lists which are built and consumed in the same frame.
+The array must not be kept beyond the current frame.
+Growing the array leaves the old memory unused until the frame ends.
+If no frame is open on the creating thread, the heap is used instead.
+*/
+template <typename T>
+class FrameArray : public Array<T>
+{
+public:
+	FrameArray() :
+		Array<T>(GetFrameAllocator())
+	{
+	}
+
+	explicit FrameArray(int capacity) :
+		Array<T>(GetFrameAllocator())
+	{
+		this->Reserve(capacity);
+	}
+
+	FrameArray(const FrameArray&) = delete;
+	FrameArray& operator=(const FrameArray&) = delete;
+
+private:
+	static Allocator* GetFrameAllocator()
+	{
+		return FrameArena::IsFrameOpen() ? &FrameAllocator::Instance() : nullptr;
+	}
 };
 
 template <typename T>
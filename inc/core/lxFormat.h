@@ -37,6 +37,19 @@ public:
 		return size;
 	}
 
+	int WriteDirect(const format::Locale& locale, const char* data, int size, int flags) override
+	{
+		LUX_UNUSED(locale);
+
+		m_Str.Append(StringView(data, size));
+		if((flags & format::ESinkFlags::Newline) != 0) {
+			m_Str.Append(StringView("\n", 1));
+			++size;
+		}
+
+		return size;
+	}
+
 private:
 	core::String& m_Str;
 };
@@ -63,6 +76,18 @@ struct sink_access<lux::core::String>
 {
 	static lux::core::StringSink Get(lux::core::String& x) { return lux::core::StringSink(x); }
 };
+
+template <>
+struct direct_arg<lux::core::String>
+{
+	static internal::DirectArg Get(const lux::core::String& s) { return internal::DirectArg::String(s.Size(), s.Data()); }
+};
+
+template <>
+struct direct_arg<lux::core::StringView>
+{
+	static internal::DirectArg Get(lux::core::StringView s) { return internal::DirectArg::String(s.Size(), s.Data()); }
+};
 }
 
 #endif // #ifndef INCLUDED_LUX_FORMAT_H
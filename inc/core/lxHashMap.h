@@ -1,13 +1,21 @@
 #ifndef INCLUDED_LUX_LX_HASH_MAP_H
 #define INCLUDED_LUX_LX_HASH_MAP_H
 #include "core/BasicHashSet.h"
+#include "core/BasicFlatHashSet.h"
 
 namespace lux
 {
 namespace core
 {
 
-template <typename K, typename V, typename HasherT = HashType<K>, typename ComparerT = CompareType<K>>
+//! Hash map with dense storage of the entries
+/**
+The entries are stored in one array, iterators are pointers into this array.
+Adding or erasing entries invalidates all iterators.
+\tparam BaseSetT The hash set used to store the entries, either BasicHashSet or BasicFlatHashSet.
+*/
+template <typename K, typename V, typename HasherT = HashType<K>, typename ComparerT = CompareType<K>,
+	template <typename, typename, typename> class BaseSetT = BasicHashSet>
 class HashMap
 {
 	struct RefTuple
@@ -127,7 +135,7 @@ class HashMap
 		}
 	};
 
-	using BaseType = BasicHashSet<Tuple, TupleHasher, TupleComparer>;
+	using BaseType = BaseSetT<Tuple, TupleHasher, TupleComparer>;
 
 	class KeyNotFoundException : public ErrorException
 	{
@@ -315,15 +323,19 @@ private:
 	BaseType m_Base;
 };
 
-template <typename K, typename V, typename HasherT, typename ComparerT>
-typename HashMap<K, V, HasherT, ComparerT>::Iterator begin(HashMap<K, V, HasherT, ComparerT>& map) { return map.begin(); }
-template <typename K, typename V, typename HasherT, typename ComparerT>
-typename HashMap<K, V, HasherT, ComparerT>::Iterator end(HashMap<K, V, HasherT, ComparerT>& map) { return map.end(); }
+//! Hash map using open addressing, see BasicFlatHashSet
+template <typename K, typename V, typename HasherT = HashType<K>, typename ComparerT = CompareType<K>>
+using FlatHashMap = HashMap<K, V, HasherT, ComparerT, BasicFlatHashSet>;
+
+template <typename K, typename V, typename HasherT, typename ComparerT, template <typename, typename, typename> class BaseSetT>
+typename HashMap<K, V, HasherT, ComparerT, BaseSetT>::Iterator begin(HashMap<K, V, HasherT, ComparerT, BaseSetT>& map) { return map.begin(); }
+template <typename K, typename V, typename HasherT, typename ComparerT, template <typename, typename, typename> class BaseSetT>
+typename HashMap<K, V, HasherT, ComparerT, BaseSetT>::Iterator end(HashMap<K, V, HasherT, ComparerT, BaseSetT>& map) { return map.end(); }
 
-template <typename K, typename V, typename HasherT, typename ComparerT>
-typename HashMap<K, V, HasherT, ComparerT>::ConstIterator begin(const HashMap<K, V, HasherT, ComparerT>& map) { return map.begin(); }
-template <typename K, typename V, typename HasherT, typename ComparerT>
-typename HashMap<K, V, HasherT, ComparerT>::ConstIterator end(const HashMap<K, V, HasherT, ComparerT>& map) { return map.end(); }
+template <typename K, typename V, typename HasherT, typename ComparerT, template <typename, typename, typename> class BaseSetT>
+typename HashMap<K, V, HasherT, ComparerT, BaseSetT>::ConstIterator begin(const HashMap<K, V, HasherT, ComparerT, BaseSetT>& map) { return map.begin(); }
+template <typename K, typename V, typename HasherT, typename ComparerT, template <typename, typename, typename> class BaseSetT>
+typename HashMap<K, V, HasherT, ComparerT, BaseSetT>::ConstIterator end(const HashMap<K, V, HasherT, ComparerT, BaseSetT>& map) { return map.end(); }
 
 } // namespace core
 } // namespace lux
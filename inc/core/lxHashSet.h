@@ -3,6 +3,7 @@
 #include "core/lxUtil.h"
 #include "core/lxIterator.h"
 #include "core/BasicHashSet.h"
+#include "core/BasicFlatHashSet.h"
 
 namespace lux
 {
@@ -13,13 +14,14 @@ namespace core
 template <
 	typename T,
 	typename Hash = HashType<T>,
-	typename Compare = CompareType<T>>
+	typename Compare = CompareType<T>,
+	template <typename, typename, typename> class BaseSetT = BasicHashSet>
 	class HashSet
 {
 public:
 	using Iterator = T*;
 	using ConstIterator = const T*;
-	using BaseType = BasicHashSet<T, Hash, Compare>;
+	using BaseType = BaseSetT<T, Hash, Compare>;
 
 	struct FindAddResult
 	{
@@ -35,8 +37,7 @@ public:
 public:
 	HashSet() = default;
 	HashSet(const Hash& hasher, const Compare& comparer) :
-		m_Base(hasher),
-		m_Compare(comparer)
+		m_Base(hasher, comparer)
 	{
 	}
 	HashSet(const HashSet& other) = default;
@@ -52,7 +53,7 @@ public:
 	{
 		FindAddResult out;
 		auto result = m_Base.Add(value, BaseType::EAddOption::FailOnDuplicate, value);
-		out.it = Iterator(m_Base.GetValue(result.id));
+		out.it = Iterator(&m_Base.GetValue(result.id));
 		out.addedNew = result.addedNew;
 		return out;
 	}
@@ -60,7 +61,7 @@ public:
 	{
 		FindAddResult out;
 		auto result = m_Base.Add(value, BaseType::EAddOption::Replace, value);
-		out.it = Iterator(m_Base.GetValue(result.id));
+		out.it = Iterator(&m_Base.GetValue(result.id));
 		out.addedNew = result.addedNew;
 		return out;
 	}
@@ -74,7 +75,7 @@ public:
 
 	void EraseIter(Iterator it)
 	{
-		m_Base.Erase(it - &m_Base.GetValue(0));
+		m_Base.Erase(m_Base.Find(*it));
 	}
 
 	FindAddResult FindOrAdd(const T& value)
@@ -120,18 +121,22 @@ public:
 	bool IsEmpty() const { return m_Base.GetSize() == 0; }
 
 private:
-	BasicHashSet<T, Hash, Compare> m_Base;
+	BaseType m_Base;
 };
 
-template <typename T, typename Hash, typename Compare>
-typename HashSet<T, Hash, Compare>::Iterator begin(HashSet<T, Hash, Compare>& set) { return set.begin(); }
-template <typename T, typename Hash, typename Compare>
-typename HashSet<T, Hash, Compare>::Iterator end(HashSet<T, Hash, Compare>& set) { return set.end(); }
+//! Hash set using open addressing, see BasicFlatHashSet
+template <typename T, typename Hash = HashType<T>, typename Compare = CompareType<T>>
+using FlatHashSet = HashSet<T, Hash, Compare, BasicFlatHashSet>;
 
-template <typename T, typename Hash, typename Compare>
-typename HashSet<T, Hash, Compare>::ConstIterator begin(const HashSet<T, Hash, Compare>& set) { return set.begin(); }
-template <typename T, typename Hash, typename Compare>
-typename HashSet<T, Hash, Compare>::ConstIterator end(const HashSet<T, Hash, Compare>& set) { return set.end(); }
+template <typename T, typename Hash, typename Compare, template <typename, typename, typename> class BaseSetT>
+typename HashSet<T, Hash, Compare, BaseSetT>::Iterator begin(HashSet<T, Hash, Compare, BaseSetT>& set) { return set.begin(); }
+template <typename T, typename Hash, typename Compare, template <typename, typename, typename> class BaseSetT>
+typename HashSet<T, Hash, Compare, BaseSetT>::Iterator end(HashSet<T, Hash, Compare, BaseSetT>& set) { return set.end(); }
+
+template <typename T, typename Hash, typename Compare, template <typename, typename, typename> class BaseSetT>
+typename HashSet<T, Hash, Compare, BaseSetT>::ConstIterator begin(const HashSet<T, Hash, Compare, BaseSetT>& set) { return set.begin(); }
+template <typename T, typename Hash, typename Compare, template <typename, typename, typename> class BaseSetT>
+typename HashSet<T, Hash, Compare, BaseSetT>::ConstIterator end(const HashSet<T, Hash, Compare, BaseSetT>& set) { return set.end(); }
 
 } // namespace core
 } // namespace lux
@@ -0,0 +1,151 @@
+#ifndef INCLUDED_LUX_PROFILER_H
+#define INCLUDED_LUX_PROFILER_H
+#include "core/LuxBase.h"
+#include "core/lxArray.h"
+#include "core/lxString.h"
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define LUX_PROFILER_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LUX_PROFILER_RDTSC
+#else
+#include <chrono>
+#endif
+
+namespace lux
+{
+namespace core
+{
+
+//! Static description of a profiled code section
+/**
+Created once per code location by LX_PROFILE_SCOPE.
+*/
+struct ProfileZone
+{
+	const char* name;
+	const char* file;
+	int line;
+};
+
+//! Summary of all calls of a zone, with the same call path, in a frame
+struct ProfileNode
+{
+	const ProfileZone* zone;
+	int parent; //!< Index of the parent node, -1 for top level zones
+	int depth; //!< Nesting depth, 0 for top level zones
+	int thread; //!< Index of the thread, see Profiler::GetThreadName
+	int calls; //!< Number of calls in the frame
+	double totalMicros; //!< Time spent in the zone including children
+	double selfMicros; //!< Time spent in the zone excluding children
+};
+
+//! Hierarchical timing summary of a single frame
+struct ProfileFrame
+{
+	u32 frameIndex = 0;
+	double durationMicros = 0;
+	int droppedEvents = 0; //!< Zones lost because a thread buffer was full
+
+	//! All nodes of the frame, a parent is always before its children.
+	core::Array<ProfileNode> nodes;
+};
+
+//! Low overhead profiler for scoped zones
+/**
+Each thread writes finished zones into its own lock-free ring buffer.
+The buffers are collected once per frame by NextFrame, which builds the
+summary of the finished frame and appends the zones to the capture if a
+capture is running.
+Zones are only recorded if LUX_ENABLE_PROFILER is defined, which is the
+case for debug builds and builds with LUX_COMPILE_WITH_PROFILER.
+A zone costs two timer reads and a few nanoseconds for recording, the
+benchmark Profiler.EmptyZone measures it.
+All functions except RecordZone and SetThreadName must be called from the
+thread running the frame loop.
+*/
+class Profiler
+{
+public:
+	//! The current value of the timer used for the zones.
+	static u64 GetTimestamp()
+	{
+#ifdef LUX_PROFILER_RDTSC
+		return __rdtsc();
+#else
+		return (u64)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+	}
+
+	//! Add a finished zone of the calling thread.
+	LUX_API static void RecordZone(const ProfileZone* zone, u64 begin, u64 end);
+
+	//! Set the name of the calling thread, shown in exported traces.
+	LUX_API static void SetThreadName(core::StringView name);
+	LUX_API static int GetThreadCount();
+	LUX_API static core::String GetThreadName(int thread);
+
+	//! End the current frame and start a new one.
+	/**
+	Is called by the engine at the begin of each frame.
+	*/
+	LUX_API static void NextFrame();
+
+	//! The summary of the last finished frame.
+	LUX_API static const ProfileFrame& GetLastFrame();
+
+	//! Start collecting all zones of the following frames for export.
+	LUX_API static void BeginCapture();
+	//! Stop collecting zones, the captured zones stay available for export.
+	LUX_API static void EndCapture();
+	LUX_API static bool IsCapturing();
+
+	//! Write the captured zones in the Chrome trace event format.
+	/**
+	The file can be opened with chrome://tracing or ui.perfetto.dev.
+	\throws FileNotFoundException If the file can't be created.
+	*/
+	LUX_API static void ExportChromeTrace(const core::String& path);
+
+	//! Write the summary of the last frame as JSON.
+	/**
+	\throws FileNotFoundException If the file can't be created.
+	*/
+	LUX_API static void ExportFrameSummary(const core::String& path);
+};
+
+//! Records the lifetime of the object as zone.
+class ProfileScope : core::Uncopyable
+{
+public:
+	explicit ProfileScope(const ProfileZone& zone) :
+		m_Zone(&zone),
+		m_Begin(Profiler::GetTimestamp())
+	{
+	}
+
+	~ProfileScope()
+	{
+		Profiler::RecordZone(m_Zone, m_Begin, Profiler::GetTimestamp());
+	}
+
+private:
+	const ProfileZone* m_Zone;
+	u64 m_Begin;
+};
+
+} // namespace core
+} // namespace lux
+
+#ifdef LUX_ENABLE_PROFILER
+//! Profile the rest of the current scope, name must be a string literal.
+#define LX_PROFILE_SCOPE(name) \
+	static const ::lux::core::ProfileZone LX_CONCAT(lxProfileZone, __LINE__) = {name, __FILE__, __LINE__}; \
+	::lux::core::ProfileScope LX_CONCAT(lxProfileScope, __LINE__)(LX_CONCAT(lxProfileZone, __LINE__))
+#else
+#define LX_PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif // #ifndef INCLUDED_LUX_PROFILER_H
@@ -0,0 +1,97 @@
+#ifndef INCLUDED_LUX_SLAB_ALLOCATOR_H
+#define INCLUDED_LUX_SLAB_ALLOCATOR_H
+#include "core/LuxBase.h"
+#include "core/HelperTemplates.h"
+#include "core/lxArray.h"
+#include <mutex>
+
+namespace lux
+{
+namespace core
+{
+
+//! Placement argument to allocate an object next to another one.
+struct SlabHint
+{
+	explicit SlabHint(const void* n) :
+		neighbour(n)
+	{
+	}
+
+	const void* neighbour;
+};
+
+//! Allocator for many objects of the same size
+/**
+Objects are placed in big continuous slabs instead of being spread over the
+heap, which keeps objects allocated together close in memory.
+The allocator is threadsafe.
+*/
+class SlabAllocator : core::Uncopyable
+{
+public:
+	struct Statistics
+	{
+		int slabCount; //!< Number of slabs allocated from the heap
+		int capacity; //!< Number of objects fitting into all slabs
+		int used; //!< Number of currently allocated objects
+
+		//! The part of the slab memory which is unused.
+		float GetFragmentation() const
+		{
+			return capacity ? 1.0f - (float)used / capacity : 0.0f;
+		}
+	};
+
+public:
+	//! Create a slab allocator
+	/**
+	\param objectSize The size of a single object in bytes.
+	\param objectsPerSlab The number of objects in a single slab.
+	*/
+	LUX_API SlabAllocator(size_t objectSize, int objectsPerSlab = 256);
+	LUX_API ~SlabAllocator();
+
+	//! Allocate memory for a single object.
+	/**
+	\param neighbour If not null, the memory is placed in the same slab as
+		this object if possible.
+	\return Memory of at least objectSize bytes, never null.
+	*/
+	LUX_API void* Allocate(const void* neighbour = nullptr);
+
+	//! Free memory allocated with Allocate.
+	LUX_API void Free(void* ptr);
+
+	//! Check if the memory was allocated by this allocator.
+	LUX_API bool Owns(const void* ptr) const;
+
+	//! Release all slabs without any allocated object.
+	LUX_API void ReleaseEmptySlabs();
+
+	LUX_API Statistics GetStatistics() const;
+
+	size_t GetObjectSize() const { return m_ObjectSize; }
+
+private:
+	struct Slab;
+
+	Slab* FindSlab(const void* ptr) const;
+	Slab* CreateSlab();
+	void* AllocateFrom(Slab* slab);
+
+private:
+	size_t m_ObjectSize;
+	int m_ObjectsPerSlab;
+
+	core::Array<Slab*> m_Slabs; //!< All slabs sorted by address
+	core::Array<Slab*> m_Available; //!< Slabs which may have free space
+	int m_Used;
+
+	mutable std::mutex m_Lock;
+};
+
+} // namespace core
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_SLAB_ALLOCATOR_H
@@ -2,6 +2,9 @@
 #define INCLUDED_LUX_SORT_H
 #include "core/iterators/lxBaseIterator.h"
 #include "core/lxUtil.h"
+#include <cstring>
+#include <future>
+#include <type_traits>
 
 namespace lux
 {
@@ -54,11 +57,431 @@ inline void Heapsort(RanIt first, RanIt end, const Compare& compare)
 	}
 }
 
+namespace impl_sort
+{
+template <typename RanIt>
+inline void Swap(RanIt a, RanIt b)
+{
+	auto tmp(std::move(*a));
+	*a = std::move(*b);
+	*b = std::move(tmp);
+}
+
+//! Uninitialized memory for temporary elements.
+template <typename T>
+class TempBuffer
+{
+public:
+	explicit TempBuffer(int count) :
+		m_Data((T*)::operator new(sizeof(T) * (count > 0 ? count : 1)))
+	{
+	}
+	~TempBuffer()
+	{
+		::operator delete(m_Data);
+	}
+	TempBuffer(const TempBuffer&) = delete;
+	TempBuffer& operator=(const TempBuffer&) = delete;
+
+	T* Data() const { return m_Data; }
+
+private:
+	T* m_Data;
+};
+
+//! Sorting ranges at most this size is done with insertion sort.
+static const int INSERTION_SORT_LIMIT = 16;
+
+// Stable, fast for very small ranges.
+template <typename RanIt, typename Compare>
+inline void InsertionSort(RanIt first, RanIt end, const Compare& compare)
+{
+	if(first == end)
+		return;
+	for(RanIt i = first + 1; i != end; ++i) {
+		if(!compare.Smaller(*i, *(i - 1)))
+			continue;
+		auto tmp(std::move(*i));
+		RanIt j = i;
+		do {
+			*j = std::move(*(j - 1));
+			--j;
+		} while(j != first && compare.Smaller(tmp, *(j - 1)));
+		*j = std::move(tmp);
+	}
+}
+
+// Move the median of a, b and c to result.
+template <typename RanIt, typename Compare>
+inline void MoveMedianToFirst(RanIt result, RanIt a, RanIt b, RanIt c, const Compare& compare)
+{
+	if(compare.Smaller(*a, *b)) {
+		if(compare.Smaller(*b, *c))
+			Swap(result, b);
+		else if(compare.Smaller(*a, *c))
+			Swap(result, c);
+		else
+			Swap(result, a);
+	} else if(compare.Smaller(*a, *c)) {
+		Swap(result, a);
+	} else if(compare.Smaller(*b, *c)) {
+		Swap(result, c);
+	} else {
+		Swap(result, b);
+	}
+}
+
+template <typename RanIt, typename Compare>
+void IntrosortLoop(RanIt first, RanIt end, int depthLimit, const Compare& compare)
+{
+	while(end - first > INSERTION_SORT_LIMIT) {
+		if(depthLimit == 0) {
+			// Too many bad pivots, guarantee O(n log n).
+			Heapsort(first, end, compare);
+			return;
+		}
+		--depthLimit;
+
+		MoveMedianToFirst(first, first + 1, first + (end - first) / 2, end - 1, compare);
+
+		// The median of three guarantees that both scans stop inside the range.
+		RanIt lo = first + 1;
+		RanIt hi = end;
+		while(true) {
+			while(compare.Smaller(*lo, *first))
+				++lo;
+			--hi;
+			while(compare.Smaller(*first, *hi))
+				--hi;
+			if(!(lo < hi))
+				break;
+			Swap(lo, hi);
+			++lo;
+		}
+
+		// Recurse into the right part, loop on the left one.
+		IntrosortLoop(lo, end, depthLimit, compare);
+		end = lo;
+	}
+	InsertionSort(first, end, compare);
+}
+
+// Merge the sorted ranges [first, mid) and [mid, end), buffer must have
+// space for mid-first elements.
+template <typename RanIt, typename T, typename Compare>
+void Merge(RanIt first, RanIt mid, RanIt end, T* buffer, const Compare& compare)
+{
+	if(first == mid || mid == end || !compare.Smaller(*mid, *(mid - 1)))
+		return;
+
+	int leftCount = int(mid - first);
+	for(int i = 0; i < leftCount; ++i)
+		new ((void*)(buffer + i)) T(std::move(*(first + i)));
+
+	T* left = buffer;
+	T* leftEnd = buffer + leftCount;
+	RanIt right = mid;
+	RanIt out = first;
+	while(left != leftEnd && right != end) {
+		// Take from the left on equality, to keep the sort stable.
+		if(compare.Smaller(*right, *left))
+			*out++ = std::move(*right++);
+		else
+			*out++ = std::move(*left++);
+	}
+	while(left != leftEnd)
+		*out++ = std::move(*left++);
+
+	for(int i = 0; i < leftCount; ++i)
+		buffer[i].~T();
+}
+
+template <typename RanIt, typename T, typename Compare>
+void MergeSortRec(RanIt first, RanIt end, T* buffer, const Compare& compare)
+{
+	if(end - first <= INSERTION_SORT_LIMIT) {
+		InsertionSort(first, end, compare);
+		return;
+	}
+	RanIt mid = first + (end - first) / 2;
+	MergeSortRec(first, mid, buffer, compare);
+	MergeSortRec(mid, end, buffer, compare);
+	Merge(first, mid, end, buffer, compare);
+}
+
+//! Maps a key to unsigned bits with the same order.
+template <typename KeyT, typename Enable = void>
+struct RadixKey;
+
+template <typename KeyT>
+struct RadixKey<KeyT, typename std::enable_if<std::is_integral<KeyT>::value && std::is_unsigned<KeyT>::value>::type>
+{
+	using BitsT = typename std::conditional<(sizeof(KeyT) > 4), u64, u32>::type;
+	static BitsT Get(KeyT key) { return BitsT(key); }
+	static const int BYTES = sizeof(KeyT);
+};
+
+template <typename KeyT>
+struct RadixKey<KeyT, typename std::enable_if<std::is_integral<KeyT>::value && std::is_signed<KeyT>::value>::type>
+{
+	using BitsT = typename std::conditional<(sizeof(KeyT) > 4), u64, u32>::type;
+	using UnsignedT = typename std::make_unsigned<KeyT>::type;
+	// Flip the sign bit, so negative numbers come first.
+	static BitsT Get(KeyT key) { return BitsT(UnsignedT(key) ^ (UnsignedT(1) << (sizeof(KeyT) * 8 - 1))); }
+	static const int BYTES = sizeof(KeyT);
+};
+
+template <>
+struct RadixKey<float>
+{
+	using BitsT = u32;
+	// Negative floats are reversed by flipping all bits, positive ones are
+	// moved behind them by setting the sign bit.
+	static BitsT Get(float key)
+	{
+		u32 bits;
+		std::memcpy(&bits, &key, sizeof(bits));
+		return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+	}
+	static const int BYTES = 4;
+};
+
+template <>
+struct RadixKey<double>
+{
+	using BitsT = u64;
+	static BitsT Get(double key)
+	{
+		u64 bits;
+		std::memcpy(&bits, &key, sizeof(bits));
+		return (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+	}
+	static const int BYTES = 8;
+};
+} // namespace impl_sort
+
+//! Sort a random access range with introsort
+/**
+Quicksort with median of three pivots, which falls back to heapsort for
+bad inputs and uses insertion sort for small ranges.
+Not stable.
+*/
+template <typename RanIt, typename Compare>
+inline void Introsort(RanIt first, RanIt end, const Compare& compare)
+{
+	int size = core::IteratorDistance(first, end);
+	if(size <= 1)
+		return;
+	int depthLimit = 0;
+	for(int i = size; i > 1; i >>= 1)
+		depthLimit += 2;
+	impl_sort::IntrosortLoop(first, end, depthLimit, compare);
+}
+
+//! Sort a random access range with merge sort
+/**
+Stable, needs temporary memory for half the range.
+*/
+template <typename RanIt, typename Compare>
+inline void MergeSort(RanIt first, RanIt end, const Compare& compare)
+{
+	using T = typename std::decay<decltype(*first)>::type;
+	int size = core::IteratorDistance(first, end);
+	if(size <= impl_sort::INSERTION_SORT_LIMIT) {
+		impl_sort::InsertionSort(first, end, compare);
+		return;
+	}
+	impl_sort::TempBuffer<T> buffer(size / 2 + 1);
+	impl_sort::MergeSortRec(first, end, buffer.Data(), compare);
+}
+
+//! Sort a random access range with LSD radix sort
+/**
+Stable, sorts in linear time.
+\param keyFunc Maps an element to its sort key, an integer or floating point number.
+	Is called once per element.
+*/
+template <typename RanIt, typename KeyFuncT>
+void RadixSort(RanIt first, RanIt end, const KeyFuncT& keyFunc)
+{
+	using T = typename std::decay<decltype(*first)>::type;
+	using KeyT = typename std::decay<decltype(keyFunc(*first))>::type;
+	using Traits = impl_sort::RadixKey<KeyT>;
+	using BitsT = typename Traits::BitsT;
+	struct Entry
+	{
+		BitsT key;
+		int index;
+	};
+
+	int size = core::IteratorDistance(first, end);
+	if(size <= 1)
+		return;
+
+	impl_sort::TempBuffer<Entry> entries(size * 2);
+	Entry* src = entries.Data();
+	Entry* dst = entries.Data() + size;
+
+	// Count all digits in a single pass.
+	int counts[Traits::BYTES][256] = {};
+	for(int i = 0; i < size; ++i) {
+		BitsT key = Traits::Get(keyFunc(*(first + i)));
+		src[i].key = key;
+		src[i].index = i;
+		for(int b = 0; b < Traits::BYTES; ++b)
+			++counts[b][(key >> (b * 8)) & 0xFF];
+	}
+
+	for(int b = 0; b < Traits::BYTES; ++b) {
+		int* count = counts[b];
+		// Skip digits which are equal in all keys.
+		if(count[(src[0].key >> (b * 8)) & 0xFF] == size)
+			continue;
+		int offset = 0;
+		for(int d = 0; d < 256; ++d) {
+			int c = count[d];
+			count[d] = offset;
+			offset += c;
+		}
+		for(int i = 0; i < size; ++i)
+			dst[count[(src[i].key >> (b * 8)) & 0xFF]++] = src[i];
+		std::swap(src, dst);
+	}
+
+	// Apply the permutation to the elements.
+	impl_sort::TempBuffer<T> values(size);
+	T* v = values.Data();
+	for(int i = 0; i < size; ++i)
+		new ((void*)(v + i)) T(std::move(*(first + src[i].index)));
+	for(int i = 0; i < size; ++i) {
+		*(first + i) = std::move(v[i]);
+		v[i].~T();
+	}
+}
+
+//! Compare type, which sorts elements by a numeric key
+/**
+Sort uses radix sort for it.
+*/
+template <typename KeyFuncT>
+struct SortKeyType
+{
+	KeyFuncT keyFunc;
+
+	explicit SortKeyType(const KeyFuncT& func) :
+		keyFunc(func)
+	{
+	}
+
+	template <typename T>
+	bool Smaller(const T& a, const T& b) const { return keyFunc(a) < keyFunc(b); }
+	template <typename T>
+	bool Equal(const T& a, const T& b) const { return keyFunc(a) == keyFunc(b); }
+};
+
+//! Sort elements by a numeric key
+/**
+\param func Maps an element to an integer or floating point number.
+*/
+template <typename KeyFuncT>
+SortKeyType<KeyFuncT> SortByKey(const KeyFuncT& func)
+{
+	return SortKeyType<KeyFuncT>(func);
+}
+
+enum class ESortAlgorithm
+{
+	Introsort, //!< Fast, not stable.
+	MergeSort, //!< Stable, needs temporary memory.
+	Heapsort, //!< No temporary memory, not stable, slower than introsort.
+};
+
+//! Sort a range
 template <typename RangeT, typename CompareType>
-void Sort(RangeT&& range, CompareType compare)
+void Sort(RangeT&& range, CompareType compare, ESortAlgorithm algorithm = ESortAlgorithm::Introsort)
+{
+	using namespace std;
+	switch(algorithm) {
+	case ESortAlgorithm::Introsort: Introsort(begin(range), end(range), compare); break;
+	case ESortAlgorithm::MergeSort: MergeSort(begin(range), end(range), compare); break;
+	case ESortAlgorithm::Heapsort: Heapsort(begin(range), end(range), compare); break;
+	}
+}
+
+//! Sort a range by a numeric key, see SortByKey
+/**
+Uses radix sort for bigger ranges, the sort is always stable.
+*/
+template <typename RangeT, typename KeyFuncT>
+void Sort(RangeT&& range, SortKeyType<KeyFuncT> compare)
 {
 	using namespace std;
-	Heapsort(begin(range), end(range), compare);
+	auto first = begin(range);
+	auto last = end(range);
+	if(core::IteratorDistance(first, last) < 64)
+		impl_sort::InsertionSort(first, last, compare);
+	else
+		RadixSort(first, last, compare.keyFunc);
+}
+
+//! Sort a range with a stable merge sort on a thread pool
+/**
+The range is split into one part per thread, which are sorted in parallel
+and then merged pairwise, again in parallel.
+Small ranges are sorted on the calling thread.
+The calling thread blocks until the range is sorted, so this must not be
+called from a job running on the same pool.
+\param pool A thread pool, i.e. core::ThreadPool, with a Push method taking a
+	void function and returning a std::future.
+*/
+template <typename RangeT, typename CompareType, typename PoolT>
+void Sort(RangeT&& range, CompareType compare, PoolT& pool)
+{
+	using namespace std;
+	auto first = begin(range);
+	using T = typename std::decay<decltype(*first)>::type;
+
+	const int MIN_PART_SIZE = 2048;
+	const int MAX_PARTS = 64;
+	int size = core::IteratorDistance(first, end(range));
+	int parts = 1;
+	while(parts * 2 <= pool.GetThreadCount() * 2 && parts * 2 <= MAX_PARTS && size / (parts * 2) >= MIN_PART_SIZE)
+		parts *= 2;
+	if(parts == 1) {
+		MergeSort(first, end(range), compare);
+		return;
+	}
+
+	// Part i covers [bounds[i], bounds[i+1]), each part has its own piece
+	// of the buffer.
+	int bounds[MAX_PARTS + 1];
+	for(int i = 0; i <= parts; ++i)
+		bounds[i] = int((long long)size * i / parts);
+	impl_sort::TempBuffer<T> buffer(size);
+	T* buf = buffer.Data();
+
+	std::future<void> futures[MAX_PARTS];
+	for(int i = 0; i < parts; ++i) {
+		futures[i] = pool.Push([=, &compare]() {
+			impl_sort::MergeSortRec(first + bounds[i], first + bounds[i + 1], buf + bounds[i], compare);
+		});
+	}
+	for(int i = 0; i < parts; ++i)
+		futures[i].get();
+
+	for(int width = 1; width < parts; width *= 2) {
+		int count = 0;
+		for(int i = 0; i + width < parts; i += 2 * width) {
+			int lo = bounds[i];
+			int mid = bounds[i + width];
+			int hi = bounds[i + 2 * width < parts ? i + 2 * width : parts];
+			futures[count++] = pool.Push([=, &compare]() {
+				impl_sort::Merge(first + lo, first + mid, first + hi, buf + lo, compare);
+			});
+		}
+		for(int i = 0; i < count; ++i)
+			futures[i].get();
+	}
 }
 
 }
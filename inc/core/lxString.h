@@ -146,7 +146,7 @@ public:
 	//! The number of codepoints in the string.
 	inline int CodePointCount() const
 	{
-		return CodePoints().End() - CodePoints().First();
+		return CodePointCountUTF8(Data(), Size());
 	}
 
 	//! The number of bytes allocated for the string.
@@ -614,6 +614,30 @@ struct HashType<String>
 	{
 		return HashType<StringView>()(str.Data(), str.Size());
 	}
+	// Allows lookups in string maps without creating a string.
+	unsigned int operator()(const StringView& str) const
+	{
+		return HashType<StringView>()(str.Data(), str.Size());
+	}
+	unsigned int operator()(const char* str) const
+	{
+		return HashType<StringView>()(str, (int)strlen(str));
+	}
+};
+
+template <>
+struct CompareType<String>
+{
+	template <typename T>
+	bool Equal(const String& str, const T& b) const
+	{
+		return str == b;
+	}
+	template <typename T>
+	bool Smaller(const String& str, const T& b) const
+	{
+		return str < b;
+	}
 };
 
 template <>
@@ -99,7 +99,7 @@ private:
 	StringTableHandle AddFindString(const StringView& str, bool find);
 
 private:
-	HashMap<CheckEntry, StringTableHandle, CheckEntry::Hasher, CheckEntry::Compare> m_Map;
+	FlatHashMap<CheckEntry, StringTableHandle, CheckEntry::Hasher, CheckEntry::Compare> m_Map;
 	MemBlock* m_First;
 	MemBlock* m_Last;
 };
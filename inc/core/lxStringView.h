@@ -167,6 +167,11 @@ public:
 	{
 		return MakeRange<const char*>(m_Data, m_Data + m_Size);
 	}
+	//! The number of codepoints in the string.
+	int CodePointCount() const
+	{
+		return CodePointCountUTF8(m_Data, m_Size);
+	}
 	//! The unicode codepoints of the string as range.
 	core::Range<ConstUTF8Iterator> CodePoints() const
 	{
@@ -17,6 +17,15 @@ The passed string must be nul-terminated.
 */
 LUX_API int StringLengthUTF8(const char* str, int* outBytes = nullptr);
 
+//! Computes the number of codepoints inside utf8 data.
+/**
+The data is processed 16 bytes at a time.
+\param str The string data.
+\param size The number of bytes in the string.
+\return The number of codepoints in the string.
+*/
+LUX_API int CodePointCountUTF8(const char* str, int size);
+
 //! Moves the passed utf8 cursor onto the character before the current one
 LUX_API void RetractCursorUTF8(const char*& ptr);
 
@@ -153,7 +162,8 @@ public:
 
 	ConstUTF8Iterator& operator++()
 	{
-		if(m_Data < m_First)
+		// Ascii characters are handled inline.
+		if(m_Data < m_First || (u8)*m_Data < 0x80)
 			++m_Data;
 		else
 			core::AdvanceCursorUTF8(m_Data);
@@ -177,7 +187,7 @@ public:
 	ConstUTF8Iterator operator--(int)
 	{
 		ConstUTF8Iterator tmp(*this);
-		++*this;
+		--*this;
 		return tmp;
 	}
 
@@ -257,6 +267,9 @@ public:
 
 	u32 operator*() const
 	{
+		u8 c = (u8)*m_Data;
+		if(c < 0x80)
+			return c;
 		return core::GetCharacterUTF8(m_Data);
 	}
 
@@ -9,16 +9,49 @@ namespace core
 {
 
 //! Convert a utf16-string to a array of utf8 elements.
+/**
+\param data The little endian utf16 data.
+\param size The size of data in bytes, -1 if data is NUL-terminated.
+*/
 LUX_API Array<u8> UTF16ToUTF8(const void* data, int size);
 
 //! Convert a utf16-string to a string.
+/**
+\param data The little endian utf16 data.
+\param size The size of data in bytes, -1 if data is NUL-terminated.
+*/
 LUX_API core::String UTF16ToString(const void* data, int size);
 
 //! Convert a utf8-string to a array of utf16 elements
+/**
+Ascii parts of the string are converted 16 bytes at a time.
+\param data The utf8 data, must be valid utf8.
+\param size The size of data in bytes, -1 if data is NUL-terminated.
+\param dst The utf16 elements are appended to this array.
+\return dst
+*/
 LUX_API Array<u16>& UTF8ToUTF16(const void* data, int size, Array<u16>& dst);
 
-//! Convert a utf8-string to a array of utf16 elements
-LUX_API Array<u16>& UTF8ToUTF16(const void* data, int size, Array<u16>& dst);
+//! Convert a utf8-string to a array of codepoints
+/**
+Ascii parts of the string are converted 16 bytes at a time.
+\param data The utf8 data, must be valid utf8.
+\param size The size of data in bytes, -1 if data is NUL-terminated.
+\param dst The codepoints are appended to this array.
+\return dst
+*/
+LUX_API Array<u32>& UTF8ToUTF32(const void* data, int size, Array<u32>& dst);
+
+//! Check if data is valid utf8.
+/**
+Overlong sequences, surrogates and codepoints above 0x10FFFF are invalid.
+Ascii parts of the data are checked 16 bytes at a time.
+\param data The checked data.
+\param size The size of data in bytes.
+\param [out] errorOffset If not null and the data is invalid, the offset of the first invalid sequence is written here.
+\return True if the data is valid utf8.
+*/
+LUX_API bool IsValidUTF8(const void* data, int size, int* errorOffset = nullptr);
 
 struct Win32String
 {
@@ -5,6 +5,7 @@
 #include <future>
 #include "core/lxDeque.h"
 #include "core/lxArray.h"
+#include "core/lxProfiler.h"
 
 namespace lux
 {
@@ -162,7 +163,10 @@ private:
 		Function* function = pool.m_Queue.Pop();
 		do {
 			while(function) {
-				function->Call();
+				{
+					LX_PROFILE_SCOPE("ThreadPool::Job");
+					function->Call();
+				}
 				delete function;
 				if(pool.m_FlagKill)
 					return;
@@ -31,6 +31,8 @@ FORMAT_API void fmtPrint(Context& ctx, unsigned long long data, const Placeholde
 
 FORMAT_API void fmtPrint(Context& ctx, const void* data, const Placeholder& placeholder);
 
+// Types: f or none rounds to the digit count, r writes the shortest string
+// reading back as the same number, h writes hexadecimal.
 FORMAT_API void fmtPrint(Context& ctx, float data, const Placeholder& placeholder);
 FORMAT_API void fmtPrint(Context& ctx, double data, const Placeholder& placeholder);
 FORMAT_API void fmtPrint(Context& ctx, long double data, const Placeholder& placeholder);
@@ -3,6 +3,7 @@
 #include "format/Context.h"
 #include "format/FormatLocale.h"
 #include <cassert>
+#include <cstdint>
 
 namespace format
 {
@@ -11,13 +12,39 @@ namespace format
 /**
 for Not a number nan is written
 for infinite +inf or -inf is written.
-For number bigger than 10^13 or smaller than 10^-9 expontial notation is used in format 12.34e+5
+For number bigger than 10^14 or smaller than 10^-9 expontial notation is used in format 1.234e+5
+\param ctx The context where the number is written to.
 \param n The number to convert
-\param [out] s Here the resulting string is written. Must be at least MAX_DOUBLE_LEN+digits character long, String is not nullptr-terminated.
-\param digiti The maximal number of digits after the decimal-point.
-\return The length of the resulting string, 0 if an error occured.
+\param digits The maximal number of digits after the decimal-point, or -1 for the
+shortest representation which reads back as the same number.
+\param forcePrecision Fill up the digits after the decimal-point with zeros.
+\param locale The format of the number.
 */
 FORMAT_API void PutFloat(Context& ctx, double n, int digits, bool forcePrecision, const Facet_NumericalFormat& locale);
+//! Convert a floating point number to a string.
+/**
+Like the double version, but the shortest representation uses the precision of floats.
+*/
+FORMAT_API void PutFloat(Context& ctx, float n, int digits, bool forcePrecision, const Facet_NumericalFormat& locale);
+
+//! Generate the shortest digits of a floating point number.
+/**
+The generated digits read back as the same number, with the precision of the passed type.
+\param n The number to convert, must be finite and greater than zero.
+\param [out] digits The decimal digits, at least 17 character long, not null-terminated.
+\param [out] exponent The decimal exponent, n = digits * 10^exponent.
+\return The number of digits.
+*/
+FORMAT_API int ShortestDigits(double n, char* digits, int& exponent);
+FORMAT_API int ShortestDigits(float n, char* digits, int& exponent);
+
+//! Write the decimal digits of an unsigned integer.
+/**
+\param n The number to convert
+\param [out] s The digits, at least 20 character long, not null-terminated.
+\return The number of digits.
+*/
+FORMAT_API int UIntToDecimal(uint64_t n, char* s);
 
 FORMAT_API void PutHexFloat(Context& ctx, double n, const Facet_NumericalFormat& locale);
 
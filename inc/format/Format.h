@@ -3,6 +3,7 @@
 #include "format/Context.h"
 #include "format/Sink.h"
 #include "format/FormatLocale.h"
+#include "format/FormatPlan.h"
 
 //! Contains all format functionality
 namespace format
@@ -26,6 +27,16 @@ Will perform normal formatting, but will write the result into a Context.<br>
 template <typename... Types>
 void vformat(Context& ctx, Slice str, const Types&... args);
 
+//! Format a plan and write it into a given context
+/**
+Like vformat with a string, but the format string isn't parsed again.
+\param ctx The context where the formatted data is written to
+\param plan The format plan
+\param args The placeholder arguments
+*/
+template <int N, typename... Types>
+void vformat(Context& ctx, const FormatPlan<N>& plan, const Types&... args);
+
 struct FormatExData
 {
 	const Locale* locale = nullptr;
@@ -44,6 +55,20 @@ struct FormatExData
 template <typename SinkT, typename... Types>
 int formatEx(SinkT&& sink, const FormatExData& exData, Slice str, const Types&... args);
 
+//! Format a plan
+/**
+If the plan only contains simple placeholders and all arguments support it,
+the output is written directly into the sink without formatting context.
+\param sink The destination sink
+\param exData Extended data for formatting.
+\param plan The format plan
+\param args The placeholder arguments
+\return The number of characters written, or -1 on error
+\throws format::exception When an error occured an FORMAT_EXCEPTIONS is set
+*/
+template <typename SinkT, int N, typename... Types>
+int formatEx(SinkT&& sink, const FormatExData& exData, const FormatPlan<N>& plan, const Types&... args);
+
 //! Format a string
 /**
 The output and input types default to FORMAT_STRING_TYPE
@@ -69,6 +94,20 @@ The output and input types default to FORMAT_STRING_TYPE
 template <typename SinkT, typename... Types>
 int formatln(SinkT&& sink, const char* str, const Types&... args);
 
+//! Format a plan
+/**
+See format with a string.
+*/
+template <typename SinkT, int N, typename... Types>
+int format(SinkT&& sink, const FormatPlan<N>& plan, const Types&... args);
+
+//! Format a plan and write a newline character into the sink and flush the sink
+/**
+See formatln with a string.
+*/
+template <typename SinkT, int N, typename... Types>
+int formatln(SinkT&& sink, const FormatPlan<N>& plan, const Types&... args);
+
 /** @}*/
 
 }
@@ -56,29 +56,62 @@ namespace internal
 	}
 
 	FORMAT_API void format(Context& ctx, Slice fmtStr);
+	FORMAT_API void format(Context& ctx, const PlanView& plan);
+
+	template <typename... Types>
+	inline void SetRefFormatEntries(Context& ctx, BaseFormatEntryType* entries, const Types&... args)
+	{
+		// Validate RefFormatEntry sizes
+		int unused1[] = {0, (internal::CheckRefEntryType<Types>(), 0)...};
+		(void)unused1;
+
+		char* ptr = (char*)entries;
+		(void)ptr; // Fixed warning if entryCount is zero.
+		int unused2[] = {0,
+			// Perform calls directly to reduce compile file size.
+			(new (ptr) internal::RefFormatEntry<Types>(&args), ptr += sizeof(internal::BaseFormatEntryType), 0)...
+		};
+		(void)unused2;
+
+		ctx.SetFormatEntries(entries, (int)sizeof...(Types), sizeof(internal::BaseFormatEntryType));
+	}
+
+	template <typename T>
+	inline DirectArg GetDirectArg(const T& arg)
+	{
+		return direct_arg<T>::Get(arg);
+	}
+
+	// Try to format the plan without context, returns -1 if not possible.
+	template <typename SinkT, typename... Types>
+	inline int formatDirect(SinkT& sink, const Locale& locale, const PlanView& plan, int sinkFlags, const Types&... args)
+	{
+		DirectArg directArgs[sizeof...(Types) ? sizeof...(Types) : 1] = {GetDirectArg(args)...};
+		char buffer[DIRECT_BUFFER_SIZE];
+		int size = FormatDirect(buffer, DIRECT_BUFFER_SIZE, plan, directArgs, (int)sizeof...(Types), locale);
+		if(size < 0)
+			return -1;
+		return sink.WriteDirect(locale, buffer, size, sinkFlags);
+	}
 }
 
 template <typename... Types>
 inline void vformat(Context& ctx, Slice str, const Types&... args)
 {
-	// Validate RefFormatEntry sizes
-	int unused1[] = {0, (internal::CheckRefEntryType<Types>(), 0)...};
-	(void)unused1;
-
 	// Allocate stack memory for RefEntries
 	internal::BaseFormatEntryType entries[sizeof...(Types) ? sizeof...(Types) : 1]; // Arrays of size 0 are forbidden.
-	char* ptr = (char*)entries;
-	(void)ptr; // Fixed warning if entryCount is zero.
-	int unused2[] = {0, 
-		// Perform calls directly to reduce compile file size.
-		(new (ptr) internal::RefFormatEntry<Types>(&args), ptr += sizeof(internal::BaseFormatEntryType), 0)...
-	};
-	(void)unused2;
-
-	ctx.SetFormatEntries(entries, (int)sizeof...(Types), sizeof(internal::BaseFormatEntryType));
+	internal::SetRefFormatEntries(ctx, entries, args...);
 	internal::format(ctx, str);
 }
 
+template <int N, typename... Types>
+inline void vformat(Context& ctx, const FormatPlan<N>& plan, const Types&... args)
+{
+	internal::BaseFormatEntryType entries[sizeof...(Types) ? sizeof...(Types) : 1];
+	internal::SetRefFormatEntries(ctx, entries, args...);
+	internal::format(ctx, plan.GetView());
+}
+
 template <typename... Types>
 inline void vformat(Context& ctx, const char* str, const Types&... args)
 {
@@ -108,6 +141,35 @@ inline int formatEx(SinkT&& sink, const FormatExData& exData, Slice str, const T
 #endif
 }
 
+template <typename SinkT, int N, typename... Types>
+inline int formatEx(SinkT&& sink, const FormatExData& exData, const FormatPlan<N>& plan, const Types&... args)
+{
+#ifdef FORMAT_NO_EXCEPTIONS
+	try {
+#endif
+		const Locale& locale = exData.locale ? *exData.locale : *GetLocale();
+		using CleanSinkT =
+			typename std::remove_cv<
+			typename std::remove_reference<SinkT>::type>::type;
+		auto real_sink = sink_access<CleanSinkT>::Get(sink);
+
+		auto view = plan.GetView();
+		if(view.isDirect) {
+			int written = internal::formatDirect(real_sink, locale, view, exData.sinkFlags, args...);
+			if(written >= 0)
+				return written;
+		}
+
+		Context ctx(locale);
+		vformat(ctx, plan, args...);
+		return (int)real_sink.Write(ctx, ctx.Slices(), exData.sinkFlags);
+#ifdef FORMAT_NO_EXCEPTIONS
+	} catch(...) {
+		return -1;
+	}
+#endif
+}
+
 template <typename SinkT, typename... Types>
 inline int format(SinkT&& sink, const char* str, const Types&... args)
 {
@@ -127,6 +189,19 @@ inline int format(SinkT&& sink, Slice str, const Types&... args)
 	FormatExData data;
 	return formatEx(sink, data, str, args...);
 }
+template <typename SinkT, int N, typename... Types>
+inline int format(SinkT&& sink, const FormatPlan<N>& plan, const Types&... args)
+{
+	FormatExData data;
+	return formatEx(sink, data, plan, args...);
+}
+template <typename SinkT, int N, typename... Types>
+inline int format(SinkT&& sink, Locale* locale, const FormatPlan<N>& plan, const Types&... args)
+{
+	FormatExData data;
+	data.locale = locale;
+	return formatEx(sink, data, plan, args...);
+}
 template <typename SinkT, typename... Types>
 inline int formatln(SinkT&& sink, const char* str, const Types&... args)
 {
@@ -140,4 +215,12 @@ inline int formatln(SinkT&& sink, Slice str, const Types&... args)
 	return formatEx(sink, data, str, args...);
 }
 
+template <typename SinkT, int N, typename... Types>
+inline int formatln(SinkT&& sink, const FormatPlan<N>& plan, const Types&... args)
+{
+	FormatExData data;
+	data.sinkFlags = ESinkFlags::Newline;
+	return formatEx(sink, data, plan, args...);
+}
+
 }
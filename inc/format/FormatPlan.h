@@ -0,0 +1,359 @@
+#ifndef INCLUDED_FORMAT_FORMAT_PLAN_H
+#define INCLUDED_FORMAT_FORMAT_PLAN_H
+#include "format/FormatConfig.h"
+#include "format/FormatMemoryFwd.h"
+#include "format/Exception.h"
+#include <climits>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace format
+{
+class Locale;
+
+/** \addtogroup Formatting
+@{
+*/
+
+//! A single part of a split format string.
+struct PlanEntry
+{
+	enum class EKind
+	{
+		Text,
+		Placeholder
+	};
+
+	EKind kind = EKind::Text;
+	//! Text: The first character, Placeholder: The character after the opening brace.
+	int offset = 0;
+	//! The number of characters of a text.
+	int size = 0;
+	//! The argument used by a placeholder.
+	int argId = 0;
+	//! The type of a placeholder, the part after the exclamation mark.
+	int typeOffset = 0;
+	int typeSize = 0;
+	//! The format of a placeholder, the part after the colon.
+	int formatOffset = 0;
+	int formatSize = 0;
+};
+
+//! Untyped access to a format plan.
+struct PlanView
+{
+	const char* str;
+	int size;
+	const PlanEntry* entries;
+	int entryCount;
+	bool isDirect; //!< All placeholders are plain {} or {n}.
+	bool needsParsing; //!< The string contains function placeholders and must be parsed while formatting.
+};
+
+//! A format string validated and split while compiling.
+/**
+Formatting with a plan skips parsing the format string, and placeholders
+without type or format are written directly into the output, if the sink
+and the arguments allow it.
+Plans must be created in a constant expression for the validation to happen
+while compiling, syntax errors are then reported as compile errors:
+\code
+static constexpr auto LIGHT_NAME = format::MakePlan("light{}");
+format::format(name, LIGHT_NAME, id);
+\endcode
+Strings containing function placeholders are stored as they are, and parsed
+normally while formatting.
+*/
+template <int N>
+class FormatPlan
+{
+public:
+	constexpr explicit FormatPlan(const char (&str)[N]) :
+		m_Str(str),
+		m_Size(N - 1),
+		m_Entries{},
+		m_EntryCount(0),
+		m_ArgCount(0),
+		m_IsDirect(true),
+		m_NeedsParsing(false)
+	{
+		Parse();
+	}
+
+	//! The number of arguments referenced by the placeholders.
+	/**
+	Arguments used inside placeholder formats are not counted.
+	*/
+	constexpr int GetArgCount() const { return m_ArgCount; }
+
+	//! The number of text and placeholder entries.
+	constexpr int GetEntryCount() const { return m_EntryCount; }
+
+	//! Can the plan be written without a formatting context.
+	constexpr bool IsDirect() const { return m_IsDirect; }
+
+	//! Is the format string parsed while formatting.
+	constexpr bool NeedsParsing() const { return m_NeedsParsing; }
+
+	PlanView GetView() const
+	{
+		return PlanView{m_Str, m_Size, m_Entries, m_EntryCount, m_IsDirect, m_NeedsParsing};
+	}
+
+private:
+	// The parser must match internal::format exactly.
+	constexpr void Parse()
+	{
+		int pos = 0;
+		int textStart = 0;
+		int nextArg = 0;
+		while(pos < m_Size) {
+			if(m_Str[pos] != '{') {
+				++pos;
+				continue;
+			}
+			AddText(textStart, pos);
+			++pos;
+
+			// Double brace escape, the second brace starts the next text.
+			if(pos < m_Size && m_Str[pos] == '{') {
+				textStart = pos;
+				++pos;
+				continue;
+			}
+
+			if(!ParsePlaceholder(pos, nextArg)) {
+				m_NeedsParsing = true;
+				m_IsDirect = false;
+				m_EntryCount = 0;
+				return;
+			}
+			textStart = pos;
+		}
+		AddText(textStart, pos);
+	}
+
+	constexpr bool ParsePlaceholder(int& pos, int& nextArg)
+	{
+		PlanEntry entry;
+		entry.kind = PlanEntry::EKind::Placeholder;
+		entry.offset = pos;
+
+		SkipSpace(pos);
+		if(pos >= m_Size)
+			throw syntax_exception("Missing closing brace for placeholder", pos);
+		int argId = -1;
+		char c = m_Str[pos];
+		if(c >= '0' && c <= '9')
+			argId = ReadInteger(pos);
+		else if(c != '}' && c != ':' && c != '!')
+			return false; // Function placeholder
+		SkipSpace(pos);
+
+		if(pos < m_Size && m_Str[pos] == '!') {
+			entry.typeOffset = ++pos;
+			int braceLevel = 0;
+			while(true) {
+				if(pos >= m_Size)
+					throw syntax_exception("Missing closing brace for placeholder", pos);
+				c = m_Str[pos++];
+				if(c == '{')
+					++braceLevel;
+				if(c == '}')
+					--braceLevel;
+				if(pos >= m_Size || (m_Str[pos] == '}' && braceLevel == 0) || m_Str[pos] == ':')
+					break;
+			}
+			entry.typeSize = pos - entry.typeOffset;
+		}
+
+		if(pos < m_Size && m_Str[pos] == ':') {
+			entry.formatOffset = ++pos;
+			int braceLevel = 0;
+			while(true) {
+				if(pos >= m_Size)
+					throw syntax_exception("Missing closing brace for placeholder", pos);
+				c = m_Str[pos++];
+				if(c == '{')
+					++braceLevel;
+				if(c == '}')
+					--braceLevel;
+				if(pos >= m_Size || (m_Str[pos] == '}' && braceLevel == 0))
+					break;
+			}
+			entry.formatSize = pos - entry.formatOffset;
+		}
+
+		SkipSpace(pos);
+		if(pos >= m_Size || m_Str[pos] != '}')
+			throw syntax_exception("Missing closing brace for placeholder", pos);
+		++pos;
+
+		if(argId >= 0) {
+			entry.argId = argId;
+			nextArg = argId + 1;
+		} else {
+			entry.argId = nextArg++;
+		}
+		if(entry.argId >= m_ArgCount)
+			m_ArgCount = entry.argId + 1;
+		if(entry.typeSize || entry.formatSize)
+			m_IsDirect = false;
+
+		m_Entries[m_EntryCount++] = entry;
+		return true;
+	}
+
+	constexpr void AddText(int start, int end)
+	{
+		if(end == start)
+			return;
+		PlanEntry entry;
+		entry.offset = start;
+		entry.size = end - start;
+		m_Entries[m_EntryCount++] = entry;
+	}
+
+	constexpr void SkipSpace(int& pos) const
+	{
+		while(pos < m_Size && m_Str[pos] == ' ')
+			++pos;
+	}
+
+	constexpr int ReadInteger(int& pos) const
+	{
+		int out = 0;
+		while(pos < m_Size && m_Str[pos] >= '0' && m_Str[pos] <= '9') {
+			int digit = m_Str[pos] - '0';
+			if(out > (INT_MAX - digit) / 10)
+				throw syntax_exception("Integer literal is too big.", pos);
+			out = out * 10 + digit;
+			++pos;
+		}
+		return out;
+	}
+
+private:
+	const char* m_Str;
+	int m_Size;
+	// Each entry uses at least one character.
+	PlanEntry m_Entries[N];
+	int m_EntryCount;
+	int m_ArgCount;
+	bool m_IsDirect;
+	bool m_NeedsParsing;
+};
+
+//! Create a format plan from a string literal.
+/**
+Use in a constant expression, to validate the string while compiling.
+*/
+template <int N>
+constexpr FormatPlan<N> MakePlan(const char (&str)[N])
+{
+	return FormatPlan<N>(str);
+}
+
+namespace internal
+{
+//! An argument which can be written without formatting context.
+struct DirectArg
+{
+	enum class EKind
+	{
+		None, //!< The argument needs a context.
+		Integer,
+		String
+	};
+
+	EKind kind = EKind::None;
+	bool negative = false;
+	unsigned long long magnitude = 0;
+	Slice str;
+
+	static DirectArg Integer(bool negative, unsigned long long magnitude)
+	{
+		DirectArg out;
+		out.kind = EKind::Integer;
+		out.negative = negative;
+		out.magnitude = magnitude;
+		return out;
+	}
+
+	static DirectArg String(int size, const char* data)
+	{
+		DirectArg out;
+		out.kind = EKind::String;
+		out.str = Slice(size, data);
+		return out;
+	}
+};
+
+//! Size of the stack buffer used for direct formatting, longer output uses a context.
+const int DIRECT_BUFFER_SIZE = 256;
+
+//! Write a plan without context.
+/**
+\return The number of written bytes, or -1 if the plan can't be written
+directly, because of the arguments or the size of the buffer.
+*/
+FORMAT_API int FormatDirect(char* buffer, int bufferSize, const PlanView& plan, const DirectArg* args, int argCount, const Locale& locale);
+}
+
+//! Access to the direct formatting path.
+/**
+Specialize this class, to allow types to be written without formatting
+context, when used with plain {} placeholders.
+The output must be the same as the output of fmtPrint with an empty
+placeholder.
+The default implementation always uses the context.
+*/
+template <typename T, typename Enable = void>
+struct direct_arg
+{
+	static internal::DirectArg Get(const T&) { return internal::DirectArg(); }
+};
+
+/** \cond UNDOCUMENTED */
+template <typename T>
+struct direct_arg<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+{
+	static internal::DirectArg Get(T value)
+	{
+		bool negative = value < T(0);
+		auto magnitude = (unsigned long long)value;
+		return internal::DirectArg::Integer(negative, negative ? 0ull - magnitude : magnitude);
+	}
+};
+
+template <>
+struct direct_arg<const char*>
+{
+	static internal::DirectArg Get(const char* str)
+	{
+		return internal::DirectArg::String(str ? (int)std::strlen(str) : 0, str);
+	}
+};
+
+template <>
+struct direct_arg<char*> : direct_arg<const char*> {};
+
+template <int SIZE>
+struct direct_arg<char[SIZE]> : direct_arg<const char*> {};
+
+template <>
+struct direct_arg<std::string>
+{
+	static internal::DirectArg Get(const std::string& str)
+	{
+		return internal::DirectArg::String((int)str.size(), str.data());
+	}
+};
+/** \endcond */
+
+/** @}*/
+
+}
+
+#endif // #ifndef INCLUDED_FORMAT_FORMAT_PLAN_H
@@ -28,6 +28,24 @@ public:
 	\return The number of characters written
 	*/
 	virtual int Write(Context& ctx, const Context::SlicesT& slices, int flags) = 0;
+
+	//! Write an already formatted string to the sink.
+	/**
+	Used by format plans, which can format simple strings without context.
+	The default implementation creates a context and calls Write, sinks
+	should override it to write the data directly.
+	\param locale The locale used for formatting
+	\param data The string to write
+	\param size The number of bytes in the string
+	\param flags The flags to used while writing
+	\return The number of characters written
+	*/
+	virtual int WriteDirect(const Locale& locale, const char* data, int size, int flags)
+	{
+		Context ctx(locale);
+		ctx.AddSlice(size, data);
+		return Write(ctx, ctx.Slices(), flags);
+	}
 };
 
 //! Wrapper around a sink reference
@@ -45,6 +63,10 @@ public:
 	{
 		return m_Ref.Write(ctx, slices, flags);
 	}
+	virtual int WriteDirect(const Locale& locale, const char* data, int size, int flags)
+	{
+		return m_Ref.WriteDirect(locale, data, size, flags);
+	}
 private:
 	Sink& m_Ref;
 };
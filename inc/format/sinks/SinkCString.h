@@ -36,6 +36,7 @@ public:
 	}
 
 	FORMAT_API int Write(Context& ctx, const Context::SlicesT& slices, int flags) override;
+	FORMAT_API int WriteDirect(const Locale& locale, const char* data, int size, int flags) override;
 
 private:
 	SafeCString m_Str;
@@ -8,6 +8,8 @@
 #include "video/Texture.h"
 #include "video/Renderer.h"
 #include "video/Pass.h"
+#include "video/SpriteBank.h"
+#include "video/VertexTypes.h"
 #include "gui/Font.h"
 
 namespace lux
@@ -48,16 +50,30 @@ public:
 	LUX_API void DrawText(gui::Font* font, const FontRenderSettings& settings, const core::StringView& text, const math::Vector2F& position, const math::RectF* clip);
 
 	LUX_API void DrawRectangle(const math::RectF& rect, video::Color color, const math::RectF* clip = nullptr);
+	//! Draw a textured rectangle
+	/**
+	Consecutive rectangles with the same texture are collected and drawn in a
+	single call, on the next call with another texture or on Flush.
+	*/
 	LUX_API void DrawRectangle(const math::RectF& rect, video::Texture* texture, const math::RectF& tCoord=math::RectF(0,0,1,1), video::Color color=video::Color::White, const math::RectF* clip = nullptr);
+	//! Draw a sprite from a sprite bank
+	/**
+	Sprites on the same atlas page are batched like textured rectangles.
+	*/
+	LUX_API void DrawSprite(const math::RectF& rect, video::SpriteBank* bank, video::SpriteBank::Sprite sprite, float time = 0, video::Color color = video::Color::White, const math::RectF* clip = nullptr);
 	LUX_API void DrawTriangle(const math::Vector2F& a, const math::Vector2F& b, const math::Vector2F& c, video::Color color, const math::RectF* clip = nullptr);
 
 	LUX_API void DrawLine(const math::Vector2F& start, const math::Vector2F& end, video::Color color, float thickness = 1.0f, const LineStyle& style = LineStyle::Solid());
+	//! Draw all collected rectangles
 	LUX_API void Flush();
 	LUX_API video::Renderer* GetRenderer() const;
 private:
 	video::Renderer* m_Renderer;
 	video::Pass m_TexturePass;
 	video::Pass m_DiffusePass;
+
+	StrongRef<video::Texture> m_BatchTexture;
+	core::Array<video::Vertex2D> m_Batch;
 };
 
 } // namespace gui
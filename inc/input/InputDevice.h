@@ -98,6 +98,9 @@ public:
 	*/
 	const core::String& GetName() const { return m_Name; }
 
+	//! Get the unique identifier of the device.
+	core::StringView GetGUID() const { return m_Desc->GetGUID(); }
+
 	//! The number of elements on this device
 	/**
 	\param type The event type given by the queried elements.
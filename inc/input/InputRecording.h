@@ -0,0 +1,162 @@
+#ifndef INCLUDED_LUX_INPUT_RECORDING_H
+#define INCLUDED_LUX_INPUT_RECORDING_H
+#include "core/ReferenceCounted.h"
+#include "core/lxArray.h"
+#include "core/Clock.h"
+#include "input/InputDevice.h"
+
+namespace lux
+{
+namespace io
+{
+class File;
+}
+namespace input
+{
+class InputSystem;
+
+//! Records input events and frame times into a binary stream.
+/**
+The recorder listens to the event signal of the input system, so exactly the
+events seen by the application are recorded, each with a timestamp.
+Call NextFrame once per frame with the time passed to the frame, the events
+received since the last call are written together with the frame.
+The devices are written into the stream with their complete description, so
+the recording can be replayed on another machine.
+Recordings are replayed with InputReplay.
+*/
+class InputRecorder : public ReferenceCounted
+{
+public:
+	//! Start recording.
+	/**
+	\param system The recorded input system.
+	\param file The file receiving the stream, must be writable.
+	*/
+	LUX_API InputRecorder(InputSystem* system, io::File* file);
+	LUX_API ~InputRecorder();
+
+	//! Finish the current frame.
+	/**
+	The events of the frame are written to the file.
+	\param secsPassed The time passed to the frame in seconds.
+	*/
+	LUX_API void NextFrame(float secsPassed);
+
+	//! Stop recording and terminate the stream.
+	/**
+	Events received after the last call to NextFrame are written as a final
+	frame, with the time passed since the last frame.
+	Called automatically when the recorder is destroyed.
+	*/
+	LUX_API void Finish();
+
+	//! The number of recorded frames.
+	int GetFrameCount() const { return m_FrameCount; }
+
+	//! Is the recorder still recording.
+	bool IsRecording() const { return !m_Finished; }
+
+private:
+	void OnEvent(const Event& event);
+	int GetDeviceId(InputDevice* device);
+	u32 TakeTimeDelta();
+	void WriteFrame(float secsPassed);
+
+	void WriteU8(u8 value);
+	void WriteVarInt(u32 value);
+	void WriteFloat(float value);
+	void WriteString(core::StringView str);
+
+private:
+	StrongRef<InputSystem> m_System;
+	StrongRef<io::File> m_File;
+
+	core::Array<StrongRef<InputDevice>> m_Devices;
+	core::Array<u8> m_Buffer;
+
+	core::Duration m_LastTime;
+	core::Duration m_LastFrameTime;
+	int m_FrameCount;
+	bool m_Finished;
+};
+
+//! Replays recordings of an InputRecorder.
+/**
+The events of a recording are sent to the input system frame by frame, in
+place of the real devices.
+Recorded keyboards and mice are replayed on the primary keyboard and mouse,
+other devices are matched by GUID.
+To keep the replay exact block the live input of the input system while
+replaying, see InputSystem::SetLiveInputBlocked.
+LuxDevice::RunSimpleFrameLoop does this automatically.
+*/
+class InputReplay : public ReferenceCounted
+{
+public:
+	//! Load a recording.
+	/**
+	The remaining content of the file is read and validated.
+	A recording without end, e.g. if the application crashed while recording,
+	is replayed up to the last complete frame.
+	\param system The input system receiving the events.
+	\param file The file containing the recording.
+	\throws FileFormatException If the file isn't a valid recording.
+	*/
+	LUX_API InputReplay(InputSystem* system, io::File* file);
+	LUX_API ~InputReplay();
+
+	//! Send the events of the next frame to the input system.
+	/**
+	\param [out] secsPassed The recorded time of the frame in seconds.
+	\return False if the recording is finished, no events were sent.
+	*/
+	LUX_API bool NextFrame(float& secsPassed);
+
+	//! The number of frames in the recording.
+	int GetFrameCount() const { return m_FrameCount; }
+
+	//! The number of replayed frames.
+	int GetCurrentFrame() const { return m_CurrentFrame; }
+
+	//! Is the whole recording replayed.
+	bool IsFinished() const { return m_CurrentFrame == m_FrameCount; }
+
+	//! The timestamp of the last replayed event or frame.
+	/**
+	Relative to the start of the recording, i.e. the real time the replayed
+	part took while recording.
+	*/
+	core::Duration GetRecordedTime() const { return m_RecordedTime; }
+
+private:
+	struct DeviceInfo
+	{
+		int buttonCount;
+		int axisCount;
+		int areaCount;
+	};
+
+	class Reader;
+	u8 ReadRecord(Reader& reader, bool dispatch, float& secsPassed);
+	void AddDevice(Reader& reader, bool dispatch);
+	InputDevice* GetDevice(u32 id, EDeviceEventType type, u32 code, bool dispatch);
+
+private:
+	StrongRef<InputSystem> m_System;
+
+	core::Array<u8> m_Data;
+	int m_Cursor;
+
+	core::Array<DeviceInfo> m_DeviceInfos;
+	core::Array<StrongRef<InputDevice>> m_Devices;
+
+	core::Duration m_RecordedTime;
+	int m_FrameCount;
+	int m_CurrentFrame;
+};
+
+} // namespace input
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_INPUT_RECORDING_H
@@ -61,6 +61,26 @@ public:
 	*/
 	LUX_API void Update(Event& event);
 
+	//! Ignore the events sent with Update.
+	/**
+	Used while replaying recorded input, so the real devices can't change the
+	replayed state.
+	Replayed events are sent with SendReplayedEvent.
+	\param blocked Should events sent with Update be ignored.
+	*/
+	LUX_API void SetLiveInputBlocked(bool blocked);
+
+	//! Are the events sent with Update ignored.
+	LUX_API bool IsLiveInputBlocked() const;
+
+	//! Send a replayed input event.
+	/**
+	Like Update, but works while the live input is blocked and ignores the
+	foreground state, the event was already filtered when it was recorded.
+	\param [in] [out] event The event to send.
+	*/
+	LUX_API void SendReplayedEvent(Event& event);
+
 	//! Find the device belonging to a device description.
 	/**
 	\param desc The description of the input device
@@ -74,6 +94,9 @@ public:
 	//! Get the primary mouse
 	LUX_API StrongRef<InputDevice> GetMouse();
 
+private:
+	void DoUpdate(Event& event, bool checkForeground);
+
 private:
 	core::HashMap<core::String, StrongRef<InputDevice>> m_GUIDMap;
 	WeakRef<InputDevice> m_KeyboardDevice;
@@ -83,6 +106,7 @@ private:
 
 	bool m_IsForeground;
 	bool m_ForegroundHandling;
+	bool m_LiveInputBlocked;
 };
 
 } // namespace input
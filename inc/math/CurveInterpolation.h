@@ -91,9 +91,9 @@ int GetUpperBound(const Sample<T>* samples, int count, float x, int hint)
 	const Sample<T>* n;
 	const Sample<T>* i;
 	auto range = core::MakeRange(samples, samples + count);
-	if(hint >= 1 && hint < count && samples[hint-1].x > x && samples[hint].x < x)
+	if(hint >= 1 && hint < count && samples[hint-1].x < x && x <= samples[hint].x)
 		return hint;
-	else if(hint + 1 < count && samples[hint].x > x && samples[hint + 1].x < x)
+	else if(hint >= 0 && hint + 1 < count && samples[hint].x < x && x <= samples[hint + 1].x)
 		return hint+1;
 	Sample<T> dummy;
 	dummy.x = x;
@@ -222,7 +222,7 @@ T CurveInterpolation(
 	int upper, lower;
 	CurveHelper::GetBounds(samples, count, x, lower, upper, upperHint);
 	if(cacheData)
-		*cacheData = (u32)upperHint;
+		*cacheData = (u32)upper;
 	const float xl = samples[lower].x;
 	const T vl = samples[lower].value;
 	const float xu = samples[upper].x;
@@ -249,6 +249,32 @@ If false is returned the box is never visible.
 */
 LUX_API bool IsOrientedBoxMaybeVisible(const ViewFrustum& frustum, const math::AABBoxF& box, const math::Transformation& boxTransform);
 
+//! Computes the axis aligned box enclosing a transformed box.
+/**
+\param box The box in local coordinates.
+\param transform The transformation to apply.
+\return The smallest axis aligned box containing the transformed box.
+*/
+LUX_API AABBoxF TransformAABox(const AABBoxF& box, const Transformation& transform);
+
+//! Tests many axis aligned boxes against a frustum at once.
+/**
+Gives the same result as calling IsAABoxMaybeVisible for each box, but
+tests four boxes at once.
+\param frustum The frustum to test against.
+\param boxes The boxes to test.
+\param count The number of boxes.
+\param outVisible For each box true is written if it's maybe visible.
+\param planeHints Optional, one entry per box. Contains the plane which culled the box
+	the last time, this plane is tested first. Is updated with the new culling planes.
+	Initialize it with 0 if nothing is known about the boxes.
+*/
+LUX_API void AreAABoxesMaybeVisible(
+	const ViewFrustum& frustum,
+	const AABBoxF* boxes, int count,
+	bool* outVisible,
+	u8* planeHints = nullptr);
+
 }
 }
 
@@ -129,22 +129,32 @@ public:
 
 	//! Transforms a array of row vectors with this matrix
 	/**
-	in and out are allowed to be overlapping, with the right alignment
+	in and out are allowed to be the same array.
 	\param in The array to transform
 	\param [out] out The array where the transformend vectors are written
 	\param count The number of vectors in the array
 	*/
-	inline void TransformVectorArray(const Vector3F in[], Vector3F out[], int count) const
-	{
-		for(int i = 0; i < count; ++i, ++in, ++out) {
-			const float x = in->x*m[0][0] + in->y*m[1][0] + in->z*m[2][0] + m[3][0];
-			const float y = in->x*m[0][1] + in->y*m[1][1] + in->z*m[2][1] + m[3][1];
-			const float z = in->x*m[0][2] + in->y*m[1][2] + in->z*m[2][2] + m[3][2];
-			out->x = x;
-			out->y = y;
-			out->z = z;
-		}
-	}
+	void TransformVectorArray(const Vector3F in[], Vector3F out[], int count) const;
+
+	//! Apply only the rotation of this matrix to a array of row vectors
+	/**
+	Does the same as RotateVector for each element.
+	in and out are allowed to be the same array.
+	\param in The array to rotate
+	\param [out] out The array where the rotated vectors are written
+	\param count The number of vectors in the array
+	*/
+	void RotateVectorArray(const Vector3F in[], Vector3F out[], int count) const;
+
+	//! Transforms a array of planes with this matrix
+	/**
+	Does the same as TransformPlane for each element.
+	in and out are allowed to be the same array.
+	\param in The array to transform
+	\param [out] out The array where the transformed planes are written
+	\param count The number of planes in the array
+	*/
+	void TransformPlaneArray(const PlaneF in[], PlaneF out[], int count) const;
 
 	//! Transforms a vector returnig the new w coordinate
 	/**
@@ -602,6 +602,28 @@ Quaternion<T> operator*(T s, const Quaternion<T>& q)
 //! Typedef for quaternion with float precision
 typedef Quaternion<float> QuaternionF;
 
+//! Multiply two arrays of quaternions
+/**
+Computes out[i] = a[i] * b[i].
+out is allowed to be the same array as a or b.
+\param a The first factors
+\param b The second factors
+\param [out] out The array where the products are written
+\param count The number of quaternions in each array
+*/
+LUX_API void MultiplyQuaternionArray(const QuaternionF a[], const QuaternionF b[], QuaternionF out[], int count);
+
+//! Transform a array of vectors with a quaternion
+/**
+Does the same as QuaternionF::Transform for each element.
+in and out are allowed to be the same array.
+\param q The quaternion to transform with
+\param in The array to transform
+\param [out] out The array where the transformed vectors are written
+\param count The number of vectors in the array
+*/
+LUX_API void TransformVectorArray(const QuaternionF& q, const Vector3F in[], Vector3F out[], int count);
+
 template <typename T>
 bool IsEqual(const Quaternion<T>& a, const Quaternion<T>& b, const T tolerance = math::Constants<T>::rounding_error())
 {
@@ -94,6 +94,19 @@ public:
 	virtual void SetAnimatedValue(AnimatedValueHandle handle, const core::VariableAccess& data) = 0;
 	virtual void GetAnimatedValue(AnimatedValueHandle handle, const core::VariableAccess& data) = 0;
 
+	//! Get the storage of an animated value.
+	/**
+	Allows animation controllers to write the value directly, instead of
+	calling SetAnimatedValue for each change.
+	The pointer must stay valid as long as the object lives.
+	\return A pointer to the value, null if the value must be set with SetAnimatedValue.
+	*/
+	virtual void* GetAnimatedValuePointer(AnimatedValueHandle handle)
+	{
+		LUX_UNUSED(handle);
+		return nullptr;
+	}
+
 protected:
 	virtual void InitSharedAnimatedValues() const {}
 	static AnimatedValueHandle AddSharedAnimatedValue(const char* name, core::Type type, int forceId = -1)
@@ -127,6 +140,7 @@ private:
 };
 
 class Animation;
+class AnimationTrack;
 class AnimationController
 {
 public:
@@ -155,20 +169,38 @@ public:
 	LUX_API Animation* GetAnimation();
 	LUX_API AnimatedObject* GetObject();
 
+	//! Tick many controllers at once.
+	/**
+	Has the same effect as calling Tick on each controller.
+	Controllers playing the same animation are evaluated together, one track
+	after another, so the data of each curve is loaded only once.
+	\param controllers The controllers to tick, each controller must appear only once.
+	\param count The number of controllers.
+	\param secsPassed The time passed since the last tick in seconds.
+	*/
+	LUX_API static void TickBatch(AnimationController* const* controllers, int count, float secsPassed);
+
 private:
+	struct TrackState
+	{
+		AnimatedValueHandle handle;
+		void* target; // Null if the value must be set with SetAnimatedValue.
+		u32 token; // The last used segment of the curve.
+	};
+
 	int GetMaxSize() const;
 	bool UpdateTimer(float newTime);
+	bool Advance(float secsPassed);
+	void ApplyTrack(int id, const AnimationTrack* track, const BakedCurve& curve);
 
 private:
 	WeakRef<AnimatedObject> m_Object;
 	StrongRef<Animation> m_Animation;
 
-	core::Array<AnimatedValueHandle> m_HandleCache;
+	core::Array<TrackState> m_TrackStates;
 
 	core::RawMemory m_Buffer;
 
-	u32 m_AnimationToken;
-
 	float m_Time;
 	float m_Speed;
 
@@ -195,6 +227,7 @@ public:
 	core::Type GetType() const { return m_Type; } 
 	const core::String& GetName() const { return m_ValueName; }
 	StrongRef<Curve> GetCurve() { return m_Curve; }
+	const Curve* GetCurve() const { return m_Curve; }
 	float GetStart() const { return m_Curve->GetStart(); }
 	float GetEnd() const { return m_Curve->GetEnd(); }
 
@@ -227,8 +260,28 @@ public:
 
 	LUX_API core::Name GetReferableType() const;
 
+	//! Convert the curves of all tracks for fast evaluation.
+	/**
+	Done automatically on first use, after adding or removing tracks and
+	for each curve which changed since it was baked.
+	*/
+	LUX_API void Bake();
+
+	//! The baked curves, one per track.
+	/**
+	Curves changed since the last call are baked again.
+	Tracks whose curve can't be baked have a componentCount of zero.
+	*/
+	LUX_API const core::Array<BakedCurve>& GetBakedCurves();
+
+private:
+	void BakeTrack(int id);
+
 private:
 	core::Array<StrongRef<AnimationTrack>> m_Tracks;
+	core::Array<BakedCurve> m_BakedCurves;
+	core::Array<u32> m_BakedChangeCounts;
+	bool m_IsBaked = false;
 	float m_Start;
 	float m_End;
 };
@@ -1,6 +1,8 @@
 #ifndef INCLUDED_LUX_SCENE_COMPONENT_H
 #define INCLUDED_LUX_SCENE_COMPONENT_H
 #include "core/Referable.h"
+#include "core/lxMemoryAlloc.h"
+#include "core/lxSlabAllocator.h"
 #include "math/AABBox.h"
 #include "scene/SceneRendererData.h"
 
@@ -51,7 +53,32 @@ public:
 	{
 	}
 
+	//! Components are allocated from slab allocators, one for each size class.
+	/**
+	The allocators are selected by the size of the object in steps of 16 bytes,
+	component types of similar size share an allocator.
+	Components larger than 512 bytes are allocated from the heap.
+	*/
+	LUX_API static void* operator new(size_t size);
+	LUX_API static void* operator new(size_t size, const core::MemoryDebugInfo& info);
+	LUX_API static void operator delete(void* ptr, size_t size);
+	LUX_API static void operator delete(void* ptr, const core::MemoryDebugInfo& info);
+
+	//! Combined occupancy of all component allocators.
+	LUX_API static core::SlabAllocator::Statistics GetPoolStatistics();
+	//! Return unused memory of the component allocators to the heap.
+	/**
+	Called automatically when the last scene is destroyed.
+	*/
+	LUX_API static void ReleasePoolMemory();
+
 	virtual void Render(const SceneRenderData&) {}
+	//! Called once per camera before the component is rendered.
+	/**
+	Called even if the component is culled, it may still cast shadows.
+	Used to select the level of detail.
+	*/
+	virtual void PrepareRender(const SceneRenderCamData& camData) { LUX_UNUSED(camData); }
 	virtual RenderPassSet GetRenderPass() const { return RenderPassSet(); }
 
 	virtual const math::AABBoxF& GetBoundingBox() const { return math::AABBoxF::EMPTY; }
@@ -2,6 +2,7 @@
 #define INCLUDED_LUX_SCENE_ANIMATION_CURVE_H
 #include "core/ReferenceCounted.h"
 #include "math/CurveInterpolation.h"
+#include "math/Vector2.h"
 #include "math/Vector3.h"
 #include "core/VariableAccess.h"
 
@@ -10,6 +11,41 @@ namespace lux
 namespace scene
 {
 
+//! A curve converted for fast evaluation.
+/**
+The values are stored component by component, each component of all samples
+in one array, i.e. component c of sample i is at c*sampleCount+i.
+The tangents for smooth interpolation are computed while baking.
+The result of Evaluate is the same as the one of the original curve.
+*/
+struct BakedCurve
+{
+	//! The number of floats per value, zero if the curve couldn't be baked.
+	int componentCount = 0;
+	math::EInterpolation interpolation = math::EInterpolation::Smooth;
+	math::EEdgeHandling edgeHandling = math::EEdgeHandling::Clamp;
+	core::Array<float> times;
+	core::Array<float> values;
+	//! Same layout as the values, only used for smooth interpolation.
+	core::Array<float> tangents;
+
+	//! Evaluate the curve.
+	/**
+	\param time The time to query.
+	\param [out] out Receives componentCount floats.
+	\param token The index of the last used segment, used to speed up the
+		search for the next time, can be null.
+	*/
+	LUX_API void Evaluate(float time, float* out, u32* token = nullptr) const;
+};
+
+//! The number of floats in values of a type, zero if it can't be baked.
+template <typename T> struct BakedComponentCount { static const int VALUE = 0; };
+template <> struct BakedComponentCount<float> { static const int VALUE = 1; };
+template <> struct BakedComponentCount<math::Vector2F> { static const int VALUE = 2; };
+template <> struct BakedComponentCount<math::Vector3F> { static const int VALUE = 3; };
+template <> struct BakedComponentCount<video::ColorF> { static const int VALUE = 4; };
+
 class Curve : public ReferenceCounted
 {
 public:
@@ -47,6 +83,36 @@ public:
 
 	//! The type of the elements of the curve.
 	virtual core::Type GetType() const = 0;
+
+	//! Convert the curve for fast evaluation.
+	/**
+	\param [out] out The baked curve.
+	\return False if the curve can't be baked, out is unchanged then.
+	*/
+	virtual bool Bake(BakedCurve& out) const
+	{
+		LUX_UNUSED(out);
+		return false;
+	}
+
+	//! Counts the changes of the curve.
+	/**
+	Used to find out if a baked copy of the curve is outdated.
+	*/
+	u32 GetChangeCount() const
+	{
+		return m_ChangeCount;
+	}
+
+protected:
+	//! Must be called by derived classes, when the curve was changed.
+	void OnChange()
+	{
+		++m_ChangeCount;
+	}
+
+private:
+	u32 m_ChangeCount = 0;
 };
 
 class KeyFrameCurve : public Curve
@@ -55,6 +121,7 @@ public:
 	void SetInterpolation(math::EInterpolation interpolation)
 	{
 		m_Interpolation = interpolation;
+		OnChange();
 	}
 	math::EInterpolation GetInterpolation() const
 	{
@@ -63,6 +130,7 @@ public:
 	void SetEdgeHandling(math::EEdgeHandling handling)
 	{
 		m_EdgeHandling = handling;
+		OnChange();
 	}
 	math::EEdgeHandling GetEdgeHandling() const
 	{
@@ -75,11 +143,18 @@ public:
 		Samples<T>().PushBack(math::Sample<T>(x, value));
 	}
 
+	//! Access the samples for changing them.
+	/**
+	Each call counts as a change of the curve, call it again after changing
+	the samples through a reference kept from an earlier call.
+	*/
 	template <typename T>
 	core::Array<math::Sample<T>>& Samples()
 	{
-		if(core::TemplType<T>::Get() == m_Type)
+		if(core::TemplType<T>::Get() == m_Type) {
+			OnChange();
 			return *((core::Array<math::Sample<T>>*)SamplesPointer());
+		}
 		throw core::TypeCastException(m_Type, core::TemplType<T>::Get());
 	}
 
@@ -139,6 +214,35 @@ public:
 			return m_Samples.Back().x;
 	}
 
+	bool Bake(BakedCurve& out) const
+	{
+		const int components = BakedComponentCount<T>::VALUE;
+		if(components == 0)
+			return false;
+
+		const int count = m_Samples.Size();
+		const bool smooth = m_Interpolation == math::EInterpolation::Smooth && count > 1;
+		out.componentCount = components;
+		out.interpolation = m_Interpolation;
+		out.edgeHandling = m_EdgeHandling;
+		out.times.Resize(count);
+		out.values.Resize(count * components);
+		out.tangents.Resize(smooth ? count * components : 0);
+		for(int i = 0; i < count; ++i) {
+			out.times[i] = m_Samples[i].x;
+			auto value = (const float*)&m_Samples[i].value;
+			for(int c = 0; c < components; ++c)
+				out.values[c * count + i] = value[c];
+			if(smooth) {
+				T tangent = math::CurveHelper::GetTangent(m_Samples.Data(), count, i, m_EdgeHandling);
+				auto tangentData = (const float*)&tangent;
+				for(int c = 0; c < components; ++c)
+					out.tangents[c * count + i] = tangentData[c];
+			}
+		}
+		return true;
+	}
+
 protected:
 	void* SamplesPointer()
 	{
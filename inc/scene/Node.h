@@ -2,6 +2,7 @@
 #define INCLUDED_LUX_SCENE_NODE_H
 #include "core/lxName.h"
 #include "core/lxArray.h"
+#include "core/lxSlabAllocator.h"
 
 #include "math/Transformation.h"
 #include "scene/Component.h"
@@ -19,6 +20,7 @@ class Scene;
 class Node : public core::Referable
 {
 	friend class Component;
+	friend class Scene;
 private:
 	typedef core::Array<StrongRef<Component>> SceneNodeComponentList;
 
@@ -64,6 +66,22 @@ public:
 	LUX_API Node(Scene* scene);
 	LUX_API ~Node();
 
+	//! Nodes are allocated from a slab allocator shared by all scenes.
+	LUX_API static void* operator new(size_t size);
+	LUX_API static void* operator new(size_t size, const core::SlabHint& hint);
+	LUX_API static void* operator new(size_t size, const core::MemoryDebugInfo& info);
+	LUX_API static void operator delete(void* ptr, size_t size);
+	LUX_API static void operator delete(void* ptr, const core::SlabHint& hint);
+	LUX_API static void operator delete(void* ptr, const core::MemoryDebugInfo& info);
+
+	//! Occupancy of the node allocator.
+	LUX_API static core::SlabAllocator::Statistics GetPoolStatistics();
+	//! Return unused memory of the node allocator to the heap.
+	/**
+	Called automatically when the last scene is destroyed.
+	*/
+	LUX_API static void ReleasePoolMemory();
+
 	LUX_API void Animate(float time);
 
 	////////////////////////////////////////////////////////////////////////////////
@@ -458,6 +476,18 @@ public:
 	box is updated automatically.
 	*/
 	LUX_API void RecalculateBoundingBox();
+	//! Called by components whose bounding box changed.
+	/**
+	Recalculates the bounding box, unless it was set by the user.
+	*/
+	LUX_API void OnComponentBoundingBoxChanged();
+
+	//! The bounding box in world coordinates.
+	/**
+	Encloses the bounding box transformed by the absolute transformation.
+	It's cached and only recomputed if one of both changes.
+	*/
+	LUX_API const math::AABBoxF& GetWorldBoundingBox();
 
 	////////////////////////////////////////////////////////////////////////////////
 
@@ -519,17 +549,21 @@ private:
 	StrongRef<Collider> m_Collider;
 
 	math::AABBoxF m_BoundingBox;
+	math::AABBoxF m_WorldBoundingBox;
+
+	//! Position of the node in the transform order of the scene, see Scene::UpdateTransforms.
+	int m_TransformIndex;
 
-	// TODO: Merge all this into a single flag
-	bool m_IsVisible;
-	bool m_IsTrulyVisible;
+	bool m_IsVisible : 1;
+	bool m_IsTrulyVisible : 1;
 	//! Is the current bounding box set by the user.
-	bool m_HasUserBoundingBox;
-	bool m_CastShadow;
-	bool m_InheritTranslation;
-	bool m_InheritRotation;
-	bool m_InheritScale;
-	bool m_IsTransformDirty;
+	bool m_HasUserBoundingBox : 1;
+	bool m_CastShadow : 1;
+	bool m_InheritTranslation : 1;
+	bool m_InheritRotation : 1;
+	bool m_InheritScale : 1;
+	bool m_IsTransformDirty : 1;
+	bool m_IsWorldBoxDirty : 1;
 };
 
 } // namespace scene
@@ -30,9 +30,20 @@ public:
 	bool renderWireframe = false;
 };
 
+//! Occupancy of the node and component allocators
+/**
+The allocators are shared between all scenes.
+*/
+struct ScenePoolStatistics
+{
+	core::SlabAllocator::Statistics nodes;
+	core::SlabAllocator::Statistics components;
+};
+
 class InternalRenderData;
 class Scene : public ReferenceCounted, core::Uncopyable
 {
+	friend class Node;
 public:
 	LUX_API Scene();
 	LUX_API ~Scene();
@@ -60,6 +71,18 @@ public:
 
 	LUX_API void AnimateAll(float secsPassed);
 
+	//! Update the absolute transformation of all changed nodes.
+	/**
+	The nodes are visited in a flat parent-before-child order, so each
+	transformation is computed exactly once from the already updated
+	parent.
+	Is called automatically by AnimateAll and DrawScene.
+	*/
+	LUX_API void UpdateTransforms();
+
+	//! Statistics about the memory used by nodes and components.
+	LUX_API ScenePoolStatistics GetPoolStatistics() const;
+
 	//! Visit all components.
 	/*
 	Visits the components in top-down order.
@@ -87,6 +110,16 @@ public:
 	inline void SetDebugSettings(const SceneDebugSettings& settings);
 	inline const SceneDebugSettings& GetDebugSettings();
 
+private:
+	void OnHierarchyChange()
+	{
+		m_IsTransformOrderDirty = true;
+		m_HasDirtyTransforms = true;
+	}
+	bool SetSubtreeTransformDirty(Node* node);
+	void AppendTransformOrder(Node* node, int parent);
+	InternalRenderData* GetRenderData();
+
 private:
 	StrongRef<Node> m_Root; //!< The root of the scenegraph
 
@@ -94,10 +127,21 @@ private:
 	core::Array<StrongRef<Component>> m_CompDeletionQueue; //!< Nodes to delete on next deletion run
 	
 	// TODO: Use better datastructure for this.
-	core::HashSet<Component*> m_AnimatedComps; //!< The animated nodes of the graph
+	core::FlatHashSet<Component*> m_AnimatedComps; //!< The animated nodes of the graph
 
 	core::AttributeList m_Attributes;
 
+	struct TransformEntry
+	{
+		Node* node;
+		int parent; //!< Index of the parent entry, -1 for the root
+		int end; //!< One past the last entry in the subtree of this node
+	};
+	//! All nodes of the scene in depth-first order, i.e. each subtree is a continuous range.
+	core::Array<TransformEntry> m_TransformOrder;
+	bool m_IsTransformOrderDirty = true;
+	bool m_HasDirtyTransforms = true;
+
 	SceneDebugSettings m_DebugSettings;
 
 	std::unique_ptr<InternalRenderData> renderData;
@@ -32,6 +32,8 @@ class SceneRenderCamData
 public:
 	math::Transformation transform;
 	math::ViewFrustum frustum;
+	//! Projected size of one unit at distance one, relative to half the screen height.
+	float projScale = 1.0f;
 };
 
 class SceneRenderData
@@ -9,6 +9,7 @@ namespace lux
 namespace video
 {
 class Mesh;
+class Geometry;
 }
 namespace scene
 {
@@ -18,7 +19,7 @@ class Mesh : public Component
 {
 	LX_REFERABLE_MEMBERS_API(Mesh, LUX_API);
 
-private:
+protected:
 	LUX_API Mesh();
 	LUX_API Mesh(const Mesh& other);
 public:
@@ -50,9 +51,23 @@ public:
 	*/
 	LUX_API bool GetReadMaterialsOnly() const;
 
+	LUX_API void PrepareRender(const SceneRenderCamData& camData) override;
 	LUX_API void Render(const SceneRenderData& data) override;
 	LUX_API RenderPassSet GetRenderPass() const override;
 
+	//! Set the bias of the level of detail selection.
+	/**
+	The projected size of the mesh is multiplied by the bias before the level
+	is selected, larger values keep the detailed levels longer.
+	The levels are created with video::GenerateLODs.
+	\param bias The bias, the default is 1.
+	*/
+	LUX_API void SetLODBias(float bias);
+	LUX_API float GetLODBias() const;
+
+	//! The currently drawn level of detail, 0 is the original mesh.
+	int GetLODLevel() const { return m_LODLevel; }
+
 	LUX_API video::Material* GetMaterial(int index);
 	LUX_API const video::Material* GetMaterial(int index) const;
 	LUX_API void SetMaterial(int index, video::Material* m);
@@ -61,6 +76,10 @@ public:
 
 	LUX_API const math::AABBoxF& GetBoundingBox() const override;
 
+protected:
+	//! The geometry drawn by Render, by default the one of the mesh.
+	LUX_API virtual video::Geometry* GetRenderGeometry();
+
 private:
 	void CopyMaterials();
 
@@ -71,6 +90,9 @@ protected:
 	core::Array<StrongRef<video::Material>> m_Materials;
 
 	math::AABBoxF m_BoundingBox;
+
+	int m_LODLevel;
+	float m_LODBias;
 };
 
 } // namespace scene
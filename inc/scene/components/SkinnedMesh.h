@@ -0,0 +1,161 @@
+#ifndef INCLUDED_LUX_SCENE_SKINNED_MESH_H
+#define INCLUDED_LUX_SCENE_SKINNED_MESH_H
+#include "scene/components/SceneMesh.h"
+#include "video/mesh/Skeleton.h"
+#include <future>
+
+namespace lux
+{
+namespace video
+{
+class Geometry;
+}
+namespace scene
+{
+
+//! A mesh deformed by an animated skeleton.
+/**
+The vertices are skinned on the cpu into a dynamic vertexbuffer owned by the
+component, the index buffer is shared with the mesh.
+The mesh must carry a skeleton and bone weights, like skinned meshes loaded
+from .x files, see video::GetSkinningData.
+The pose is updated lazily before rendering, use UpdateSkinnedMeshes to update
+many meshes in parallel instead.
+The bounding box follows the pose, it encloses the vertices of each bone
+transformed with the bone. The box of the node is updated when the component
+is animated.
+*/
+class SkinnedMesh : public Mesh
+{
+	LX_REFERABLE_MEMBERS_API(SkinnedMesh, LUX_API);
+
+private:
+	LUX_API SkinnedMesh();
+	LUX_API SkinnedMesh(const SkinnedMesh& other);
+
+public:
+	//! Create a skinned instance of a mesh.
+	/**
+	\throws GenericInvalidArgumentException If the mesh isn't skinned.
+	*/
+	LUX_API SkinnedMesh(video::Mesh* mesh);
+	LUX_API ~SkinnedMesh();
+
+	//! Set a new model
+	/**
+	Null clears the mesh, nothing is drawn until a new one is set.
+	\throws GenericInvalidArgumentException If the mesh isn't skinned.
+	*/
+	LUX_API void SetMesh(video::Mesh* mesh);
+
+	//! Set the played animation, null to show the bind pose.
+	LUX_API void SetClip(video::SkeletalClip* clip);
+	LUX_API StrongRef<video::SkeletalClip> GetClip() const;
+
+	//! Set the current time in the clip in seconds.
+	LUX_API void SetTime(float time);
+	LUX_API float GetTime() const;
+
+	//! Set the playback speed, 1 is normal speed.
+	LUX_API void SetSpeed(float speed);
+	LUX_API float GetSpeed() const;
+
+	//! Should the clip loop, otherwise the last frame is held.
+	LUX_API void SetLooping(bool loop);
+	LUX_API bool GetLooping() const;
+
+	LUX_API void Animate(float secsPassed) override;
+	//! The levels of detail don't use the skinned vertices, skinned meshes are always fully detailed.
+	void PrepareRender(const SceneRenderCamData&) override {}
+	LUX_API void Render(const SceneRenderData& data) override;
+	LUX_API RenderPassSet GetRenderPass() const override;
+
+	//! Sample the clip and skin the vertices.
+	/**
+	Only touches data owned by this component, so different components can be
+	updated in parallel.
+	The new vertices are sent to the driver on the next render.
+	*/
+	LUX_API void UpdatePose();
+
+	//! Does the pose change since the last update.
+	bool IsPoseDirty() const { return m_PoseDirty; }
+
+protected:
+	LUX_API video::Geometry* GetRenderGeometry() override;
+
+private:
+	void InitSkinning();
+	void UpdateMatrices();
+	void UpdateNodeBoundingBox();
+
+private:
+	//! The bind pose box of the vertices influenced by a bone.
+	struct BoneBox
+	{
+		int bone;
+		math::AABBoxF box;
+	};
+
+
+	StrongRef<video::MeshExDataSkinning> m_Skinning;
+	StrongRef<video::SkeletalClip> m_Clip;
+	StrongRef<video::Geometry> m_Geometry;
+	int m_PositionOffset;
+	int m_NormalOffset;
+
+	core::Array<math::Matrix4> m_LocalPose;
+	core::Array<math::Matrix4> m_WorldPose;
+	core::Array<math::Matrix4> m_SkinMatrices;
+	core::Array<BoneBox> m_BoneBoxes;
+
+	float m_Time;
+	float m_Speed;
+	bool m_Loop;
+	bool m_PoseDirty;
+	bool m_MatricesDirty;
+	bool m_BoxChanged;
+};
+
+//! Update the poses of many skinned meshes on a thread pool
+/**
+The meshes are split into one part per thread, and the calling thread blocks
+until all poses are updated.
+Only meshes with a dirty pose are updated.
+\param meshes The meshes to update, each mesh must appear only once.
+\param count The number of meshes.
+\param pool A thread pool, i.e. core::ThreadPool, with a Push method taking a
+	void function and returning a std::future.
+*/
+template <typename PoolT>
+void UpdateSkinnedMeshes(SkinnedMesh* const* meshes, int count, PoolT& pool)
+{
+	const int MAX_PARTS = 64;
+	int parts = math::Min(math::Min(pool.GetThreadCount(), MAX_PARTS), count);
+	if(parts <= 1) {
+		for(int i = 0; i < count; ++i) {
+			if(meshes[i]->IsPoseDirty())
+				meshes[i]->UpdatePose();
+		}
+		return;
+	}
+
+	std::future<void> futures[MAX_PARTS];
+	for(int p = 0; p < parts; ++p) {
+		int begin = int((long long)count * p / parts);
+		int end = int((long long)count * (p + 1) / parts);
+		futures[p] = pool.Push([=]() {
+			for(int i = begin; i < end; ++i) {
+				if(meshes[i]->IsPoseDirty())
+					meshes[i]->UpdatePose();
+			}
+		});
+	}
+	for(int p = 0; p < parts; ++p)
+		futures[p].get();
+}
+
+} // namespace scene
+} // namespace lux
+
+#endif
@@ -82,7 +82,7 @@ private:
 	core::Pool<Particle> m_Pool;
 	core::Array<float> m_Data;
 
-	core::Array<EmitData> m_EmitData;
+	core::SmallArray<EmitData, 8> m_EmitData;
 	core::Array<CreationData> m_CreationData;
 
 	core::Array<math::Transformation> m_EmitTransform;
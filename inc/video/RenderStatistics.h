@@ -48,18 +48,25 @@ public:
 	LUX_API RenderStatistics();
 	LUX_API ~RenderStatistics();
 	LUX_API void AddPrimitives(u32 count);
+	//! Count bytes of transient geometry copied to the device.
+	LUX_API void AddStreamedBytes(u32 bytes);
 	LUX_API void BeginFrame();
 	LUX_API void EndFrame();
 	LUX_API u32 GetPrimitivesDrawn() const;
+	//! The number of bytes streamed to the device in the last frame.
+	LUX_API u32 GetStreamedBytes() const;
 	LUX_API float GetDuration() const;
 	LUX_API void PushGroup(core::StringView name);
 	LUX_API void PopGroup();
 	LUX_API const Group& GetGroup(core::StringView name) const;
 
 private:
-	core::HashMap<core::String, Group> m_Groups;
+	core::FlatHashMap<core::String, Group> m_Groups;
 	core::Array<Group*> m_GroupStack;
 
+	u32 m_StreamedBytesCounter = 0;
+	u32 m_StreamedBytes = 0;
+
 	core::Duration m_Duration;
 	core::Duration m_FrameStart;
 };
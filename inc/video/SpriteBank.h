@@ -3,6 +3,7 @@
 #include "core/ReferenceCounted.h"
 #include "math/Rect.h"
 #include "core/lxArray.h"
+#include "video/images/TextureAtlas.h"
 
 namespace lux
 {
@@ -109,6 +110,18 @@ public:
 	*/
 	LUX_API Sprite AddAnimatedSprite(Sprite first, Sprite last, float time, bool loop);
 
+	//! Pack images into atlas textures and add them as new sprites
+	/**
+	Sprites on the same atlas page share a texture and can be drawn in a single batch.
+	\param images The images of the sprites
+	\param count The number of images
+	\param [out] outSprites Receives a handle for each image
+	\param settings The settings of the atlas pages
+	*/
+	LUX_API void AddAtlasSprites(
+		Image* const* images, int count, Sprite* outSprites,
+		const TextureAtlasSettings& settings = TextureAtlasSettings());
+
 	//! Delete all sprites from the bank
 	LUX_API void Clear();
 
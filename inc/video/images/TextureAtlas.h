@@ -0,0 +1,130 @@
+#ifndef INCLUDED_LUX_TEXTURE_ATLAS_H
+#define INCLUDED_LUX_TEXTURE_ATLAS_H
+#include "core/ReferenceCounted.h"
+#include "core/lxArray.h"
+#include "math/Rect.h"
+#include "math/Dimension2.h"
+#include "math/Vector2.h"
+#include "video/images/Image.h"
+
+namespace lux
+{
+namespace video
+{
+
+//! Settings for packing sprites into atlas pages
+struct TextureAtlasSettings
+{
+	//! The size of each page in pixel
+	math::Dimension2I pageSize = math::Dimension2I(1024, 1024);
+
+	//! Pixels around each sprite, filled with the edge pixels of the sprite
+	/**
+	Keeps bilinear filtering and the first mip levels from blending neighbouring sprites.
+	*/
+	int gutter = 2;
+
+	//! Empty pixels between the gutters of neighbouring sprites
+	int padding = 0;
+
+	//! The cells of the sprites, including the gutter, start at multiples of this value
+	/**
+	With a power of two the sprites stay on the same texel grid in the smaller mip levels.
+	*/
+	int alignment = 4;
+};
+
+//! The place of a single sprite in an atlas
+struct TextureAtlasEntry
+{
+	//! The page containing the sprite
+	int page;
+	//! The pixels of the sprite, without the gutter
+	math::RectI rect;
+};
+
+//! Packs rectangles into atlas pages
+/**
+Uses the skyline bottom-left heuristic, each page keeps the upper outline of the
+placed rectangles and new rectangles are put at the lowest position on it.
+New pages are added when a rectangle doesn't fit into any existing page.
+*/
+class TextureAtlasPacker
+{
+public:
+	LUX_API TextureAtlasPacker(const TextureAtlasSettings& settings = TextureAtlasSettings());
+
+	//! Pack rectangles into the pages
+	/**
+	The rectangles are placed from largest to smallest, which gives a much better
+	fill rate than the input order.
+	Can be called multiple times, the pages are filled further.
+	\param sizes The size of each rectangle in pixel, without gutter.
+	\param count The number of rectangles.
+	\param [out] out Receives the place of each rectangle.
+	*/
+	LUX_API void Pack(const math::Dimension2I* sizes, int count, TextureAtlasEntry* out);
+
+	//! The number of used pages
+	LUX_API int GetPageCount() const;
+
+	LUX_API const TextureAtlasSettings& GetSettings() const;
+
+	//! Remove all pages
+	LUX_API void Clear();
+
+private:
+	struct SkylineNode
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	struct Page
+	{
+		core::Array<SkylineNode> skyline;
+	};
+
+	bool FindPosition(const Page& page, int width, int height, int cellWidth, int& outNode, int& outY) const;
+	void Place(Page& page, int node, int y, int width, int height);
+	int Align(int value) const;
+
+private:
+	TextureAtlasSettings m_Settings;
+	core::Array<Page> m_Pages;
+};
+
+//! Fill the gutter around a sprite with its edge pixels
+/**
+\param data The pixels of the atlas page.
+\param pitch The size of a row of the page in bytes.
+\param pageSize The size of the page in pixel.
+\param bytesPerPixel The size of a pixel in bytes.
+\param rect The pixels of the sprite, without gutter.
+\param gutter The width of the gutter, clipped to the page.
+*/
+LUX_API void FillAtlasGutter(
+	u8* data, int pitch, const math::Dimension2I& pageSize, int bytesPerPixel,
+	const math::RectI& rect, int gutter);
+
+//! Pack images into new atlas pages
+/**
+Can be used to build atlases offline, the pages can be written with the image system.
+All images are converted to the format of the first one.
+\param images The images to pack.
+\param count The number of images.
+\param settings The settings for the pages.
+\param [out] outPages Receives the new pages.
+\param [out] outEntries Receives the place of each image.
+*/
+LUX_API void BuildTextureAtlas(
+	Image* const* images, int count,
+	const TextureAtlasSettings& settings,
+	core::Array<StrongRef<Image>>& outPages,
+	TextureAtlasEntry* outEntries);
+
+} // namespace video
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_TEXTURE_ATLAS_H
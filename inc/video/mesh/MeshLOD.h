@@ -0,0 +1,63 @@
+#ifndef INCLUDED_LUX_MESH_LOD_H
+#define INCLUDED_LUX_MESH_LOD_H
+#include "video/mesh/VideoMesh.h"
+#include "video/mesh/Geometry.h"
+
+namespace lux
+{
+namespace video
+{
+
+//! A simplified version of a mesh.
+struct MeshLODLevel
+{
+	//! Geometry with the simplified indices, shares the vertices of the mesh.
+	StrongRef<Geometry> geometry;
+	//! The first primitive of each material range of the mesh.
+	core::Array<int> firstPrimitives;
+	//! The last primitive of each material range, smaller than the first one for empty ranges.
+	core::Array<int> lastPrimitives;
+	//! The largest distance to the original surface, relative to the radius of the mesh.
+	float error = 0;
+	//! Use this level when the projected radius of the mesh is smaller, relative to half the screen height.
+	float screenSize = 0;
+};
+
+//! The levels of detail of a mesh.
+/**
+Level 0 is the mesh itself, so levels[0] is the first simplified level.
+*/
+class MeshExDataLOD : public MeshExData
+{
+public:
+	//! The simplified levels, ordered from fine to coarse.
+	core::Array<MeshLODLevel> levels;
+};
+
+//! Create levels of detail for a mesh.
+/**
+Each level is simplified from the original triangles, each material range on
+its own, so all levels can be drawn with the materials of the mesh.
+Vertices used by more than one material range are never moved.
+The levels are added to the mesh, an existing set of levels is replaced.
+Only triangle lists with 32 bit float positions are supported.
+\param mesh The mesh to simplify.
+\param levelCount The largest number of levels to create, fewer are created
+	when the mesh can't be simplified further.
+\param reduction Each level keeps this fraction of the triangles of the level before.
+\param maxError The largest allowed error of a level, relative to the radius of the mesh.
+\param errorTolerance The largest error visible on the screen, relative to half the screen height,
+	used to compute the screen size of each level.
+\return The created levels, null if the mesh wasn't simplified.
+*/
+LUX_API StrongRef<MeshExDataLOD> GenerateLODs(
+	Mesh* mesh,
+	int levelCount = 3,
+	float reduction = 0.5f,
+	float maxError = 0.05f,
+	float errorTolerance = 0.002f);
+
+} // namespace video
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_MESH_LOD_H
@@ -2,6 +2,7 @@
 #define INCLUDED_LUX_MESH_MANIPULATOR_H
 #include "video/mesh/VideoMesh.h"
 #include "video/mesh/Geometry.h"
+#include "video/mesh/MeshOptimizer.h"
 #include "video/VertexBuffer.h"
 #include "video/IndexBuffer.h"
 #include "video/Color.h"
@@ -374,6 +375,131 @@ public:
 	}
 };
 
+//! Optimizes triangle geometry for rendering.
+/**
+Merges vertices with the same data, reorders the triangles for the
+post-transform vertex cache and to reduce overdraw, and then stores the
+vertices in the order they are used.
+Only triangle lists with 32 bit float positions are changed.
+For meshes each material range is optimized on its own, so the ranges stay valid.
+Use AnalyzeVertexCache to measure the result.
+*/
+class MeshManipulatorOptimize : public MeshManipulator
+{
+public:
+	//! Constructor
+	/**
+	\param weld Merge vertices with exactly the same data.
+	\param overdrawThreshold See OptimizeOverdraw, 0 to skip the overdraw optimization.
+	*/
+	MeshManipulatorOptimize(bool weld = true, float overdrawThreshold = 1.05f) :
+		m_Weld(weld),
+		m_OverdrawThreshold(overdrawThreshold)
+	{
+	}
+
+	Mesh* operator()(Mesh* mesh)
+	{
+		core::Array<int> rangeBegins;
+		for(int i = 0; i < mesh->GetRangeCount(); ++i) {
+			int material, first, last;
+			mesh->GetMaterialRange(i, material, first, last);
+			rangeBegins.PushBack(first);
+		}
+		Optimize(mesh->GetGeometry(), rangeBegins);
+		mesh->RecalculateBoundingBox();
+		return mesh;
+	}
+
+	Geometry* operator()(Geometry* geo)
+	{
+		core::Array<int> rangeBegins;
+		rangeBegins.PushBack(0);
+		Optimize(geo, rangeBegins);
+		return geo;
+	}
+
+private:
+	void Optimize(Geometry* geo, const core::Array<int>& rangeBegins)
+	{
+		if(!geo || geo->GetPrimitiveType() != EPrimitiveType::Triangles)
+			return;
+		auto ib = geo->GetIndices();
+		auto vb = geo->GetVertices();
+		if(!ib || !vb)
+			return;
+		auto posElem = vb->GetFormat().GetElement(VertexElement::EUsage::Position);
+		if(!posElem.IsValid() || posElem.GetType() != VertexElement::EType::Float3)
+			return;
+
+		const int indexCount = geo->GetPrimitiveCount() * 3;
+		const int stride = vb->GetStride();
+		int vertexCount = vb->GetSize();
+		core::Array<u32> indices;
+		indices.Resize(indexCount);
+		for(int i = 0; i < indexCount; ++i)
+			indices[i] = (u32)ib->GetIndex(i);
+
+		core::RawMemory vertices(vertexCount * stride);
+		std::memcpy(vertices.Pointer(), vb->Pointer_c(), vertexCount * stride);
+		core::Array<u32> remap;
+		remap.Resize(vertexCount);
+		if(m_Weld) {
+			int unique = WeldVertices(remap.Data(), vertices.Pointer(), vertexCount, stride);
+			if(unique < vertexCount) {
+				core::RawMemory welded(unique * stride);
+				RemapVertices(welded.Pointer(), vertices.Pointer(), vertexCount, stride, remap.Data());
+				RemapIndices(indices.Data(), indexCount, remap.Data());
+				vertices = std::move(welded);
+				vertexCount = unique;
+			}
+		}
+
+		core::Array<math::Vector3F> positions;
+		positions.Resize(vertexCount);
+		const u8* posData = (const u8*)vertices.Pointer() + posElem.GetOffset();
+		for(int i = 0; i < vertexCount; ++i)
+			std::memcpy(&positions[i], posData + i * stride, sizeof(math::Vector3F));
+
+		core::Array<u32> temp;
+		temp.Resize(indexCount);
+		for(int r = 0; r < rangeBegins.Size(); ++r) {
+			const int begin = rangeBegins[r] * 3;
+			const int end = r + 1 < rangeBegins.Size() ? rangeBegins[r + 1] * 3 : indexCount;
+			if(end <= begin)
+				continue;
+			OptimizeVertexCache(temp.Data() + begin, indices.Data() + begin, end - begin, vertexCount);
+			if(m_OverdrawThreshold > 0) {
+				OptimizeOverdraw(
+					indices.Data() + begin, temp.Data() + begin, end - begin,
+					positions.Data(), vertexCount,
+					geo->GetFrontFaceWinding(), m_OverdrawThreshold);
+			} else {
+				std::memcpy(indices.Data() + begin, temp.Data() + begin, (end - begin) * sizeof(u32));
+			}
+		}
+
+		const int usedCount = OptimizeVertexFetch(remap.Data(), indices.Data(), indexCount, vertexCount);
+		vb->SetSize(usedCount, false);
+		RemapVertices(vb->Pointer(), vertices.Pointer(), vertexCount, stride, remap.Data());
+		vb->Update();
+
+		auto indexType = EIndexFormat::Bit16;
+		if(usedCount > math::Constants<u16>::max())
+			indexType = EIndexFormat::Bit32;
+		ib->SetFormat(indexType, false);
+		ib->SetSize(indexCount, false);
+		ib->SetIndices32(indices.Data(), indexCount, 0);
+		ib->Update();
+
+		geo->RecalculateBoundingBox();
+	}
+
+private:
+	bool m_Weld;
+	float m_OverdrawThreshold;
+};
+
 } // namespace video
 } // namespace lux
 
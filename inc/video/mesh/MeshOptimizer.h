@@ -0,0 +1,128 @@
+#ifndef INCLUDED_LUX_MESH_OPTIMIZER_H
+#define INCLUDED_LUX_MESH_OPTIMIZER_H
+#include "core/LuxBase.h"
+#include "math/Vector3.h"
+#include "video/VideoEnums.h"
+
+namespace lux
+{
+namespace video
+{
+
+//! Result of a simulated post-transform vertex cache.
+struct VertexCacheStatistics
+{
+	//! The number of vertex shader invocations.
+	int vertexTransforms = 0;
+	//! Average cache miss ratio, transformed vertices per triangle, best case is 0.5.
+	float acmr = 0;
+	//! Average transform to vertex ratio, transformed vertices per used vertex, best case is 1.
+	float atvr = 0;
+};
+
+//! Simulate a FIFO post-transform vertex cache on a triangle list.
+/**
+\param indices The indices of the triangle list.
+\param indexCount The number of indices.
+\param vertexCount The number of vertices, all indices must be smaller.
+\param cacheSize The number of vertices in the simulated cache.
+*/
+LUX_API VertexCacheStatistics AnalyzeVertexCache(const u32* indices, int indexCount, int vertexCount, int cacheSize = 16);
+
+//! Reorder triangles for the post-transform vertex cache.
+/**
+Uses the algorithm by Tom Forsyth, "Linear-Speed Vertex Cache Optimisation",
+which doesn't depend on the exact size of the hardware cache.
+\param [out] dst Receives the reordered indices, must not overlap indices.
+\param indices The indices of the triangle list.
+\param indexCount The number of indices.
+\param vertexCount The number of vertices, all indices must be smaller.
+*/
+LUX_API void OptimizeVertexCache(u32* dst, const u32* indices, int indexCount, int vertexCount);
+
+//! Reorder clusters of triangles to reduce overdraw.
+/**
+The triangles are split into clusters, keeping the cache efficiency of the
+input order, then the clusters facing away from the center of the mesh are
+moved to the front, since they are more likely to occlude the others.
+Should run after OptimizeVertexCache.
+\param [out] dst Receives the reordered indices, must not overlap indices.
+\param indices The indices of the triangle list.
+\param indexCount The number of indices.
+\param positions The vertex positions.
+\param vertexCount The number of vertices, all indices must be smaller.
+\param frontFace The winding of the front faces.
+\param threshold How much the vertex cache efficiency may get worse, 1.05
+	allows 5% more transformed vertices. Larger values create smaller clusters.
+*/
+LUX_API void OptimizeOverdraw(
+	u32* dst, const u32* indices, int indexCount,
+	const math::Vector3F* positions, int vertexCount,
+	EFaceWinding frontFace, float threshold = 1.05f);
+
+//! Reorder vertices in the order they are used by the triangles.
+/**
+Improves the locality of vertex fetches, should run after all triangle
+reorderings.
+Vertices not referenced by any index are dropped.
+\param [out] remap Receives the new index of each old vertex, ~0u for unused vertices.
+\param [in,out] indices The indices, they are changed to the new vertex order.
+\param indexCount The number of indices.
+\param vertexCount The number of vertices, all indices must be smaller.
+\return The number of used vertices.
+*/
+LUX_API int OptimizeVertexFetch(u32* remap, u32* indices, int indexCount, int vertexCount);
+
+//! Find vertices with exactly the same data.
+/**
+\param [out] remap Receives the new index of each vertex, all copies of a
+	vertex get the same index, the unique vertices keep their order.
+\param vertices The vertex data.
+\param vertexCount The number of vertices.
+\param stride The size of a vertex in bytes, all bytes are compared.
+\return The number of unique vertices.
+*/
+LUX_API int WeldVertices(u32* remap, const void* vertices, int vertexCount, int stride);
+
+//! Move vertices to new positions.
+/**
+\param [out] dst The new vertex data, must not overlap src.
+\param src The old vertex data.
+\param vertexCount The number of old vertices.
+\param stride The size of a vertex in bytes.
+\param remap The new index of each old vertex, ~0u to drop the vertex.
+*/
+LUX_API void RemapVertices(void* dst, const void* src, int vertexCount, int stride, const u32* remap);
+
+//! Change indices to a new vertex order.
+LUX_API void RemapIndices(u32* indices, int indexCount, const u32* remap);
+
+//! Reduce the number of triangles by collapsing edges.
+/**
+The collapses are chosen by quadric error metrics. Each collapse moves a vertex
+onto one of its neighbours, so no vertices are created and all vertex
+attributes stay valid.
+Vertices on open borders and on attribute seams, i.e. where the same position
+is used by different vertices, aren't moved.
+\param [out] dst Receives the new indices, can be equal to indices.
+\param indices The indices of the triangle list.
+\param indexCount The number of indices.
+\param positions The vertex positions.
+\param vertexCount The number of vertices, all indices must be smaller.
+\param targetIndexCount Stop when there are at most this many indices left.
+\param targetError The largest allowed distance to the original surface, in
+	units of the positions.
+\param locked Optional, one entry per vertex, non-zero to never move the vertex.
+\param [out] resultError Receives the largest distance of a done collapse, can be null.
+\return The new number of indices.
+*/
+LUX_API int SimplifyMesh(
+	u32* dst, const u32* indices, int indexCount,
+	const math::Vector3F* positions, int vertexCount,
+	int targetIndexCount, float targetError,
+	const u8* locked = nullptr, float* resultError = nullptr);
+
+} // namespace video
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_MESH_OPTIMIZER_H
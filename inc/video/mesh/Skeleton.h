@@ -0,0 +1,199 @@
+#ifndef INCLUDED_LUX_SKELETON_H
+#define INCLUDED_LUX_SKELETON_H
+#include "core/ReferenceCounted.h"
+#include "core/lxArray.h"
+#include "core/lxString.h"
+#include "math/Matrix4.h"
+#include "math/Quaternion.h"
+#include "video/mesh/VideoMesh.h"
+
+namespace lux
+{
+namespace video
+{
+
+//! A hierarchy of joints.
+/**
+The joints are stored flat, each joint references its parent by index.
+Parents are always stored before their children, so the absolute transforms
+can be computed with a single pass over the joints, see SolveJointHierarchy.
+*/
+class Skeleton : public ReferenceCounted
+{
+public:
+	//! Add a new joint.
+	/**
+	\param name The name of the joint, can be empty.
+	\param parent The index of the parent joint, -1 for a root joint.
+	\param bindPose The transform of the joint relative to its parent in the bind pose.
+	\return The index of the new joint.
+	\throws ArgumentOutOfRangeException If the parent isn't an existing joint.
+	*/
+	LUX_API int AddJoint(const core::String& name, int parent, const math::Matrix4& bindPose = math::Matrix4::IDENTITY);
+
+	//! Change the relative bind pose of a joint.
+	LUX_API void SetBindPose(int joint, const math::Matrix4& bindPose);
+
+	//! Find a joint by name.
+	/**
+	\return The index of the first joint with this name, -1 if there is none.
+	*/
+	LUX_API int FindJoint(core::StringView name) const;
+
+	int GetJointCount() const { return m_Parents.Size(); }
+	const core::String& GetJointName(int joint) const { return m_Names.At(joint); }
+	int GetParent(int joint) const { return m_Parents.At(joint); }
+	const math::Matrix4& GetBindPose(int joint) const { return m_BindPoses.At(joint); }
+
+	//! The parent indices of all joints.
+	const int* GetParents() const { return m_Parents.Data(); }
+	//! The relative bind poses of all joints.
+	const math::Matrix4* GetBindPoses() const { return m_BindPoses.Data(); }
+
+private:
+	core::Array<core::String> m_Names;
+	core::Array<int> m_Parents;
+	core::Array<math::Matrix4> m_BindPoses;
+};
+
+//! The skeleton a mesh was modeled with.
+/**
+The bones of the MeshExDataBoneTable are matched with the joints by name.
+*/
+class MeshExDataSkeleton : public MeshExData
+{
+public:
+	StrongRef<Skeleton> skeleton;
+};
+
+//! Joint animation sampled at a fixed rate.
+/**
+The keys of all tracks are stored in separate arrays for translation, rotation
+and scale, so sampling touches only the data it needs.
+Because all keys have the same distance, finding the keys around a time is a
+single division.
+*/
+class SkeletalClip : public ReferenceCounted
+{
+public:
+	//! Create an empty clip.
+	/**
+	\param frameRate The number of keys per second.
+	\param frameCount The number of keys per track, at least one.
+	*/
+	LUX_API SkeletalClip(float frameRate, int frameCount);
+
+	//! Add the keys of a joint.
+	/**
+	Each array contains one key per frame.
+	\param joint The index of the animated joint.
+	\param translations The translation keys.
+	\param rotations The rotation keys, should have unit length.
+	\param scales The uniform scale keys, null to use a scale of one.
+	*/
+	LUX_API void AddTrack(int joint, const math::Vector3F* translations, const math::QuaternionF* rotations, const float* scales = nullptr);
+
+	int GetTrackCount() const { return m_Joints.Size(); }
+	float GetFrameRate() const { return m_FrameRate; }
+	int GetFrameCount() const { return m_FrameCount; }
+	//! The time between the first and the last key in seconds.
+	float GetDuration() const { return (m_FrameCount - 1) / m_FrameRate; }
+
+	//! Sample the clip at multiple times at once.
+	/**
+	Writes the relative transforms of all animated joints, other joints keep
+	their value, initialize them with the bind pose.
+	Rotations are interpolated linear and normalized afterwards.
+	\param times The sample times in seconds, one per pose.
+	\param poseCount The number of poses to sample.
+	\param jointCount The number of joints per pose.
+	\param [out] poses The relative joint transforms, pose after pose.
+	\param loop Should times after the end wrap around, otherwise they are clamped.
+	*/
+	LUX_API void Sample(const float* times, int poseCount, int jointCount, math::Matrix4* poses, bool loop = true) const;
+
+private:
+	float m_FrameRate;
+	int m_FrameCount;
+
+	core::Array<int> m_Joints;
+	// Track t uses the keys [t*frameCount, (t+1)*frameCount).
+	core::Array<math::Vector3F> m_Translations;
+	core::Array<math::QuaternionF> m_Rotations;
+	core::Array<float> m_Scales;
+};
+
+//! The bone influences of a single vertex.
+struct SkinVertex
+{
+	float weights[4]; //!< Normalized weights, unused influences have weight zero.
+	u8 bones[4]; //!< Indices into the skinning matrices.
+};
+
+//! Compute the absolute joint transforms.
+/**
+\param parents The parent index of each joint, parents must come before their children.
+\param local The relative joint transforms.
+\param [out] world The absolute joint transforms, must not overlap local.
+\param jointCount The number of joints.
+*/
+LUX_API void SolveJointHierarchy(const int* parents, const math::Matrix4* local, math::Matrix4* world, int jointCount);
+
+//! Transform vertices by a weighted blend of four matrices.
+/**
+The result is written into interleaved vertex data, i.e. directly into a vertexbuffer.
+Normals are rotated and normalized again.
+\param matrices The skinning matrices referenced by the vertices.
+\param positions The bind pose positions.
+\param normals The bind pose normals, can be null.
+\param skin The influences of each vertex.
+\param count The number of vertices.
+\param [out] dst The first output vertex.
+\param stride The distance between two output vertices in bytes.
+\param positionOffset The offset of the position in an output vertex.
+\param normalOffset The offset of the normal in an output vertex, ignored if normals is null.
+*/
+LUX_API void SkinVertices(
+	const math::Matrix4* matrices,
+	const math::Vector3F* positions,
+	const math::Vector3F* normals,
+	const SkinVertex* skin,
+	int count,
+	void* dst, int stride, int positionOffset, int normalOffset);
+
+//! The bind pose data needed to skin a mesh on the cpu.
+/**
+Created once per mesh, and shared by all skinned instances of it.
+The last skinning matrix is reserved for vertices without influences and
+should be the identity.
+*/
+class MeshExDataSkinning : public MeshExData
+{
+public:
+	StrongRef<Skeleton> skeleton;
+	core::Array<int> boneJoints; //!< The joint of each bone, -1 if it has none.
+	core::Array<math::Matrix4> boneOffsets; //!< Transform from bind pose to joint space, per bone.
+
+	core::Array<math::Vector3F> positions;
+	core::Array<math::Vector3F> normals;
+	core::Array<SkinVertex> skin;
+
+	//! The number of skinning matrices needed, one per bone and one identity.
+	int GetMatrixCount() const { return boneOffsets.Size() + 1; }
+
+	//! Compute the skinning matrices from absolute joint transforms.
+	LUX_API void GetSkinningMatrices(const math::Matrix4* world, math::Matrix4* out) const;
+};
+
+//! Get the skinning data of a mesh.
+/**
+The data is created from the bone table and the vertices of the mesh on the
+first call, and then stored with the mesh.
+\return The skinning data, null if the mesh isn't skinned or uses more than 255 bones.
+*/
+LUX_API StrongRef<MeshExDataSkinning> GetSkinningData(Mesh* mesh);
+
+} // namespace video
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_SKELETON_H
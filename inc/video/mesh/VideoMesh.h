@@ -1,6 +1,7 @@
 #ifndef INCLUDED_LUX_MESH_H
 #define INCLUDED_LUX_MESH_H
 #include "math/AABBox.h"
+#include "math/Matrix4.h"
 
 #include "core/Referable.h"
 
@@ -28,6 +29,8 @@ class MeshExDataBoneTable : public MeshExData
 public:
 	int maxSkinWeightPerVertex;
 	core::Array<core::String> boneNames;
+	//! Transform from mesh space to the space of each bone, in the bind pose.
+	core::Array<math::Matrix4> offsetMatrices;
 };
 
 class MeshExDataVertexDuplicationIndizes : public MeshExData
@@ -99,7 +102,7 @@ public:
 		LX_CHECK_NULL_ARG(data);
 
 		if(m_ExData)
-			data->m_NextData = m_ExData->m_NextData;
+			data->m_NextData = m_ExData;
 		m_ExData = data;
 	}
 	void RemoveExData(MeshExData* data)
@@ -109,8 +112,8 @@ public:
 			if(x == data) {
 				if(prev)
 					prev->m_NextData = x->m_NextData;
-				if(data == m_ExData)
-					m_ExData = nullptr;
+				else
+					m_ExData = x->m_NextData;
 				break;
 			}
 			prev = x;
@@ -1,6 +1,8 @@
 #include "LuxDeviceNull.h"
 #include "core/Clock.h"
 #include "core/Logger.h"
+#include "core/lxArena.h"
+#include "core/lxProfiler.h"
 
 #include "core/ReferableFactory.h"
 #include "core/ResourceSystem.h"
@@ -38,6 +40,9 @@
 #include "gui/Window.h"
 #include "gui/Cursor.h"
 
+#include "input/InputSystem.h"
+#include "input/InputRecording.h"
+
 namespace lux
 {
 LuxDeviceNull::LuxDeviceNull()
@@ -282,6 +287,10 @@ private:
 	{
 		video::RenderStatistics::Instance()->EndFrame();
 		video::RenderStatistics::Instance()->BeginFrame();
+		core::FrameScope frameScope;
+#ifdef LUX_ENABLE_PROFILER
+		core::Profiler::NextFrame();
+#endif
 
 		if(m_Scene)
 			m_Scene->AnimateAll(secsPassed);
@@ -378,12 +387,42 @@ private:
 	video::VideoDriver* m_Driver;
 	video::Renderer* m_Renderer;
 };
+
+void RunReplayFrameLoop(LuxDevice* device, DefaultSimpleFrameLoop& defLoop, const LuxDevice::SimpleFrameLoop& frameLoop)
+{
+	// The real devices would change the replayed states.
+	auto inputSys = input::InputSystem::Instance();
+	bool wasBlocked = inputSys->IsLiveInputBlocked();
+	inputSys->SetLiveInputBlocked(true);
+
+	while(device->Run(0)) {
+		// Paused frames don't consume the recording.
+		if(!defLoop.CallPreFrame())
+			continue;
+
+		float secsPassed;
+		if(!frameLoop.replay->NextFrame(secsPassed))
+			break;
+		if(frameLoop.fixedTimeStep > 0)
+			secsPassed = frameLoop.fixedTimeStep;
+		if(frameLoop.recorder)
+			frameLoop.recorder->NextFrame(secsPassed);
+		defLoop.CallDoFrame(secsPassed);
+	}
+
+	inputSys->SetLiveInputBlocked(wasBlocked);
+}
 }
 
 void LuxDeviceNull::RunSimpleFrameLoop(const SimpleFrameLoop& frameLoop)
 {
 	DefaultSimpleFrameLoop defLoop(this, frameLoop);
 
+	if(frameLoop.replay) {
+		RunReplayFrameLoop(this, defLoop, frameLoop);
+		return;
+	}
+
 	core::Duration startTime;
 	core::Duration endTime;
 	core::Duration passedTime;
@@ -397,8 +436,12 @@ void LuxDeviceNull::RunSimpleFrameLoop(const SimpleFrameLoop& frameLoop)
 			continue;
 		}
 
-		if(secsPassed > minSecsPassed)
-			defLoop.CallDoFrame(secsPassed);
+		if(secsPassed > minSecsPassed) {
+			float frameSecs = frameLoop.fixedTimeStep > 0 ? frameLoop.fixedTimeStep : secsPassed;
+			if(frameLoop.recorder)
+				frameLoop.recorder->NextFrame(frameSecs);
+			defLoop.CallDoFrame(frameSecs);
+		}
 
 		endTime = core::Clock::GetTicks();
 		passedTime = (endTime - startTime);
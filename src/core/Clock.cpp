@@ -1,4 +1,5 @@
 #include "core/Clock.h"
+#include "core/lxSort.h"
 #include <chrono>
 #include <thread>
 
@@ -46,13 +47,315 @@ Duration Clock::GetTicks()
 	return Duration(std::chrono::high_resolution_clock::now().time_since_epoch());
 }
 
-TimerManager::~TimerManager()
+//! Hierarchical timing wheel
+/**
+The time is split into ticks of one millisecond.
+The first level has a slot for each of the next 256 ticks, each higher level
+has 64 slots each covering a whole turn of the level below.
+When the first level completes a turn, the next slot of the level above is
+redistributed into the lower levels.
+Timers whose tick was already processed, but whose exact time isn't reached
+yet, wait in the due list.
+*/
+class TimerWheel
 {
-	while(m_FirstTimer) {
-		auto next = m_FirstTimer->next;
-		delete m_FirstTimer;
-		m_FirstTimer = next;
+public:
+	static const Duration::BaseType RESOLUTION = Duration::CountPerMilli;
+	static const int LEVEL0_BITS = 8;
+	static const int LEVEL0_SIZE = 1 << LEVEL0_BITS;
+	static const int LEVEL_BITS = 6;
+	static const int LEVEL_SIZE = 1 << LEVEL_BITS;
+	static const int LEVEL_COUNT = 4;
+	static const u64 MAX_DELTA = (u64(1) << (LEVEL0_BITS + LEVEL_COUNT * LEVEL_BITS)) - 1;
+
+public:
+	~TimerWheel()
+	{
+		for(auto& head : m_Level0)
+			DeleteList(head);
+		for(auto& level : m_Levels) {
+			for(auto& head : level)
+				DeleteList(head);
+		}
+		DeleteList(m_Due);
+		DeleteList(m_Inactive);
+	}
+
+	InternalTimer* Create(const TimerSettings& settings)
+	{
+		auto t = new InternalTimer;
+		t->repeatCount = settings.count;
+		t->period = settings.period;
+		t->remain = settings.start;
+		t->paused = false;
+		t->killed = false;
+		t->level0 = false;
+		t->wheel = this;
+		t->next = nullptr;
+		t->prevNext = nullptr;
+		t->deadline = m_Now + settings.start;
+		Schedule(t);
+		++m_TimerCount;
+		return t;
+	}
+
+	void Kill(InternalTimer* t)
+	{
+		if(!t->killed && !IsFinished(t))
+			--m_TimerCount;
+		if(t->state == InternalTimer::EState::Firing) {
+			// Deleted after the broadcast.
+			t->killed = true;
+			return;
+		}
+		Unlink(t);
+		delete t;
+	}
+
+	void Pause(InternalTimer* t, bool pause)
+	{
+		if(t->paused == pause)
+			return;
+		t->paused = pause;
+		if(t->state == InternalTimer::EState::Firing || IsFinished(t))
+			return;
+		if(pause) {
+			t->remain = GetRemainingTime(t);
+			Unlink(t);
+			Link(m_Inactive, t, InternalTimer::EState::Inactive);
+		} else {
+			Unlink(t);
+			t->deadline = m_Now + t->remain;
+			Schedule(t);
+		}
+	}
+
+	Duration GetRemainingTime(const InternalTimer* t) const
+	{
+		if(t->state == InternalTimer::EState::Inactive || t->state == InternalTimer::EState::Finished)
+			return t->remain;
+		if(t->deadline <= m_Now)
+			return Duration(0);
+		return t->deadline - m_Now;
+	}
+
+	void Tick(Duration passed)
+	{
+		m_Now += passed;
+
+		// Check the timers left over from the last tick.
+		InternalTimer* due = m_Due;
+		if(due)
+			due->prevNext = &due;
+		m_Due = nullptr;
+		CollectExpired(due);
+
+		u64 target = u64(m_Now.Count() / RESOLUTION);
+		while(m_WheelTick <= target) {
+			if(m_ScheduledCount == 0) {
+				// Nothing in the wheel, all slots until now are empty.
+				m_WheelTick = target + 1;
+				break;
+			}
+
+			int index = int(m_WheelTick & (LEVEL0_SIZE - 1));
+			if(index == 0) {
+				for(int level = 0; level < LEVEL_COUNT; ++level) {
+					int levelIndex = int((m_WheelTick >> (LEVEL0_BITS + level * LEVEL_BITS)) & (LEVEL_SIZE - 1));
+					Cascade(m_Levels[level][levelIndex]);
+					if(levelIndex != 0)
+						break;
+				}
+			}
+
+			if(m_Level0Count == 0) {
+				// Skip the empty slots until the next cascade.
+				u64 nextTurn = (m_WheelTick | (LEVEL0_SIZE - 1)) + 1;
+				m_WheelTick = nextTurn < target + 1 ? nextTurn : target + 1;
+				continue;
+			}
+
+			InternalTimer* list = m_Level0[index];
+			if(list)
+				list->prevNext = &list;
+			m_Level0[index] = nullptr;
+			++m_WheelTick;
+			CollectExpired(list);
+		}
+
+		FireExpired();
 	}
+
+	int GetTimerCount() const { return m_TimerCount; }
+
+private:
+	static bool IsFinished(const InternalTimer* t)
+	{
+		return t->state == InternalTimer::EState::Finished;
+	}
+
+	void Link(InternalTimer*& head, InternalTimer* t, InternalTimer::EState state, bool level0 = false)
+	{
+		t->next = head;
+		if(head)
+			head->prevNext = &t->next;
+		head = t;
+		t->prevNext = &head;
+		t->state = state;
+		t->level0 = level0;
+		if(state == InternalTimer::EState::Scheduled)
+			++m_ScheduledCount;
+		if(level0)
+			++m_Level0Count;
+	}
+
+	void Unlink(InternalTimer* t)
+	{
+		if(!t->prevNext)
+			return;
+		*t->prevNext = t->next;
+		if(t->next)
+			t->next->prevNext = t->prevNext;
+		t->next = nullptr;
+		t->prevNext = nullptr;
+		if(t->state == InternalTimer::EState::Scheduled)
+			--m_ScheduledCount;
+		if(t->level0)
+			--m_Level0Count;
+	}
+
+	void Schedule(InternalTimer* t)
+	{
+		u64 tick = u64(t->deadline.Count() / RESOLUTION);
+		if(tick < m_WheelTick) {
+			Link(m_Due, t, InternalTimer::EState::Due);
+			return;
+		}
+
+		u64 delta = tick - m_WheelTick;
+		if(delta < LEVEL0_SIZE) {
+			Link(m_Level0[tick & (LEVEL0_SIZE - 1)], t, InternalTimer::EState::Scheduled, true);
+			return;
+		}
+
+		// Timers too far in the future wait in the last slot and are
+		// redistributed from there.
+		if(delta > MAX_DELTA)
+			tick = m_WheelTick + MAX_DELTA;
+		int level = 0;
+		while(level < LEVEL_COUNT - 1 && delta >= (u64(1) << (LEVEL0_BITS + (level + 1) * LEVEL_BITS)))
+			++level;
+		int index = int((tick >> (LEVEL0_BITS + level * LEVEL_BITS)) & (LEVEL_SIZE - 1));
+		Link(m_Levels[level][index], t, InternalTimer::EState::Scheduled);
+	}
+
+	void Cascade(InternalTimer*& head)
+	{
+		InternalTimer* t = head;
+		head = nullptr;
+		while(t) {
+			InternalTimer* next = t->next;
+			--m_ScheduledCount;
+			t->next = nullptr;
+			t->prevNext = nullptr;
+			Schedule(t);
+			t = next;
+		}
+	}
+
+	// Moves expired timers of the list to the batch, and the others to the due list.
+	void CollectExpired(InternalTimer*& list)
+	{
+		while(list) {
+			InternalTimer* t = list;
+			Unlink(t);
+			if(t->deadline <= m_Now) {
+				t->state = InternalTimer::EState::Firing;
+				m_Expired.PushBack(t);
+			} else {
+				Link(m_Due, t, InternalTimer::EState::Due);
+			}
+		}
+	}
+
+	void FireExpired()
+	{
+		if(m_Expired.IsEmpty())
+			return;
+
+		core::Sort(m_Expired, core::SortByKey([](const InternalTimer* t) { return t->deadline.Count(); }));
+
+		// New timers can be created by the callbacks, so iterate by index.
+		for(int i = 0; i < m_Expired.Size(); ++i) {
+			InternalTimer* t = m_Expired[i];
+			bool fire = !t->killed && !t->paused;
+			if(fire)
+				t->event.Broadcast();
+
+			if(t->killed) {
+				delete t;
+				continue;
+			}
+
+			if(!fire) {
+				// Paused by an earlier callback of the batch, fires directly after resuming.
+				t->remain = Duration(0);
+				Link(m_Inactive, t, InternalTimer::EState::Inactive);
+				continue;
+			}
+
+			if(t->repeatCount > 0 && --t->repeatCount == 0) {
+				// Finished, stays alive until the handle is killed.
+				--m_TimerCount;
+				t->remain = Duration(0);
+				Link(m_Inactive, t, InternalTimer::EState::Finished);
+				continue;
+			}
+
+			t->deadline = m_Now + t->period;
+			if(t->paused) {
+				t->remain = t->period;
+				Link(m_Inactive, t, InternalTimer::EState::Inactive);
+			} else {
+				Schedule(t);
+			}
+		}
+		m_Expired.Clear();
+	}
+
+	static void DeleteList(InternalTimer*& head)
+	{
+		while(head) {
+			auto next = head->next;
+			delete head;
+			head = next;
+		}
+	}
+
+private:
+	InternalTimer* m_Level0[LEVEL0_SIZE] = {};
+	InternalTimer* m_Levels[LEVEL_COUNT][LEVEL_SIZE] = {};
+	InternalTimer* m_Due = nullptr;
+	InternalTimer* m_Inactive = nullptr;
+
+	Duration m_Now;
+	u64 m_WheelTick = 0; //!< The next tick to process
+	int m_ScheduledCount = 0; //!< The number of timers in the wheel slots
+	int m_Level0Count = 0; //!< The number of timers in the first level
+	int m_TimerCount = 0;
+
+	core::Array<InternalTimer*> m_Expired;
+};
+
+TimerManager::~TimerManager()
+{
+	delete m_Wheel;
+}
+
+void TimerManager::Tick(Duration passed)
+{
+	if(m_Wheel)
+		m_Wheel->Tick(passed);
 }
 
 void TimerManager::RunLoop(Duration stepSize)
@@ -72,7 +375,7 @@ void TimerManager::RunLoop(Duration stepSize)
 			Tick(stepSize);
 		}
 		// Abort if there are no more timers.
-		if(!m_FirstTimer || m_AbortLoop)
+		if(GetTimerCount() == 0 || m_AbortLoop)
 			return;
 
 		// Wait.
@@ -87,41 +390,35 @@ void TimerManager::RunLoop(Duration stepSize)
 
 Timer TimerManager::CreateTimer(const TimerSettings& settings)
 {
-	return Timer(CreateInternalTimer(settings));
+	if(!m_Wheel)
+		m_Wheel = new TimerWheel;
+	return Timer(m_Wheel->Create(settings));
 }
 
 Timer TimerManager::CreateTimer(Duration period)
 {
 	TimerSettings settings(period);
-	return Timer(CreateInternalTimer(settings));
+	return CreateTimer(settings);
+}
+
+int TimerManager::GetTimerCount() const
+{
+	return m_Wheel ? m_Wheel->GetTimerCount() : 0;
+}
+
+void TimerManager::KillTimer(InternalTimer* t)
+{
+	t->wheel->Kill(t);
 }
 
-InternalTimer* TimerManager::CreateInternalTimer(const TimerSettings& settings)
+void TimerManager::PauseTimer(InternalTimer* t, bool pause)
 {
-	auto t = new InternalTimer;
-	t->repeatCount = settings.count;
-	t->period = settings.period;
-	t->remain = settings.start;
-	t->paused = false;
-	t->next = m_FirstTimer;
-	t->prev = nullptr;
-	m_FirstTimer = t;
-	++m_TimerCount;
-	return m_FirstTimer;
+	t->wheel->Pause(t, pause);
 }
 
-InternalTimer* TimerManager::DestroyInternalTimer(InternalTimer* t)
+Duration TimerManager::GetRemainingTime(const InternalTimer* t)
 {
-	auto next = t->next;
-	if(t->next)
-		t->next->prev = t->prev;
-	if(t->prev)
-		t->prev->next = t->next;
-	if(t == m_FirstTimer)
-		m_FirstTimer = nullptr;
-	--m_TimerCount;
-	delete t;
-	return next;
+	return t->wheel->GetRemainingTime(t);
 }
 
 } // namespace core
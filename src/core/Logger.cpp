@@ -5,6 +5,10 @@
 #include "core/StringConverter.h"
 #include "io/ioExceptions.h"
 #include <atomic>
+#include <cstring>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 #ifdef LUX_WINDOWS
 #include "platform/StrippedWindows.h"
 #endif
@@ -217,8 +221,12 @@ public:
 
 		fwrite(s.Data(), 1, s.Size(), m_File);
 		fputs("\n", m_File);
+	}
 
-		fflush(m_File);
+	void Flush()
+	{
+		if(m_File)
+			fflush(m_File);
 	}
 
 private:
@@ -307,6 +315,379 @@ private:
 
 #endif // LUX_WINDOWS
 
+//! Message buffer with a single producer and a single consumer.
+/**
+Each entry is stored as header followed by the message bytes, the positions
+are free running counters, the buffer size must be a power of two.
+The ring is owned by both the producing thread and the logger, and deleted
+when both released it, whichever of them ends first.
+*/
+class LogRing
+{
+	struct Header
+	{
+		u32 size;
+		ELogLevel level;
+	};
+
+public:
+	explicit LogRing(u32 size) :
+		m_Data(new u8[size]),
+		m_Size(size),
+		m_Head(0),
+		m_Tail(0),
+		m_IsAbandoned(false),
+		m_RefCount(2)
+	{
+	}
+
+	~LogRing()
+	{
+		delete[] m_Data;
+	}
+
+	//! Called once by the owning thread and once by the logger.
+	void Release()
+	{
+		if(m_RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete this;
+	}
+
+	//! Called only by the owning thread.
+	bool Push(core::StringView s, ELogLevel ll)
+	{
+		Header header = {(u32)s.Size(), ll};
+		u32 need = EntrySize(header.size);
+		u32 head = m_Head.load(std::memory_order_relaxed);
+		u32 tail = m_Tail.load(std::memory_order_acquire);
+		if(m_Size - (head - tail) < need)
+			return false;
+
+		Write(head, &header, sizeof(header));
+		Write(head + sizeof(header), s.Data(), header.size);
+		m_Head.store(head + need, std::memory_order_release);
+		return true;
+	}
+
+	//! Called only by the logging thread.
+	template <typename FuncT>
+	void Consume(core::String& tmp, FuncT func)
+	{
+		u32 tail = m_Tail.load(std::memory_order_relaxed);
+		u32 head = m_Head.load(std::memory_order_acquire);
+		while(tail != head) {
+			Header header;
+			Read(tail, &header, sizeof(header));
+			tmp.Clear();
+			ReadString(tail + sizeof(header), header.size, tmp);
+			func(tmp, header.level);
+			tail += EntrySize(header.size);
+		}
+		m_Tail.store(tail, std::memory_order_release);
+	}
+
+	bool IsEmpty() const
+	{
+		return m_Head.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_relaxed);
+	}
+
+	bool IsFull() const
+	{
+		return m_Size - (m_Head.load() - m_Tail.load()) < m_Size / 2;
+	}
+
+	u32 GetSize() const { return m_Size; }
+
+	void Abandon() { m_IsAbandoned = true; }
+	bool IsAbandoned() const { return m_IsAbandoned; }
+
+private:
+	static u32 EntrySize(u32 textSize)
+	{
+		return (u32)((sizeof(Header) + textSize + 7) & ~7);
+	}
+
+	void Write(u32 pos, const void* data, u32 size)
+	{
+		u32 offset = pos & (m_Size - 1);
+		u32 first = math::Min(size, m_Size - offset);
+		memcpy(m_Data + offset, data, first);
+		memcpy(m_Data, (const u8*)data + first, size - first);
+	}
+
+	void Read(u32 pos, void* data, u32 size) const
+	{
+		u32 offset = pos & (m_Size - 1);
+		u32 first = math::Min(size, m_Size - offset);
+		memcpy(data, m_Data + offset, first);
+		memcpy((u8*)data + first, m_Data, size - first);
+	}
+
+	void ReadString(u32 pos, u32 size, core::String& out) const
+	{
+		u32 offset = pos & (m_Size - 1);
+		u32 first = math::Min(size, m_Size - offset);
+		out.Append((const char*)m_Data + offset, (int)first);
+		out.Append((const char*)m_Data, (int)(size - first));
+	}
+
+private:
+	u8* m_Data;
+	u32 m_Size;
+	std::atomic<u32> m_Head;
+	std::atomic<u32> m_Tail;
+	std::atomic<bool> m_IsAbandoned;
+	std::atomic<int> m_RefCount;
+};
+
+class AsyncLogger
+{
+public:
+	~AsyncLogger()
+	{
+		Stop();
+		std::lock_guard<std::mutex> _(m_RingLock);
+		for(auto r : m_Rings)
+			r->Release();
+		m_Rings.Clear();
+	}
+
+	void Start()
+	{
+		std::lock_guard<std::mutex> _(m_ThreadLock);
+		if(m_Thread.joinable())
+			return;
+		m_IsRunning = true;
+		m_Thread = std::thread([this]() { Run(); });
+		m_IsEnabled = true;
+	}
+
+	void Stop()
+	{
+		std::lock_guard<std::mutex> _(m_ThreadLock);
+		if(!m_Thread.joinable())
+			return;
+		m_IsEnabled = false;
+		{
+			std::lock_guard<std::mutex> lock(m_WakeLock);
+			m_IsRunning = false;
+		}
+		m_WakeCondition.notify_one();
+		m_Thread.join();
+
+		// Print the messages pushed after the last drain of the thread.
+		Drain(true);
+	}
+
+	bool IsEnabled() const { return m_IsEnabled; }
+
+	bool Push(core::StringView s, ELogLevel ll)
+	{
+		LogRing* ring = GetThreadRing(s.Size());
+		if(!ring)
+			return false;
+
+		// Give the logging thread some time if the buffer is full.
+		for(int tries = 0; tries < 100; ++tries) {
+			if(ring->Push(s, ll)) {
+				if(ring->IsFull())
+					Wake();
+				return true;
+			}
+			Wake();
+			std::this_thread::yield();
+		}
+
+		++m_Dropped;
+		return true;
+	}
+
+	void Flush()
+	{
+		if(!m_IsEnabled)
+			return;
+		std::unique_lock<std::mutex> lock(m_WakeLock);
+		u64 target = m_RequestedFlush = m_FinishedFlush + 1;
+		m_WakeCondition.notify_one();
+		m_FlushCondition.wait(lock, [&]() { return m_FinishedFlush >= target || !m_IsRunning; });
+	}
+
+	std::atomic<int> rateLimit{0};
+	std::atomic<bool> deduplicate{false};
+
+private:
+	struct ThreadRing
+	{
+		LogRing* ring = nullptr;
+		~ThreadRing()
+		{
+			if(ring) {
+				ring->Abandon();
+				ring->Release();
+			}
+		}
+	};
+
+	LogRing* GetThreadRing(int messageSize)
+	{
+		static thread_local ThreadRing threadRing;
+		if(!threadRing.ring) {
+			threadRing.ring = new LogRing(64 * 1024);
+			std::lock_guard<std::mutex> _(m_RingLock);
+			m_Rings.PushBack(threadRing.ring);
+		}
+		if((u32)messageSize + 16 > threadRing.ring->GetSize() / 2)
+			return nullptr; // Much too big, print it directly.
+		return threadRing.ring;
+	}
+
+	void Wake()
+	{
+		m_WakeCondition.notify_one();
+	}
+
+	void Run()
+	{
+		bool isRunning = true;
+		while(isRunning) {
+			u64 flushTarget;
+			{
+				std::unique_lock<std::mutex> lock(m_WakeLock);
+				m_WakeCondition.wait_for(lock, std::chrono::milliseconds(10));
+				isRunning = m_IsRunning;
+				flushTarget = m_RequestedFlush;
+			}
+
+			bool forceFlush = flushTarget > m_FinishedFlush || !isRunning;
+			Drain(forceFlush);
+
+			if(forceFlush) {
+				std::lock_guard<std::mutex> lock(m_WakeLock);
+				m_FinishedFlush = flushTarget;
+			}
+			m_FlushCondition.notify_all();
+		}
+	}
+
+	void Drain(bool flushRepeats)
+	{
+		m_BatchCount = 0;
+		auto now = std::chrono::steady_clock::now();
+		if(now - m_WindowStart >= std::chrono::seconds(1)) {
+			m_WindowStart = now;
+			m_WindowCount = 0;
+			if(m_Suppressed) {
+				AddSummary("{} log messages were suppressed.", m_Suppressed, ELogLevel::Warning);
+				m_Suppressed = 0;
+			}
+			flushRepeats = true;
+		}
+
+		int dropped = m_Dropped.exchange(0);
+		if(dropped)
+			AddSummary("{} log messages were dropped, the log buffer was full.", dropped, ELogLevel::Warning);
+
+		{
+			std::lock_guard<std::mutex> _(m_RingLock);
+			for(int i = 0; i < m_Rings.Size();) {
+				auto ring = m_Rings[i];
+				ring->Consume(m_Tmp, [this](const core::String& text, ELogLevel ll) { AddMessage(text, ll); });
+				if(ring->IsAbandoned() && ring->IsEmpty()) {
+					ring->Release();
+					m_Rings.Erase(i);
+				} else {
+					++i;
+				}
+			}
+		}
+
+		if(flushRepeats)
+			FlushRepeats();
+
+		if(m_BatchCount) {
+			auto printer = GetPrinter();
+			if(printer)
+				printer->PrintSync(m_Batch.Data(), m_BatchCount);
+		}
+	}
+
+	void AddMessage(const core::String& text, ELogLevel ll)
+	{
+		if(deduplicate && ll == m_LastLevel && text.Equal(m_LastText)) {
+			++m_Repeats;
+			return;
+		}
+		FlushRepeats();
+
+		int limit = rateLimit;
+		if(limit > 0 && m_WindowCount >= limit) {
+			++m_Suppressed;
+			return;
+		}
+		++m_WindowCount;
+
+		m_LastText.Clear();
+		m_LastText.Append(text);
+		m_LastLevel = ll;
+		AddEntry(text, ll);
+	}
+
+	void FlushRepeats()
+	{
+		if(m_Repeats) {
+			AddSummary("Last message repeated {} times.", m_Repeats, m_LastLevel);
+			m_Repeats = 0;
+		}
+	}
+
+	void AddSummary(core::StringView fmt, int count, ELogLevel ll)
+	{
+		m_SummaryText.Clear();
+		core::StringConverter::AppendFormat(m_SummaryText, fmt, count);
+		AddEntry(m_SummaryText, ll);
+	}
+
+	void AddEntry(core::StringView text, ELogLevel ll)
+	{
+		if(m_BatchCount == m_Batch.Size())
+			m_Batch.PushBack(Printer::Entry());
+		auto& entry = m_Batch[m_BatchCount++];
+		entry.text.Clear();
+		entry.text.Append(text);
+		entry.level = ll;
+	}
+
+private:
+	std::mutex m_ThreadLock;
+	std::thread m_Thread;
+	std::atomic<bool> m_IsEnabled{false};
+
+	std::mutex m_WakeLock;
+	std::condition_variable m_WakeCondition;
+	std::condition_variable m_FlushCondition;
+	bool m_IsRunning = false;
+	u64 m_RequestedFlush = 0;
+	u64 m_FinishedFlush = 0;
+
+	std::mutex m_RingLock;
+	core::Array<LogRing*> m_Rings;
+	std::atomic<int> m_Dropped{0};
+
+	// Only used by the logging thread, and by Stop once the thread ended.
+	core::String m_Tmp;
+	core::String m_SummaryText;
+	core::Array<Printer::Entry> m_Batch;
+	int m_BatchCount = 0;
+
+	core::String m_LastText;
+	ELogLevel m_LastLevel = ELogLevel::None;
+	int m_Repeats = 0;
+
+	std::chrono::steady_clock::time_point m_WindowStart;
+	int m_WindowCount = 0;
+	int m_Suppressed = 0;
+};
+
 }
 
 Printer* HTMLPrinter = nullptr;
@@ -322,5 +703,78 @@ Printer* Win32DebugPrinter = &realWin32DebugPrinter;
 Printer* Win32DebugPrinter = nullptr;
 #endif
 
+// Defined after the printers, so it's destroyed and flushed before them.
+static Impl::AsyncLogger g_AsyncLogger;
+
+void SetAsyncLogging(bool enable)
+{
+	if(enable)
+		g_AsyncLogger.Start();
+	else
+		g_AsyncLogger.Stop();
+}
+
+bool IsAsyncLogging()
+{
+	return g_AsyncLogger.IsEnabled();
+}
+
+void FlushLog()
+{
+	g_AsyncLogger.Flush();
+}
+
+void SetLogRateLimit(int messagesPerSecond)
+{
+	g_AsyncLogger.rateLimit = messagesPerSecond;
+}
+
+void SetLogDeduplication(bool enable)
+{
+	g_AsyncLogger.deduplicate = enable;
+}
+
+namespace Impl
+{
+namespace
+{
+struct ThreadBuffers
+{
+	static const int COUNT = 4;
+	core::String buffers[COUNT];
+	int depth = 0;
+};
+
+thread_local ThreadBuffers t_ThreadBuffers;
+}
+
+ThreadBufferScope::ThreadBufferScope()
+{
+	auto& buffers = t_ThreadBuffers;
+	// Deeply nested log calls are rare, they get a new string.
+	if(buffers.depth < ThreadBuffers::COUNT)
+		m_Buffer = &buffers.buffers[buffers.depth];
+	else
+		m_Buffer = new core::String;
+	++buffers.depth;
+	m_Buffer->Clear();
+}
+
+ThreadBufferScope::~ThreadBufferScope()
+{
+	auto& buffers = t_ThreadBuffers;
+	--buffers.depth;
+	if(buffers.depth >= ThreadBuffers::COUNT)
+		delete m_Buffer;
+}
+
+bool PushAsync(core::StringView s, ELogLevel ll)
+{
+	if(!g_AsyncLogger.IsEnabled())
+		return false;
+	return g_AsyncLogger.Push(s, ll);
+}
+}
+
 }
 }
@@ -2,6 +2,7 @@
 #include "core/ReferableFactory.h"
 #include "core/lxAlgorithm.h"
 #include "core/Logger.h"
+#include "core/lxProfiler.h"
 
 #include "io/FileSystem.h"
 #include "io/File.h"
@@ -81,6 +82,7 @@ public:
 			throw FileFormatException("File format not supported", type.AsView());
 
 		// Load the resource
+		LX_PROFILE_SCOPE("ResourceLoader::LoadResource");
 		auto oldCursor = file->GetCursor();
 		try {
 			loader->LoadResource(file, dst);
@@ -198,6 +200,7 @@ StrongRef<core::Referable> ResourceSystem::CreateResource(int typeId, io::File*
 
 StrongRef<core::Referable> ResourceSystem::CreateResource(int typeId, io::File* file, const ResourceOrigin& origin)
 {
+	LX_PROFILE_SCOPE("ResourceSystem::CreateResource");
 	// Get loader and correct resource type from file
 	auto type = self->types[typeId].name;
 	core::Name typeToLoad;
@@ -213,6 +216,7 @@ StrongRef<core::Referable> ResourceSystem::CreateResource(int typeId, io::File*
 	// Load the resource
 	auto oldCursor = file->GetCursor();
 	try {
+		LX_PROFILE_SCOPE("ResourceLoader::LoadResource");
 		loader->LoadResource(file, object);
 
 		// Add to cache
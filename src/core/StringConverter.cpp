@@ -1,4 +1,8 @@
 #include "core/StringConverter.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 
 namespace lux
 {
@@ -7,38 +11,45 @@ namespace core
 namespace StringConverter
 {
 
+static constexpr auto INT_PLAN = format::MakePlan("{}");
+static constexpr auto FLOAT_PLAN = format::MakePlan("{!r}");
+
 String IntToString(intmax_t num)
 {
 	String out;
-	format::format(out, "{}", num);
+	format::format(out, INT_PLAN, num);
 	return out;
 }
 
 String UIntToString(intmax_t num)
 {
 	String out;
-	format::format(out, "{}", num);
+	format::format(out, INT_PLAN, num);
 	return out;
 }
 
 String& AppendIntToString(String& str, intmax_t value)
 {
-	return AppendFormat(str, "{}", value);
+	format::format(str, INT_PLAN, value);
+	return str;
 }
 
 String& AppendUIntToString(String& str, uintmax_t value)
 {
-	return AppendFormat(str, "{}", value);
+	format::format(str, INT_PLAN, value);
+	return str;
 }
 
 String& Append(String& str, float value)
 {
-	return AppendFormat(str, "{}", value);
+	format::format(str, FLOAT_PLAN, value);
+	return str;
 }
 
 String& Append(String& str, double value)
 {
-	return AppendFormat(str, "{}", value);
+	format::format(str, FLOAT_PLAN, value);
+	return str;
 }
 
 String& Append(String& str, const DateAndTime& value)
@@ -51,90 +62,557 @@ String& Append(String& str, const StringView& value)
 	return str.Append(value);
 }
 
-float ParseFloat(StringView str, float errorValue, int* nextChar, EParseError* error)
+namespace
 {
-	int sign = 1;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define LUX_PARSE_NO_SWAR
+#endif
 
-	if(str.IsEmpty()) {
-		if(nextChar)
-			*nextChar = 0;
-		if(error)
-			*error = EParseError::EmptyInput;
-		return errorValue;
+bool IsDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+#ifndef LUX_PARSE_NO_SWAR
+/*
+Eight digits are checked and converted at once, as bytes of a 64 bit integer.
+*/
+u64 LoadEightChars(const char* c)
+{
+	u64 value;
+	std::memcpy(&value, c, 8);
+	return value;
+}
+
+bool IsEightDigits(u64 value)
+{
+	return ((value & 0xF0F0F0F0F0F0F0F0ull) |
+		(((value + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+u32 ParseEightDigits(u64 value)
+{
+	const u64 mask = 0x000000FF000000FFull;
+	const u64 mul1 = 0x000F424000000064ull; // 100 + (1000000 << 32)
+	const u64 mul2 = 0x0000271000000001ull; // 1 + (10000 << 32)
+	value -= 0x3030303030303030ull;
+	value = (value * 10) + (value >> 8);
+	value = (((value & mask) * mul1) + (((value >> 16) & mask) * mul2)) >> 32;
+	return u32(value);
+}
+#endif
+
+// Accumulate all digits, returns the first non digit.
+// The value wraps around if there are too many digits.
+const char* ParseDigits(const char* cur, const char* end, u64& value)
+{
+#ifndef LUX_PARSE_NO_SWAR
+	while(end - cur >= 8) {
+		u64 chars = LoadEightChars(cur);
+		if(!IsEightDigits(chars))
+			break;
+		value = value * 100000000 + ParseEightDigits(chars);
+		cur += 8;
+	}
+#endif
+	while(cur != end && IsDigit(*cur)) {
+		value = value * 10 + u64(*cur - '0');
+		++cur;
 	}
+	return cur;
+}
+
+struct ParsedNumber
+{
+	u64 mantissa;
+	s64 exponent;
+	bool negative;
+	bool tooManyDigits;
+	const char* end;
+};
 
-	int i = 0;
-	if(str[i] == '-') {
-		sign = -1;
-		++i;
-	} else if(str[i] == '+') {
-		sign = 1;
-		++i;
+// The decimal representation of a number, value = mantissa * 10^exponent.
+// Only the first 19 digits are stored in the mantissa.
+bool ParseNumber(const char* cur, const char* end, ParsedNumber& out)
+{
+	out.negative = false;
+	out.tooManyDigits = false;
+	if(cur != end && (*cur == '-' || *cur == '+')) {
+		out.negative = (*cur == '-');
+		++cur;
 	}
 
-	if(i + 3 <= str.Size() && (str[i] == 'i' && str[i+1] == 'n' && str[i+2]=='f')) {
-		i += 3;
-		if(nextChar)
-			*nextChar = i;
-		if(error)
-			*error = EParseError::Error;
-		return sign * std::numeric_limits<float>::infinity();
-	}
-
-	unsigned int pre = 0;
-	unsigned int post = std::numeric_limits<unsigned int>::max();
-
-	unsigned int* value = &pre;
-	int numDigits = 1;
-	while(i < str.Size()) {
-		if(str[i] >= '0' && str[i] <= '9') {
-			unsigned int old = *value;
-			unsigned int dvalue = str[i] - '0';
-			*value *= 10;
-			*value += dvalue;
-			numDigits *= 10;
-			if(*value < old) {
-				if(value == &pre) {
-					value = &post;
-					post = 0;
-					numDigits = 1;
-				} else if(value == &post)
-					break;
-			}
-			++i;
-		} else if(str[i] == '.') {
-			if(value == &pre) {
-				post = 0;
-				value = &post;
-				++i;
-				numDigits = 1;
-			} else if(value == &post)
-				break;
+	const char* startDigits = cur;
+	u64 mantissa = 0;
+	cur = ParseDigits(cur, end, mantissa);
+	const char* endInteger = cur;
+	s64 digitCount = endInteger - startDigits;
+
+	const char* startFraction = cur;
+	const char* endFraction = cur;
+	s64 exponent = 0;
+	if(cur != end && *cur == '.') {
+		++cur;
+		startFraction = cur;
+		cur = ParseDigits(cur, end, mantissa);
+		endFraction = cur;
+		exponent = startFraction - endFraction;
+		digitCount -= exponent;
+	}
+
+	if(digitCount == 0)
+		return false;
+
+	s64 explicitExponent = 0;
+	if(cur != end && (*cur == 'e' || *cur == 'E')) {
+		const char* e = cur;
+		++cur;
+		bool negativeExponent = false;
+		if(cur != end && (*cur == '-' || *cur == '+')) {
+			negativeExponent = (*cur == '-');
+			++cur;
+		}
+		if(cur == end || !IsDigit(*cur)) {
+			// Not an exponent, the number ends before the e.
+			cur = e;
 		} else {
-			break;
+			while(cur != end && IsDigit(*cur)) {
+				if(explicitExponent < 0x10000000)
+					explicitExponent = explicitExponent * 10 + (*cur - '0');
+				++cur;
+			}
+			if(negativeExponent)
+				explicitExponent = -explicitExponent;
+			exponent += explicitExponent;
 		}
 	}
+	out.end = cur;
 
-	float out = (float)pre;
-	if(post != std::numeric_limits<unsigned int>::max())
-		out += (float)post / numDigits;
+	if(digitCount > 19) {
+		// Leading zeros aren't significant.
+		for(const char* c = startDigits; c != endFraction && (*c == '0' || *c == '.'); ++c) {
+			if(*c == '0')
+				--digitCount;
+		}
+		if(digitCount > 19) {
+			out.tooManyDigits = true;
+			const u64 MIN_19_DIGITS = 1000000000000000000ull;
+			mantissa = 0;
+			const char* c = startDigits;
+			while(mantissa < MIN_19_DIGITS && c != endInteger) {
+				mantissa = mantissa * 10 + u64(*c - '0');
+				++c;
+			}
+			if(mantissa >= MIN_19_DIGITS) {
+				exponent = (endInteger - c) + explicitExponent;
+			} else {
+				c = startFraction;
+				while(mantissa < MIN_19_DIGITS && c != endFraction) {
+					mantissa = mantissa * 10 + u64(*c - '0');
+					++c;
+				}
+				exponent = (startFraction - c) + explicitExponent;
+			}
+		}
+	}
 
-	out *= sign;
+	out.mantissa = mantissa;
+	out.exponent = exponent;
+	return true;
+}
 
-	if(nextChar)
-		*nextChar = i;
+/*
+Correctly rounded conversion to float with the Eisel-Lemire algorithm, see
+Daniel Lemire, "Number Parsing at a Gigabyte per Second".
+The mantissa is multiplied with a 128 bit approximation of the power of five,
+the remaining power of two goes directly into the exponent.
+*/
+const int FLOAT_MANTISSA_BITS = 23;
+const int FLOAT_MIN_EXPONENT = -127;
+const int FLOAT_INFINITE_POWER = 0xFF;
+const int FLOAT_SMALLEST_POWER_OF_TEN = -65;
+const int FLOAT_LARGEST_POWER_OF_TEN = 38;
 
-	if(error)
-		*error = EParseError::Error;
+// Normalized 128 bit powers of five, 5^-65 to 5^38, high and low part.
+const u64 POWERS_OF_FIVE[] = {
+	0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9, // 5^-65
+	0xA87FEA27A539E9A5, 0x3F2398D747B36224, // 5^-64
+	0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD, // 5^-63
+	0x83A3EEEEF9153E89, 0x1953CF68300424AC, // 5^-62
+	0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7, // 5^-61
+	0xCDB02555653131B6, 0x3792F412CB06794D, // 5^-60
+	0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0, // 5^-59
+	0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4, // 5^-58
+	0xC8DE047564D20A8B, 0xF245825A5A445275, // 5^-57
+	0xFB158592BE068D2E, 0xEED6E2F0F0D56712, // 5^-56
+	0x9CED737BB6C4183D, 0x55464DD69685606B, // 5^-55
+	0xC428D05AA4751E4C, 0xAA97E14C3C26B886, // 5^-54
+	0xF53304714D9265DF, 0xD53DD99F4B3066A8, // 5^-53
+	0x993FE2C6D07B7FAB, 0xE546A8038EFE4029, // 5^-52
+	0xBF8FDB78849A5F96, 0xDE98520472BDD033, // 5^-51
+	0xEF73D256A5C0F77C, 0x963E66858F6D4440, // 5^-50
+	0x95A8637627989AAD, 0xDDE7001379A44AA8, // 5^-49
+	0xBB127C53B17EC159, 0x5560C018580D5D52, // 5^-48
+	0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6, // 5^-47
+	0x9226712162AB070D, 0xCAB3961304CA70E8, // 5^-46
+	0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22, // 5^-45
+	0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A, // 5^-44
+	0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242, // 5^-43
+	0xB267ED1940F1C61C, 0x55F038B237591ED3, // 5^-42
+	0xDF01E85F912E37A3, 0x6B6C46DEC52F6688, // 5^-41
+	0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015, // 5^-40
+	0xAE397D8AA96C1B77, 0xABEC975E0A0D081A, // 5^-39
+	0xD9C7DCED53C72255, 0x96E7BD358C904A21, // 5^-38
+	0x881CEA14545C7575, 0x7E50D64177DA2E54, // 5^-37
+	0xAA242499697392D2, 0xDDE50BD1D5D0B9E9, // 5^-36
+	0xD4AD2DBFC3D07787, 0x955E4EC64B44E864, // 5^-35
+	0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E, // 5^-34
+	0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E, // 5^-33
+	0xCFB11EAD453994BA, 0x67DE18EDA5814AF2, // 5^-32
+	0x81CEB32C4B43FCF4, 0x80EACF948770CED7, // 5^-31
+	0xA2425FF75E14FC31, 0xA1258379A94D028D, // 5^-30
+	0xCAD2F7F5359A3B3E, 0x096EE45813A04330, // 5^-29
+	0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC, // 5^-28
+	0x9E74D1B791E07E48, 0x775EA264CF55347E, // 5^-27
+	0xC612062576589DDA, 0x95364AFE032A819E, // 5^-26
+	0xF79687AED3EEC551, 0x3A83DDBD83F52205, // 5^-25
+	0x9ABE14CD44753B52, 0xC4926A9672793543, // 5^-24
+	0xC16D9A0095928A27, 0x75B7053C0F178294, // 5^-23
+	0xF1C90080BAF72CB1, 0x5324C68B12DD6339, // 5^-22
+	0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E04, // 5^-21
+	0xBCE5086492111AEA, 0x88F4BB1CA6BCF585, // 5^-20
+	0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E6, // 5^-19
+	0x9392EE8E921D5D07, 0x3AFF322E62439FD0, // 5^-18
+	0xB877AA3236A4B449, 0x09BEFEB9FAD487C3, // 5^-17
+	0xE69594BEC44DE15B, 0x4C2EBE687989A9B4, // 5^-16
+	0x901D7CF73AB0ACD9, 0x0F9D37014BF60A11, // 5^-15
+	0xB424DC35095CD80F, 0x538484C19EF38C95, // 5^-14
+	0xE12E13424BB40E13, 0x2865A5F206B06FBA, // 5^-13
+	0x8CBCCC096F5088CB, 0xF93F87B7442E45D4, // 5^-12
+	0xAFEBFF0BCB24AAFE, 0xF78F69A51539D749, // 5^-11
+	0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1C, // 5^-10
+	0x89705F4136B4A597, 0x31680A88F8953031, // 5^-9
+	0xABCC77118461CEFC, 0xFDC20D2B36BA7C3E, // 5^-8
+	0xD6BF94D5E57A42BC, 0x3D32907604691B4D, // 5^-7
+	0x8637BD05AF6C69B5, 0xA63F9A49C2C1B110, // 5^-6
+	0xA7C5AC471B478423, 0x0FCF80DC33721D54, // 5^-5
+	0xD1B71758E219652B, 0xD3C36113404EA4A9, // 5^-4
+	0x83126E978D4FDF3B, 0x645A1CAC083126EA, // 5^-3
+	0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A4, // 5^-2
+	0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCD, // 5^-1
+	0x8000000000000000, 0x0000000000000000, // 5^0
+	0xA000000000000000, 0x0000000000000000, // 5^1
+	0xC800000000000000, 0x0000000000000000, // 5^2
+	0xFA00000000000000, 0x0000000000000000, // 5^3
+	0x9C40000000000000, 0x0000000000000000, // 5^4
+	0xC350000000000000, 0x0000000000000000, // 5^5
+	0xF424000000000000, 0x0000000000000000, // 5^6
+	0x9896800000000000, 0x0000000000000000, // 5^7
+	0xBEBC200000000000, 0x0000000000000000, // 5^8
+	0xEE6B280000000000, 0x0000000000000000, // 5^9
+	0x9502F90000000000, 0x0000000000000000, // 5^10
+	0xBA43B74000000000, 0x0000000000000000, // 5^11
+	0xE8D4A51000000000, 0x0000000000000000, // 5^12
+	0x9184E72A00000000, 0x0000000000000000, // 5^13
+	0xB5E620F480000000, 0x0000000000000000, // 5^14
+	0xE35FA931A0000000, 0x0000000000000000, // 5^15
+	0x8E1BC9BF04000000, 0x0000000000000000, // 5^16
+	0xB1A2BC2EC5000000, 0x0000000000000000, // 5^17
+	0xDE0B6B3A76400000, 0x0000000000000000, // 5^18
+	0x8AC7230489E80000, 0x0000000000000000, // 5^19
+	0xAD78EBC5AC620000, 0x0000000000000000, // 5^20
+	0xD8D726B7177A8000, 0x0000000000000000, // 5^21
+	0x878678326EAC9000, 0x0000000000000000, // 5^22
+	0xA968163F0A57B400, 0x0000000000000000, // 5^23
+	0xD3C21BCECCEDA100, 0x0000000000000000, // 5^24
+	0x84595161401484A0, 0x0000000000000000, // 5^25
+	0xA56FA5B99019A5C8, 0x0000000000000000, // 5^26
+	0xCECB8F27F4200F3A, 0x0000000000000000, // 5^27
+	0x813F3978F8940984, 0x4000000000000000, // 5^28
+	0xA18F07D736B90BE5, 0x5000000000000000, // 5^29
+	0xC9F2C9CD04674EDE, 0xA400000000000000, // 5^30
+	0xFC6F7C4045812296, 0x4D00000000000000, // 5^31
+	0x9DC5ADA82B70B59D, 0xF020000000000000, // 5^32
+	0xC5371912364CE305, 0x6C28000000000000, // 5^33
+	0xF684DF56C3E01BC6, 0xC732000000000000, // 5^34
+	0x9A130B963A6C115C, 0x3C7F400000000000, // 5^35
+	0xC097CE7BC90715B3, 0x4B9F100000000000, // 5^36
+	0xF0BDC21ABB48DB20, 0x1E86D40000000000, // 5^37
+	0x96769950B50D88F4, 0x1314448000000000, // 5^38
+};
+
+struct U128
+{
+	u64 low;
+	u64 high;
+};
+
+U128 FullMultiplication(u64 a, u64 b)
+{
+	U128 out;
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 r = (unsigned __int128)a * b;
+	out.low = u64(r);
+	out.high = u64(r >> 64);
+#else
+	const u64 aLo = a & 0xFFFFFFFF;
+	const u64 aHi = a >> 32;
+	const u64 bLo = b & 0xFFFFFFFF;
+	const u64 bHi = b >> 32;
+	const u64 p0 = aLo * bLo;
+	const u64 p1 = aLo * bHi;
+	const u64 p2 = aHi * bLo;
+	const u64 p3 = aHi * bHi;
+	const u64 mid = (p0 >> 32) + (p1 & 0xFFFFFFFF) + (p2 & 0xFFFFFFFF);
+	out.low = (mid << 32) | (p0 & 0xFFFFFFFF);
+	out.high = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
 	return out;
 }
 
-int ParseInt(StringView str, int errorValue, int* nextChar, EParseError* error)
+int LeadingZeros(u64 value)
+{
+	int count = 0;
+	while(!(value & (u64(1) << 63))) {
+		value <<= 1;
+		++count;
+	}
+	return count;
+}
+
+// Returns the biased exponent and the mantissa without hidden bit.
+void ComputeFloat(s64 q, u64 w, int& power2, u64& mantissa)
 {
-	unsigned int value = 0;
-	int numDigits = 0;
-	int sign = 1;
+	if(w == 0 || q < FLOAT_SMALLEST_POWER_OF_TEN) {
+		power2 = 0;
+		mantissa = 0;
+		return;
+	}
+	if(q > FLOAT_LARGEST_POWER_OF_TEN) {
+		power2 = FLOAT_INFINITE_POWER;
+		mantissa = 0;
+		return;
+	}
+
+	const int lz = LeadingZeros(w);
+	w <<= lz;
+
+	// Only the upper bits of the product are needed, use the second
+	// part of the power only if the lower bits could carry into them.
+	const int index = 2 * int(q - FLOAT_SMALLEST_POWER_OF_TEN);
+	const u64 precisionMask = 0xFFFFFFFFFFFFFFFFull >> (FLOAT_MANTISSA_BITS + 3);
+	U128 product = FullMultiplication(w, POWERS_OF_FIVE[index]);
+	if((product.high & precisionMask) == precisionMask) {
+		U128 second = FullMultiplication(w, POWERS_OF_FIVE[index + 1]);
+		product.low += second.high;
+		if(second.high > product.low)
+			product.high++;
+	}
+
+	const int upperBit = int(product.high >> 63);
+	const int shift = upperBit + 64 - FLOAT_MANTISSA_BITS - 3;
+	mantissa = product.high >> shift;
+	// floor(log2(10^q)) + 63 = floor(q * log2(10)) + 63
+	const int power = int((((152170 + 65536) * q) >> 16) + 63);
+	power2 = power + upperBit - lz - FLOAT_MIN_EXPONENT;
+
+	if(power2 <= 0) {
+		// Subnormal
+		if(-power2 + 1 >= 64) {
+			power2 = 0;
+			mantissa = 0;
+			return;
+		}
+		mantissa >>= -power2 + 1;
+		mantissa += (mantissa & 1);
+		mantissa >>= 1;
+		power2 = (mantissa < (u64(1) << FLOAT_MANTISSA_BITS)) ? 0 : 1;
+		return;
+	}
 
+	// Exactly between two floats, round to even.
+	if(product.low <= 1 && q >= -17 && q <= 10 && (mantissa & 3) == 1) {
+		if((mantissa << shift) == product.high)
+			mantissa &= ~u64(1);
+	}
+
+	mantissa += (mantissa & 1);
+	mantissa >>= 1;
+	if(mantissa >= (u64(2) << FLOAT_MANTISSA_BITS)) {
+		mantissa = u64(1) << FLOAT_MANTISSA_BITS;
+		power2++;
+	}
+	mantissa &= ~(u64(1) << FLOAT_MANTISSA_BITS);
+	if(power2 >= FLOAT_INFINITE_POWER) {
+		power2 = FLOAT_INFINITE_POWER;
+		mantissa = 0;
+	}
+}
+
+float MakeFloat(bool negative, int power2, u64 mantissa)
+{
+	u32 bits = u32(mantissa) | (u32(power2) << FLOAT_MANTISSA_BITS) | (negative ? 0x80000000u : 0u);
+	float out;
+	std::memcpy(&out, &bits, 4);
+	return out;
+}
+
+// Convert with the c library, if the number is too long for the fast path.
+float SlowParseFloat(const char* begin, const char* end)
+{
+	core::String copy(begin, int(end - begin));
+	return std::strtof(copy.Data(), nullptr);
+}
+
+float ToFloat(const ParsedNumber& number, const char* begin)
+{
+	// Exact if mantissa and power of ten are exactly representable as float.
+	static const float POWERS_OF_TEN[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+	if(!number.tooManyDigits && number.exponent >= -10 && number.exponent <= 10 && number.mantissa <= (u64(2) << FLOAT_MANTISSA_BITS)) {
+		float value = float(number.mantissa);
+		if(number.exponent < 0)
+			value /= POWERS_OF_TEN[-number.exponent];
+		else
+			value *= POWERS_OF_TEN[number.exponent];
+		return number.negative ? -value : value;
+	}
+
+	int power2;
+	u64 mantissa;
+	ComputeFloat(number.exponent, number.mantissa, power2, mantissa);
+	if(number.tooManyDigits) {
+		// The real value is between the truncated mantissa and the next one.
+		int power2Up;
+		u64 mantissaUp;
+		ComputeFloat(number.exponent, number.mantissa + 1, power2Up, mantissaUp);
+		if(power2 != power2Up || mantissa != mantissaUp)
+			return SlowParseFloat(begin, number.end);
+	}
+
+	return MakeFloat(number.negative, power2, mantissa);
+}
+
+bool MatchWord(const char* cur, const char* end, const char* word)
+{
+	for(; *word; ++word, ++cur) {
+		if(cur == end || (*cur | 0x20) != *word)
+			return false;
+	}
+	return true;
+}
+
+// Parse a float, returns the end of the number or nullptr if there is no number.
+const char* ParseFloatRaw(const char* begin, const char* end, float& out, EParseError& error)
+{
+	ParsedNumber number;
+	if(!ParseNumber(begin, end, number)) {
+		// Infinity and not a number
+		const char* cur = begin;
+		bool negative = false;
+		if(cur != end && (*cur == '-' || *cur == '+')) {
+			negative = (*cur == '-');
+			++cur;
+		}
+		if(MatchWord(cur, end, "inf")) {
+			cur += MatchWord(cur, end, "infinity") ? 8 : 3;
+			out = negative ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+			error = EParseError::OK;
+			return cur;
+		}
+		if(MatchWord(cur, end, "nan")) {
+			out = std::numeric_limits<float>::quiet_NaN();
+			error = EParseError::OK;
+			return cur + 3;
+		}
+		error = EParseError::Error;
+		return nullptr;
+	}
+
+	out = ToFloat(number, begin);
+	error = std::isinf(out) ? EParseError::Overflow : EParseError::OK;
+	return number.end;
+}
+
+// Parse a integer, returns the end of the number or nullptr if there is no number.
+const char* ParseIntRaw(const char* begin, const char* end, int& out, EParseError& error)
+{
+	const char* cur = begin;
+	bool negative = false;
+	if(cur != end && (*cur == '-' || *cur == '+')) {
+		negative = (*cur == '-');
+		++cur;
+	}
+
+	const char* startDigits = cur;
+	while(cur != end && *cur == '0')
+		++cur;
+	const char* startSignificant = cur;
+	u64 value = 0;
+	cur = ParseDigits(cur, end, value);
+	if(cur == startDigits) {
+		error = EParseError::Error;
+		return nullptr;
+	}
+
+	const u64 maxValue = negative ? u64(std::numeric_limits<int>::max()) + 1 : u64(std::numeric_limits<int>::max());
+	if(cur - startSignificant > 10 || value > maxValue) {
+		error = EParseError::Overflow;
+		return cur;
+	}
+
+	out = negative ? int(0 - u32(value)) : int(value);
+	error = EParseError::OK;
+	return cur;
+}
+
+bool IsSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+const char* SkipSpace(const char* cur, const char* end)
+{
+	while(cur != end && IsSpace(*cur))
+		++cur;
+	return cur;
+}
+
+// Skip whitespace and a single comma.
+const char* SkipSeparator(const char* cur, const char* end)
+{
+	cur = SkipSpace(cur, end);
+	if(cur != end && *cur == ',')
+		cur = SkipSpace(cur + 1, end);
+	return cur;
+}
+
+template <typename T, typename ParseT>
+int ParseArrayTempl(StringView str, T* out, int count, int* nextChar, ParseT parse)
+{
+	const char* begin = str.Data();
+	const char* end = begin + str.Size();
+	const char* cur = begin;
+	const char* last = begin;
+	int parsed = 0;
+	while(parsed < count) {
+		cur = parsed ? SkipSeparator(cur, end) : SkipSpace(cur, end);
+		EParseError error;
+		const char* next = parse(cur, end, out[parsed], error);
+		if(!next || error != EParseError::OK)
+			break;
+		cur = next;
+		last = next;
+		++parsed;
+	}
+
+	if(nextChar)
+		*nextChar = int(last - begin);
+	return parsed;
+}
+}
+
+float ParseFloat(StringView str, float errorValue, int* nextChar, EParseError* error)
+{
 	if(str.IsEmpty()) {
 		if(nextChar)
 			*nextChar = 0;
@@ -143,46 +621,44 @@ int ParseInt(StringView str, int errorValue, int* nextChar, EParseError* error)
 		return errorValue;
 	}
 
-	int i = 0;
-	if(str[i] == '-') {
-		sign = -1;
-		++i;
-	} else if(str[i] == '+') {
-		sign = 1;
-		++i;
-	}
-
-	unsigned int maxValue = sign==1 ? (unsigned int)std::numeric_limits<int>::max() : ((unsigned int)std::numeric_limits<int>::max()+1);
-	while(i < str.Size()) {
-		if(str[i] >= '0' && str[i] <= '9') {
-			unsigned int dvalue = str[i] - '0';
-			if(value > (maxValue-dvalue)/10) { 
-				if(nextChar)
-					*nextChar = i;
-				if(error)
-					*error = EParseError::Overflow;
-				return errorValue;
-			}
-			value = 10*value + dvalue;
-			numDigits++;
-			++i;
-		} else {
-			break;
-		}
-	}
-
+	float value;
+	EParseError err;
+	const char* end = ParseFloatRaw(str.Data(), str.Data() + str.Size(), value, err);
 	if(nextChar)
-		*nextChar = i;
+		*nextChar = end ? int(end - str.Data()) : 0;
+	if(error)
+		*error = err;
+	return err == EParseError::OK ? value : errorValue;
+}
 
-	if(numDigits > 0) {
-		if(error)
-			*error = EParseError::OK;
-		return (int)value*sign;
-	} else {
+int ParseInt(StringView str, int errorValue, int* nextChar, EParseError* error)
+{
+	if(str.IsEmpty()) {
+		if(nextChar)
+			*nextChar = 0;
 		if(error)
-			*error = EParseError::Error;
+			*error = EParseError::EmptyInput;
 		return errorValue;
 	}
+
+	int value;
+	EParseError err;
+	const char* end = ParseIntRaw(str.Data(), str.Data() + str.Size(), value, err);
+	if(nextChar)
+		*nextChar = end ? int(end - str.Data()) : 0;
+	if(error)
+		*error = err;
+	return err == EParseError::OK ? value : errorValue;
+}
+
+int ParseFloatArray(StringView str, float* out, int count, int* nextChar)
+{
+	return ParseArrayTempl(str, out, count, nextChar, ParseFloatRaw);
+}
+
+int ParseIntArray(StringView str, int* out, int count, int* nextChar)
+{
+	return ParseArrayTempl(str, out, count, nextChar, ParseIntRaw);
 }
 
 bool ParseBool(StringView str, bool errorValue, int* nextChar, EParseError* error)
@@ -192,7 +668,7 @@ bool ParseBool(StringView str, bool errorValue, int* nextChar, EParseError* erro
 	if(isTrue && nextChar)
 		*nextChar = 4;
 	bool isFalse = str.StartsWith("false", EStringCompare::CaseInsensitive);
-	if(isTrue && nextChar)
+	if(isFalse && nextChar)
 		*nextChar = 5;
 
 	if(error)
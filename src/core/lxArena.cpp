@@ -0,0 +1,116 @@
+#include "core/lxArena.h"
+
+namespace lux
+{
+namespace core
+{
+
+struct Arena::Block
+{
+	Block* next;
+	size_t size;
+};
+
+Arena::Arena(size_t blockSize) :
+	m_Current(nullptr),
+	m_BlockSize(blockSize),
+	m_Reserved(0),
+	m_UsedBefore(0),
+	m_Begin(0),
+	m_Cursor(0),
+	m_End(0)
+{
+}
+
+Arena::~Arena()
+{
+	FreeBlocks();
+}
+
+void Arena::FreeBlocks()
+{
+	while(m_Current) {
+		Block* next = m_Current->next;
+		::operator delete(m_Current);
+		m_Current = next;
+	}
+	m_Reserved = 0;
+	m_UsedBefore = 0;
+	m_Begin = m_Cursor = m_End = 0;
+}
+
+void Arena::Reset()
+{
+	if(m_Current && m_Current->next) {
+		// Replace all blocks by a single one, big enough for everything used
+		// until now, so the next cycle doesn't have to allocate anything.
+		size_t total = m_Reserved;
+		FreeBlocks();
+		AllocateSlow(total, 1);
+	}
+
+	m_UsedBefore = 0;
+	m_Cursor = m_Begin;
+}
+
+void* Arena::AllocateSlow(size_t bytes, size_t align)
+{
+	size_t size = sizeof(Block) + bytes + align;
+	if(size < m_BlockSize)
+		size = m_BlockSize;
+
+	Block* block = (Block*)::operator new(size);
+	block->next = m_Current;
+	block->size = size;
+	m_Current = block;
+	m_Reserved += size;
+
+	m_UsedBefore += m_Cursor - m_Begin;
+	m_Begin = m_Cursor = (size_t)(block + 1);
+	m_End = (size_t)block + size;
+
+	return Allocate(bytes, align);
+}
+
+namespace
+{
+struct ThreadFrameArena
+{
+	Arena arena;
+	int depth = 0;
+};
+
+thread_local ThreadFrameArena t_FrameArena;
+}
+
+Arena& FrameArena::Get()
+{
+	return t_FrameArena.arena;
+}
+
+void FrameArena::BeginFrame()
+{
+	++t_FrameArena.depth;
+}
+
+void FrameArena::EndFrame()
+{
+	auto& frame = t_FrameArena;
+	lxAssert(frame.depth > 0);
+	if(--frame.depth == 0)
+		frame.arena.Reset();
+}
+
+bool FrameArena::IsFrameOpen()
+{
+	return t_FrameArena.depth > 0;
+}
+
+FrameAllocator& FrameAllocator::Instance()
+{
+	static FrameAllocator instance;
+	return instance;
+}
+
+} // namespace core
+} // namespace lux
@@ -0,0 +1,437 @@
+#include "core/lxProfiler.h"
+#include "core/lxSTDIO.h"
+#include "core/lxSort.h"
+#include "core/StringConverter.h"
+#include "io/ioExceptions.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace lux
+{
+namespace core
+{
+
+namespace
+{
+
+struct ZoneEvent
+{
+	const ProfileZone* zone;
+	u64 begin;
+	u64 end;
+};
+
+struct CapturedZone
+{
+	const ProfileZone* zone;
+	u64 begin;
+	u64 end;
+	int thread;
+};
+
+//! Single producer single consumer ring buffer of a thread
+/**
+Only the owning thread writes, only the frame loop thread reads.
+If the buffer is full, new zones are dropped.
+*/
+struct ThreadBuffer
+{
+	static const u32 CAPACITY = 16 * 1024;
+
+	ZoneEvent events[CAPACITY];
+	std::atomic<u32> write;
+	std::atomic<u32> read;
+	std::atomic<int> dropped;
+	std::atomic<bool> finished; //!< Set when the owning thread exits
+	u32 cachedRead; //!< Last seen read position, only used by the writer
+
+	int index; //!< Index of the thread name
+
+	ThreadBuffer()
+	{
+		Reset(0);
+	}
+
+	void Reset(int newIndex)
+	{
+		write.store(0, std::memory_order_relaxed);
+		read.store(0, std::memory_order_relaxed);
+		dropped.store(0, std::memory_order_relaxed);
+		finished.store(false, std::memory_order_relaxed);
+		cachedRead = 0;
+		index = newIndex;
+	}
+};
+
+//! Marks the buffer of a thread as finished when the thread exits.
+struct ThreadBufferOwner
+{
+	ThreadBuffer* buffer = nullptr;
+
+	~ThreadBufferOwner()
+	{
+		if(buffer)
+			buffer->finished.store(true, std::memory_order_release);
+	}
+};
+
+struct ProfilerData
+{
+	//! Number of buffers of exited threads kept for new threads, the rest is freed
+	static const int MAX_FREE_BUFFERS = 4;
+
+	std::mutex threadLock;
+	core::Array<ThreadBuffer*> threads; //!< Buffers of running threads and of exited ones with unread zones
+	core::Array<ThreadBuffer*> freeBuffers;
+	core::Array<core::String> threadNames; //!< Names of all threads ever seen, indexed by ThreadBuffer::index
+
+	// Conversion of timestamps to microseconds.
+	u64 baseTimestamp;
+	std::chrono::steady_clock::time_point baseTime;
+	double ticksPerMicro;
+
+	u64 frameBegin;
+	ProfileFrame lastFrame;
+
+	bool capturing = false;
+	u64 captureBegin = 0;
+	core::Array<CapturedZone> capture;
+
+	// Temporary data to build the frame summary.
+	core::Array<ThreadBuffer*> frameThreads;
+	core::Array<ThreadBuffer*> finishedThreads;
+	core::Array<ZoneEvent> frameEvents;
+	struct BuildNode
+	{
+		int firstChild;
+		int nextSibling;
+	};
+	core::Array<BuildNode> buildNodes;
+	struct OpenZone
+	{
+		int node;
+		u64 end;
+	};
+	core::Array<OpenZone> stack;
+
+	ProfilerData()
+	{
+		baseTimestamp = Profiler::GetTimestamp();
+		baseTime = std::chrono::steady_clock::now();
+		frameBegin = baseTimestamp;
+#ifdef LUX_PROFILER_RDTSC
+		ticksPerMicro = 1000.0;
+#else
+		ticksPerMicro = (double)std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num / 1000000.0;
+#endif
+	}
+
+	~ProfilerData()
+	{
+		for(auto buffer : threads)
+			delete buffer;
+		for(auto buffer : freeBuffers)
+			delete buffer;
+	}
+
+	void Calibrate()
+	{
+#ifdef LUX_PROFILER_RDTSC
+		// The rate of the timestamp counter is unknown, compare it with the
+		// steady clock. The longer the profiler runs, the better the estimate.
+		u64 timestamp = Profiler::GetTimestamp();
+		auto micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - baseTime).count();
+		if(micros > 1000.0)
+			ticksPerMicro = (double)(timestamp - baseTimestamp) / micros;
+#endif
+	}
+
+	double ToMicros(u64 ticks) const
+	{
+		return (double)ticks / ticksPerMicro;
+	}
+};
+
+ProfilerData& GetData()
+{
+	static ProfilerData data;
+	return data;
+}
+
+// The buffer is read through a plain pointer, a thread_local with a
+// destructor is checked for initialization on every access, which was most
+// of the recording cost. The owner is only touched when the buffer is created.
+thread_local ThreadBuffer* t_ThreadBuffer = nullptr;
+thread_local ThreadBufferOwner t_ThreadBufferOwner;
+
+ThreadBuffer* CreateThreadBuffer()
+{
+	auto& data = GetData();
+	std::lock_guard<std::mutex> lock(data.threadLock);
+	ThreadBuffer* buffer;
+	if(data.freeBuffers.IsEmpty()) {
+		buffer = new ThreadBuffer;
+	} else {
+		buffer = data.freeBuffers.Back();
+		data.freeBuffers.PopBack();
+	}
+	buffer->Reset(data.threadNames.Size());
+	auto& name = data.threadNames.EmplaceBack("Thread ");
+	core::StringConverter::AppendIntToString(name, buffer->index);
+	data.threads.PushBack(buffer);
+	t_ThreadBufferOwner.buffer = buffer;
+	t_ThreadBuffer = buffer;
+	return buffer;
+}
+
+inline ThreadBuffer* GetThreadBuffer()
+{
+	ThreadBuffer* buffer = t_ThreadBuffer;
+	return buffer ? buffer : CreateThreadBuffer();
+}
+
+void WriteJSONString(FILE* file, const char* str)
+{
+	fputc('"', file);
+	for(; *str; ++str) {
+		char c = *str;
+		if(c == '"' || c == '\\')
+			fputc('\\', file);
+		if((unsigned char)c < 0x20)
+			c = ' ';
+		fputc(c, file);
+	}
+	fputc('"', file);
+}
+
+} // anonymous namespace
+
+void Profiler::RecordZone(const ProfileZone* zone, u64 begin, u64 end)
+{
+	ThreadBuffer* buffer = GetThreadBuffer();
+	u32 write = buffer->write.load(std::memory_order_relaxed);
+	if(write - buffer->cachedRead >= ThreadBuffer::CAPACITY) {
+		// Only look at the reader if the buffer seems full.
+		buffer->cachedRead = buffer->read.load(std::memory_order_acquire);
+		if(write - buffer->cachedRead >= ThreadBuffer::CAPACITY) {
+			buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+	buffer->events[write % ThreadBuffer::CAPACITY] = ZoneEvent{zone, begin, end};
+	buffer->write.store(write + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(core::StringView name)
+{
+	auto buffer = GetThreadBuffer();
+	auto& data = GetData();
+	std::lock_guard<std::mutex> lock(data.threadLock);
+	data.threadNames[buffer->index] = name;
+}
+
+int Profiler::GetThreadCount()
+{
+	auto& data = GetData();
+	std::lock_guard<std::mutex> lock(data.threadLock);
+	return data.threadNames.Size();
+}
+
+core::String Profiler::GetThreadName(int thread)
+{
+	auto& data = GetData();
+	std::lock_guard<std::mutex> lock(data.threadLock);
+	return data.threadNames.At(thread);
+}
+
+void Profiler::NextFrame()
+{
+	auto& data = GetData();
+	u64 frameEnd = GetTimestamp();
+	data.Calibrate();
+
+	auto& frame = data.lastFrame;
+	frame.frameIndex++;
+	frame.durationMicros = data.ToMicros(frameEnd - data.frameBegin);
+	frame.droppedEvents = 0;
+	frame.nodes.Clear();
+	data.buildNodes.Clear();
+
+	// Threads created while collecting are picked up in the next frame.
+	data.frameThreads.Clear();
+	data.finishedThreads.Clear();
+	{
+		std::lock_guard<std::mutex> lock(data.threadLock);
+		data.frameThreads = data.threads;
+	}
+
+	for(int i = 0; i < data.frameThreads.Size(); ++i) {
+		ThreadBuffer* buffer = data.frameThreads[i];
+		const int t = buffer->index;
+		frame.droppedEvents += buffer->dropped.exchange(0, std::memory_order_relaxed);
+
+		// Take all zones finished before the end of the frame, they are
+		// stored in the order they finished.
+		// The finished flag is read first, so write is final if it's set.
+		const bool finished = buffer->finished.load(std::memory_order_acquire);
+		data.frameEvents.Clear();
+		u32 read = buffer->read.load(std::memory_order_relaxed);
+		u32 write = buffer->write.load(std::memory_order_acquire);
+		for(; read != write; ++read) {
+			auto& e = buffer->events[read % ThreadBuffer::CAPACITY];
+			if(e.end > frameEnd)
+				break;
+			data.frameEvents.PushBack(e);
+			if(data.capturing)
+				data.capture.PushBack(CapturedZone{e.zone, e.begin, e.end, t});
+		}
+		buffer->read.store(read, std::memory_order_release);
+		if(finished && read == write)
+			data.finishedThreads.PushBack(buffer);
+
+		// Outer zones first.
+		core::Sort(data.frameEvents, core::CompareTypeFromSmaller<ZoneEvent>([](const ZoneEvent& a, const ZoneEvent& b) {
+			return a.begin < b.begin || (a.begin == b.begin && a.end > b.end);
+		}));
+
+		// Rebuild the nesting, zones with the same parent and zone are merged.
+		data.stack.Clear();
+		int firstRoot = -1;
+		for(auto& e : data.frameEvents) {
+			while(!data.stack.IsEmpty() && data.stack.Back().end <= e.begin)
+				data.stack.PopBack();
+
+			int parent = data.stack.IsEmpty() ? -1 : data.stack.Back().node;
+			int first = parent < 0 ? firstRoot : data.buildNodes[parent].firstChild;
+			int node = first;
+			while(node >= 0 && frame.nodes[node].zone != e.zone)
+				node = data.buildNodes[node].nextSibling;
+			if(node < 0) {
+				node = frame.nodes.Size();
+				ProfileNode n;
+				n.zone = e.zone;
+				n.parent = parent;
+				n.depth = data.stack.Size();
+				n.thread = t;
+				n.calls = 0;
+				n.totalMicros = 0;
+				n.selfMicros = 0;
+				frame.nodes.PushBack(n);
+				data.buildNodes.PushBack(ProfilerData::BuildNode{-1, first});
+				if(parent < 0)
+					firstRoot = node;
+				else
+					data.buildNodes[parent].firstChild = node;
+			}
+
+			double micros = data.ToMicros(e.end - e.begin);
+			auto& n = frame.nodes[node];
+			n.calls++;
+			n.totalMicros += micros;
+			n.selfMicros += micros;
+			if(parent >= 0)
+				frame.nodes[parent].selfMicros -= micros;
+
+			data.stack.PushBack(ProfilerData::OpenZone{node, e.end});
+		}
+	}
+
+	// Recycle the buffers of exited threads, once all their zones are read.
+	if(!data.finishedThreads.IsEmpty()) {
+		std::lock_guard<std::mutex> lock(data.threadLock);
+		for(auto buffer : data.finishedThreads) {
+			data.threads.EraseValue(buffer);
+			if(data.freeBuffers.Size() < ProfilerData::MAX_FREE_BUFFERS)
+				data.freeBuffers.PushBack(buffer);
+			else
+				delete buffer;
+		}
+	}
+
+	data.frameBegin = frameEnd;
+}
+
+const ProfileFrame& Profiler::GetLastFrame()
+{
+	return GetData().lastFrame;
+}
+
+void Profiler::BeginCapture()
+{
+	auto& data = GetData();
+	data.capture.Clear();
+	data.captureBegin = GetTimestamp();
+	data.capturing = true;
+}
+
+void Profiler::EndCapture()
+{
+	GetData().capturing = false;
+}
+
+bool Profiler::IsCapturing()
+{
+	return GetData().capturing;
+}
+
+void Profiler::ExportChromeTrace(const core::String& path)
+{
+	auto& data = GetData();
+	FILE* file = core::FOpenUTF8(path.Data(), "wb");
+	if(!file)
+		throw io::FileNotFoundException(path.AsView());
+
+	fputs("{\"traceEvents\":[\n", file);
+	int threadCount = GetThreadCount();
+	for(int t = 0; t < threadCount; ++t) {
+		fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":", t);
+		WriteJSONString(file, GetThreadName(t).Data());
+		fputs("}},\n", file);
+	}
+	for(int i = 0; i < data.capture.Size(); ++i) {
+		auto& e = data.capture[i];
+		// Zones started before the capture are clamped.
+		u64 begin = e.begin > data.captureBegin ? e.begin - data.captureBegin : 0;
+		u64 end = e.end > data.captureBegin ? e.end - data.captureBegin : 0;
+		fputs("{\"name\":", file);
+		WriteJSONString(file, e.zone->name);
+		fprintf(file, ",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"file\":",
+			e.thread, data.ToMicros(begin), data.ToMicros(end - begin));
+		WriteJSONString(file, e.zone->file);
+		fprintf(file, ",\"line\":%d}}%s\n", e.zone->line, i + 1 < data.capture.Size() ? "," : "");
+	}
+	fputs("],\"displayTimeUnit\":\"ms\"}\n", file);
+	fclose(file);
+}
+
+void Profiler::ExportFrameSummary(const core::String& path)
+{
+	auto& frame = GetData().lastFrame;
+	FILE* file = core::FOpenUTF8(path.Data(), "wb");
+	if(!file)
+		throw io::FileNotFoundException(path.AsView());
+
+	fprintf(file, "{\"frame\":%u,\"duration\":%.3f,\"dropped\":%d,\"threads\":[",
+		frame.frameIndex, frame.durationMicros, frame.droppedEvents);
+	int threadCount = GetThreadCount();
+	for(int t = 0; t < threadCount; ++t) {
+		if(t != 0)
+			fputc(',', file);
+		WriteJSONString(file, GetThreadName(t).Data());
+	}
+	fputs("],\"zones\":[\n", file);
+	for(int i = 0; i < frame.nodes.Size(); ++i) {
+		auto& n = frame.nodes[i];
+		fputs("{\"name\":", file);
+		WriteJSONString(file, n.zone->name);
+		fprintf(file, ",\"parent\":%d,\"depth\":%d,\"thread\":%d,\"calls\":%d,\"total\":%.3f,\"self\":%.3f}%s\n",
+			n.parent, n.depth, n.thread, n.calls, n.totalMicros, n.selfMicros,
+			i + 1 < frame.nodes.Size() ? "," : "");
+	}
+	fputs("]}\n", file);
+	fclose(file);
+}
+
+} // namespace core
+} // namespace lux
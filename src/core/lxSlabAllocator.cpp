@@ -0,0 +1,182 @@
+#include "core/lxSlabAllocator.h"
+
+namespace lux
+{
+namespace core
+{
+
+struct SlabAllocator::Slab
+{
+	struct FreeEntry
+	{
+		FreeEntry* next;
+	};
+
+	u8* begin;
+	u8* end;
+	FreeEntry* free;
+	int used;
+	bool isAvailable;
+};
+
+SlabAllocator::SlabAllocator(size_t objectSize, int objectsPerSlab) :
+	m_ObjectSize(objectSize),
+	m_ObjectsPerSlab(objectsPerSlab),
+	m_Used(0)
+{
+	lxAssert(objectsPerSlab > 0);
+
+	// Each free object must be able to store the free list pointer.
+	const size_t align = sizeof(void*) > 8 ? sizeof(void*) : 8;
+	if(m_ObjectSize < sizeof(void*))
+		m_ObjectSize = sizeof(void*);
+	m_ObjectSize = (m_ObjectSize + align - 1) & ~(align - 1);
+}
+
+SlabAllocator::~SlabAllocator()
+{
+	for(auto slab : m_Slabs) {
+		::operator delete(slab->begin);
+		delete slab;
+	}
+}
+
+void* SlabAllocator::Allocate(const void* neighbour)
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	if(neighbour) {
+		Slab* slab = FindSlab(neighbour);
+		if(slab && slab->free)
+			return AllocateFrom(slab);
+	}
+
+	while(!m_Available.IsEmpty()) {
+		Slab* slab = m_Available.Back();
+		if(slab->free)
+			return AllocateFrom(slab);
+		slab->isAvailable = false;
+		m_Available.PopBack();
+	}
+
+	return AllocateFrom(CreateSlab());
+}
+
+void SlabAllocator::Free(void* ptr)
+{
+	if(!ptr)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	Slab* slab = FindSlab(ptr);
+	lxAssert(slab);
+
+	auto entry = (Slab::FreeEntry*)ptr;
+	entry->next = slab->free;
+	slab->free = entry;
+	--slab->used;
+	--m_Used;
+
+	if(!slab->isAvailable) {
+		slab->isAvailable = true;
+		m_Available.PushBack(slab);
+	}
+}
+
+bool SlabAllocator::Owns(const void* ptr) const
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+	return FindSlab(ptr) != nullptr;
+}
+
+void SlabAllocator::ReleaseEmptySlabs()
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	core::Array<Slab*> remaining;
+	for(auto slab : m_Slabs) {
+		if(slab->used == 0) {
+			::operator delete(slab->begin);
+			delete slab;
+		} else {
+			remaining.PushBack(slab);
+		}
+	}
+	m_Slabs = std::move(remaining);
+
+	m_Available.Clear();
+	for(auto slab : m_Slabs) {
+		slab->isAvailable = slab->free != nullptr;
+		if(slab->isAvailable)
+			m_Available.PushBack(slab);
+	}
+}
+
+SlabAllocator::Statistics SlabAllocator::GetStatistics() const
+{
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	Statistics out;
+	out.slabCount = m_Slabs.Size();
+	out.capacity = m_Slabs.Size() * m_ObjectsPerSlab;
+	out.used = m_Used;
+	return out;
+}
+
+SlabAllocator::Slab* SlabAllocator::FindSlab(const void* ptr) const
+{
+	// Binary search for the last slab starting before ptr.
+	int first = 0;
+	int last = m_Slabs.Size();
+	while(first < last) {
+		int mid = (first + last) / 2;
+		if(m_Slabs[mid]->begin <= (const u8*)ptr)
+			first = mid + 1;
+		else
+			last = mid;
+	}
+	if(first == 0)
+		return nullptr;
+	Slab* slab = m_Slabs[first - 1];
+	return (const u8*)ptr < slab->end ? slab : nullptr;
+}
+
+SlabAllocator::Slab* SlabAllocator::CreateSlab()
+{
+	Slab* slab = new Slab;
+	size_t size = m_ObjectSize * m_ObjectsPerSlab;
+	slab->begin = (u8*)::operator new(size);
+	slab->end = slab->begin + size;
+	slab->used = 0;
+
+	// Build the free list in address order.
+	slab->free = nullptr;
+	for(int i = m_ObjectsPerSlab - 1; i >= 0; --i) {
+		auto entry = (Slab::FreeEntry*)(slab->begin + i * m_ObjectSize);
+		entry->next = slab->free;
+		slab->free = entry;
+	}
+
+	// Keep the slabs sorted by address.
+	int pos = 0;
+	while(pos < m_Slabs.Size() && m_Slabs[pos]->begin < slab->begin)
+		++pos;
+	m_Slabs.Insert(slab, pos);
+
+	slab->isAvailable = true;
+	m_Available.PushBack(slab);
+	return slab;
+}
+
+void* SlabAllocator::AllocateFrom(Slab* slab)
+{
+	auto entry = slab->free;
+	slab->free = entry->next;
+	++slab->used;
+	++m_Used;
+	return entry;
+}
+
+} // namespace core
+} // namespace lux
@@ -1,5 +1,12 @@
 #include "core/lxUnicode.h"
 #include "core/lxException.h"
+#include <cstring>
+
+#if defined(LUX_CORE_NO_SIMD)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LUX_UNICODE_SSE
+#include <emmintrin.h>
+#endif
 
 extern "C"
 {
@@ -26,6 +33,38 @@ int StringLengthUTF8(const char* str, int* outBytes)
 	return len;
 }
 
+int CodePointCountUTF8(const char* str, int size)
+{
+	// Count the continuation bytes, every other byte starts a codepoint.
+	const u8* s = (const u8*)str;
+	int continuation = 0;
+	int i = 0;
+#ifdef LUX_UNICODE_SSE
+	// Continuation bytes are 0x80 to 0xBF, i.e. signed -128 to -65.
+	const __m128i limit = _mm_set1_epi8(-64);
+	for(; i + 16 <= size; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+		u32 mask = (u32)_mm_movemask_epi8(_mm_cmplt_epi8(v, limit));
+		mask = mask - ((mask >> 1) & 0x5555);
+		mask = (mask & 0x3333) + ((mask >> 2) & 0x3333);
+		mask = (mask + (mask >> 4)) & 0x0F0F;
+		continuation += (int)((mask + (mask >> 8)) & 0x1F);
+	}
+#endif
+	for(; i + 8 <= size; i += 8) {
+		u64 block;
+		std::memcpy(&block, s + i, 8);
+		u64 mask = (block & ~(block << 1)) & 0x8080808080808080ull;
+		continuation += (int)(((mask >> 7) * 0x0101010101010101ull) >> 56);
+	}
+	for(; i < size; ++i) {
+		if((s[i] & 0xC0) == 0x80)
+			++continuation;
+	}
+
+	return size - continuation;
+}
+
 void RetractCursorUTF8(const char*& ptr)
 {
 	--ptr;
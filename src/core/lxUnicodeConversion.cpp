@@ -1,43 +1,213 @@
 #include "core/lxUnicodeConversion.h"
 #include "core/lxUnicode.h"
+#include <cstring>
+
+#if defined(LUX_CORE_NO_SIMD)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LUX_UNICODE_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LUX_UNICODE_NEON
+#include <arm_neon.h>
+#endif
 
 namespace lux
 {
 namespace core
 {
 
-Array<u8> UTF16ToUTF8(const void* _data, int size)
+namespace
 {
-	auto data = (const char*)_data;
-	auto end = data+size;
-	Array<u8> out;
-	u8 buffer[4];
-	while(data != end) {
-		u32 c = AdvanceCursorUTF16(data);
-		if(size == -1 && !c)
+const u64 ASCII_MASK = 0x8080808080808080ull;
+
+// Copy the leading ascii bytes of src into dst, widened to the element type.
+// Returns the number of copied bytes.
+template <typename T>
+int CopyASCII(const u8* src, int size, T* dst)
+{
+	int i = 0;
+#if defined(LUX_UNICODE_SSE)
+	const __m128i zero = _mm_setzero_si128();
+	for(; i + 16 <= size; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+		if(_mm_movemask_epi8(v))
+			break;
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+		if(sizeof(T) == 2) {
+			_mm_storeu_si128((__m128i*)(dst + i), lo);
+			_mm_storeu_si128((__m128i*)(dst + i + 8), hi);
+		} else {
+			_mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi16(lo, zero));
+			_mm_storeu_si128((__m128i*)(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+			_mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+			_mm_storeu_si128((__m128i*)(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+		}
+	}
+#elif defined(LUX_UNICODE_NEON)
+	for(; i + 16 <= size; i += 16) {
+		uint8x16_t v = vld1q_u8(src + i);
+		uint8x8_t any = vorr_u8(vget_low_u8(v), vget_high_u8(v));
+		if(vget_lane_u64(vreinterpret_u64_u8(any), 0) & ASCII_MASK)
+			break;
+		uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+		uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+		if(sizeof(T) == 2) {
+			vst1q_u16((uint16_t*)(dst + i), lo);
+			vst1q_u16((uint16_t*)(dst + i + 8), hi);
+		} else {
+			vst1q_u32((uint32_t*)(dst + i), vmovl_u16(vget_low_u16(lo)));
+			vst1q_u32((uint32_t*)(dst + i + 4), vmovl_u16(vget_high_u16(lo)));
+			vst1q_u32((uint32_t*)(dst + i + 8), vmovl_u16(vget_low_u16(hi)));
+			vst1q_u32((uint32_t*)(dst + i + 12), vmovl_u16(vget_high_u16(hi)));
+		}
+	}
+#endif
+	for(; i < size && src[i] < 0x80; ++i)
+		dst[i] = (T)src[i];
+	return i;
+}
+
+// The number of leading ascii bytes.
+int CountASCII(const u8* src, int size)
+{
+	int i = 0;
+#if defined(LUX_UNICODE_SSE)
+	for(; i + 16 <= size; i += 16) {
+		if(_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(src + i))))
+			break;
+	}
+#endif
+	for(; i + 8 <= size; i += 8) {
+		u64 block;
+		std::memcpy(&block, src + i, 8);
+		if(block & ASCII_MASK)
+			break;
+	}
+	while(i < size && src[i] < 0x80)
+		++i;
+	return i;
+}
+
+// Decode a single codepoint, the data must be valid utf8.
+u32 DecodeUTF8(const u8*& ptr, const u8* end)
+{
+	u8 u0 = *ptr;
+	int length = u0 < 0xE0 ? 2 : (u0 < 0xF0 ? 3 : 4);
+	if(u0 < 0xC0 || u0 >= 0xF8 || end - ptr < length)
+		throw UnicodeException(u0);
+	u32 c;
+	if(length == 2)
+		c = (u0 & 0x1F) << 6 | (ptr[1] & 0x3F);
+	else if(length == 3)
+		c = (u0 & 0x0F) << 12 | (ptr[1] & 0x3F) << 6 | (ptr[2] & 0x3F);
+	else
+		c = (u0 & 0x07) << 18 | (ptr[1] & 0x3F) << 12 | (ptr[2] & 0x3F) << 6 | (ptr[3] & 0x3F);
+	ptr += length;
+	return c;
+}
+
+// Convert little endian utf16 data to utf8.
+// Stops when the input is consumed or less than 4 bytes are left in dst.
+// Returns the number of written bytes.
+int EncodeUTF8(const u8*& src, const u8* end, u8* dst, int dstSize)
+{
+	u8* cur = dst;
+	u8* dstEnd = dst + dstSize;
+	while(end - src >= 2 && dstEnd - cur >= 4) {
+#if defined(LUX_UNICODE_SSE)
+		// Eight ascii units at once.
+		const __m128i highBits = _mm_set1_epi16((short)0xFF80);
+		const __m128i zero = _mm_setzero_si128();
+		while(end - src >= 16 && dstEnd - cur >= 8) {
+			__m128i v = _mm_loadu_si128((const __m128i*)src);
+			if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, highBits), zero)) != 0xFFFF)
+				break;
+			_mm_storel_epi64((__m128i*)cur, _mm_packus_epi16(v, v));
+			src += 16;
+			cur += 8;
+		}
+		if(end - src < 2 || dstEnd - cur < 4)
+			break;
+#endif
+		if(src[1] == 0 && src[0] < 0x80) {
+			*cur++ = src[0];
+			src += 2;
+			continue;
+		}
+		if(end - src < 4) {
+			u16 h = (u16)(src[0] | src[1] << 8);
+			if(h >= 0xD800 && h <= 0xDFFF)
+				throw UnicodeException(h);
+		}
+		const char* ptr = (const char*)src;
+		u32 c = AdvanceCursorUTF16(ptr);
+		src = (const u8*)ptr;
+		cur += CodePointToUTF8(c, cur);
+	}
+	return int(cur - dst);
+}
+
+int UTF16Size(const void* data, int size)
+{
+	if(size != -1)
+		return size;
+	const u8* ptr = (const u8*)data;
+	int out = 0;
+	while(ptr[out] || ptr[out + 1])
+		out += 2;
+	return out;
+}
+
+template <typename T>
+int DecodeUTF8Bulk(const u8* src, int size, T* dst)
+{
+	const u8* end = src + size;
+	T* cur = dst;
+	while(src != end) {
+		int ascii = CopyASCII(src, int(end - src), cur);
+		src += ascii;
+		cur += ascii;
+		if(src == end)
 			break;
-		u8* cur = buffer;
-		int bytes = CodePointToUTF8(c, cur);
-		for(int i = 0; i < bytes; ++i)
-			out.PushBack(*cur++);
+		u32 c = DecodeUTF8(src, end);
+		if(sizeof(T) == 4) {
+			*cur++ = (T)c;
+		} else {
+			int bytes = CodePointToUTF16(c, cur);
+			cur += bytes / 2;
+		}
 	}
+	return int(cur - dst);
+}
+
+} // anonymous namespace
+
+Array<u8> UTF16ToUTF8(const void* _data, int size)
+{
+	size = UTF16Size(_data, size);
+	auto data = (const u8*)_data;
+	Array<u8> out;
+	// Each utf16 unit needs at most three bytes.
+	out.Resize((size / 2) * 3 + 4);
+	int bytes = EncodeUTF8(data, data + size, out.Data(), out.Size());
+	out.Resize(bytes);
 	return out;
 }
 
 core::String UTF16ToString(const void* _data, int size)
 {
-	auto data = (const char*)_data;
-	auto end = data+size;
+	size = UTF16Size(_data, size);
+	auto data = (const u8*)_data;
+	auto end = data + size;
 	core::String out;
+	out.Reserve((size / 2) + 1);
+	u8 buffer[512];
 	while(data != end) {
-		u32 c = AdvanceCursorUTF16(data);
-		if(size == -1 && !c)
+		int bytes = EncodeUTF8(data, end, buffer, sizeof(buffer));
+		if(bytes == 0)
 			break;
-		u8 buffer[4];
-		u8* cur = buffer;
-		int bytes = CodePointToUTF8(c, cur);
-		for(int i = 0; i < bytes; ++i)
-			out.AppendByte(*cur++);
+		out.Append((const char*)buffer, bytes);
 	}
 
 	return out;
@@ -45,20 +215,77 @@ core::String UTF16ToString(const void* _data, int size)
 
 Array<u16>& UTF8ToUTF16(const void* _data, int size, Array<u16>& out)
 {
-	const char* data = (const char*)_data;
-	auto end = data+size;
-	while(data != end) {
-		u32 c = AdvanceCursorUTF8(data);
-		if(size == -1 && !c)
+	if(size == -1)
+		size = (int)std::strlen((const char*)_data);
+	// Utf16 never needs more units than utf8 needs bytes.
+	int base = out.Size();
+	out.Resize(base + size);
+	int count = DecodeUTF8Bulk((const u8*)_data, size, out.Data() + base);
+	out.Resize(base + count);
+
+	return out;
+}
+
+Array<u32>& UTF8ToUTF32(const void* _data, int size, Array<u32>& out)
+{
+	if(size == -1)
+		size = (int)std::strlen((const char*)_data);
+	int base = out.Size();
+	out.Resize(base + size);
+	int count = DecodeUTF8Bulk((const u8*)_data, size, out.Data() + base);
+	out.Resize(base + count);
+
+	return out;
+}
+
+bool IsValidUTF8(const void* _data, int size, int* errorOffset)
+{
+	auto data = (const u8*)_data;
+	int i = 0;
+	while(i < size) {
+		i += CountASCII(data + i, size - i);
+		if(i == size)
 			break;
-		u16 buffer[2];
-		int bytes = CodePointToUTF16(c, buffer);
-		out.PushBack(buffer[0]);
-		if(bytes == 4)
-			out.PushBack(buffer[1]);
+
+		// Multibyte sequences, see the table in chapter 3.9 of the unicode standard.
+		const u8* s = data + i;
+		int remain = size - i;
+		u8 u0 = s[0];
+		int length;
+		u8 min = 0x80;
+		u8 max = 0xBF;
+		if(u0 < 0xC2) {
+			length = 0;
+		} else if(u0 < 0xE0) {
+			length = 2;
+		} else if(u0 < 0xF0) {
+			length = 3;
+			if(u0 == 0xE0)
+				min = 0xA0; // Overlong
+			else if(u0 == 0xED)
+				max = 0x9F; // Surrogates
+		} else if(u0 < 0xF5) {
+			length = 4;
+			if(u0 == 0xF0)
+				min = 0x90; // Overlong
+			else if(u0 == 0xF4)
+				max = 0x8F; // Above 0x10FFFF
+		} else {
+			length = 0;
+		}
+
+		bool valid = length != 0 && remain >= length && s[1] >= min && s[1] <= max;
+		for(int j = 2; valid && j < length; ++j)
+			valid = (s[j] & 0xC0) == 0x80;
+		if(!valid) {
+			if(errorOffset)
+				*errorOffset = i;
+			return false;
+		}
+		i += length;
 	}
 
-	return out;
+	return true;
 }
 
 int CodePointToUTF8(u32 c, void* _dst)
@@ -89,17 +316,15 @@ int CodePointToUTF8(u32 c, void* _dst)
 }
 
 int CodePointToUTF16(u32 c, void* _dst)
-{	
+{
 	u16* dst = (u16*)_dst;
-	if(c < 0xFFFF) {
+	if(c <= 0xFFFF) {
 		dst[0] = (u16)c;
 		return 2;
-	} else if(c <= 0x1FFFFF) {
+	} else if(c <= 0x10FFFF) {
 		c -= 0x10000;
-		u16 h = 0xD800 | (c & 0x3FF);
-		uint16_t l = 0xDC00 | ((c >> 10) & 0x3FF);
-		dst[0] = h;
-		dst[1]= l;
+		dst[0] = (u16)(0xD800 | (c >> 10));
+		dst[1] = (u16)(0xDC00 | (c & 0x3FF));
 		return 4;
 	} else {
 		throw UnicodeException(c);
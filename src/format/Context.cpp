@@ -112,7 +112,7 @@ void Context::EndWorkingSlice(Slice slice, int usedSize)
 
 FormatEntry* Context::GetFormatEntry(int id)
 {
-	if(id > m_FormatEntriesCount)
+	if(id < 0 || id >= m_FormatEntriesCount)
 		throw syntax_exception("Not enough arguments", size_t(id));
 	return (FormatEntry*)((char*)m_FormatEntries + m_FormatEntryStride * id);
 }
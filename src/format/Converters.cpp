@@ -73,6 +73,13 @@ static void PutCharacter(Context& ctx, bool sign, uint32_t value, bool longForm)
 	}
 }
 
+// The absolute value, also for the smallest value of a signed type.
+template <typename U, typename T>
+static U Magnitude(T value)
+{
+	return value < 0 ? U(0) - U(value) : U(value);
+}
+
 template <typename T>
 static void PutIntTempl(Context& ctx, bool sign, T value, const Placeholder& placeholder)
 {
@@ -108,28 +115,28 @@ void fmtPrint(Context& ctx, const char* data, const Placeholder& placeholder)
 
 void fmtPrint(Context& ctx, char data, const Placeholder& placeholder)
 {
-	PutIntTempl<unsigned int>(ctx, data < 0, std::abs(data), placeholder);
+	PutIntTempl<unsigned int>(ctx, data < 0, Magnitude<unsigned int>(data), placeholder);
 }
 
 void fmtPrint(Context& ctx, signed char data, const Placeholder& placeholder)
 {
-	PutIntTempl<unsigned int>(ctx, data < 0, std::abs(data), placeholder);
+	PutIntTempl<unsigned int>(ctx, data < 0, Magnitude<unsigned int>(data), placeholder);
 }
 void fmtPrint(Context& ctx, signed short data, const Placeholder& placeholder)
 {
-	PutIntTempl<unsigned int>(ctx, data < 0, std::abs(data), placeholder);
+	PutIntTempl<unsigned int>(ctx, data < 0, Magnitude<unsigned int>(data), placeholder);
 }
 void fmtPrint(Context& ctx, signed int data, const Placeholder& placeholder)
 {
-	PutIntTempl<unsigned int>(ctx, data < 0, std::abs(data), placeholder);
+	PutIntTempl<unsigned int>(ctx, data < 0, Magnitude<unsigned int>(data), placeholder);
 }
 void fmtPrint(Context& ctx, signed long data, const Placeholder& placeholder)
 {
-	PutIntTempl<unsigned long>(ctx, data < 0, std::abs(data), placeholder);
+	PutIntTempl<unsigned long>(ctx, data < 0, Magnitude<unsigned long>(data), placeholder);
 }
 void fmtPrint(Context& ctx, signed long long data, const Placeholder& placeholder)
 {
-	PutIntTempl<unsigned long long>(ctx, data < 0, abs(data), placeholder);
+	PutIntTempl<unsigned long long>(ctx, data < 0, Magnitude<unsigned long long>(data), placeholder);
 }
 
 void fmtPrint(Context& ctx, unsigned char data, const Placeholder& placeholder)
@@ -163,7 +170,8 @@ void fmtPrint(Context& ctx, const void* data, const Placeholder& placeholder)
 	}
 }
 
-void fmtPrint(Context& ctx, double data, const Placeholder& placeholder)
+template <typename T>
+static void PutFloatTempl(Context& ctx, T data, const Placeholder& placeholder)
 {
 	auto pl = parser::BasicPlaceholder::Parse(placeholder.format, ctx, ctx.GetCurArgId());
 	if(pl.dot.IsEnabled() && !pl.dot.HasValue())
@@ -178,11 +186,14 @@ void fmtPrint(Context& ctx, double data, const Placeholder& placeholder)
 
 	bool forcePrecision = pl.star.IsEnabled();
 
-	if(placeholder.type == 'f' || placeholder.type.size == 0) {
+	if(placeholder.type == 'f' || placeholder.type == 'r' || placeholder.type.size == 0) {
 		bool sign = (data < 0);
 		if(sign || pl.plus.IsEnabled())
 			ctx.AddSlice(sign ? facet.Minus : facet.Plus);
 
+		// Round trip: The shortest digits reading back as the same number.
+		if(placeholder.type == 'r')
+			digits = -1;
 		PutFloat(ctx, sign ? -data : data, digits, forcePrecision, facet);
 	} else if(placeholder.type == 'h') {
 		if(pl.hash.IsEnabled())
@@ -197,14 +208,19 @@ void fmtPrint(Context& ctx, double data, const Placeholder& placeholder)
 	}
 }
 
+void fmtPrint(Context& ctx, double data, const Placeholder& placeholder)
+{
+	PutFloatTempl(ctx, data, placeholder);
+}
+
 void fmtPrint(Context& ctx, float data, const Placeholder& placeholder)
 {
-	fmtPrint(ctx, (double)data, placeholder);
+	PutFloatTempl(ctx, data, placeholder);
 }
 
 void fmtPrint(Context& ctx, long double data, const Placeholder& placeholder)
 {
-	fmtPrint(ctx, (double)data, placeholder);
+	PutFloatTempl(ctx, (double)data, placeholder);
 }
 
 void fmtPrint(Context& ctx, bool data, const Placeholder& placeholder)
@@ -2,6 +2,9 @@
 #include "format/UnicodeConversion.h"
 #include "format/GeneralParsing.h"
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 namespace format
 {
@@ -15,49 +18,48 @@ static void ReverseString(char* s, int len)
 	}
 }
 
-static double GetPow10(int i)
-{
-	static const double table[23] = {
-		0.00000000001,
-		0.0000000001,
-		0.000000001,
-		0.00000001,
-		0.0000001,
-		0.000001,
-		0.00001,
-		0.0001,
-		0.001,
-		0.01,
-		0.1,
-		1.0,
-		10.0,
-		100.0,
-		1000.0,
-		10000.0,
-		100000.0,
-		1000000.0,
-		10000000.0,
-		100000000.0,
-		1000000000.0,
-		10000000000.0,
-		100000000000.0,
-	};
-
-	if(i >= -11 && i <= 11)
-		return table[i + 11];
-	else
-		return pow(10, i);
-}
+static const char DIGIT_PAIRS[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+int UIntToDecimal(uint64_t n, char* s)
+{
+	// Write two digits at once from the back, then move to the front.
+	char buffer[20];
+	char* c = buffer + 20;
+	while(n >= 100) {
+		auto pair = (n % 100) * 2;
+		n /= 100;
+		*--c = DIGIT_PAIRS[pair + 1];
+		*--c = DIGIT_PAIRS[pair];
+	}
+	if(n >= 10) {
+		*--c = DIGIT_PAIRS[n * 2 + 1];
+		*--c = DIGIT_PAIRS[n * 2];
+	} else {
+		*--c = char('0' + n);
+	}
 
-// sign pre.postEexp
-// MAX_INT_LEN + 1 + digits + 1 + MAX_INT_LEN
-// 11 + 1 + 11 + 1= 24
-//static size_t MAX_DOUBLE_LEN = 24;
+	int len = int(buffer + 20 - c);
+	std::memcpy(s, c, len);
+	return len;
+}
 
 //! Convert a unsigned interger to an ASCII string
 template <typename T>
 int IntToStringTempl(T n, char* s, int base)
 {
+	if(base == 10)
+		return UIntToDecimal(n, s);
+
 	if(base > 10 + 26 || base < 2)
 		return 0;
 
@@ -76,144 +78,486 @@ int IntToStringTempl(T n, char* s, int base)
 }
 
 /*
-for Not a number nan is written
-for infinite +inf or -inf is written.
-For number bigger than 10^13 or smaller than 10^-9 expontial notation is used in format 12.34e+5
-
-The last rule implies that the precomma part has at most 13 digits.
+Shortest digits of floating point numbers.
+Uses the Grisu2 algorithm by Florian Loitsch, "Printing Floating-Point Numbers
+Quickly and Accurately with Integers". The generated digits always read back
+as the same number, and are the shortest possible in nearly all cases.
 */
-void PutFloat(Context& ctx, double n, int digits, bool forcePrecision, const Facet_NumericalFormat& locale)
+namespace
 {
-	if(digits < 0 || digits >= 10)
-		return;
+struct DiyFp
+{
+	uint64_t f;
+	int e;
 
-	char BUFFER[32];
-	char* s = BUFFER;
+	DiyFp(uint64_t _f, int _e) :
+		f(_f),
+		e(_e)
+	{
+	}
 
-	if(std::isnan(n)) {
-		ctx.AddSlice(locale.NaN);
-	} else if(std::isinf(n)) {
-		if(n < 0)
-			ctx.AddSlice(locale.Minus);
+	static DiyFp Sub(const DiyFp& x, const DiyFp& y)
+	{
+		return DiyFp(x.f - y.f, x.e);
+	}
 
-		ctx.AddSlice(locale.Inf);
-	} else if(n == 0) {
-		ctx.AddSlice(1, "0");
-		if(forcePrecision && digits > 0) {
-			ctx.AddSlice(locale.Comma);
-			PutZeros(ctx, digits);
-		}
-	} else {
-		int m;
-		int len;
-		int sign = (n < 0);
-		if(sign)
-			n = -n;
+	// The upper 64 bit of the product, rounded.
+	static DiyFp Mul(const DiyFp& x, const DiyFp& y)
+	{
+		const uint64_t u_lo = x.f & 0xFFFFFFFFu;
+		const uint64_t u_hi = x.f >> 32;
+		const uint64_t v_lo = y.f & 0xFFFFFFFFu;
+		const uint64_t v_hi = y.f >> 32;
+
+		const uint64_t p0 = u_lo * v_lo;
+		const uint64_t p1 = u_lo * v_hi;
+		const uint64_t p2 = u_hi * v_lo;
+		const uint64_t p3 = u_hi * v_hi;
+
+		uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+		q += uint64_t(1) << 31;
+		const uint64_t h = p3 + (p2 >> 32) + (p1 >> 32) + (q >> 32);
+
+		return DiyFp(h, x.e + y.e + 64);
+	}
 
-		// Check is exponential notation should be used.
-		m = (int)std::log10(n);
-		int useExp = (m >= 14 || (sign && m >= 9) || m <= -9);
-		if(useExp) {
-			if(m < 0)
-				m -= 1;
-			n /= GetPow10(m);
+	static DiyFp Normalize(DiyFp x)
+	{
+		while((x.f >> 63) == 0) {
+			x.f <<= 1;
+			x.e--;
 		}
+		return x;
+	}
 
-		if(sign)
-			ctx.AddSlice(locale.Minus);
+	static DiyFp NormalizeTo(const DiyFp& x, int e)
+	{
+		return DiyFp(x.f << (x.e - e), e);
+	}
+};
 
-		// Split into integer part before comma and after comma.
-		// 64-Bit since we need enough room for at least 13 digits.
-		// otherwise we use exponential notation.
-		uint64_t pre = (uint64_t)n;
-		uint64_t post = (uint64_t)((n - std::floor(n)) * GetPow10(digits + 1));
-
-		// Round the number
-		int post_digits = digits;
-		if(post > 0) {
-			if(post % 10 >= 5)
-				post += 5;
-			post /= 10;
-			while(post % 10 == 0 && post) {
-				post /= 10;
-				--post_digits;
-			}
-			if(post_digits == 0) {
-				pre++;
-				post = 0;
-			}
+struct Boundaries
+{
+	DiyFp w;
+	DiyFp minus;
+	DiyFp plus;
+};
+
+// The value and the middle between the value and its neighbours, for the
+// precision of the original type.
+template <typename T>
+Boundaries ComputeBoundaries(T value)
+{
+	static_assert(std::numeric_limits<T>::is_iec559, "Must be iec559");
+	static const int PRECISION = std::numeric_limits<T>::digits;
+	static const int BIAS = std::numeric_limits<T>::max_exponent - 1 + (PRECISION - 1);
+	static const int MIN_EXP = 1 - BIAS;
+	static const uint64_t HIDDEN_BIT = uint64_t(1) << (PRECISION - 1);
+
+	using BitsT = typename std::conditional<PRECISION == 24, uint32_t, uint64_t>::type;
+	BitsT bits;
+	std::memcpy(&bits, &value, sizeof(T));
+	const uint64_t e = bits >> (PRECISION - 1);
+	const uint64_t f = bits & (HIDDEN_BIT - 1);
+
+	const DiyFp v = e == 0 ? DiyFp(f, MIN_EXP) : DiyFp(f + HIDDEN_BIT, int(e) - BIAS);
+
+	// The lower neighbour is closer for powers of two.
+	const bool lowerIsCloser = f == 0 && e > 1;
+	const DiyFp plus = DiyFp(2 * v.f + 1, v.e - 1);
+	const DiyFp minus = lowerIsCloser ? DiyFp(4 * v.f - 1, v.e - 2) : DiyFp(2 * v.f - 1, v.e - 1);
+
+	const DiyFp wPlus = DiyFp::Normalize(plus);
+	const DiyFp wMinus = DiyFp::NormalizeTo(minus, wPlus.e);
+
+	return Boundaries{DiyFp::Normalize(v), wMinus, wPlus};
+}
+
+// Scaled products have a binary exponent in [ALPHA, GAMMA].
+const int ALPHA = -60;
+const int GAMMA = -32;
+
+struct CachedPower
+{
+	uint64_t f;
+	int e;
+	int k;
+};
+
+// Normalized powers of ten, c = f * 2^e = 10^k.
+const CachedPower CACHED_POWERS[] = {
+	{0xAB70FE17C79AC6CA, -1060, -300},
+	{0xFF77B1FCBEBCDC4F, -1034, -292},
+	{0xBE5691EF416BD60C, -1007, -284},
+	{0x8DD01FAD907FFC3C, -980, -276},
+	{0xD3515C2831559A83, -954, -268},
+	{0x9D71AC8FADA6C9B5, -927, -260},
+	{0xEA9C227723EE8BCB, -901, -252},
+	{0xAECC49914078536D, -874, -244},
+	{0x823C12795DB6CE57, -847, -236},
+	{0xC21094364DFB5637, -821, -228},
+	{0x9096EA6F3848984F, -794, -220},
+	{0xD77485CB25823AC7, -768, -212},
+	{0xA086CFCD97BF97F4, -741, -204},
+	{0xEF340A98172AACE5, -715, -196},
+	{0xB23867FB2A35B28E, -688, -188},
+	{0x84C8D4DFD2C63F3B, -661, -180},
+	{0xC5DD44271AD3CDBA, -635, -172},
+	{0x936B9FCEBB25C996, -608, -164},
+	{0xDBAC6C247D62A584, -582, -156},
+	{0xA3AB66580D5FDAF6, -555, -148},
+	{0xF3E2F893DEC3F126, -529, -140},
+	{0xB5B5ADA8AAFF80B8, -502, -132},
+	{0x87625F056C7C4A8B, -475, -124},
+	{0xC9BCFF6034C13053, -449, -116},
+	{0x964E858C91BA2655, -422, -108},
+	{0xDFF9772470297EBD, -396, -100},
+	{0xA6DFBD9FB8E5B88F, -369, -92},
+	{0xF8A95FCF88747D94, -343, -84},
+	{0xB94470938FA89BCF, -316, -76},
+	{0x8A08F0F8BF0F156B, -289, -68},
+	{0xCDB02555653131B6, -263, -60},
+	{0x993FE2C6D07B7FAC, -236, -52},
+	{0xE45C10C42A2B3B06, -210, -44},
+	{0xAA242499697392D3, -183, -36},
+	{0xFD87B5F28300CA0E, -157, -28},
+	{0xBCE5086492111AEB, -130, -20},
+	{0x8CBCCC096F5088CC, -103, -12},
+	{0xD1B71758E219652C, -77, -4},
+	{0x9C40000000000000, -50, 4},
+	{0xE8D4A51000000000, -24, 12},
+	{0xAD78EBC5AC620000, 3, 20},
+	{0x813F3978F8940984, 30, 28},
+	{0xC097CE7BC90715B3, 56, 36},
+	{0x8F7E32CE7BEA5C70, 83, 44},
+	{0xD5D238A4ABE98068, 109, 52},
+	{0x9F4F2726179A2245, 136, 60},
+	{0xED63A231D4C4FB27, 162, 68},
+	{0xB0DE65388CC8ADA8, 189, 76},
+	{0x83C7088E1AAB65DB, 216, 84},
+	{0xC45D1DF942711D9A, 242, 92},
+	{0x924D692CA61BE758, 269, 100},
+	{0xDA01EE641A708DEA, 295, 108},
+	{0xA26DA3999AEF774A, 322, 116},
+	{0xF209787BB47D6B85, 348, 124},
+	{0xB454E4A179DD1877, 375, 132},
+	{0x865B86925B9BC5C2, 402, 140},
+	{0xC83553C5C8965D3D, 428, 148},
+	{0x952AB45CFA97A0B3, 455, 156},
+	{0xDE469FBD99A05FE3, 481, 164},
+	{0xA59BC234DB398C25, 508, 172},
+	{0xF6C69A72A3989F5C, 534, 180},
+	{0xB7DCBF5354E9BECE, 561, 188},
+	{0x88FCF317F22241E2, 588, 196},
+	{0xCC20CE9BD35C78A5, 614, 204},
+	{0x98165AF37B2153DF, 641, 212},
+	{0xE2A0B5DC971F303A, 667, 220},
+	{0xA8D9D1535CE3B396, 694, 228},
+	{0xFB9B7CD9A4A7443C, 720, 236},
+	{0xBB764C4CA7A44410, 747, 244},
+	{0x8BAB8EEFB6409C1A, 774, 252},
+	{0xD01FEF10A657842C, 800, 260},
+	{0x9B10A4E5E9913129, 827, 268},
+	{0xE7109BFBA19C0C9D, 853, 276},
+	{0xAC2820D9623BF429, 880, 284},
+	{0x80444B5E7AA7CF85, 907, 292},
+	{0xBF21E44003ACDD2D, 933, 300},
+	{0x8E679C2F5E44FF8F, 960, 308},
+	{0xD433179D9C8CB841, 986, 316},
+	{0x9E19DB92B4E31BA9, 1013, 324},
+};
+const int CACHED_POWERS_MIN_DEC_EXP = -300;
+const int CACHED_POWERS_DEC_STEP = 8;
+
+CachedPower GetCachedPower(int e)
+{
+	// k = ceil((ALPHA - e - 1) * log10(2)), 78913 / 2^18 approximates log10(2).
+	const int f = ALPHA - e - 1;
+	const int k = (f * 78913) / (1 << 18) + (f > 0);
+	const int index = (-CACHED_POWERS_MIN_DEC_EXP + k + (CACHED_POWERS_DEC_STEP - 1)) / CACHED_POWERS_DEC_STEP;
+	assert(index >= 0 && index < int(sizeof(CACHED_POWERS) / sizeof(*CACHED_POWERS)));
+	const CachedPower cached = CACHED_POWERS[index];
+	assert(ALPHA <= cached.e + e + 64 && cached.e + e + 64 <= GAMMA);
+	return cached;
+}
+
+int FindLargestPow10(uint32_t n, uint32_t& pow10)
+{
+	static const uint32_t POWERS[10] = {
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+	int digits = 10;
+	while(digits > 1 && n < POWERS[digits - 1])
+		--digits;
+	pow10 = POWERS[digits - 1];
+	return digits;
+}
+
+// Move the last digit towards the real value, while still inside the boundaries.
+void Grisu2Round(char* buffer, int len, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t tenK)
+{
+	while(rest < dist && delta - rest >= tenK &&
+		(rest + tenK < dist || dist - rest > rest + tenK - dist)) {
+		buffer[len - 1]--;
+		rest += tenK;
+	}
+}
+
+void Grisu2DigitGen(char* buffer, int& len, int& exponent, DiyFp mMinus, DiyFp w, DiyFp mPlus)
+{
+	uint64_t delta = DiyFp::Sub(mPlus, mMinus).f;
+	uint64_t dist = DiyFp::Sub(mPlus, w).f;
+
+	const DiyFp one(uint64_t(1) << -mPlus.e, mPlus.e);
+
+	uint32_t p1 = uint32_t(mPlus.f >> -one.e);
+	uint64_t p2 = mPlus.f & (one.f - 1);
+
+	// Integral digits
+	uint32_t pow10;
+	int n = FindLargestPow10(p1, pow10);
+	while(n > 0) {
+		const uint32_t d = p1 / pow10;
+		p1 %= pow10;
+		buffer[len++] = char('0' + d);
+		--n;
+
+		const uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+		if(rest <= delta) {
+			exponent += n;
+			Grisu2Round(buffer, len, dist, delta, rest, uint64_t(pow10) << -one.e);
+			return;
 		}
+		pow10 /= 10;
+	}
 
-		// Write pre part
-		len = 0;
-		do {
-			*s++ = '0' + pre % 10;
-			++len;
-		} while((pre /= 10) > 0);
-
-		ReverseString(s - len, len);
-		ctx.AddSlice(int(s - BUFFER), BUFFER, true);
-		s = BUFFER;
-
-		// Write post part
-		bool hasPost = (post > 0);
-		len = 0;
-		if(hasPost) {
-			ctx.AddSlice(locale.Comma);
+	// Fractional digits
+	int m = 0;
+	while(true) {
+		p2 *= 10;
+		const uint64_t d = p2 >> -one.e;
+		p2 &= one.f - 1;
+		buffer[len++] = char('0' + d);
+		++m;
+
+		delta *= 10;
+		dist *= 10;
+		if(p2 <= delta)
+			break;
+	}
 
-			while(post > 0) {
-				*s++ = '0' + post % 10;
-				post /= 10;
-				++len;
-			}
+	exponent -= m;
+	Grisu2Round(buffer, len, dist, delta, p2, one.f);
+}
 
-			while(len < post_digits) {
-				*s++ = '0';
-				++len;
-			}
+template <typename T>
+int ShortestDigitsTempl(T value, char* buffer, int& exponent)
+{
+	const Boundaries b = ComputeBoundaries(value);
+	const CachedPower cached = GetCachedPower(b.plus.e);
+	const DiyFp c(cached.f, cached.e);
+
+	const DiyFp w = DiyFp::Mul(b.w, c);
+	const DiyFp wMinus = DiyFp::Mul(b.minus, c);
+	const DiyFp wPlus = DiyFp::Mul(b.plus, c);
+
+	// Shrink the boundaries by one ulp to stay inside after the rounding of Mul.
+	const DiyFp mMinus(wMinus.f + 1, wMinus.e);
+	const DiyFp mPlus(wPlus.f - 1, wPlus.e);
+
+	int len = 0;
+	exponent = -cached.k;
+	Grisu2DigitGen(buffer, len, exponent, mMinus, w, mPlus);
+	return len;
+}
+
+// Round a digit string to the given number of digits, returns the new length.
+// If the rounding overflows, the digits are "1" and exponent is increased.
+int RoundDigits(char* buffer, int len, int keep, int& exponent)
+{
+	if(keep >= len)
+		return len;
+	if(keep < 0) {
+		exponent += len;
+		return 0;
+	}
 
-			ReverseString(s - len, len);
+	bool roundUp = buffer[keep] >= '5';
+	exponent += len - keep;
+	len = keep;
+	if(roundUp) {
+		int i = len - 1;
+		while(i >= 0 && buffer[i] == '9')
+			--i;
+		if(i < 0) {
+			buffer[0] = '1';
+			exponent += len;
+			return 1;
 		}
+		buffer[i]++;
+		len = i + 1;
+		exponent += keep - len;
+	}
+	return len;
+}
+}
+
+int ShortestDigits(double n, char* digits, int& exponent)
+{
+	return ShortestDigitsTempl(n, digits, exponent);
+}
+
+int ShortestDigits(float n, char* digits, int& exponent)
+{
+	return ShortestDigitsTempl(n, digits, exponent);
+}
+
+/*
+The number is written from its shortest digits, which are then rounded to the
+requested number of digits.
+*/
+static void PutFloatDigits(Context& ctx, char* digits, int len, int exponent, int maxDigits, bool forcePrecision, const Facet_NumericalFormat& locale)
+{
+	char BUFFER[64];
+	char* s = BUFFER;
 
-		ctx.AddSlice(int(s - BUFFER), BUFFER, true);
-		s = BUFFER;
+	// Remove trailing zeros.
+	while(len > 1 && digits[len - 1] == '0') {
+		--len;
+		++exponent;
+	}
 
-		// Add zeros for precision.
-		size_t rem = digits - len;
-		if(forcePrecision && rem) {
-			if(!hasPost)
-				ctx.AddSlice(locale.Comma);
-			while(rem--)
+	// The exponent of the first digit.
+	int e = len + exponent - 1;
+	bool useExp = (e >= 14 || e < -9);
+
+	// Round to the maximal number of digits after the comma.
+	if(maxDigits >= 0) {
+		int comma = useExp ? 1 : len + exponent;
+		len = RoundDigits(digits, len, comma + maxDigits, exponent);
+		while(len > 1 && digits[len - 1] == '0') {
+			--len;
+			++exponent;
+		}
+		if(len == 0) {
+			digits[0] = '0';
+			len = 1;
+			exponent = 0;
+		}
+		if(useExp)
+			e = len + exponent - 1;
+	}
+
+	int postLen;
+	if(useExp) {
+		// d.ddde+x
+		*s++ = digits[0];
+		postLen = len - 1;
+		if(postLen > 0) {
+			ctx.AddSlice(int(s - BUFFER), BUFFER, true);
+			s = BUFFER;
+			ctx.AddSlice(locale.Comma);
+			std::memcpy(s, digits + 1, postLen);
+			s += postLen;
+		}
+	} else {
+		int pre = len + exponent;
+		if(pre <= 0) {
+			// 0.000ddd
+			*s++ = '0';
+			ctx.AddSlice(int(s - BUFFER), BUFFER, true);
+			s = BUFFER;
+			ctx.AddSlice(locale.Comma);
+			for(int i = 0; i < -pre; ++i)
+				*s++ = '0';
+			std::memcpy(s, digits, len);
+			s += len;
+			postLen = len - pre;
+		} else if(pre >= len) {
+			// ddd000
+			std::memcpy(s, digits, len);
+			s += len;
+			for(int i = len; i < pre; ++i)
 				*s++ = '0';
+			postLen = 0;
+		} else {
+			// ddd.ddd
+			std::memcpy(s, digits, pre);
+			s += pre;
+			ctx.AddSlice(int(s - BUFFER), BUFFER, true);
+			s = BUFFER;
+			ctx.AddSlice(locale.Comma);
+			postLen = len - pre;
+			std::memcpy(s, digits + pre, postLen);
+			s += postLen;
 		}
+	}
 
-		ctx.AddSlice(int(s - BUFFER), BUFFER, true);
-		s = BUFFER;
+	// Add zeros for precision.
+	if(forcePrecision && maxDigits > postLen) {
+		if(postLen == 0) {
+			ctx.AddSlice(int(s - BUFFER), BUFFER, true);
+			s = BUFFER;
+			ctx.AddSlice(locale.Comma);
+		}
+		for(int i = postLen; i < maxDigits; ++i)
+			*s++ = '0';
+	}
 
-		// Write exponent
-		len = 0;
-		if(useExp) {
-			ctx.AddSlice(1, "e");
-			if(m >= 0) {
-				ctx.AddSlice(locale.Plus);
-			} else {
-				ctx.AddSlice(locale.Minus);
-				m = -m;
-			}
+	ctx.AddSlice(int(s - BUFFER), BUFFER, true);
 
-			while(m > 0) {
-				*s++ = '0' + m % 10;
-				m /= 10;
-				++len;
-			}
+	// Write exponent
+	if(useExp) {
+		ctx.AddSlice(1, "e");
+		if(e >= 0) {
+			ctx.AddSlice(locale.Plus);
+		} else {
+			ctx.AddSlice(locale.Minus);
+			e = -e;
+		}
+		int expLen = UIntToDecimal(uint64_t(e), BUFFER);
+		ctx.AddSlice(expLen, BUFFER, true);
+	}
+}
+
+template <typename T>
+static void PutFloatTempl(Context& ctx, T n, int digits, bool forcePrecision, const Facet_NumericalFormat& locale)
+{
+	if(std::isnan(n)) {
+		ctx.AddSlice(locale.NaN);
+	} else if(std::isinf(n)) {
+		if(n < 0)
+			ctx.AddSlice(locale.Minus);
 
-			ReverseString(s - len, len);
+		ctx.AddSlice(locale.Inf);
+	} else if(n == 0) {
+		ctx.AddSlice(1, "0");
+		if(forcePrecision && digits > 0) {
+			ctx.AddSlice(locale.Comma);
+			PutZeros(ctx, digits);
+		}
+	} else {
+		if(n < 0) {
+			ctx.AddSlice(locale.Minus);
+			n = -n;
 		}
 
-		ctx.AddSlice(int(s - BUFFER), BUFFER, true);
+		char buffer[32];
+		int exponent;
+		int len = ShortestDigits(n, buffer, exponent);
+		PutFloatDigits(ctx, buffer, len, exponent, digits, forcePrecision, locale);
 	}
 }
 
+void PutFloat(Context& ctx, double n, int digits, bool forcePrecision, const Facet_NumericalFormat& locale)
+{
+	PutFloatTempl(ctx, n, digits, forcePrecision, locale);
+}
+
+void PutFloat(Context& ctx, float n, int digits, bool forcePrecision, const Facet_NumericalFormat& locale)
+{
+	PutFloatTempl(ctx, n, digits, forcePrecision, locale);
+}
+
 static void GetExpFraction(double dvalue, int& exponent, uint64_t& fraction)
 {
 	static_assert(std::numeric_limits<double>::is_iec559, "Must be iec559");
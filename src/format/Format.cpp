@@ -1,6 +1,7 @@
 #include "format/Format.h"
 #include "format/ConvertersHelper.h"
 #include "format/GeneralParsing.h"
+#include "format/FormatLocale.h"
 #include <climits>
 #include <cassert>
 
@@ -128,7 +129,7 @@ public:
 	}
 	int RetrieveNextValue(int arg)
 	{
-		value = arg + 1;
+		value = arg;
 		ctx.SetCurArgId(arg);
 		return arg;
 	}
@@ -334,5 +335,88 @@ void format(Context& ctx, Slice fmtStr)
 	}
 }
 
+void format(Context& ctx, const PlanView& plan)
+{
+	if(plan.needsParsing) {
+		format(ctx, Slice(plan.size, plan.str));
+		return;
+	}
+
+	Context::SubContext subCtx(ctx);
+	Placeholder pl;
+	for(int i = 0; i < plan.entryCount; ++i) {
+		auto& entry = plan.entries[i];
+		if(entry.kind == PlanEntry::EKind::Text) {
+			ctx.AddSlice(entry.size, plan.str + entry.offset);
+			continue;
+		}
+
+#if defined(FORMAT_ERROR_TEXT) && defined(FORMAT_NO_EXCEPTIONS)
+		try {
+#endif
+			ctx.SetCurPlaceholderOffset(entry.offset);
+			ctx.SetCurArgId(entry.argId);
+			pl.argId = entry.argId;
+			pl.type = Slice(entry.typeSize, plan.str + entry.typeOffset);
+			pl.format = Slice(entry.formatSize, plan.str + entry.formatOffset);
+			WriteSimplePlaceholder(ctx, pl);
+#if defined(FORMAT_ERROR_TEXT) && defined(FORMAT_NO_EXCEPTIONS)
+		} catch(const format_exception& exp) {
+			ctx.AddTerminatedSlice("<FORMAT_ERROR:");
+			ctx.AddTerminatedSlice(exp.msg);
+			ctx.AddTerminatedSlice(">");
+		}
+#endif
+	}
+}
+
+int FormatDirect(char* buffer, int bufferSize, const PlanView& plan, const DirectArg* args, int argCount, const Locale& locale)
+{
+	if(!plan.isDirect)
+		return -1;
+
+	auto& minus = locale.GetNumericalFacet().Minus;
+	char* cursor = buffer;
+	char* end = buffer + bufferSize;
+	for(int i = 0; i < plan.entryCount; ++i) {
+		auto& entry = plan.entries[i];
+		if(entry.kind == PlanEntry::EKind::Text) {
+			if(end - cursor < entry.size)
+				return -1;
+			std::memcpy(cursor, plan.str + entry.offset, entry.size);
+			cursor += entry.size;
+			continue;
+		}
+
+		// Missing arguments are reported by the context path.
+		if(entry.argId >= argCount)
+			return -1;
+		auto& arg = args[entry.argId];
+		if(arg.kind == DirectArg::EKind::Integer) {
+			char digits[20];
+			int digitCount = UIntToDecimal(arg.magnitude, digits);
+			int signSize = arg.negative ? (int)minus.size() : 0;
+			if(end - cursor < signSize + digitCount)
+				return -1;
+			if(signSize) {
+				std::memcpy(cursor, minus.data(), signSize);
+				cursor += signSize;
+			}
+			std::memcpy(cursor, digits, digitCount);
+			cursor += digitCount;
+		} else if(arg.kind == DirectArg::EKind::String) {
+			if(end - cursor < arg.str.size)
+				return -1;
+			if(arg.str.size)
+				std::memcpy(cursor, arg.str.data, arg.str.size);
+			cursor += arg.str.size;
+		} else {
+			return -1;
+		}
+	}
+
+	return int(cursor - buffer);
+}
+
 }
 }
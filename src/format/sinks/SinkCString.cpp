@@ -26,4 +26,21 @@ int cstring_sink::Write(Context&, const Context::SlicesT& slices, int flags)
 
 	return int(c - m_Str.string) - 1;
 }
+
+int cstring_sink::WriteDirect(const Locale&, const char* data, int size, int flags)
+{
+	if(m_Str.maxSize == 0)
+		return 0;
+
+	int tocopy = size < m_Str.maxSize - 1 ? size : m_Str.maxSize - 1;
+	std::memcpy(m_Str.string, data, tocopy);
+	char* c = m_Str.string + tocopy;
+
+	if(tocopy < m_Str.maxSize - 1 && (flags & ESinkFlags::Newline) != 0)
+		*c++ = '\n';
+
+	*c++ = '\0';
+
+	return int(c - m_Str.string) - 1;
+}
 }
@@ -23,4 +23,15 @@ int stdstring_sink::Write(Context& ctx, const Context::SlicesT& slices, int flag
 	return size;
 }
 
+int stdstring_sink::WriteDirect(const Locale&, const char* data, int size, int flags)
+{
+	m_Str.assign(data, size);
+	if((flags & ESinkFlags::Newline) != 0) {
+		m_Str.push_back('\n');
+		++size;
+	}
+
+	return size;
+}
+
 }
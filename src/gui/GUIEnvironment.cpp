@@ -1,5 +1,6 @@
 #include "gui/GUIEnvironment.h"
 #include "core/Logger.h"
+#include "core/lxProfiler.h"
 
 #include "input/InputSystem.h"
 
@@ -245,6 +246,7 @@ void GUIEnvironment::SetDrawVirtualCursor(bool draw)
 
 void GUIEnvironment::Update(float secsPassed)
 {
+	LX_PROFILE_SCOPE("GUIEnvironment::Update");
 	m_SecsPassed = secsPassed;
 
 	auto newHovered = GetElementByPos(m_CursorPos).GetWeak();
@@ -298,6 +300,7 @@ void GUIEnvironment::Render()
 {
 	m_Time += m_SecsPassed;
 
+	LX_PROFILE_SCOPE("GUIEnvironment::Render");
 	video::RenderStatistics::GroupScope grpScope("gui");
 
 	m_Renderer->Begin();
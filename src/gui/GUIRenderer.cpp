@@ -10,6 +10,9 @@ namespace gui
 
 namespace
 {
+// The number of rectangles drawn with a single call.
+const int MAX_BATCH_RECTS = 256;
+
 class ParamSetCallback : public video::ShaderParamSetCallback
 {
 public:
@@ -66,6 +69,7 @@ Renderer::Renderer(video::Renderer* r)
 
 void Renderer::Begin()
 {
+	Flush();
 	m_Renderer->SetTransform(video::ETransform::World, math::Matrix4::IDENTITY);
 }
 
@@ -75,6 +79,7 @@ void Renderer::DrawText(gui::Font* font,
 	const math::Vector2F& position,
 	const math::RectF* clip)
 {
+	Flush();
 	if(font)
 		font->Draw(settings, text, position, clip);
 }
@@ -87,6 +92,8 @@ void Renderer::DrawRectangle(const math::RectF& rect, video::Color color, const
 	if(realRect.IsEmpty())
 		return;
 
+	Flush();
+
 	video::Vertex2D quad[4] = {
 		video::Vertex2D(realRect.left, realRect.bottom, color),
 		video::Vertex2D(realRect.right, realRect.bottom, color),
@@ -107,22 +114,37 @@ void Renderer::DrawRectangle(const math::RectF& rect, video::Texture* texture, c
 	if(realRect.IsEmpty())
 		return;
 
+	if(m_BatchTexture != texture || m_Batch.Size() >= MAX_BATCH_RECTS * 6)
+		Flush();
+	m_BatchTexture = texture;
+
 	video::Vertex2D quad[4] = {
 		video::Vertex2D(realRect.left, realRect.bottom, color, tCoord.left, tCoord.bottom),
 		video::Vertex2D(realRect.right, realRect.bottom, color, tCoord.right, tCoord.bottom),
 		video::Vertex2D(realRect.left, realRect.top, color, tCoord.left, tCoord.top),
 		video::Vertex2D(realRect.right, realRect.top, color, tCoord.right, tCoord.top)
 	};
-	ParamSetCallback::SetData dat;
-	dat.layer = video::TextureLayer(texture);
-	m_Renderer->SendPassSettingsEx(video::ERenderMode::Mode2D, m_TexturePass, false, &g_ShaderParamSet, &dat);
-	m_Renderer->Draw(video::RenderRequest::FromMemory(
-		video::EPrimitiveType::TriangleStrip,
-		2, quad, 4, video::VertexFormat::STANDARD_2D));
+	m_Batch.PushBack(quad[0]);
+	m_Batch.PushBack(quad[1]);
+	m_Batch.PushBack(quad[2]);
+	m_Batch.PushBack(quad[2]);
+	m_Batch.PushBack(quad[1]);
+	m_Batch.PushBack(quad[3]);
+}
+
+void Renderer::DrawSprite(const math::RectF& rect, video::SpriteBank* bank, video::SpriteBank::Sprite sprite, float time, video::Color color, const math::RectF* clip)
+{
+	LX_CHECK_NULL_ARG(bank);
+
+	math::RectF* coords;
+	video::Texture* texture;
+	if(bank->GetSprite(sprite, time, coords, texture))
+		DrawRectangle(rect, texture, *coords, color, clip);
 }
 
 void Renderer::DrawTriangle(const math::Vector2F& a, const math::Vector2F& b, const math::Vector2F& c, video::Color color, const math::RectF* clip)
 {
+	Flush();
 	video::Vertex2D tri[3] = {
 		video::Vertex2D(a.x, a.y, color),
 		video::Vertex2D(b.x, b.y, color),
@@ -190,6 +212,8 @@ void Renderer::DrawLine(const math::Vector2F& start, const math::Vector2F& end,
 		return;
 	if(style.steps[style.invert] == 0)
 		return;
+
+	Flush();
 	m_Renderer->SendPassSettings(m_DiffusePass, false, &g_ShaderParamSet);
 	LineBuffer lineBuffer(m_Renderer, color);
 
@@ -225,6 +249,19 @@ void Renderer::DrawLine(const math::Vector2F& start, const math::Vector2F& end,
 
 void Renderer::Flush()
 {
+	if(m_Batch.IsEmpty())
+		return;
+
+	ParamSetCallback::SetData dat;
+	dat.layer = video::TextureLayer(m_BatchTexture);
+	m_Renderer->SendPassSettingsEx(video::ERenderMode::Mode2D, m_TexturePass, false, &g_ShaderParamSet, &dat);
+	m_Renderer->Draw(video::RenderRequest::FromMemory(
+		video::EPrimitiveType::Triangles,
+		m_Batch.Size() / 3, m_Batch.Data(), m_Batch.Size(),
+		video::VertexFormat::STANDARD_2D));
+
+	m_Batch.Clear();
+	m_BatchTexture = nullptr;
 }
 
 video::Renderer* Renderer::GetRenderer() const
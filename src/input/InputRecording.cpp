@@ -0,0 +1,527 @@
+#include "input/InputRecording.h"
+#include "input/InputSystem.h"
+#include "input/InputDevice.h"
+#include "io/File.h"
+#include "core/lxException.h"
+#include <cstring>
+
+namespace lux
+{
+namespace input
+{
+
+/*
+Stream layout:
+	u32 magic 'LXIR'
+	u32 version
+	records...
+
+Each record starts with its tag, integers are stored as 7 bit varints, floats
+as raw little endian bytes and strings as length followed by the bytes.
+The time deltas are the microseconds since the previous event or frame.
+Devices are declared before their first event, ids are assigned in order.
+*/
+namespace
+{
+const u32 STREAM_MAGIC = LX_MAKE_FOURCC('L', 'X', 'I', 'R');
+const u32 STREAM_VERSION = 1;
+const char STREAM_FORMAT[] = "lxir";
+
+enum class ERecordTag : u8
+{
+	End = 0,
+	Frame = 1, // time delta, secsPassed
+	Device = 2, // id, type, guid, name, (count, (type, name)*) for buttons, axes, areas
+	Button = 3, // time delta, device, code, pressedDown
+	KeyboardButton = 4, // like Button, followed by four characters
+	Axis = 5, // time delta, device, code, rel, abs
+	Area = 6, // time delta, device, code, rel.x, rel.y, abs.x, abs.y
+};
+
+const EDeviceEventType DEVICE_ELEMENT_ORDER[] = {
+	EDeviceEventType::Button,
+	EDeviceEventType::Axis,
+	EDeviceEventType::Area
+};
+
+class ReplayDeviceDesc : public InputDeviceDesc
+{
+public:
+	struct Element
+	{
+		core::String name;
+		EDeviceElementType type;
+	};
+
+	EDeviceType GetType() const override { return type; }
+	core::StringView GetName() const override { return name; }
+	core::StringView GetGUID() const override { return guid; }
+
+	int GetElementCount(EDeviceEventType eventType) const override
+	{
+		return GetElements(eventType).Size();
+	}
+	core::StringView GetElementName(EDeviceEventType eventType, int id) const override
+	{
+		return GetElements(eventType).At(id).name;
+	}
+	EDeviceElementType GetElementType(EDeviceEventType eventType, int id) const override
+	{
+		return GetElements(eventType).At(id).type;
+	}
+
+	const core::Array<Element>& GetElements(EDeviceEventType eventType) const
+	{
+		return elements[(int)eventType];
+	}
+
+	EDeviceType type;
+	core::String name;
+	core::String guid;
+	core::Array<Element> elements[3];
+};
+
+} // anonymous namespace
+
+InputRecorder::InputRecorder(InputSystem* system, io::File* file) :
+	m_System(system),
+	m_File(file),
+	m_FrameCount(0),
+	m_Finished(false)
+{
+	LX_CHECK_NULL_ARG(system);
+	LX_CHECK_NULL_ARG(file);
+
+	u32 header[2] = {STREAM_MAGIC, STREAM_VERSION};
+	m_File->WriteBinary(header, sizeof(header));
+
+	m_LastTime = core::Clock::GetTicks();
+	m_LastFrameTime = m_LastTime;
+	m_System->GetEventSignal().Connect(this, &InputRecorder::OnEvent);
+}
+
+InputRecorder::~InputRecorder()
+{
+	Finish();
+}
+
+void InputRecorder::NextFrame(float secsPassed)
+{
+	if(m_Finished)
+		return;
+
+	WriteFrame(secsPassed);
+}
+
+void InputRecorder::Finish()
+{
+	if(m_Finished)
+		return;
+
+	m_System->GetEventSignal().DisconnectClass(this);
+	m_Finished = true;
+
+	// The events of the unfinished frame form the last frame.
+	if(!m_Buffer.IsEmpty())
+		WriteFrame((core::Clock::GetTicks() - m_LastFrameTime).AsSeconds());
+
+	u8 end = (u8)ERecordTag::End;
+	m_File->WriteBinary(&end, 1);
+}
+
+void InputRecorder::WriteFrame(float secsPassed)
+{
+	WriteU8((u8)ERecordTag::Frame);
+	WriteVarInt(TakeTimeDelta());
+	WriteFloat(secsPassed);
+	m_LastFrameTime = m_LastTime;
+
+	// Write whole frames, a frame is never split between two writes.
+	m_File->WriteBinary(m_Buffer.Data(), m_Buffer.Size());
+	m_Buffer.Clear();
+	++m_FrameCount;
+}
+
+void InputRecorder::OnEvent(const Event& event)
+{
+	// The events are buffered until the frame is finished.
+	if(m_Finished || !event.device)
+		return;
+
+	int device = GetDeviceId(event.device);
+	if(auto key = event.TryAs<KeyboardButtonEvent>()) {
+		WriteU8((u8)ERecordTag::KeyboardButton);
+		WriteVarInt(TakeTimeDelta());
+		WriteVarInt(device);
+		WriteVarInt(key->code);
+		WriteU8(key->pressedDown ? 1 : 0);
+		for(u32 c : key->character)
+			WriteVarInt(c);
+	} else if(auto button = event.TryAs<ButtonEvent>()) {
+		WriteU8((u8)ERecordTag::Button);
+		WriteVarInt(TakeTimeDelta());
+		WriteVarInt(device);
+		WriteVarInt(button->code);
+		WriteU8(button->pressedDown ? 1 : 0);
+	} else if(auto axis = event.TryAs<AxisEvent>()) {
+		WriteU8((u8)ERecordTag::Axis);
+		WriteVarInt(TakeTimeDelta());
+		WriteVarInt(device);
+		WriteVarInt(axis->code);
+		WriteFloat(axis->rel);
+		WriteFloat(axis->abs);
+	} else if(auto area = event.TryAs<AreaEvent>()) {
+		WriteU8((u8)ERecordTag::Area);
+		WriteVarInt(TakeTimeDelta());
+		WriteVarInt(device);
+		WriteVarInt(area->code);
+		WriteFloat(area->rel.x);
+		WriteFloat(area->rel.y);
+		WriteFloat(area->abs.x);
+		WriteFloat(area->abs.y);
+	}
+}
+
+int InputRecorder::GetDeviceId(InputDevice* device)
+{
+	for(int i = 0; i < m_Devices.Size(); ++i) {
+		if(m_Devices[i] == device)
+			return i;
+	}
+
+	int id = m_Devices.Size();
+	m_Devices.PushBack(device);
+
+	WriteU8((u8)ERecordTag::Device);
+	WriteVarInt(id);
+	WriteU8((u8)device->GetType());
+	WriteString(device->GetGUID());
+	WriteString(device->GetName());
+	for(auto type : DEVICE_ELEMENT_ORDER) {
+		int count = device->GetElementCount(type);
+		WriteVarInt(count);
+		for(int i = 0; i < count; ++i) {
+			WriteVarInt((u32)device->GetElementType(type, i));
+			WriteString(device->GetElementName(type, i));
+		}
+	}
+
+	return id;
+}
+
+u32 InputRecorder::TakeTimeDelta()
+{
+	auto now = core::Clock::GetTicks();
+	auto delta = now - m_LastTime;
+	m_LastTime = now;
+	return delta.Count() > 0 ? (u32)delta.Count() : 0;
+}
+
+void InputRecorder::WriteU8(u8 value)
+{
+	m_Buffer.PushBack(value);
+}
+
+void InputRecorder::WriteVarInt(u32 value)
+{
+	while(value >= 0x80) {
+		m_Buffer.PushBack((u8)(value | 0x80));
+		value >>= 7;
+	}
+	m_Buffer.PushBack((u8)value);
+}
+
+void InputRecorder::WriteFloat(float value)
+{
+	u8 bytes[4];
+	memcpy(bytes, &value, 4);
+	for(u8 b : bytes)
+		m_Buffer.PushBack(b);
+}
+
+void InputRecorder::WriteString(core::StringView str)
+{
+	WriteVarInt((u32)str.Size());
+	for(int i = 0; i < str.Size(); ++i)
+		m_Buffer.PushBack((u8)str.Data()[i]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class InputReplay::Reader
+{
+public:
+	Reader(const core::Array<u8>& data, int cursor) :
+		m_Data(data),
+		m_Cursor(cursor)
+	{
+	}
+
+	int GetCursor() const { return m_Cursor; }
+	bool IsAtEnd() const { return m_Cursor >= m_Data.Size(); }
+	bool IsTruncated() const { return m_Truncated; }
+
+	u8 ReadU8()
+	{
+		if(m_Cursor >= m_Data.Size())
+			EndOfStream();
+		return m_Data[m_Cursor++];
+	}
+
+	u32 ReadVarInt()
+	{
+		u32 value = 0;
+		for(int shift = 0; shift < 35; shift += 7) {
+			u8 b = ReadU8();
+			value |= (u32)(b & 0x7F) << shift;
+			if(!(b & 0x80))
+				return value;
+		}
+		Error("Invalid integer");
+		return 0;
+	}
+
+	float ReadFloat()
+	{
+		u8 bytes[4];
+		for(auto& b : bytes)
+			b = ReadU8();
+		float value;
+		memcpy(&value, bytes, 4);
+		return value;
+	}
+
+	core::String ReadString()
+	{
+		u32 size = ReadVarInt();
+		if(size > (u32)(m_Data.Size() - m_Cursor))
+			EndOfStream();
+		core::String out((const char*)m_Data.Data() + m_Cursor, (int)size);
+		m_Cursor += (int)size;
+		return out;
+	}
+
+	static void Error(core::StringView msg)
+	{
+		throw core::FileFormatException(msg, STREAM_FORMAT);
+	}
+
+private:
+	void EndOfStream()
+	{
+		m_Truncated = true;
+		Error("Unexpected end of stream");
+	}
+
+private:
+	const core::Array<u8>& m_Data;
+	int m_Cursor;
+	bool m_Truncated = false;
+};
+
+InputReplay::InputReplay(InputSystem* system, io::File* file) :
+	m_System(system),
+	m_Cursor(0),
+	m_FrameCount(0),
+	m_CurrentFrame(0)
+{
+	LX_CHECK_NULL_ARG(system);
+	LX_CHECK_NULL_ARG(file);
+
+	s64 size = file->GetSize() - file->GetCursor();
+	if(size < 8 || size > 0x7FFFFFFF)
+		Reader::Error("Invalid stream size");
+	m_Data.Resize((int)size);
+	file->ReadBinary(size, m_Data.Data());
+
+	u32 header[2];
+	memcpy(header, m_Data.Data(), sizeof(header));
+	if(header[0] != STREAM_MAGIC)
+		Reader::Error("Invalid magic number");
+	if(header[1] != STREAM_VERSION)
+		Reader::Error("Stream version is not supported");
+	m_Cursor = (int)sizeof(header);
+
+	// Validate the whole stream, so a broken recording is detected before
+	// the replay starts and not in the middle of a measurement.
+	// A stream without end, e.g. if the application crashed while recording,
+	// is replayed up to the last complete frame.
+	Reader reader(m_Data, m_Cursor);
+	float secsPassed;
+	try {
+		while(!reader.IsAtEnd()) {
+			u8 tag = ReadRecord(reader, false, secsPassed);
+			if(tag == (u8)ERecordTag::End)
+				break;
+			if(tag == (u8)ERecordTag::Frame)
+				++m_FrameCount;
+		}
+	} catch(core::FileFormatException&) {
+		if(!reader.IsTruncated())
+			throw;
+	}
+	m_DeviceInfos.Clear();
+}
+
+InputReplay::~InputReplay()
+{
+}
+
+bool InputReplay::NextFrame(float& secsPassed)
+{
+	if(IsFinished())
+		return false;
+
+	Reader reader(m_Data, m_Cursor);
+	while(ReadRecord(reader, true, secsPassed) != (u8)ERecordTag::Frame) {
+		// The validation guarantees a complete frame before the end of the stream.
+	}
+	m_Cursor = reader.GetCursor();
+	++m_CurrentFrame;
+
+	return true;
+}
+
+u8 InputReplay::ReadRecord(Reader& reader, bool dispatch, float& secsPassed)
+{
+	auto tag = (ERecordTag)reader.ReadU8();
+	if(tag == ERecordTag::End)
+		return (u8)tag;
+	if(tag == ERecordTag::Device) {
+		AddDevice(reader, dispatch);
+		return (u8)tag;
+	}
+
+	auto timeDelta = core::Duration::Micros((core::Duration::BaseType)reader.ReadVarInt());
+	if(dispatch)
+		m_RecordedTime += timeDelta;
+
+	switch(tag) {
+	case ERecordTag::Frame:
+		secsPassed = reader.ReadFloat();
+		break;
+	case ERecordTag::Button:
+	case ERecordTag::KeyboardButton:
+	{
+		KeyboardButtonEvent key;
+		ButtonEvent button;
+		ButtonEvent& event = tag == ERecordTag::KeyboardButton ? key : button;
+		u32 device = reader.ReadVarInt();
+		event.code = (int)reader.ReadVarInt();
+		event.pressedDown = reader.ReadU8() != 0;
+		if(tag == ERecordTag::KeyboardButton) {
+			for(auto& c : key.character)
+				c = reader.ReadVarInt();
+		}
+		event.device = GetDevice(device, EDeviceEventType::Button, event.code, dispatch);
+		if(dispatch)
+			m_System->SendReplayedEvent(event);
+	}
+	break;
+	case ERecordTag::Axis:
+	{
+		AxisEvent event;
+		u32 device = reader.ReadVarInt();
+		event.code = (int)reader.ReadVarInt();
+		event.rel = reader.ReadFloat();
+		event.abs = reader.ReadFloat();
+		event.device = GetDevice(device, EDeviceEventType::Axis, event.code, dispatch);
+		if(dispatch)
+			m_System->SendReplayedEvent(event);
+	}
+	break;
+	case ERecordTag::Area:
+	{
+		AreaEvent event;
+		u32 device = reader.ReadVarInt();
+		event.code = (int)reader.ReadVarInt();
+		event.rel.x = reader.ReadFloat();
+		event.rel.y = reader.ReadFloat();
+		event.abs.x = reader.ReadFloat();
+		event.abs.y = reader.ReadFloat();
+		event.device = GetDevice(device, EDeviceEventType::Area, event.code, dispatch);
+		if(dispatch)
+			m_System->SendReplayedEvent(event);
+	}
+	break;
+	default:
+		Reader::Error("Unknown record");
+	}
+
+	return (u8)tag;
+}
+
+void InputReplay::AddDevice(Reader& reader, bool dispatch)
+{
+	u32 id = reader.ReadVarInt();
+	if(id != (u32)m_DeviceInfos.Size())
+		Reader::Error("Invalid device id");
+
+	StrongRef<ReplayDeviceDesc> desc = LUX_NEW(ReplayDeviceDesc);
+	u8 type = reader.ReadU8();
+	if(type > (u8)EDeviceType::Joystick)
+		Reader::Error("Invalid device type");
+	desc->type = (EDeviceType)type;
+	desc->guid = reader.ReadString();
+	desc->name = reader.ReadString();
+	for(auto eventType : DEVICE_ELEMENT_ORDER) {
+		auto& elements = desc->elements[(int)eventType];
+		u32 count = reader.ReadVarInt();
+		for(u32 i = 0; i < count; ++i) {
+			ReplayDeviceDesc::Element elem;
+			elem.type = (EDeviceElementType)reader.ReadVarInt();
+			elem.name = reader.ReadString();
+			elements.PushBack(elem);
+		}
+	}
+
+	DeviceInfo info;
+	info.buttonCount = desc->GetElementCount(EDeviceEventType::Button);
+	info.axisCount = desc->GetElementCount(EDeviceEventType::Axis);
+	info.areaCount = desc->GetElementCount(EDeviceEventType::Area);
+	m_DeviceInfos.PushBack(info);
+
+	if(!dispatch)
+		return;
+
+	auto IsCompatible = [&](InputDevice* device) {
+		return device &&
+			device->GetElementCount(EDeviceEventType::Button) == info.buttonCount &&
+			device->GetElementCount(EDeviceEventType::Axis) == info.axisCount &&
+			device->GetElementCount(EDeviceEventType::Area) == info.areaCount;
+	};
+
+	// The GUIDs of the same device differ between machines, so keyboards and
+	// mice are replayed on the primary devices if possible.
+	StrongRef<InputDevice> device;
+	if(desc->type == EDeviceType::Keyboard)
+		device = m_System->GetKeyboard();
+	else if(desc->type == EDeviceType::Mouse)
+		device = m_System->GetMouse();
+	if(!IsCompatible(device))
+		device = m_System->FindDevice(desc);
+	if(!IsCompatible(device))
+		throw core::InvalidOperationException("Replayed device doesn't match the device in the input system");
+
+	m_Devices.PushBack(device);
+}
+
+InputDevice* InputReplay::GetDevice(u32 id, EDeviceEventType type, u32 code, bool dispatch)
+{
+	if(id >= (u32)m_DeviceInfos.Size())
+		Reader::Error("Invalid device id");
+	auto& info = m_DeviceInfos[id];
+	u32 count = 0;
+	switch(type) {
+	case EDeviceEventType::Button: count = info.buttonCount; break;
+	case EDeviceEventType::Axis: count = info.axisCount; break;
+	case EDeviceEventType::Area: count = info.areaCount; break;
+	}
+	if(code >= count)
+		Reader::Error("Invalid element code");
+
+	return dispatch ? (InputDevice*)m_Devices[id] : nullptr;
+}
+
+} // namespace input
+} // namespace lux
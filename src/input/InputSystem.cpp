@@ -26,7 +26,8 @@ void InputSystem::Destroy()
 
 InputSystem::InputSystem() :
 	m_IsForeground(false),
-	m_ForegroundHandling(true)
+	m_ForegroundHandling(true),
+	m_LiveInputBlocked(false)
 {
 }
 
@@ -53,6 +54,28 @@ StrongRef<InputDevice> InputSystem::FindDevice(InputDeviceDesc* desc)
 }
 
 void InputSystem::Update(Event& event)
+{
+	if(m_LiveInputBlocked)
+		return;
+	DoUpdate(event, true);
+}
+
+void InputSystem::SetLiveInputBlocked(bool blocked)
+{
+	m_LiveInputBlocked = blocked;
+}
+
+bool InputSystem::IsLiveInputBlocked() const
+{
+	return m_LiveInputBlocked;
+}
+
+void InputSystem::SendReplayedEvent(Event& event)
+{
+	DoUpdate(event, false);
+}
+
+void InputSystem::DoUpdate(Event& event, bool checkForeground)
 {
 	if(!event.device)
 		return;
@@ -70,7 +93,7 @@ void InputSystem::Update(Event& event)
 	bool changed = event.device->Update(event);
 	if(!changed)
 		return;
-	if(!IsForeground() && !GetForegroundHandling())
+	if(checkForeground && !IsForeground() && !GetForegroundHandling())
 		return;
 	m_EventSignal.Broadcast(event);
 }
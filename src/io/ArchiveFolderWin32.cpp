@@ -18,14 +18,11 @@ namespace
 core::Array<u16> ConvertPathToWin32WidePath(const Path& p)
 {
 	core::Array<u16> out;
-	for(auto c : p.AsView().CodePoints()) {
-		u16 buffer[2];
-		int bytes = core::CodePointToUTF16(c, buffer);
-		if(buffer[0] == '/')
-			buffer[0] = '\\';
-		out.PushBack(buffer[0]);
-		if(bytes == 4)
-			out.PushBack(buffer[1]);
+	auto view = p.AsView();
+	core::UTF8ToUTF16(view.Data(), view.Size(), out);
+	for(auto& c : out) {
+		if(c == '/')
+			c = '\\';
 	}
 	out.PushBack(0);
 
@@ -1,4 +1,6 @@
 #include "math/FreeMathFunctions.h"
+#include "math/SIMD.h"
+#include "core/lxArray.h"
 
 namespace lux
 {
@@ -650,6 +652,127 @@ bool IsOrientedBoxMaybeVisible(const ViewFrustum& frustum, const math::AABBoxF&
 	return true;
 }
 
+AABBoxF TransformAABox(const AABBoxF& box, const Transformation& transform)
+{
+	Matrix4 m;
+	transform.ToMatrix(m);
+
+	// Transform the center and project the half extent on each world axis.
+	auto center = box.GetCenter();
+	auto half = box.GetExtent() * 0.5f;
+	Vector3F worldCenter;
+	Vector3F worldHalf;
+	for(int j = 0; j < 3; ++j) {
+		worldCenter[j] = center.x * m(0, j) + center.y * m(1, j) + center.z * m(2, j) + m(3, j);
+		worldHalf[j] =
+			half.x * Abs(m(0, j)) +
+			half.y * Abs(m(1, j)) +
+			half.z * Abs(m(2, j));
+	}
+
+	return AABBoxF(worldCenter - worldHalf, worldCenter + worldHalf);
+}
+
+static bool IsBehindPlane(const PlaneF& plane, const AABBoxF& box)
+{
+	return TestPlaneWithAABox(plane, box.minCorner, box.maxCorner) == EPlaneRelation::Back;
+}
+
+namespace
+{
+// Tests up to four boxes against the planes, unused lanes repeat the last box.
+void TestBoxGroup(
+	const simd::Float4 (&planes)[ViewFrustum::Count][7],
+	const AABBoxF* boxes, const int* ids, int laneCount,
+	bool* outVisible,
+	u8* planeHints)
+{
+	const simd::Float4 zero = simd::Splat(0.0f);
+	const simd::Float4 half = simd::Splat(0.5f);
+
+	// Transpose the boxes into center and half extent per axis.
+	float mins[3][4];
+	float maxs[3][4];
+	for(int lane = 0; lane < 4; ++lane) {
+		auto& box = boxes[ids[math::Min(lane, laneCount - 1)]];
+		for(int a = 0; a < 3; ++a) {
+			mins[a][lane] = box.minCorner[a];
+			maxs[a][lane] = box.maxCorner[a];
+		}
+	}
+	simd::Float4 center[3];
+	simd::Float4 extent[3];
+	for(int a = 0; a < 3; ++a) {
+		auto mi = simd::Load(mins[a]);
+		auto ma = simd::Load(maxs[a]);
+		center[a] = simd::Mul(simd::Add(mi, ma), half);
+		extent[a] = simd::Mul(simd::Sub(ma, mi), half);
+	}
+
+	// A box is behind a plane if its corner furthest along the normal
+	// is still behind it.
+	const int allLanes = (1 << laneCount) - 1;
+	int culled = 0;
+	for(int p = 0; p < ViewFrustum::Count && culled != allLanes; ++p) {
+		auto dist = simd::MulAdd(planes[p][0], center[0], planes[p][6]);
+		dist = simd::MulAdd(planes[p][1], center[1], dist);
+		dist = simd::MulAdd(planes[p][2], center[2], dist);
+		dist = simd::MulAdd(planes[p][3], extent[0], dist);
+		dist = simd::MulAdd(planes[p][4], extent[1], dist);
+		dist = simd::MulAdd(planes[p][5], extent[2], dist);
+		int newCulled = ~simd::LessMask(zero, dist) & allLanes & ~culled;
+		if(newCulled && planeHints) {
+			for(int lane = 0; lane < laneCount; ++lane) {
+				if(newCulled & (1 << lane))
+					planeHints[ids[lane]] = (u8)p;
+			}
+		}
+		culled |= newCulled;
+	}
+
+	for(int lane = 0; lane < laneCount; ++lane)
+		outVisible[ids[lane]] = (culled & (1 << lane)) == 0;
+}
+}
+
+void AreAABoxesMaybeVisible(
+	const ViewFrustum& frustum,
+	const AABBoxF* boxes, int count,
+	bool* outVisible,
+	u8* planeHints)
+{
+	simd::Float4 planes[ViewFrustum::Count][7];
+	for(int p = 0; p < ViewFrustum::Count; ++p) {
+		auto& plane = frustum.Plane((ViewFrustum::EPlane)p);
+		planes[p][0] = simd::Splat(plane.normal.x);
+		planes[p][1] = simd::Splat(plane.normal.y);
+		planes[p][2] = simd::Splat(plane.normal.z);
+		planes[p][3] = simd::Splat(Abs(plane.normal.x));
+		planes[p][4] = simd::Splat(Abs(plane.normal.y));
+		planes[p][5] = simd::Splat(Abs(plane.normal.z));
+		planes[p][6] = simd::Splat(plane.d);
+	}
+
+	// Boxes culled by the same plane as last time are rejected with a single
+	// test, all others are collected and tested in groups of four.
+	int pending[4];
+	int pendingCount = 0;
+	for(int i = 0; i < count; ++i) {
+		if(planeHints && planeHints[i] < ViewFrustum::Count &&
+			IsBehindPlane(frustum.Plane((ViewFrustum::EPlane)planeHints[i]), boxes[i])) {
+			outVisible[i] = false;
+			continue;
+		}
+		pending[pendingCount++] = i;
+		if(pendingCount == 4) {
+			TestBoxGroup(planes, boxes, pending, 4, outVisible, planeHints);
+			pendingCount = 0;
+		}
+	}
+	if(pendingCount > 0)
+		TestBoxGroup(planes, boxes, pending, pendingCount, outVisible, planeHints);
+}
+
 } // namespace math
 } // namespace lux
 
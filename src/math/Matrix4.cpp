@@ -1,4 +1,5 @@
 #include "math/Matrix4.h"
+#include "math/SIMD.h"
 
 namespace lux
 {
@@ -114,7 +115,16 @@ bool Matrix4::SetByInvertTransform(const Matrix4& mat)
 
 Matrix4 Matrix4::GetTransformInverted(bool* result) const
 {
-	float invDet = GetTransformDet();
+	// The inverse of the upper 3x3 matrix is the transposed matrix of the
+	// crossproducts of its rows divided by the determinant.
+	const simd::Float4 r0 = simd::Load3(m[0]);
+	const simd::Float4 r1 = simd::Load3(m[1]);
+	const simd::Float4 r2 = simd::Load3(m[2]);
+	const simd::Float4 c0 = simd::Cross3(r1, r2);
+	const simd::Float4 c1 = simd::Cross3(r2, r0);
+	const simd::Float4 c2 = simd::Cross3(r0, r1);
+
+	float invDet = simd::Dot3(r0, c0);
 	if(IsZero(invDet)) {
 		if(result)
 			*result = false;
@@ -125,22 +135,25 @@ Matrix4 Matrix4::GetTransformInverted(bool* result) const
 	}
 	invDet = 1 / invDet;
 
+	float c[3][4];
+	simd::Store(c[0], c0);
+	simd::Store(c[1], c1);
+	simd::Store(c[2], c2);
+
+	const simd::Float4 scale = simd::Splat(invDet);
+	const simd::Float4 o0 = simd::Mul(simd::Set(c[0][0], c[1][0], c[2][0], 0), scale);
+	const simd::Float4 o1 = simd::Mul(simd::Set(c[0][1], c[1][1], c[2][1], 0), scale);
+	const simd::Float4 o2 = simd::Mul(simd::Set(c[0][2], c[1][2], c[2][2], 0), scale);
+	simd::Float4 o3 = simd::Mul(simd::Splat(m[3][0]), o0);
+	o3 = simd::MulAdd(simd::Splat(m[3][1]), o1, o3);
+	o3 = simd::MulAdd(simd::Splat(m[3][2]), o2, o3);
+	o3 = simd::Sub(simd::Splat(0), o3);
+
 	Matrix4 out;
-	out.m[0][0] = invDet * (m[1][1] * m[2][2] - m[1][2] * m[2][1]);
-	out.m[0][1] = -invDet * (m[0][1] * m[2][2] - m[0][2] * m[2][1]);
-	out.m[0][2] = invDet * (m[0][1] * m[1][2] - m[0][2] * m[1][1]);
-	out.m[0][3] = 0;
-	out.m[1][0] = -invDet * (m[1][0] * m[2][2] - m[1][2] * m[2][0]);
-	out.m[1][1] = invDet * (m[0][0] * m[2][2] - m[0][2] * m[2][0]);
-	out.m[1][2] = -invDet * (m[0][0] * m[1][2] - m[0][2] * m[1][0]);
-	out.m[1][3] = 0;
-	out.m[2][0] = invDet * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
-	out.m[2][1] = -invDet * (m[0][0] * m[2][1] - m[0][1] * m[2][0]);
-	out.m[2][2] = invDet * (m[0][0] * m[1][1] - m[0][1] * m[1][0]);
-	out.m[2][3] = 0;
-	out.m[3][0] = -(m[3][0] * out.m[0][0] + m[3][1] * out.m[1][0] + m[3][2] * out.m[2][0]);
-	out.m[3][1] = -(m[3][0] * out.m[0][1] + m[3][1] * out.m[1][1] + m[3][2] * out.m[2][1]);
-	out.m[3][2] = -(m[3][0] * out.m[0][2] + m[3][1] * out.m[1][2] + m[3][2] * out.m[2][2]);
+	simd::Store(out.m[0], o0);
+	simd::Store(out.m[1], o1);
+	simd::Store(out.m[2], o2);
+	simd::Store(out.m[3], o3);
 	out.m[3][3] = 1;
 
 	return out;
@@ -701,18 +714,105 @@ Matrix4 Matrix4::operator* (const Matrix4& other) const
 
 Matrix4& Matrix4::SetByProduct(const Matrix4& a, const Matrix4& b)
 {
+	// Each row of the result is a linear combination of the rows of a.
+	// All inputs are read before the row is written, so a and b may alias this.
+	const simd::Float4 a0 = simd::Load(a.m[0]);
+	const simd::Float4 a1 = simd::Load(a.m[1]);
+	const simd::Float4 a2 = simd::Load(a.m[2]);
+	const simd::Float4 a3 = simd::Load(a.m[3]);
 	for(int r = 0; r < 4; ++r) {
-		for(int c = 0; c < 4; ++c) {
-			float s = 0;
-			for(int k = 0; k < 4; ++k)
-				s += a(k, c) * b(r, k);
-			m[r][c] = s;
-		}
+		const simd::Float4 br = simd::Load(b.m[r]);
+		simd::Float4 row = simd::Mul(simd::SplatLane<0>(br), a0);
+		row = simd::MulAdd(simd::SplatLane<1>(br), a1, row);
+		row = simd::MulAdd(simd::SplatLane<2>(br), a2, row);
+		row = simd::MulAdd(simd::SplatLane<3>(br), a3, row);
+		simd::Store(m[r], row);
 	}
 
 	return *this;
 }
 
+static_assert(sizeof(Vector3F) == 3 * sizeof(float), "The array kernels need packed vectors.");
+
+void Matrix4::TransformVectorArray(const Vector3F in[], Vector3F out[], int count) const
+{
+	// Four vectors at a time, with one register per component.
+	int i = 0;
+	for(; i + 4 <= count; i += 4) {
+		simd::Float4 x, y, z;
+		simd::LoadTransposed3(&in[i].x, x, y, z);
+		simd::Float4 ox = simd::MulAdd(x, simd::Splat(m[0][0]), simd::Splat(m[3][0]));
+		simd::Float4 oy = simd::MulAdd(x, simd::Splat(m[0][1]), simd::Splat(m[3][1]));
+		simd::Float4 oz = simd::MulAdd(x, simd::Splat(m[0][2]), simd::Splat(m[3][2]));
+		ox = simd::MulAdd(y, simd::Splat(m[1][0]), ox);
+		oy = simd::MulAdd(y, simd::Splat(m[1][1]), oy);
+		oz = simd::MulAdd(y, simd::Splat(m[1][2]), oz);
+		ox = simd::MulAdd(z, simd::Splat(m[2][0]), ox);
+		oy = simd::MulAdd(z, simd::Splat(m[2][1]), oy);
+		oz = simd::MulAdd(z, simd::Splat(m[2][2]), oz);
+		simd::StoreTransposed3(&out[i].x, ox, oy, oz);
+	}
+
+	const simd::Float4 r0 = simd::Load(m[0]);
+	const simd::Float4 r1 = simd::Load(m[1]);
+	const simd::Float4 r2 = simd::Load(m[2]);
+	const simd::Float4 r3 = simd::Load(m[3]);
+	for(; i < count; ++i) {
+		const Vector3F v = in[i];
+		simd::Float4 o = simd::MulAdd(simd::Splat(v.x), r0, r3);
+		o = simd::MulAdd(simd::Splat(v.y), r1, o);
+		o = simd::MulAdd(simd::Splat(v.z), r2, o);
+		simd::Store3(&out[i].x, o);
+	}
+}
+
+void Matrix4::RotateVectorArray(const Vector3F in[], Vector3F out[], int count) const
+{
+	// RotateVector multiplies with the transposed matrix, otherwise the same
+	// as TransformVectorArray without translation.
+	int i = 0;
+	for(; i + 4 <= count; i += 4) {
+		simd::Float4 x, y, z;
+		simd::LoadTransposed3(&in[i].x, x, y, z);
+		simd::Float4 ox = simd::Mul(x, simd::Splat(m[0][0]));
+		simd::Float4 oy = simd::Mul(x, simd::Splat(m[1][0]));
+		simd::Float4 oz = simd::Mul(x, simd::Splat(m[2][0]));
+		ox = simd::MulAdd(y, simd::Splat(m[0][1]), ox);
+		oy = simd::MulAdd(y, simd::Splat(m[1][1]), oy);
+		oz = simd::MulAdd(y, simd::Splat(m[2][1]), oz);
+		ox = simd::MulAdd(z, simd::Splat(m[0][2]), ox);
+		oy = simd::MulAdd(z, simd::Splat(m[1][2]), oy);
+		oz = simd::MulAdd(z, simd::Splat(m[2][2]), oz);
+		simd::StoreTransposed3(&out[i].x, ox, oy, oz);
+	}
+
+	const simd::Float4 c0 = simd::Set(m[0][0], m[1][0], m[2][0], 0);
+	const simd::Float4 c1 = simd::Set(m[0][1], m[1][1], m[2][1], 0);
+	const simd::Float4 c2 = simd::Set(m[0][2], m[1][2], m[2][2], 0);
+	for(; i < count; ++i) {
+		const Vector3F v = in[i];
+		simd::Float4 o = simd::Mul(simd::Splat(v.x), c0);
+		o = simd::MulAdd(simd::Splat(v.y), c1, o);
+		o = simd::MulAdd(simd::Splat(v.z), c2, o);
+		simd::Store3(&out[i].x, o);
+	}
+}
+
+void Matrix4::TransformPlaneArray(const PlaneF in[], PlaneF out[], int count) const
+{
+	const simd::Float4 r0 = simd::Load3(m[0]);
+	const simd::Float4 r1 = simd::Load3(m[1]);
+	const simd::Float4 r2 = simd::Load3(m[2]);
+	for(int i = 0; i < count; ++i) {
+		const PlaneF p = in[i];
+		simd::Float4 n = simd::Mul(simd::Splat(p.normal.x), r0);
+		n = simd::MulAdd(simd::Splat(p.normal.y), r1, n);
+		n = simd::MulAdd(simd::Splat(p.normal.z), r2, n);
+		simd::Store3(&out[i].normal.x, n);
+		out[i].d = p.d - p.normal.x * m[0][3] + p.normal.y * m[1][3] + p.normal.z * m[2][3];
+	}
+}
+
 Matrix4& Matrix4::operator*=(const Matrix4& other)
 {
 	Matrix4 out;
@@ -723,9 +823,10 @@ Matrix4& Matrix4::operator*=(const Matrix4& other)
 
 Matrix4& Matrix4::operator=(const Matrix4& other)
 {
-	if(*this == other) return *this;
-	for(int i = 0; i < 16; ++i)
-		(*this)[i] = other[i];
+	simd::Store(m[0], simd::Load(other.m[0]));
+	simd::Store(m[1], simd::Load(other.m[1]));
+	simd::Store(m[2], simd::Load(other.m[2]));
+	simd::Store(m[3], simd::Load(other.m[3]));
 	return *this;
 }
 
@@ -1,4 +1,5 @@
 #include "math/Quaternion.h"
+#include "math/SIMD.h"
 
 namespace lux
 {
@@ -14,4 +15,63 @@ Type QuaternionF()
 }
 }
 }
+
+namespace math
+{
+
+void MultiplyQuaternionArray(const QuaternionF a[], const QuaternionF b[], QuaternionF out[], int count)
+{
+	// Same as Quaternion::operator*=, each component of b scales a
+	// permutation of a with flipped signs.
+	const simd::Float4 signX = simd::Set(1, -1, 1, -1);
+	const simd::Float4 signY = simd::Set(1, 1, -1, -1);
+	const simd::Float4 signZ = simd::Set(-1, 1, 1, -1);
+	for(int i = 0; i < count; ++i) {
+		const simd::Float4 q = simd::Load(&a[i].x);
+		const simd::Float4 o = simd::Load(&b[i].x);
+		simd::Float4 r = simd::Mul(simd::SplatLane<3>(o), q);
+		r = simd::MulAdd(simd::SplatLane<0>(o), simd::Mul(simd::Shuffle<3, 2, 1, 0>(q), signX), r);
+		r = simd::MulAdd(simd::SplatLane<1>(o), simd::Mul(simd::Shuffle<2, 3, 0, 1>(q), signY), r);
+		r = simd::MulAdd(simd::SplatLane<2>(o), simd::Mul(simd::Shuffle<1, 0, 3, 2>(q), signZ), r);
+		simd::Store(&out[i].x, r);
+	}
+}
+
+void TransformVectorArray(const QuaternionF& q, const Vector3F in[], Vector3F out[], int count)
+{
+	const simd::Float4 w2 = simd::Splat(2 * q.w);
+	const simd::Float4 two = simd::Splat(2);
+
+	// Four vectors at a time, with one register per component.
+	const simd::Float4 qx = simd::Splat(q.x);
+	const simd::Float4 qy = simd::Splat(q.y);
+	const simd::Float4 qz = simd::Splat(q.z);
+	int i = 0;
+	for(; i + 4 <= count; i += 4) {
+		simd::Float4 x, y, z;
+		simd::LoadTransposed3(&in[i].x, x, y, z);
+		const simd::Float4 uvx = simd::Sub(simd::Mul(qy, z), simd::Mul(qz, y));
+		const simd::Float4 uvy = simd::Sub(simd::Mul(qz, x), simd::Mul(qx, z));
+		const simd::Float4 uvz = simd::Sub(simd::Mul(qx, y), simd::Mul(qy, x));
+		const simd::Float4 uuvx = simd::Sub(simd::Mul(qy, uvz), simd::Mul(qz, uvy));
+		const simd::Float4 uuvy = simd::Sub(simd::Mul(qz, uvx), simd::Mul(qx, uvz));
+		const simd::Float4 uuvz = simd::Sub(simd::Mul(qx, uvy), simd::Mul(qy, uvx));
+		x = simd::MulAdd(two, uuvx, simd::MulAdd(w2, uvx, x));
+		y = simd::MulAdd(two, uuvy, simd::MulAdd(w2, uvy, y));
+		z = simd::MulAdd(two, uuvz, simd::MulAdd(w2, uvz, z));
+		simd::StoreTransposed3(&out[i].x, x, y, z);
+	}
+
+	const simd::Float4 imag = simd::Set(q.x, q.y, q.z, 0);
+	for(; i < count; ++i) {
+		const simd::Float4 v = simd::Load3(&in[i].x);
+		const simd::Float4 uv = simd::Cross3(imag, v);
+		const simd::Float4 uuv = simd::Cross3(imag, uv);
+		simd::Float4 r = simd::MulAdd(w2, uv, v);
+		r = simd::MulAdd(two, uuv, r);
+		simd::Store3(&out[i].x, r);
+	}
+}
+
+} // namespace math
 } // namespace lux
\ No newline at end of file
@@ -0,0 +1,185 @@
+#ifndef INCLUDED_LUX_MATH_SIMD_H
+#define INCLUDED_LUX_MATH_SIMD_H
+#include "core/LuxBase.h"
+
+// Select the vector instruction set used by the math kernels.
+// Define LUX_MATH_NO_SIMD to force the scalar implementation.
+#if defined(LUX_MATH_NO_SIMD)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LUX_MATH_SSE
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LUX_MATH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace lux
+{
+namespace math
+{
+//! Thin wrapper around a four component float register.
+/**
+All kernels are written against these functions, so they work with every
+supported instruction set and with the scalar fallback.
+*/
+namespace simd
+{
+
+#if defined(LUX_MATH_SSE)
+
+using Float4 = __m128;
+
+inline Float4 Load(const float* p) { return _mm_loadu_ps(p); }
+inline Float4 Load3(const float* p) { return _mm_setr_ps(p[0], p[1], p[2], 0.0f); }
+inline void Store(float* p, Float4 a) { _mm_storeu_ps(p, a); }
+inline Float4 Set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline Float4 Splat(float f) { return _mm_set1_ps(f); }
+inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+template <int X, int Y, int Z, int W>
+inline Float4 Shuffle(Float4 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(W, Z, Y, X)); }
+//! The components X and Y of a followed by the components Z and W of b.
+template <int X, int Y, int Z, int W>
+inline Float4 Shuffle2(Float4 a, Float4 b) { return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X)); }
+inline float GetX(Float4 a) { return _mm_cvtss_f32(a); }
+//! Bitmask with one bit per component, which is set if a < b.
+inline int LessMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+
+#elif defined(LUX_MATH_NEON)
+
+using Float4 = float32x4_t;
+
+inline Float4 Load(const float* p) { return vld1q_f32(p); }
+inline Float4 Load3(const float* p) { float tmp[4] = {p[0], p[1], p[2], 0.0f}; return vld1q_f32(tmp); }
+inline void Store(float* p, Float4 a) { vst1q_f32(p, a); }
+inline Float4 Set(float x, float y, float z, float w) { float tmp[4] = {x, y, z, w}; return vld1q_f32(tmp); }
+inline Float4 Splat(float f) { return vdupq_n_f32(f); }
+inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return vmlaq_f32(c, a, b); }
+template <int X, int Y, int Z, int W>
+inline Float4 Shuffle(Float4 a)
+{
+	float tmp[4];
+	vst1q_f32(tmp, a);
+	return Set(tmp[X], tmp[Y], tmp[Z], tmp[W]);
+}
+template <int X, int Y, int Z, int W>
+inline Float4 Shuffle2(Float4 a, Float4 b)
+{
+	float tmpA[4], tmpB[4];
+	vst1q_f32(tmpA, a);
+	vst1q_f32(tmpB, b);
+	return Set(tmpA[X], tmpA[Y], tmpB[Z], tmpB[W]);
+}
+inline float GetX(Float4 a) { return vgetq_lane_f32(a, 0); }
+inline int LessMask(Float4 a, Float4 b)
+{
+	uint32x4_t c = vcltq_f32(a, b);
+	return
+		(vgetq_lane_u32(c, 0) & 1) |
+		(vgetq_lane_u32(c, 1) & 2) |
+		(vgetq_lane_u32(c, 2) & 4) |
+		(vgetq_lane_u32(c, 3) & 8);
+}
+
+#else
+
+struct Float4
+{
+	float v[4];
+};
+
+inline Float4 Set(float x, float y, float z, float w) { return Float4{{x, y, z, w}}; }
+inline Float4 Load(const float* p) { return Set(p[0], p[1], p[2], p[3]); }
+inline Float4 Load3(const float* p) { return Set(p[0], p[1], p[2], 0.0f); }
+inline void Store(float* p, Float4 a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+inline Float4 Splat(float f) { return Set(f, f, f, f); }
+inline Float4 Add(Float4 a, Float4 b) { return Set(a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]); }
+inline Float4 Sub(Float4 a, Float4 b) { return Set(a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]); }
+inline Float4 Mul(Float4 a, Float4 b) { return Set(a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]); }
+inline Float4 Min(Float4 a, Float4 b)
+{
+	return Set(
+		a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+		a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3]);
+}
+inline Float4 Max(Float4 a, Float4 b)
+{
+	return Set(
+		a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+		a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]);
+}
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return Add(Mul(a, b), c); }
+template <int X, int Y, int Z, int W>
+inline Float4 Shuffle(Float4 a) { return Set(a.v[X], a.v[Y], a.v[Z], a.v[W]); }
+template <int X, int Y, int Z, int W>
+inline Float4 Shuffle2(Float4 a, Float4 b) { return Set(a.v[X], a.v[Y], b.v[Z], b.v[W]); }
+inline float GetX(Float4 a) { return a.v[0]; }
+inline int LessMask(Float4 a, Float4 b)
+{
+	return
+		(a.v[0] < b.v[0] ? 1 : 0) | (a.v[1] < b.v[1] ? 2 : 0) |
+		(a.v[2] < b.v[2] ? 4 : 0) | (a.v[3] < b.v[3] ? 8 : 0);
+}
+
+#endif
+
+template <int I>
+inline Float4 SplatLane(Float4 a) { return Shuffle<I, I, I, I>(a); }
+
+//! Write the first three components, doesn't touch the memory behind them.
+inline void Store3(float* p, Float4 a)
+{
+	float tmp[4];
+	Store(tmp, a);
+	p[0] = tmp[0];
+	p[1] = tmp[1];
+	p[2] = tmp[2];
+}
+
+//! Load four packed three component vectors, with one register per component.
+inline void LoadTransposed3(const float* p, Float4& x, Float4& y, Float4& z)
+{
+	// a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+	const Float4 a = Load(p);
+	const Float4 b = Load(p + 4);
+	const Float4 c = Load(p + 8);
+	x = Shuffle2<0, 3, 0, 2>(a, Shuffle2<2, 2, 1, 1>(b, c));
+	y = Shuffle2<0, 2, 0, 2>(Shuffle2<1, 1, 0, 0>(a, b), Shuffle2<3, 3, 2, 2>(b, c));
+	z = Shuffle2<0, 2, 0, 2>(Shuffle2<2, 2, 1, 1>(a, b), Shuffle2<0, 0, 3, 3>(c, c));
+}
+
+//! Store four packed three component vectors, the inverse of LoadTransposed3.
+inline void StoreTransposed3(float* p, Float4 x, Float4 y, Float4 z)
+{
+	Store(p, Shuffle2<0, 2, 0, 2>(Shuffle2<0, 0, 0, 0>(x, y), Shuffle2<0, 0, 1, 1>(z, x)));
+	Store(p + 4, Shuffle2<0, 2, 0, 2>(Shuffle2<1, 1, 1, 1>(y, z), Shuffle2<2, 2, 2, 2>(x, y)));
+	Store(p + 8, Shuffle2<0, 2, 0, 2>(Shuffle2<2, 2, 3, 3>(z, x), Shuffle2<3, 3, 3, 3>(y, z)));
+}
+
+//! The crossproduct of the first three components, the fourth is zero if both inputs are zero there.
+inline Float4 Cross3(Float4 a, Float4 b)
+{
+	Float4 c = Sub(Mul(a, Shuffle<1, 2, 0, 3>(b)), Mul(Shuffle<1, 2, 0, 3>(a), b));
+	return Shuffle<1, 2, 0, 3>(c);
+}
+
+inline float Dot3(Float4 a, Float4 b)
+{
+	Float4 m = Mul(a, b);
+	return GetX(Add(Add(m, SplatLane<1>(m)), SplatLane<2>(m)));
+}
+
+} // namespace simd
+} // namespace math
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_MATH_SIMD_H
@@ -1,5 +1,6 @@
 #include "scene/Animation.h"
 #include "core/lxMemory.h"
+#include "core/lxSort.h"
 
 LX_REGISTER_REFERABLE_CLASS(lux::scene::Animation, "lux.resource.Animation");
 
@@ -20,7 +21,9 @@ AnimationController::AnimationController(AnimatedObject* o, Animation* a)
 
 AnimationController::AnimationController(AnimationController&& old) :
 	m_Object(std::move(old.m_Object)),
-	m_Animation(std::move(old.m_Animation))
+	m_Animation(std::move(old.m_Animation)),
+	m_TrackStates(std::move(old.m_TrackStates)),
+	m_Buffer(std::move(old.m_Buffer))
 {
 	m_Time = old.m_Time;
 	m_IsLooping = old.m_IsLooping;
@@ -34,6 +37,8 @@ AnimationController& AnimationController::operator=(AnimationController&& old)
 {
 	m_Object = std::move(old.m_Object);
 	m_Animation = std::move(old.m_Animation);
+	m_TrackStates = std::move(old.m_TrackStates);
+	m_Buffer = std::move(old.m_Buffer);
 	m_Time = old.m_Time;
 	m_IsLooping = old.m_IsLooping;
 	m_IsPaused = old.m_IsPaused;
@@ -53,26 +58,86 @@ void AnimationController::Reset(AnimatedObject* o, Animation* a)
 	m_IsFinished = false;
 	m_Speed = 1;
 	m_Buffer = GetMaxSize();
-	for(auto& t : m_Animation->Tracks())
-		m_HandleCache.PushBack(o->GetAnimatedValueDesc(t->GetName(), t->GetType()).GetHandle());
+	m_TrackStates.Clear();
+	for(auto& t : m_Animation->Tracks()) {
+		TrackState state;
+		state.handle = o->GetAnimatedValueDesc(t->GetName(), t->GetType()).GetHandle();
+		state.target = o->GetAnimatedValuePointer(state.handle);
+		state.token = 0;
+		m_TrackStates.PushBack(state);
+	}
 }
 
 void AnimationController::Tick(float secsPassed)
 {
-	if(!m_Animation || !m_Object)
+	if(!Advance(secsPassed))
 		return;
 
+	auto& curves = m_Animation->GetBakedCurves();
+	const int count = math::Min(m_TrackStates.Size(), curves.Size());
+	for(int i = 0; i < count; ++i)
+		ApplyTrack(i, m_Animation->GetTrack(i), curves[i]);
+}
+
+void AnimationController::TickBatch(AnimationController* const* controllers, int count, float secsPassed)
+{
+	// Group the running controllers by their animation.
+	core::Array<AnimationController*> active;
+	active.Reserve(count);
+	for(int i = 0; i < count; ++i) {
+		if(controllers[i]->Advance(secsPassed))
+			active.PushBack(controllers[i]);
+	}
+	core::Sort(active, core::CompareTypeFromSmaller<AnimationController*>([](const AnimationController* a, const AnimationController* b) {
+		return a->m_Animation.Raw() < b->m_Animation.Raw();
+	}));
+
+	for(int begin = 0; begin < active.Size();) {
+		Animation* animation = active[begin]->m_Animation;
+		int end = begin + 1;
+		while(end < active.Size() && active[end]->m_Animation == animation)
+			++end;
+
+		// Walk the tracks in the outer loop, so each curve stays in the
+		// cache while it's evaluated for all controllers.
+		auto& curves = animation->GetBakedCurves();
+		for(int t = 0; t < curves.Size(); ++t) {
+			const AnimationTrack* track = animation->GetTrack(t);
+			for(int c = begin; c < end; ++c) {
+				if(t < active[c]->m_TrackStates.Size())
+					active[c]->ApplyTrack(t, track, curves[t]);
+			}
+		}
+		begin = end;
+	}
+}
+
+bool AnimationController::Advance(float secsPassed)
+{
+	if(!m_Animation || !m_Object)
+		return false;
+
 	if(!m_IsPaused && !m_IsFinished) {
 		if(!UpdateTimer(m_Time + secsPassed * m_Speed))
-			return;
+			return false;
 	}
 
-	int id = 0;
-	for(auto& track : m_Animation->Tracks()) {
+	return true;
+}
+
+void AnimationController::ApplyTrack(int id, const AnimationTrack* track, const BakedCurve& curve)
+{
+	auto& state = m_TrackStates[id];
+	if(curve.componentCount == 0) {
+		// Can't be baked, use the generic path.
 		core::VariableAccess access(track->GetType(), m_Buffer.Pointer());
-		track->Evaluate(*this, access, &m_AnimationToken);
-		m_Object->SetAnimatedValue(m_HandleCache[id], access);
-		++id;
+		track->Evaluate(*this, access, &state.token);
+		m_Object->SetAnimatedValue(state.handle, access);
+	} else if(state.target) {
+		curve.Evaluate(m_Time, (float*)state.target, &state.token);
+	} else {
+		curve.Evaluate(m_Time, (float*)m_Buffer.Pointer(), &state.token);
+		m_Object->SetAnimatedValue(state.handle, core::VariableAccess(track->GetType(), m_Buffer.Pointer()));
 	}
 }
 
@@ -185,6 +250,7 @@ Animation::~Animation()
 StrongRef<AnimationTrack> Animation::AddTrack(const core::String& valueName, Curve* curve)
 {
 	m_Tracks.PushBack(LUX_NEW(AnimationTrack)(valueName, curve));
+	m_IsBaked = false;
 	return m_Tracks.Back();
 }
 
@@ -196,11 +262,13 @@ StrongRef<AnimationTrack> Animation::GetTrack(int id)
 void Animation::RemoveTrack(int id)
 {
 	m_Tracks.Erase(id);
+	m_IsBaked = false;
 }
 
 void Animation::RemoveTrack(AnimationTrack* track)
 {
 	m_Tracks.EraseValue(track);
+	m_IsBaked = false;
 }
 
 int Animation::GetTrackCount() const
@@ -264,5 +332,37 @@ LUX_API core::Name Animation::GetReferableType() const
 	return core::ResourceType::Animation;
 }
 
+void Animation::Bake()
+{
+	m_BakedCurves.Clear();
+	m_BakedCurves.Resize(m_Tracks.Size());
+	m_BakedChangeCounts.Resize(m_Tracks.Size());
+	for(int i = 0; i < m_Tracks.Size(); ++i)
+		BakeTrack(i);
+	m_IsBaked = true;
+}
+
+const core::Array<BakedCurve>& Animation::GetBakedCurves()
+{
+	if(!m_IsBaked) {
+		Bake();
+	} else {
+		for(int i = 0; i < m_Tracks.Size(); ++i) {
+			const AnimationTrack* track = m_Tracks[i];
+			if(track->GetCurve()->GetChangeCount() != m_BakedChangeCounts[i])
+				BakeTrack(i);
+		}
+	}
+	return m_BakedCurves;
+}
+
+void Animation::BakeTrack(int id)
+{
+	const Curve* curve = ((const AnimationTrack*)m_Tracks[id])->GetCurve();
+	m_BakedCurves[id] = BakedCurve();
+	curve->Bake(m_BakedCurves[id]);
+	m_BakedChangeCounts[id] = curve->GetChangeCount();
+}
+
 } // namespace scene
 } // namespace lux
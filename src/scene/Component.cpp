@@ -23,6 +23,98 @@ const core::Name ExponentialFog("lux.comp.ExpFog");
 const core::Name SkyBox("lux.comp.SkyBox");
 }
 
+// Components are pooled by size class, not by type.
+// The class-scope operator new only gets the size of the object, so all
+// component types with a size in the same 16 byte class share the slabs of
+// one allocator. Bigger components come from the heap.
+namespace
+{
+const size_t POOL_GRANULARITY = 16;
+const int POOL_COUNT = 32; // Components up to 512 bytes are pooled.
+
+core::SlabAllocator** GetComponentAllocators()
+{
+	// Never destroyed, components may outlive the static objects.
+	static core::SlabAllocator** allocators = []() {
+		auto out = new core::SlabAllocator*[POOL_COUNT];
+		for(int i = 0; i < POOL_COUNT; ++i)
+			out[i] = new core::SlabAllocator((i + 1) * POOL_GRANULARITY, 64);
+		return out;
+	}();
+	return allocators;
+}
+
+core::SlabAllocator* GetComponentAllocator(size_t size)
+{
+	size_t id = (size + POOL_GRANULARITY - 1) / POOL_GRANULARITY;
+	if(id == 0 || id > POOL_COUNT)
+		return nullptr;
+	return GetComponentAllocators()[id - 1];
+}
+
+// The placement delete doesn't get the size, so the allocator owning the
+// memory is searched. Only used if a constructor throws.
+void FreeComponentMemory(void* ptr)
+{
+	auto allocators = GetComponentAllocators();
+	for(int i = 0; i < POOL_COUNT; ++i) {
+		if(allocators[i]->Owns(ptr)) {
+			allocators[i]->Free(ptr);
+			return;
+		}
+	}
+	::operator delete(ptr);
+}
+}
+
+void* Component::operator new(size_t size)
+{
+	auto allocator = GetComponentAllocator(size);
+	return allocator ? allocator->Allocate() : ::operator new(size);
+}
+
+void* Component::operator new(size_t size, const core::MemoryDebugInfo& info)
+{
+	void* ptr = Component::operator new(size);
+	core::DebugNew(ptr, info);
+	return ptr;
+}
+
+void Component::operator delete(void* ptr, size_t size)
+{
+	auto allocator = GetComponentAllocator(size);
+	if(allocator)
+		allocator->Free(ptr);
+	else
+		::operator delete(ptr);
+}
+
+void Component::operator delete(void* ptr, const core::MemoryDebugInfo&)
+{
+	// Only called if the constructor throws.
+	FreeComponentMemory(ptr);
+}
+
+core::SlabAllocator::Statistics Component::GetPoolStatistics()
+{
+	core::SlabAllocator::Statistics out = {0, 0, 0};
+	auto allocators = GetComponentAllocators();
+	for(int i = 0; i < POOL_COUNT; ++i) {
+		auto stats = allocators[i]->GetStatistics();
+		out.slabCount += stats.slabCount;
+		out.capacity += stats.capacity;
+		out.used += stats.used;
+	}
+	return out;
+}
+
+void Component::ReleasePoolMemory()
+{
+	auto allocators = GetComponentAllocators();
+	for(int i = 0; i < POOL_COUNT; ++i)
+		allocators[i]->ReleaseEmptySlabs();
+}
+
 void Component::SetAnimated(bool animated)
 {
 	if(animated == m_IsAnimated)
@@ -0,0 +1,78 @@
+#include "scene/Curve.h"
+
+namespace lux
+{
+namespace scene
+{
+
+void BakedCurve::Evaluate(float time, float* out, u32* token) const
+{
+	const int count = times.Size();
+	if(count == 0) {
+		for(int c = 0; c < componentCount; ++c)
+			out[c] = 0;
+		return;
+	}
+	if(count == 1) {
+		for(int c = 0; c < componentCount; ++c)
+			out[c] = values[c];
+		return;
+	}
+
+	const float* x = times.Data();
+	time = math::CurveHelper::MapToValidRange(time, x[0], x[count - 1], edgeHandling);
+
+	// Find the segment [lower, lower+1] containing the time, the segment of
+	// the last call and the one after it are tried first.
+	int lower = token ? (int)*token : 0;
+	if(lower < 0 || lower > count - 2 || !(x[lower] <= time && time <= x[lower + 1])) {
+		if(lower >= 0 && lower + 2 < count && x[lower + 1] <= time && time <= x[lower + 2]) {
+			++lower;
+		} else {
+			// The last time not bigger than the searched one.
+			int first = 0;
+			int last = count - 2;
+			while(first < last) {
+				const int mid = (first + last + 1) / 2;
+				if(x[mid] <= time)
+					first = mid;
+				else
+					last = mid - 1;
+			}
+			lower = first;
+		}
+	}
+	if(token)
+		*token = (u32)lower;
+
+	const int upper = lower + 1;
+	const float t = (time - x[lower]) / (x[upper] - x[lower]);
+	const float* v = values.Data();
+	if(interpolation == math::EInterpolation::Const) {
+		const int i = t < 0.5f ? lower : upper;
+		for(int c = 0; c < componentCount; ++c)
+			out[c] = v[c * count + i];
+	} else if(interpolation == math::EInterpolation::Linear) {
+		for(int c = 0; c < componentCount; ++c) {
+			const float vl = v[c * count + lower];
+			const float vu = v[c * count + upper];
+			out[c] = vl + (vu - vl) * t;
+		}
+	} else {
+		const float* tan = tangents.Data();
+		const float t2 = t * t;
+		const float t3 = t2 * t;
+		for(int c = 0; c < componentCount; ++c) {
+			const float vl = v[c * count + lower];
+			const float vu = v[c * count + upper];
+			const float tl = tan[c * count + lower];
+			const float tu = tan[c * count + upper];
+			const float a = vl * 2 - vu * 2 + tl + tu;
+			const float b = vu * 3 - vl * 3 - tl * 2 - tu;
+			out[c] = a * t3 + b * t2 + tl * t + vl;
+		}
+	}
+}
+
+} // namespace scene
+} // namespace lux
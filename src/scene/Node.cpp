@@ -3,6 +3,7 @@
 #include "scene/Collider.h"
 #include "core/Logger.h"
 #include "scene/Component.h"
+#include "math/FreeMathFunctions.h"
 
 namespace lux
 {
@@ -15,13 +16,16 @@ Node::Node(Scene* scene) :
 	m_Child(nullptr),
 	m_Tags(0),
 	m_Scene(scene),
+	m_TransformIndex(-1),
 	m_IsVisible(true),
+	m_IsTrulyVisible(true),
 	m_HasUserBoundingBox(false),
 	m_CastShadow(true),
 	m_InheritTranslation(true),
 	m_InheritRotation(true),
 	m_InheritScale(true),
-	m_IsTransformDirty(true)
+	m_IsTransformDirty(true),
+	m_IsWorldBoxDirty(true)
 {
 	ConditionalUpdateAbsTransform();
 }
@@ -32,6 +36,74 @@ Node::~Node()
 	RemoveAllComponents();
 }
 
+static core::SlabAllocator& GetNodeAllocator()
+{
+	// Never destroyed, nodes may outlive the static objects.
+	static core::SlabAllocator* allocator = new core::SlabAllocator(sizeof(Node));
+	return *allocator;
+}
+
+void* Node::operator new(size_t size)
+{
+	if(size != sizeof(Node))
+		return ::operator new(size);
+	return GetNodeAllocator().Allocate();
+}
+
+void* Node::operator new(size_t size, const core::SlabHint& hint)
+{
+	void* ptr = size != sizeof(Node) ? ::operator new(size) : GetNodeAllocator().Allocate(hint.neighbour);
+#ifdef LUX_MEMORY_ALLOC_DEBUG
+	core::DebugNew(ptr, core::MemoryDebugInfo(__FILE__, __LINE__, "Node", false));
+#endif
+	return ptr;
+}
+
+void* Node::operator new(size_t size, const core::MemoryDebugInfo& info)
+{
+	void* ptr = Node::operator new(size);
+	core::DebugNew(ptr, info);
+	return ptr;
+}
+
+void Node::operator delete(void* ptr, size_t size)
+{
+	if(size != sizeof(Node))
+		::operator delete(ptr);
+	else
+		GetNodeAllocator().Free(ptr);
+}
+
+static void FreeNodeMemory(void* ptr)
+{
+	auto& allocator = GetNodeAllocator();
+	if(allocator.Owns(ptr))
+		allocator.Free(ptr);
+	else
+		::operator delete(ptr);
+}
+
+// The placement versions are only called if the constructor throws.
+void Node::operator delete(void* ptr, const core::SlabHint&)
+{
+	FreeNodeMemory(ptr);
+}
+
+void Node::operator delete(void* ptr, const core::MemoryDebugInfo&)
+{
+	FreeNodeMemory(ptr);
+}
+
+core::SlabAllocator::Statistics Node::GetPoolStatistics()
+{
+	return GetNodeAllocator().GetStatistics();
+}
+
+void Node::ReleasePoolMemory()
+{
+	GetNodeAllocator().ReleaseEmptySlabs();
+}
+
 void Node::Animate(float time)
 {
 	for(auto& c : m_Components) {
@@ -142,6 +214,7 @@ void Node::UpdateAbsTransform()
 	}
 
 	ClearTransformDirty();
+	m_IsWorldBoxDirty = true;
 }
 
 bool Node::IsVisible() const
@@ -191,6 +264,9 @@ StrongRef<Node> Node::AddChild(Node* child)
 
 	child->m_Parent = this;
 
+	if(m_Scene)
+		m_Scene->OnHierarchyChange();
+	child->SetTransformDirty();
 	child->OnAttach();
 
 	return child;
@@ -198,7 +274,8 @@ StrongRef<Node> Node::AddChild(Node* child)
 
 StrongRef<Node> Node::AddChild()
 {
-	return AddChild(LUX_NEW(Node(m_Scene)));
+	// Place the child next to its parent, to keep traversals cache friendly.
+	return AddChild(new (core::SlabHint(this)) Node(m_Scene));
 }
 
 bool Node::HasChildren() const
@@ -223,6 +300,8 @@ void Node::RemoveChild(Node* child)
 
 			child->m_Parent = nullptr;
 			child->m_Sibling = nullptr;
+			if(m_Scene)
+				m_Scene->OnHierarchyChange();
 
 			child->Drop(); // Delete child node
 			return;
@@ -254,6 +333,8 @@ void Node::RemoveAllChildren()
 	}
 
 	m_Child = nullptr;
+	if(m_Scene)
+		m_Scene->OnHierarchyChange();
 }
 
 core::Range<Node::ChildIterator> Node::Children()
@@ -324,6 +405,7 @@ void Node::SetBoundingBox(const math::AABBoxF& box)
 {
 	m_BoundingBox = box;
 	m_HasUserBoundingBox = true;
+	m_IsWorldBoxDirty = true;
 }
 
 struct BoundingBoxCollector
@@ -346,6 +428,23 @@ void Node::RecalculateBoundingBox()
 		boxCol.Add(c->GetBoundingBox());
 	m_BoundingBox = boxCol.box;
 	m_HasUserBoundingBox = false;
+	m_IsWorldBoxDirty = true;
+}
+
+void Node::OnComponentBoundingBoxChanged()
+{
+	if(!m_HasUserBoundingBox)
+		RecalculateBoundingBox();
+}
+
+const math::AABBoxF& Node::GetWorldBoundingBox()
+{
+	ConditionalUpdateAbsTransform();
+	if(m_IsWorldBoxDirty) {
+		m_WorldBoundingBox = math::TransformAABox(m_BoundingBox, m_AbsoluteTrans);
+		m_IsWorldBoxDirty = false;
+	}
+	return m_WorldBoundingBox;
 }
 
 StrongRef<Node> Node::Clone() const
@@ -379,9 +478,17 @@ Node::Node(const Node& other) :
 	m_Child(nullptr),
 	m_Tags(other.m_Tags),
 	m_Scene(other.m_Scene),
+	m_RelativeTrans(other.m_RelativeTrans),
+	m_TransformIndex(-1),
 	m_IsVisible(other.m_IsVisible),
+	m_IsTrulyVisible(true),
 	m_HasUserBoundingBox(false),
-	m_CastShadow(true)
+	m_CastShadow(true),
+	m_InheritTranslation(other.m_InheritTranslation),
+	m_InheritRotation(other.m_InheritRotation),
+	m_InheritScale(other.m_InheritScale),
+	m_IsTransformDirty(true),
+	m_IsWorldBoxDirty(true)
 {
 	for(auto child : Children()) {
 		StrongRef<Node> node = child->Clone();
@@ -429,7 +536,10 @@ void Node::SetTransformDirty()
 
 	m_IsTransformDirty = true;
 
-	// Set all children dirty to
+	// Set all children dirty to, the scene can do this without walking the tree.
+	if(m_Scene && m_Scene->SetSubtreeTransformDirty(this))
+		return;
+
 	for(auto child : Children())
 		child->SetTransformDirty();
 }
@@ -2,9 +2,13 @@
 
 #include "core/ReferableFactory.h"
 #include "core/lxAlgorithm.h"
+#include "core/lxArena.h"
+#include "core/lxProfiler.h"
 
 #include "core/Logger.h"
 
+#include "math/FreeMathFunctions.h"
+
 #include "video/DriverConfig.h"
 #include "video/VideoDriver.h"
 #include "video/RenderTarget.h"
@@ -15,6 +19,8 @@
 
 #include "scene/StencilShadowRenderer.h"
 
+#include <atomic>
+
 namespace lux
 {
 namespace scene
@@ -91,35 +97,20 @@ class RenderableCollector : public ComponentVisitor
 {
 public:
 	void Update(
-		const math::Vector3F& camPos,
+		const SceneRenderCamData& camData,
+		bool culling,
 		Node* root)
 	{
-		m_Culling = false;
-		m_CamPos = camPos;
-		Clear();
-
-		VisitComponentsRec(root, this);
-		transparentNodeList.Sort();
-	}
-
-	void Update(
-		const math::ViewFrustum& visibleFrustum,
-		const math::Vector3F& camPos,
-		Node* root)
-	{
-		m_Culling = true;
-		m_Frustum = visibleFrustum;
-		m_CamPos = camPos;
-
-		Clear();
-		VisitComponentsRec(root, this);
-		transparentNodeList.Sort();
+		m_Culling = culling;
+		m_CamData = camData;
+		m_CamPos = camData.transform.translation;
+		Collect(root);
 	}
 
 	void Visit(Component* c)
 	{
 		if(c->GetNode()->IsTrulyVisible())
-			AddRenderEntry(c->GetNode(), c);
+			m_Candidates.PushBack(c);
 	}
 
 	core::Array<RenderEntry> skyBoxList;
@@ -128,10 +119,59 @@ public:
 	core::Array<DistanceRenderEntry> transparentNodeList;
 
 private:
-	void AddRenderEntry(Node* n, Component* r)
+	void Collect(Node* root)
+	{
+		LX_PROFILE_SCOPE("Scene::Collect");
+		Clear();
+		VisitComponentsRec(root, this);
+		CullCandidates();
+		for(int i = 0; i < m_Candidates.Size(); ++i) {
+			auto c = m_Candidates[i];
+			c->PrepareRender(m_CamData);
+			AddRenderEntry(c->GetNode(), c, m_Culling && !m_IsVisible[m_CandidateBox[i]]);
+		}
+		// The farthest element must be first in list
+		core::Sort(transparentNodeList, core::SortByKey([](const DistanceRenderEntry& e) { return -e.distance; }));
+	}
+
+	void CullCandidates()
 	{
-		bool isCulled = IsCulled(n, r, m_Frustum);
+		LX_PROFILE_SCOPE("Scene::Cull");
+		// Collect the world boxes of all candidate nodes, the components
+		// of a node are visited one after another and share a box.
+		m_CandidateBox.Clear();
+		m_Boxes.Clear();
+		Node* lastNode = nullptr;
+		for(auto c : m_Candidates) {
+			Node* node = c->GetNode();
+			if(node != lastNode) {
+				lastNode = node;
+				auto& box = node->GetBoundingBox();
+				m_Boxes.PushBack(box.IsEmpty() ? box : node->GetWorldBoundingBox());
+			}
+			m_CandidateBox.PushBack(m_Boxes.Size() - 1);
+		}
+
+		m_IsVisible.Resize(m_Boxes.Size());
+		if(!m_Culling)
+			return;
+
+		// The traversal order only changes with the scene, so the culling plane
+		// of the last frame is a good first guess for the same index.
+		m_PlaneHints.Resize(m_Boxes.Size(), 0);
+		math::AreAABoxesMaybeVisible(m_CamData.frustum,
+			m_Boxes.Data(), m_Boxes.Size(),
+			m_IsVisible.Data(), m_PlaneHints.Data());
+
+		// Nodes without bounding box are never culled.
+		for(int i = 0; i < m_Boxes.Size(); ++i) {
+			if(m_Boxes[i].IsEmpty())
+				m_IsVisible[i] = true;
+		}
+	}
 
+	void AddRenderEntry(Node* n, Component* r, bool isCulled)
+	{
 		for(ERenderPass pass : r->GetRenderPass()) {
 			switch(pass) {
 			case ERenderPass::SkyBox:
@@ -156,36 +196,46 @@ private:
 		}
 	}
 
-	bool IsCulled(Node* node, Component* r, const math::ViewFrustum& frustum)
-	{
-		LUX_UNUSED(r);
-		if(!m_Culling)
-			return false;
-		if(node->GetBoundingBox().IsEmpty())
-			return false;
-		return !math::IsOrientedBoxMaybeVisible(frustum, node->GetBoundingBox(), node->GetAbsoluteTransform());
-	}
-
 	void Clear()
 	{
+		m_Candidates.Clear();
 		skyBoxList.Clear();
 		solidNodeList.Clear();
 		shadowCasters.Clear();
 		transparentNodeList.Clear();
 	}
 private:
-	math::ViewFrustum m_Frustum;
+	SceneRenderCamData m_CamData;
 	math::Vector3F m_CamPos;
 	bool m_Culling;
+
+	core::Array<Component*> m_Candidates;
+	core::Array<int> m_CandidateBox; //!< Index into m_Boxes for each candidate
+	core::Array<math::AABBoxF> m_Boxes;
+	core::Array<bool> m_IsVisible;
+	core::Array<u8> m_PlaneHints;
 };
 
-void SetFogData(video::Renderer* renderer, ClassicalFogDescription* desc, video::ColorF* overwriteColor = nullptr)
+//! Slots of the scene parameters written every frame.
+/**
+Resolved once when the renderer parameters are created, so per frame updates
+don't have to hash the parameter names.
+*/
+struct SceneParamSlots
+{
+	int camPos;
+	int ambient;
+	int fogA;
+	int fogB;
+};
+
+void SetFogData(video::Renderer* renderer, const SceneParamSlots& slots, ClassicalFogDescription* desc, video::ColorF* overwriteColor = nullptr)
 {
 	if(desc) {
 		video::ColorF fogB;
 		video::ColorF fogA;
 		fogA = overwriteColor ? *overwriteColor : desc->GetColor();
-		renderer->GetParams().SetValue("fogA", fogA);
+		renderer->GetParams().SetValue(slots.fogA, fogA);
 		auto type = desc->GetType();
 		fogB.r =
 			type == EFogType::Linear ? 1.0f :
@@ -194,11 +244,11 @@ void SetFogData(video::Renderer* renderer, ClassicalFogDescription* desc, video:
 		fogB.g = desc->GetStart();
 		fogB.b = desc->GetEnd();
 		fogB.a = desc->GetDensity();
-		renderer->GetParams().SetValue("fogB", fogB);
+		renderer->GetParams().SetValue(slots.fogB, fogB);
 	} else {
 		video::ColorF fogB;
 		fogB.r = 0.0f;
-		renderer->GetParams().SetValue("fogB", fogB);
+		renderer->GetParams().SetValue(slots.fogB, fogB);
 	}
 }
 
@@ -275,11 +325,19 @@ class LightDataManager
 {
 public:
 	LightDataManager(video::Renderer* renderer, int maxLightsPerDraw) :
-		m_MaxLightsPerDraw(maxLightsPerDraw),
-		m_Renderer(renderer)
+		m_Renderer(renderer),
+		m_MaxLightsPerDraw(maxLightsPerDraw)
 	{
 	}
 
+	//! Resolve the light parameters of the renderer parameter list.
+	void LinkParams(core::AttributeList params)
+	{
+		m_LightSlots.Clear();
+		for(int i = 0; i < m_MaxLightsPerDraw; ++i)
+			m_LightSlots.PushBack(params.FindSlot(GetLightName(i)));
+	}
+
 	void Reset()
 	{
 		m_CurLightId = 0;
@@ -301,22 +359,26 @@ public:
 private:
 	core::String GetLightName(int id)
 	{
+		static constexpr auto LIGHT_NAME = format::MakePlan("light{}");
 		core::String name;
-		format::format(name, &format::InvariantLocale, "light{}", id);
+		format::format(name, &format::InvariantLocale, LIGHT_NAME, id);
 		return name;
 	}
 
 	void SetLight(int id, ClassicalLightDescription* desc)
 	{
-		auto name = GetLightName(id);
+		int slot = m_LightSlots[id];
+		if(slot < 0)
+			return;
 		auto mat = GenerateLightMatrix(desc);
-		m_Renderer->GetParams().SetValue(name, mat);
+		m_Renderer->GetParams().SetValue(slot, mat);
 	}
 
 private:
 	video::Renderer* m_Renderer;
 	int m_CurLightId;
 	const int m_MaxLightsPerDraw;
+	core::Array<int> m_LightSlots;
 };
 
 class ScenePassManager
@@ -382,6 +444,12 @@ public:
 		alb.AddAttribute("light3", math::Matrix4());
 
 		m_RendererAttributes = alb.BuildAndReset();
+
+		m_ParamSlots.camPos = m_RendererAttributes.FindSlot("camPos");
+		m_ParamSlots.ambient = m_RendererAttributes.FindSlot("ambient");
+		m_ParamSlots.fogA = m_RendererAttributes.FindSlot("fogA");
+		m_ParamSlots.fogB = m_RendererAttributes.FindSlot("fogB");
+		m_VideoLights.LinkParams(m_RendererAttributes);
 	}
 
 	void DrawScene()
@@ -390,7 +458,7 @@ public:
 			log::Warning("No renderobject in the scenegraph.");
 
 		// Sort visible cameras by render id
-		core::Array<SceneRenderPassController*> sortedPassControllers;
+		core::FrameArray<SceneRenderPassController*> sortedPassControllers;
 		for(auto c : m_PassControllers)
 			sortedPassControllers.PushBack(c);
 		core::Sort(sortedPassControllers,
@@ -447,7 +515,7 @@ public:
 		return fog;
 	}
 
-	void ComputeClassicalLights(core::Array<ClassicalLightDescription*>& lights, video::ColorF& ambientLight)
+	void ComputeClassicalLights(core::FrameArray<ClassicalLightDescription*>& lights, video::ColorF& ambientLight)
 	{
 		ambientLight = video::ColorF(0,0,0,0);
 		lights.Clear();
@@ -469,9 +537,9 @@ public:
 	void ComputeClassicalShadowingLights(
 		int maxIlluminating,
 		int maxShadowCasters,
-		core::Array<ClassicalLightDescription*> illuminating,
-		core::Array<ClassicalLightDescription*> shadowCasting,
-		core::Array<ClassicalLightDescription*> nonShadowCasting,
+		core::FrameArray<ClassicalLightDescription*>& illuminating,
+		core::FrameArray<ClassicalLightDescription*>& shadowCasting,
+		core::FrameArray<ClassicalLightDescription*>& nonShadowCasting,
 		video::ColorF& ambientLight)
 	{
 		illuminating.Clear();
@@ -506,16 +574,16 @@ public:
 		sceneData.video = m_Renderer;
 		sceneData.camData = camData;
 
-		m_Renderer->GetParams().SetValue("camPos", camData.transform.translation);
+		m_Renderer->GetParams().SetValue(m_ParamSlots.camPos, camData.transform.translation);
 
 		//-------------------------------------------------------------------------
 		// The lights
-		core::Array<ClassicalLightDescription*> illuminating;
+		core::FrameArray<ClassicalLightDescription*> illuminating;
 		video::ColorF totalAmbientLight;
 		ComputeClassicalLights(illuminating, totalAmbientLight);
 
 		// Enable lights
-		m_Renderer->GetParams().SetValue("ambient", totalAmbientLight);
+		m_Renderer->GetParams().SetValue(m_ParamSlots.ambient, totalAmbientLight);
 		m_VideoLights.Reset();
 		for(auto light : illuminating)
 			m_VideoLights.AddLight(light);
@@ -524,7 +592,7 @@ public:
 		// The fog
 		auto fog = ComputeSingleClassicalFog();
 		if(fog.HasValue())
-			SetFogData(m_Renderer, fog.GetValue());
+			SetFogData(m_Renderer, m_ParamSlots, fog.GetValue());
 
 		// Real object rendering starts here.
 		ScenePassManager passManager(m_Renderer, m_Scene);
@@ -557,7 +625,7 @@ public:
 		sceneData.video = m_Renderer;
 		sceneData.camData = camData;
 
-		m_Renderer->GetParams().SetValue("camPos", camData.transform.translation);
+		m_Renderer->GetParams().SetValue(m_ParamSlots.camPos, camData.transform.translation);
 
 		//-------------------------------------------------------------------------
 		// The lights
@@ -566,9 +634,9 @@ public:
 		int maxShadowCastingCount = m_SceneAttributes->GetValue<int>("maxShadowCasters");
 		maxShadowCastingCount = math::Clamp(maxShadowCastingCount, 0, m_VideoLights.GetMaxLightsPerDraw());
 
-		core::Array<ClassicalLightDescription*> illuminating;
-		core::Array<ClassicalLightDescription*> shadowCasting;
-		core::Array<ClassicalLightDescription*> nonShadowCasting;
+		core::FrameArray<ClassicalLightDescription*> illuminating;
+		core::FrameArray<ClassicalLightDescription*> shadowCasting;
+		core::FrameArray<ClassicalLightDescription*> nonShadowCasting;
 		video::ColorF ambientLight;
 		ComputeClassicalShadowingLights(
 			m_VideoLights.GetMaxLightsPerDraw(),
@@ -577,13 +645,13 @@ public:
 			ambientLight);
 
 		// Enable ambient light.
-		m_Renderer->GetParams().SetValue("ambient", ambientLight);
+		m_Renderer->GetParams().SetValue(m_ParamSlots.ambient, ambientLight);
 
 		//-------------------------------------------------------------------------
 		// The fog
 		core::Optional<ClassicalFogDescription*> fog = ComputeSingleClassicalFog();
 		if(fog.HasValue())
-			SetFogData(m_Renderer, fog.GetValue());
+			SetFogData(m_Renderer, m_ParamSlots, fog.GetValue());
 
 		// Real object rendering starts here.
 		ScenePassManager passManager(m_Renderer, m_Scene);
@@ -617,7 +685,7 @@ public:
 		// To renderer correct fog, render black fog.
 		if(correctFogForStencilShadows && fog.HasValue()) {
 			auto overwriteColor = video::ColorF(0, 0, 0, 0);
-			SetFogData(m_Renderer, fog.GetValue(), &overwriteColor);
+			SetFogData(m_Renderer, m_ParamSlots, fog.GetValue(), &overwriteColor);
 		}
 
 		// Shadow pass for each shadow casting light
@@ -694,7 +762,7 @@ public:
 
 		// Restore correct fog
 		if(correctFogForStencilShadows && fog.HasValue())
-			SetFogData(m_Renderer, fog.GetValue());
+			SetFogData(m_Renderer, m_ParamSlots, fog.GetValue());
 
 		//-------------------------------------------------------------------------
 		// Transparent objects
@@ -706,6 +774,7 @@ public:
 
 	void DrawScenePass(const SceneRenderCamData& camData)
 	{
+		LX_PROFILE_SCOPE("Scene::DrawScenePass");
 
 		UpdateConfiguration();
 
@@ -730,13 +799,8 @@ public:
 		m_VisibleFogs.Update(m_FogComps);
 
 		// Collect all renderable nodes.
-		if(m_SceneAttributes->GetValue<bool>("culling")) {
-			m_RenderableCollection.Update(
-				camData.frustum, camData.transform.translation, m_Scene->GetRoot());
-		} else {
-			m_RenderableCollection.Update(
-				camData.transform.translation, m_Scene->GetRoot());
-		}
+		m_RenderableCollection.Update(
+			camData, m_SceneAttributes->GetValue<bool>("culling"), m_Scene->GetRoot());
 
 		// Begin scene
 		m_Renderer->SetRenderTarget(data.renderTarget);
@@ -766,6 +830,7 @@ private:
 	Scene* m_Scene;
 	video::Renderer* m_Renderer;
 	core::AttributeList m_RendererAttributes;
+	SceneParamSlots m_ParamSlots;
 
 	core::AttributeList* m_SceneAttributes;
 
@@ -782,10 +847,16 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////////
 
+namespace
+{
+// The node and component pools are shared by all scenes.
+std::atomic<int> g_SceneCount(0);
+}
+
 Scene::Scene() :
-	m_Root(LUX_NEW(Node)(this)),
-	renderData(new InternalRenderData(this, video::VideoDriver::Instance()->GetRenderer(), &m_Attributes))
+	m_Root(LUX_NEW(Node)(this))
 {
+	++g_SceneCount;
 	core::AttributeListBuilder alb;
 	alb.AddAttribute("drawStencilShadows", false);
 	alb.AddAttribute("maxShadowCasters", 1);
@@ -798,6 +869,13 @@ Scene::~Scene()
 	// Explicitly free all nodes
 	m_Root = nullptr;
 	ClearDeletionQueue();
+
+	// Only the last scene returns the empty slabs, the others would free memory
+	// the remaining scenes are about to reuse.
+	if(--g_SceneCount == 0) {
+		Node::ReleasePoolMemory();
+		Component::ReleasePoolMemory();
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -861,32 +939,104 @@ void Scene::RegisterForTick(Component* c, bool doRegister)
 void Scene::RegisterLight(Component* c, bool doRegister)
 {
 	if(doRegister)
-		renderData->m_LightComps.AddAndReplace(c);
-	else
+		GetRenderData()->m_LightComps.AddAndReplace(c);
+	else if(renderData)
 		renderData->m_LightComps.Erase(c);
 }
 void Scene::RegisterFog(Component* c, bool doRegister)
 {
 	if(doRegister)
-		renderData->m_FogComps.AddAndReplace(c);
-	else
+		GetRenderData()->m_FogComps.AddAndReplace(c);
+	else if(renderData)
 		renderData->m_FogComps.Erase(c);
 }
 void Scene::RegisterRenderController(SceneRenderPassController* c, bool doRegister)
 {
 	if(doRegister)
-		renderData->m_PassControllers.AddAndReplace(c);
-	else
+		GetRenderData()->m_PassControllers.AddAndReplace(c);
+	else if(renderData)
 		renderData->m_PassControllers.Erase(c);
 }
 
+InternalRenderData* Scene::GetRenderData()
+{
+	// Created on first use, so scenes which are never drawn don't need a
+	// video driver.
+	if(!renderData) {
+		auto driver = video::VideoDriver::Instance();
+		if(!driver)
+			throw core::InvalidOperationException("Drawing a scene needs a video driver");
+		renderData.reset(new InternalRenderData(this, driver->GetRenderer(), &m_Attributes));
+	}
+	return renderData.get();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 
 void Scene::AnimateAll(float secsPassed)
 {
+	LX_PROFILE_SCOPE("Scene::AnimateAll");
 	for(auto comp : m_AnimatedComps)
 		comp->Animate(secsPassed);
 	ClearDeletionQueue();
+	UpdateTransforms();
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+
+ScenePoolStatistics Scene::GetPoolStatistics() const
+{
+	ScenePoolStatistics out;
+	out.nodes = Node::GetPoolStatistics();
+	out.components = Component::GetPoolStatistics();
+	return out;
+}
+
+void Scene::UpdateTransforms()
+{
+	LX_PROFILE_SCOPE("Scene::UpdateTransforms");
+	if(m_IsTransformOrderDirty) {
+		m_TransformOrder.Clear();
+		AppendTransformOrder(m_Root, -1);
+		m_IsTransformOrderDirty = false;
+	}
+
+	if(!m_HasDirtyTransforms)
+		return;
+
+	// Parents are always before their children, so the parent transform is
+	// already up to date when a child is updated.
+	for(auto& entry : m_TransformOrder) {
+		if(entry.node->IsTransformDirty())
+			entry.node->UpdateAbsTransform();
+	}
+	m_HasDirtyTransforms = false;
+}
+
+void Scene::AppendTransformOrder(Node* node, int parent)
+{
+	int id = m_TransformOrder.Size();
+	m_TransformOrder.PushBack(TransformEntry{node, parent, id + 1});
+	node->m_TransformIndex = id;
+	for(auto child : node->Children())
+		AppendTransformOrder(child, id);
+	m_TransformOrder[id].end = m_TransformOrder.Size();
+}
+
+bool Scene::SetSubtreeTransformDirty(Node* node)
+{
+	m_HasDirtyTransforms = true;
+	if(m_IsTransformOrderDirty)
+		return false;
+
+	int id = node->m_TransformIndex;
+	if(id < 0 || id >= m_TransformOrder.Size() || m_TransformOrder[id].node != node)
+		return false;
+
+	int end = m_TransformOrder[id].end;
+	for(int i = id + 1; i < end; ++i)
+		m_TransformOrder[i].node->m_IsTransformDirty = true;
+	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -902,9 +1052,12 @@ void Scene::VisitComponents(
 
 void Scene::DrawScene()
 {
+	LX_PROFILE_SCOPE("Scene::DrawScene");
 	video::RenderStatistics::GroupScope grpScope("scene");
+	core::FrameScope frameScope;
 
-	renderData->DrawScene();
+	UpdateTransforms();
+	GetRenderData()->DrawScene();
 
 	ClearDeletionQueue();
 }
@@ -114,7 +114,9 @@ public:
 	//! Add a silhouette to the stencil buffer
 	void AddSilhouette(const math::Transformation& transform, const video::Mesh* mesh, math::Vector3F& lightPos, bool isInfiniteLight)
 	{
-		ShadowVolume shadowVolume;
+		// Reuse the volume, to keep its memory between calls.
+		ShadowVolume& shadowVolume = m_TmpVolume;
+		shadowVolume.points.Clear();
 		GenerateVolume(mesh, lightPos, isInfiniteLight, shadowVolume);
 
 		if(!shadowVolume.points.IsEmpty()) {
@@ -321,6 +323,7 @@ private:
 
 	core::OrderedMap<const video::Mesh*, AdjacenceInfo> m_AdjacenceInfo;
 	core::Array<ShadowVolume> m_Volumes;
+	ShadowVolume m_TmpVolume;
 	core::Array<bool> m_FacingData;
 
 	video::Renderer* m_Renderer;
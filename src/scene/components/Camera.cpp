@@ -25,6 +25,7 @@ void BaseCamera::Controller::Render(SceneRenderPassHelper* helper)
 	SceneRenderCamData camData;
 	camData.frustum = frustum;
 	camData.transform = m_Cam->GetNode()->GetAbsoluteTransform();
+	camData.projScale = proj(1, 1);
 
 	auto video = helper->GetRenderer();
 
@@ -2,6 +2,7 @@
 #include "scene/Node.h"
 
 #include "video/mesh/VideoMesh.h"
+#include "video/mesh/MeshLOD.h"
 #include "video/mesh/Geometry.h"
 #include "video/Renderer.h"
 
@@ -23,13 +24,20 @@ static ERenderPass GetPassFromReq(video::EMaterialReqFlag req)
 		return ERenderPass::Solid;
 }
 
+//! Relative change of the projected size needed to switch the level of detail.
+static const float LOD_HYSTERESIS = 0.1f;
+
 Mesh::Mesh() :
-	m_OnlyReadMaterials(true)
+	m_OnlyReadMaterials(true),
+	m_LODLevel(0),
+	m_LODBias(1.0f)
 {
 }
 
 Mesh::Mesh(video::Mesh* mesh) :
-	m_OnlyReadMaterials(true)
+	m_OnlyReadMaterials(true),
+	m_LODLevel(0),
+	m_LODBias(1.0f)
 {
 	SetMesh(mesh);
 }
@@ -37,7 +45,9 @@ Mesh::Mesh(video::Mesh* mesh) :
 Mesh::Mesh(const Mesh& other) :
 	m_Mesh(other.m_Mesh),
 	m_OnlyReadMaterials(other.m_OnlyReadMaterials),
-	m_BoundingBox(other.m_BoundingBox)
+	m_BoundingBox(other.m_BoundingBox),
+	m_LODLevel(0),
+	m_LODBias(other.m_LODBias)
 {
 	if(!m_OnlyReadMaterials) {
 		for(auto it = other.m_Materials.First(); it != other.m_Materials.End(); ++it) {
@@ -50,6 +60,34 @@ Mesh::~Mesh()
 {
 }
 
+void Mesh::PrepareRender(const SceneRenderCamData& camData)
+{
+	auto node = GetNode();
+	auto lodOpt = m_Mesh ? m_Mesh->GetExData<video::MeshExDataLOD>() : core::Optional<video::MeshExDataLOD*>();
+	if(!node || !lodOpt.HasValue() || m_BoundingBox.IsEmpty()) {
+		m_LODLevel = 0;
+		return;
+	}
+	auto& levels = lodOpt.GetValue()->levels;
+
+	// The projected radius of the bounding sphere.
+	const auto& transform = node->GetAbsoluteTransform();
+	const float radius = m_BoundingBox.GetExtent().GetLength() * 0.5f * transform.scale;
+	const math::Vector3F center = transform.TransformPoint(m_BoundingBox.GetCenter());
+	const float distance = center.GetDistanceTo(camData.transform.translation);
+	const float size = distance > radius ?
+		radius * camData.projScale / distance * m_LODBias :
+		math::Constants<float>::infinity();
+
+	// Level i is used below levels[i-1].screenSize, the hysteresis avoids
+	// switching back and forth at the threshold.
+	m_LODLevel = math::Min(m_LODLevel, levels.Size());
+	while(m_LODLevel < levels.Size() && size < levels[m_LODLevel].screenSize * (1 - LOD_HYSTERESIS))
+		++m_LODLevel;
+	while(m_LODLevel > 0 && size > levels[m_LODLevel - 1].screenSize * (1 + LOD_HYSTERESIS))
+		--m_LODLevel;
+}
+
 void Mesh::Render(const SceneRenderData& r)
 {
 	auto node = GetNode();
@@ -75,10 +113,22 @@ void Mesh::Render(const SceneRenderData& r)
 	const auto worldMat = node->GetAbsoluteTransform().ToMatrix();
 	r.video->SetTransform(video::ETransform::World, worldMat);
 
-	video::Geometry* geo = m_Mesh->GetGeometry();
+	video::Geometry* geo = GetRenderGeometry();
+	const video::MeshLODLevel* lod = nullptr;
+	if(m_LODLevel > 0) {
+		auto lodOpt = m_Mesh->GetExData<video::MeshExDataLOD>();
+		if(lodOpt.HasValue() && m_LODLevel <= lodOpt.GetValue()->levels.Size()) {
+			lod = &lodOpt.GetValue()->levels[m_LODLevel - 1];
+			geo = lod->geometry;
+		}
+	}
 	for(int i = 0; i < m_Mesh->GetRangeCount(); ++i) {
 		int matId, firstPrimitive, lastPrimitive;
 		m_Mesh->GetMaterialRange(i, matId, firstPrimitive, lastPrimitive);
+		if(lod) {
+			firstPrimitive = lod->firstPrimitives[i];
+			lastPrimitive = lod->lastPrimitives[i];
+		}
 		video::Material* material = m_OnlyReadMaterials ?
 			m_Mesh->GetMaterial(matId) :
 			(video::Material*)m_Materials[matId];
@@ -156,6 +206,21 @@ int Mesh::GetMaterialCount() const
 		return m_Materials.Size();
 }
 
+void Mesh::SetLODBias(float bias)
+{
+	m_LODBias = bias;
+}
+
+float Mesh::GetLODBias() const
+{
+	return m_LODBias;
+}
+
+video::Geometry* Mesh::GetRenderGeometry()
+{
+	return m_Mesh->GetGeometry();
+}
+
 StrongRef<video::Mesh> Mesh::GetMesh()
 {
 	return m_Mesh;
@@ -166,6 +231,7 @@ void Mesh::SetMesh(video::Mesh* mesh)
 	LX_CHECK_NULL_ARG(mesh);
 	m_Mesh = mesh;
 	m_BoundingBox = mesh->GetBoundingBox();
+	m_LODLevel = 0;
 
 	CopyMaterials();
 }
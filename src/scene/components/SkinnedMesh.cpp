@@ -0,0 +1,308 @@
+#include "scene/components/SkinnedMesh.h"
+#include "scene/Node.h"
+
+#include "video/mesh/VideoMesh.h"
+#include "video/mesh/Geometry.h"
+#include "video/VertexBuffer.h"
+#include "video/HardwareBufferManager.h"
+#include "video/VideoDriver.h"
+#include <cmath>
+#include <cstring>
+
+LX_REFERABLE_MEMBERS_SRC(lux::scene::SkinnedMesh, "lux.comp.SkinnedMesh");
+
+namespace lux
+{
+namespace scene
+{
+
+namespace
+{
+// Encloses the box transformed with a matrix acting on row vectors.
+math::AABBoxF TransformBox(const math::AABBoxF& box, const math::Matrix4& m)
+{
+	const math::Vector3F center = m.TransformVector(box.GetCenter());
+	const math::Vector3F half = box.GetExtent() / 2;
+	math::Vector3F extent;
+	for(int i = 0; i < 3; ++i)
+		extent[i] = std::abs(m(0, i)) * half.x + std::abs(m(1, i)) * half.y + std::abs(m(2, i)) * half.z;
+	return math::AABBoxF(center - extent, center + extent);
+}
+}
+
+SkinnedMesh::SkinnedMesh() :
+	m_PositionOffset(0),
+	m_NormalOffset(-1),
+	m_Time(0),
+	m_Speed(1),
+	m_Loop(true),
+	m_PoseDirty(true),
+	m_MatricesDirty(true),
+	m_BoxChanged(false)
+{
+	SetAnimated(true);
+}
+
+SkinnedMesh::SkinnedMesh(video::Mesh* mesh) :
+	Mesh(mesh),
+	m_PositionOffset(0),
+	m_NormalOffset(-1),
+	m_Time(0),
+	m_Speed(1),
+	m_Loop(true),
+	m_PoseDirty(true),
+	m_MatricesDirty(true),
+	m_BoxChanged(false)
+{
+	InitSkinning();
+	SetAnimated(true);
+}
+
+SkinnedMesh::SkinnedMesh(const SkinnedMesh& other) :
+	Mesh(other),
+	m_Clip(other.m_Clip),
+	m_PositionOffset(0),
+	m_NormalOffset(-1),
+	m_Time(other.m_Time),
+	m_Speed(other.m_Speed),
+	m_Loop(other.m_Loop),
+	m_PoseDirty(true),
+	m_MatricesDirty(true),
+	m_BoxChanged(false)
+{
+	if(m_Mesh)
+		InitSkinning();
+}
+
+SkinnedMesh::~SkinnedMesh()
+{
+}
+
+void SkinnedMesh::SetMesh(video::Mesh* mesh)
+{
+	if(!mesh) {
+		m_Mesh = nullptr;
+		m_Materials.Clear();
+		m_BoundingBox = math::AABBoxF::EMPTY;
+		m_Skinning = nullptr;
+		m_Geometry = nullptr;
+		m_LocalPose.Clear();
+		m_WorldPose.Clear();
+		m_SkinMatrices.Clear();
+		m_BoneBoxes.Clear();
+		m_PoseDirty = false;
+		m_MatricesDirty = false;
+		m_BoxChanged = true;
+		UpdateNodeBoundingBox();
+		return;
+	}
+
+	Mesh::SetMesh(mesh);
+	InitSkinning();
+	UpdateNodeBoundingBox();
+}
+
+void SkinnedMesh::SetClip(video::SkeletalClip* clip)
+{
+	m_Clip = clip;
+	m_PoseDirty = true;
+	m_MatricesDirty = true;
+}
+
+StrongRef<video::SkeletalClip> SkinnedMesh::GetClip() const
+{
+	return m_Clip;
+}
+
+void SkinnedMesh::SetTime(float time)
+{
+	m_Time = time;
+	m_PoseDirty = true;
+	m_MatricesDirty = true;
+}
+
+float SkinnedMesh::GetTime() const
+{
+	return m_Time;
+}
+
+void SkinnedMesh::SetSpeed(float speed)
+{
+	m_Speed = speed;
+}
+
+float SkinnedMesh::GetSpeed() const
+{
+	return m_Speed;
+}
+
+void SkinnedMesh::SetLooping(bool loop)
+{
+	m_Loop = loop;
+	m_PoseDirty = true;
+	m_MatricesDirty = true;
+}
+
+bool SkinnedMesh::GetLooping() const
+{
+	return m_Loop;
+}
+
+void SkinnedMesh::Animate(float secsPassed)
+{
+	if(m_Clip && m_Speed != 0) {
+		m_Time += secsPassed * m_Speed;
+		// Keep the time small, to keep the precision.
+		float duration = m_Clip->GetDuration();
+		if(m_Loop && duration > 0)
+			m_Time = std::fmod(m_Time, duration);
+		m_PoseDirty = true;
+		m_MatricesDirty = true;
+	}
+
+	// The box of the node must follow the pose before the scene is culled,
+	// the vertices are still skinned later.
+	if(m_MatricesDirty && m_Skinning)
+		UpdateMatrices();
+	UpdateNodeBoundingBox();
+}
+
+void SkinnedMesh::Render(const SceneRenderData& data)
+{
+	if(!m_Geometry)
+		return;
+	if(m_PoseDirty)
+		UpdatePose();
+	UpdateNodeBoundingBox();
+	m_Geometry->GetVertices()->Update();
+
+	Mesh::Render(data);
+}
+
+RenderPassSet SkinnedMesh::GetRenderPass() const
+{
+	return m_Mesh ? Mesh::GetRenderPass() : RenderPassSet();
+}
+
+void SkinnedMesh::UpdatePose()
+{
+	if(!m_Skinning)
+		return;
+
+	if(m_MatricesDirty)
+		UpdateMatrices();
+
+	video::VertexBuffer* vb = m_Geometry->GetVertices();
+	const bool hasNormals = m_NormalOffset >= 0 && !m_Skinning->normals.IsEmpty();
+	video::SkinVertices(
+		m_SkinMatrices.Data(),
+		m_Skinning->positions.Data(),
+		hasNormals ? m_Skinning->normals.Data() : nullptr,
+		m_Skinning->skin.Data(),
+		m_Skinning->positions.Size(),
+		vb->Pointer(), vb->GetStride(), m_PositionOffset, m_NormalOffset);
+
+	m_PoseDirty = false;
+}
+
+void SkinnedMesh::UpdateMatrices()
+{
+	auto& skeleton = *m_Skinning->skeleton;
+	const int jointCount = m_LocalPose.Size();
+	for(int i = 0; i < jointCount; ++i)
+		m_LocalPose[i] = skeleton.GetBindPose(i);
+	if(m_Clip)
+		m_Clip->Sample(&m_Time, 1, jointCount, m_LocalPose.Data(), m_Loop);
+
+	video::SolveJointHierarchy(skeleton.GetParents(), m_LocalPose.Data(), m_WorldPose.Data(), jointCount);
+	m_Skinning->GetSkinningMatrices(m_WorldPose.Data(), m_SkinMatrices.Data());
+
+	// A skinned vertex is a weighted mean of its bone transformed positions,
+	// so it lies in the union of the transformed bone boxes.
+	math::AABBoxF box;
+	for(int i = 0; i < m_BoneBoxes.Size(); ++i) {
+		auto boneBox = TransformBox(m_BoneBoxes[i].box, m_SkinMatrices[m_BoneBoxes[i].bone]);
+		if(i == 0)
+			box = boneBox;
+		else
+			box.AddBox(boneBox);
+	}
+	m_BoundingBox = box;
+	m_Geometry->SetBoundingBox(box);
+	m_BoxChanged = true;
+	m_MatricesDirty = false;
+}
+
+void SkinnedMesh::UpdateNodeBoundingBox()
+{
+	// Only called from the main thread, UpdatePose must not touch the node.
+	if(!m_BoxChanged)
+		return;
+	if(auto node = GetNode())
+		node->OnComponentBoundingBoxChanged();
+	m_BoxChanged = false;
+}
+
+video::Geometry* SkinnedMesh::GetRenderGeometry()
+{
+	return m_Geometry;
+}
+
+void SkinnedMesh::InitSkinning()
+{
+	m_Skinning = video::GetSkinningData(m_Mesh);
+	if(!m_Skinning || !m_Skinning->skeleton)
+		throw core::GenericInvalidArgumentException("mesh", "Mesh contains no skinning data");
+
+	// Each instance gets its own vertices, the indices are shared.
+	auto driver = video::VideoDriver::Instance();
+	auto source = m_Mesh->GetGeometry();
+	auto sourceVertices = source->GetVertices();
+	StrongRef<video::VertexBuffer> vb = driver->GetBufferManager()->CreateVertexBuffer();
+	vb->SetFormat(sourceVertices->GetFormat(), false);
+	vb->SetHWMapping(video::EHardwareBufferMapping::Dynamic);
+	vb->SetSize(sourceVertices->GetSize(), false);
+	std::memcpy(vb->Pointer(), sourceVertices->Pointer_c(), sourceVertices->GetSize() * sourceVertices->GetStride());
+
+	m_Geometry = driver->CreateEmptyGeometry(source->GetPrimitiveType());
+	m_Geometry->SetBuffer(vb, source->GetIndices(), source->GetPrimitiveType());
+	m_Geometry->SetFrontFaceWinding(source->GetFrontFaceWinding());
+	m_Geometry->SetBoundingBox(source->GetBoundingBox());
+
+	const auto& format = vb->GetFormat();
+	m_PositionOffset = format.GetElement(video::VertexElement::EUsage::Position).GetOffset();
+	auto normalElem = format.GetElement(video::VertexElement::EUsage::Normal);
+	m_NormalOffset = normalElem.IsValid() ? normalElem.GetOffset() : -1;
+
+	const int jointCount = m_Skinning->skeleton->GetJointCount();
+	m_LocalPose.Resize(jointCount);
+	m_WorldPose.Resize(jointCount);
+	m_SkinMatrices.Resize(m_Skinning->GetMatrixCount());
+
+	// Collect the bind pose vertices of each bone.
+	core::Array<int> boneBoxIds;
+	boneBoxIds.Resize(m_SkinMatrices.Size(), -1);
+	m_BoneBoxes.Clear();
+	for(int i = 0; i < m_Skinning->positions.Size(); ++i) {
+		const auto& skin = m_Skinning->skin[i];
+		const auto& pos = m_Skinning->positions[i];
+		for(int k = 0; k < 4; ++k) {
+			if(skin.weights[k] == 0)
+				continue;
+			int& id = boneBoxIds[skin.bones[k]];
+			if(id < 0) {
+				id = m_BoneBoxes.Size();
+				m_BoneBoxes.PushBack(BoneBox{skin.bones[k], math::AABBoxF(pos)});
+			} else {
+				m_BoneBoxes[id].box.AddPoint(pos);
+			}
+		}
+	}
+
+	m_PoseDirty = true;
+	m_MatricesDirty = true;
+	m_BoxChanged = true;
+}
+
+} // namespace scene
+} // namespace lux
@@ -2,6 +2,7 @@
 #include "scene/particle/ParticleSystemTemplate.h"
 
 #include "scene/Node.h"
+#include "core/lxProfiler.h"
 #include "video/Renderer.h"
 
 LX_REFERABLE_MEMBERS_SRC(lux::scene::ParticleSystem, "lux.comp.ParticleSystem");
@@ -42,6 +43,7 @@ StrongRef<ParticleSystemTemplate> ParticleSystem::GetTemplate()
 
 void ParticleSystem::Animate(float time)
 {
+	LX_PROFILE_SCOPE("ParticleSystem::Animate");
 	auto node = GetNode();
 	if(!node)
 		return;
@@ -70,6 +72,7 @@ void ParticleSystem::Render(const SceneRenderData& r)
 	if(!node)
 		return;
 
+	LX_PROFILE_SCOPE("ParticleSystem::Render");
 	if(m_Template->IsGlobal()) {
 		r.video->SetTransform(video::ETransform::World, math::Matrix4::IDENTITY);
 	} else {
@@ -194,6 +194,63 @@ void QuadRendererMachine::ComputeLocalOrientation(const Particle& particle)
 	m_Side.SetLength(0.5f);
 }
 
+void QuadRendererMachine::CollectBatches(ParticleGroupData* group)
+{
+	const core::Pool<Particle>& pool = group->GetPool();
+	const int offset = m_Model->GetParamOffset(ParticleParam::Sprite);
+
+	m_Quads.Clear();
+	m_Batches.Clear();
+	int lastBatch = -1;
+	for(core::Pool<Particle>::ConstIterator it = pool.First(); it != pool.End(); ++it) {
+		const Particle& particle = *it;
+		video::SpriteBank::Sprite sprite;
+		if(offset < 0)
+			sprite = m_Data->DefaultSprite;
+		else
+			sprite = video::SpriteBank::Sprite((int)particle.Param(offset));
+
+		math::RectF* coords = nullptr;
+		video::Texture* texture = nullptr;
+		if(!m_Data->SpriteBank || !m_Data->SpriteBank->GetSprite(sprite, particle.age, coords, texture)) {
+			coords = nullptr;
+			texture = nullptr;
+		}
+
+		// Most particles use the same texture as the one before.
+		if(lastBatch < 0 || m_Batches[lastBatch].texture != texture) {
+			lastBatch = -1;
+			for(int i = 0; i < m_Batches.Size(); ++i) {
+				if(m_Batches[i].texture == texture) {
+					lastBatch = i;
+					break;
+				}
+			}
+			if(lastBatch < 0) {
+				m_Batches.PushBack(Batch{texture, 0, 0});
+				lastBatch = m_Batches.Size() - 1;
+			}
+		}
+
+		m_Batches[lastBatch].count++;
+		m_Quads.PushBack(Quad{&particle, coords, lastBatch});
+	}
+
+	// Sort the quads by batch, keeping the order inside each batch.
+	int first = 0;
+	for(auto& batch : m_Batches) {
+		batch.first = first;
+		first += batch.count;
+		batch.count = 0;
+	}
+	m_SortedQuads.Resize(m_Quads.Size());
+	for(auto& quad : m_Quads) {
+		auto& batch = m_Batches[quad.batch];
+		m_SortedQuads[batch.first + batch.count] = quad;
+		batch.count++;
+	}
+}
+
 void QuadRendererMachine::Render(video::Renderer* videoRenderer, ParticleGroupData* group, QuadParticleRenderer* renderer)
 {
 	if(group->GetParticleCount() == 0)
@@ -202,7 +259,6 @@ void QuadRendererMachine::Render(video::Renderer* videoRenderer, ParticleGroupDa
 	CreateBuffers(group);
 
 	StrongRef<video::VertexBuffer> vertexBuffer = m_Buffer->GetVertices();
-	const core::Pool<Particle>& pool = group->GetPool();
 
 	m_Data = renderer;
 	if(!m_Data)
@@ -212,30 +268,15 @@ void QuadRendererMachine::Render(video::Renderer* videoRenderer, ParticleGroupDa
 
 	auto& pass = m_Data->EmitLight ? m_EmitPass : m_DefaultPass;
 
-	void (QuadRendererMachine::*RenderQuad)(video::Vertex3D* vertices, const Particle& particle);
+	void (QuadRendererMachine::*RenderQuad)(video::Vertex3D* vertices, const Particle& particle, const math::RectF* coords);
+	if(m_Model->IsEnabled(ParticleParam::Angle))
+		RenderQuad = &QuadRendererMachine::RenderQuad_ScaledRotated;
+	else
+		RenderQuad = &QuadRendererMachine::RenderQuad_Scaled;
 
-	video::TextureLayer particleTexture;
-	{
-		video::Texture* texture;
-		math::RectF* rect;
-		int offset = m_Model->GetParamOffset(ParticleParam::Sprite);
-		video::SpriteBank::Sprite sprite;
-		if(offset < 0)
-			sprite = m_Data->DefaultSprite;
-		else {
-			const Particle& particle = *group->GetPool().First();
-			const int spriteID = (int)particle.Param(offset);
-			sprite = video::SpriteBank::Sprite(spriteID);
-		}
-		// TODO: Allow more than one texture for particle system.
-		if(m_Data->SpriteBank->GetSprite(sprite, 0, rect, texture))
-			particleTexture = video::TextureLayer(texture);
-
-		if(m_Model->IsEnabled(ParticleParam::Angle))
-			RenderQuad = &QuadRendererMachine::RenderQuad_ScaledRotated;
-		else
-			RenderQuad = &QuadRendererMachine::RenderQuad_Scaled;
-	}
+	// Particles with sprites from different textures are split into one batch
+	// per texture, sprites packed into the same atlas page share a batch.
+	CollectBatches(group);
 
 	math::Matrix4 world = videoRenderer->GetTransform(video::ETransform::World);
 	math::Matrix4 view = videoRenderer->GetTransform(video::ETransform::View);
@@ -246,28 +287,29 @@ void QuadRendererMachine::Render(video::Renderer* videoRenderer, ParticleGroupDa
 		ComputeGlobalOrientation();
 
 	vertexBuffer->SetCursor(0);
-	int i = 0;
-	for(core::Pool<Particle>::ConstIterator it = pool.First(); it != pool.End(); ++it) {
+	for(auto& quad : m_SortedQuads) {
 		if(globalOrientation == false)
-			ComputeLocalOrientation(*it);
+			ComputeLocalOrientation(*quad.particle);
 
 		video::Vertex3D Vertices[4];
 		Vertices[0].normal = Vertices[1].normal = Vertices[2].normal = Vertices[3].normal = -m_Look;
 
-		(this->*RenderQuad)(Vertices, *it);
+		(this->*RenderQuad)(Vertices, *quad.particle, quad.coords);
 
 		vertexBuffer->AddVertices(Vertices, 4);
-		i++;
 	}
 	vertexBuffer->Update();
 
-	ShaderParamLoader::SetData data; 
-	data.layer = particleTexture;
-	videoRenderer->SendPassSettings(pass, true, &g_ParamLoader, &data);
-	videoRenderer->Draw(video::RenderRequest::FromGeometry(m_Buffer, 0, (int)(pool.GetActiveCount() * 2)));
+	for(auto& batch : m_Batches) {
+		ShaderParamLoader::SetData data;
+		if(batch.texture)
+			data.layer = video::TextureLayer(batch.texture);
+		videoRenderer->SendPassSettings(pass, true, &g_ParamLoader, &data);
+		videoRenderer->Draw(video::RenderRequest::FromGeometry(m_Buffer, batch.first * 2, batch.count * 2));
+	}
 }
 
-void QuadRendererMachine::RenderQuad_Scaled(video::Vertex3D* vertices, const Particle& particle)
+void QuadRendererMachine::RenderQuad_Scaled(video::Vertex3D* vertices, const Particle& particle, const math::RectF* coords)
 {
 	float Size = m_Model->ReadValue(particle, ParticleParam::Size);
 
@@ -281,33 +323,10 @@ void QuadRendererMachine::RenderQuad_Scaled(video::Vertex3D* vertices, const Par
 	vertices[2].position = particle.position - (Up + Side)*Size;
 	vertices[3].position = particle.position - (Up - Side)*Size;
 
-	float alpha = m_Model->ReadValue(particle, ParticleParam::Alpha);
-	float red = m_Model->ReadValue(particle, ParticleParam::Red);
-	float green = m_Model->ReadValue(particle, ParticleParam::Green);
-	float blue = m_Model->ReadValue(particle, ParticleParam::Blue);
-	vertices[0].color.SetF(alpha, red, green, blue);
-	vertices[1].color = vertices[2].color = vertices[3].color = vertices[0].color;
-
-	int offset = m_Model->GetParamOffset(ParticleParam::Sprite);
-	video::SpriteBank::Sprite sprite;
-	if(offset < 0)
-		sprite = m_Data->DefaultSprite;
-	else {
-		const int spriteID = (int)particle.Param(offset);
-		sprite = video::SpriteBank::Sprite(spriteID);
-	}
-
-	math::RectF* rect;
-	video::Texture* texture;
-	if(m_Data->SpriteBank->GetSprite(sprite, particle.age, rect, texture)) {
-		vertices[0].texture.Set(rect->left, rect->top);
-		vertices[1].texture.Set(rect->right, rect->top);
-		vertices[2].texture.Set(rect->left, rect->bottom);
-		vertices[3].texture.Set(rect->right, rect->bottom);
-	}
+	SetQuadAttributes(vertices, particle, coords);
 }
 
-void QuadRendererMachine::RenderQuad_ScaledRotated(video::Vertex3D* vertices, const Particle& particle)
+void QuadRendererMachine::RenderQuad_ScaledRotated(video::Vertex3D* vertices, const Particle& particle, const math::RectF* coords)
 {
 	float Size = m_Model->ReadValue(particle, ParticleParam::Size);
 	float angle = m_Model->ReadValue(particle, ParticleParam::Angle);
@@ -325,6 +344,11 @@ void QuadRendererMachine::RenderQuad_ScaledRotated(video::Vertex3D* vertices, co
 	vertices[2].position = particle.position - (Up + Side)*Size;
 	vertices[3].position = particle.position - (Up - Side)*Size;
 
+	SetQuadAttributes(vertices, particle, coords);
+}
+
+void QuadRendererMachine::SetQuadAttributes(video::Vertex3D* vertices, const Particle& particle, const math::RectF* coords)
+{
 	float alpha = m_Model->ReadValue(particle, ParticleParam::Alpha);
 	float red = m_Model->ReadValue(particle, ParticleParam::Red);
 	float green = m_Model->ReadValue(particle, ParticleParam::Green);
@@ -332,22 +356,11 @@ void QuadRendererMachine::RenderQuad_ScaledRotated(video::Vertex3D* vertices, co
 	vertices[0].color.SetF(alpha, red, green, blue);
 	vertices[1].color = vertices[2].color = vertices[3].color = vertices[0].color;
 
-	int offset = m_Model->GetParamOffset(ParticleParam::Sprite);
-	video::SpriteBank::Sprite sprite;
-	if(offset < 0)
-		sprite = m_Data->DefaultSprite;
-	else {
-		const int spriteID = (int)particle.Param(offset);
-		sprite = video::SpriteBank::Sprite(spriteID);
-	}
-
-	math::RectF* rect;
-	video::Texture* texture;
-	if(m_Data->SpriteBank->GetSprite(sprite, particle.age, rect, texture)) {
-		vertices[0].texture.Set(rect->left, rect->top);
-		vertices[1].texture.Set(rect->right, rect->top);
-		vertices[2].texture.Set(rect->left, rect->bottom);
-		vertices[3].texture.Set(rect->right, rect->bottom);
+	if(coords) {
+		vertices[0].texture.Set(coords->left, coords->top);
+		vertices[1].texture.Set(coords->right, coords->top);
+		vertices[2].texture.Set(coords->left, coords->bottom);
+		vertices[3].texture.Set(coords->right, coords->bottom);
 	}
 }
 
@@ -8,6 +8,8 @@
 #include "scene/particle/ParticleModel.h"
 #include "scene/particle/BuiltinParticleRenderers.h"
 
+#include "core/lxArray.h"
+
 #include "math/Matrix4.h"
 
 namespace lux
@@ -31,8 +33,27 @@ private:
 	void SetIndexBuffer(video::IndexBuffer* indexBuffer, int from, int to);
 	void CreateBuffers(ParticleGroupData* group);
 
-	void RenderQuad_Scaled(video::Vertex3D* vertices, const Particle& particle);
-	void RenderQuad_ScaledRotated(video::Vertex3D* vertices, const Particle& particle);
+	void CollectBatches(ParticleGroupData* group);
+
+	void RenderQuad_Scaled(video::Vertex3D* vertices, const Particle& particle, const math::RectF* coords);
+	void RenderQuad_ScaledRotated(video::Vertex3D* vertices, const Particle& particle, const math::RectF* coords);
+	void SetQuadAttributes(video::Vertex3D* vertices, const Particle& particle, const math::RectF* coords);
+
+private:
+	struct Quad
+	{
+		const Particle* particle;
+		const math::RectF* coords;
+		int batch;
+	};
+
+	//! Particles using the same texture, drawn with a single call
+	struct Batch
+	{
+		video::Texture* texture;
+		int first;
+		int count;
+	};
 
 private:
 	video::VideoDriver* m_Driver;
@@ -41,6 +62,10 @@ private:
 
 	StrongRef<video::Geometry> m_Buffer;
 
+	core::Array<Quad> m_Quads;
+	core::Array<Quad> m_SortedQuads;
+	core::Array<Batch> m_Batches;
+
 	math::Vector3F m_HelpLook;
 	math::Vector3F m_HelpUp;
 
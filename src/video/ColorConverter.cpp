@@ -89,15 +89,15 @@ static void Convert_Trivial(const void* src, void* dst, u32 width, u32 height, u
 	}
 }
 
-static void CopyImage(const void* src, void* dst, ColorFormat format, u32 width, u32 height, u32 pitch)
+static void CopyImage(const void* src, void* dst, ColorFormat format, u32 width, u32 height, u32 srcPitch, u32 dstPitch)
 {
 	if(dst != src) {
 		u8* dB = (u8*)dst;
 		const u8* sB = (const u8*)src;
 		for(u32 l = 0; l < height; ++l) {
 			memcpy(dB, sB, (format.GetBitsPerPixel() * width)/8);
-			dB += pitch;
-			sB += pitch;
+			dB += dstPitch;
+			sB += srcPitch;
 		}
 	}
 }
@@ -122,11 +122,11 @@ bool ColorConverter::ConvertByFormat(
 
 	if(srcPitch < width * srcFormat.GetBytePerPixel())
 		srcPitch = width * srcFormat.GetBytePerPixel();
-	if(dstPitch == width * dstFormat.GetBytePerPixel())
+	if(dstPitch < width * dstFormat.GetBytePerPixel())
 		dstPitch = width * dstFormat.GetBytePerPixel();
 
 	if(srcFormat == dstFormat)
-		CopyImage(src, dst, srcFormat, width, height, srcPitch);
+		CopyImage(src, dst, srcFormat, width, height, srcPitch, dstPitch);
 	else if(srcFormat == ColorFormat::R8G8B8 && dstFormat == ColorFormat::A8R8G8B8)
 		Convert_R8G8B8toA8R8G8B8(src, dst, width, height, srcPitch, dstPitch);
 	else if(srcFormat == ColorFormat::R8G8B8 && dstFormat == ColorFormat::A1R5G5B5)
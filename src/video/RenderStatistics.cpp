@@ -27,9 +27,15 @@ void RenderStatistics::AddPrimitives(u32 count)
 		e->primitiveCounter += count;
 }
 
+void RenderStatistics::AddStreamedBytes(u32 bytes)
+{
+	m_StreamedBytesCounter += bytes;
+}
+
 void RenderStatistics::BeginFrame()
 {
 	m_FrameStart = core::Clock::GetTicks();
+	m_StreamedBytesCounter = 0;
 	for(auto& grp : m_Groups.Values())
 		grp.Begin();
 	auto& total = m_Groups.At("total");
@@ -41,6 +47,7 @@ void RenderStatistics::EndFrame()
 {
 	auto frameEnd = core::Clock::GetTicks();
 	m_Duration = frameEnd - m_FrameStart;
+	m_StreamedBytes = m_StreamedBytesCounter;
 	for(auto& grp : m_Groups.Values())
 		grp.End();
 }
@@ -50,6 +57,11 @@ u32 RenderStatistics::GetPrimitivesDrawn() const
 	return m_Groups.Get("total").primitives;
 }
 
+u32 RenderStatistics::GetStreamedBytes() const
+{
+	return m_StreamedBytes;
+}
+
 float RenderStatistics::GetDuration() const
 {
 	return m_Duration.AsSeconds();
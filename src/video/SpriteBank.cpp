@@ -1,6 +1,8 @@
 #include "video/SpriteBank.h"
 #include "video/VideoDriver.h"
 #include "video/Texture.h"
+#include "video/ColorConverter.h"
+#include "video/images/ImageSystem.h"
 #include "core/lxAlgorithm.h"
 
 namespace lux
@@ -65,6 +67,38 @@ SpriteBank::Sprite SpriteBank::AddAnimatedSprite(
 	return SpriteBank::Sprite(-m_AnimatedSprites.Size());
 }
 
+void SpriteBank::AddAtlasSprites(
+	Image* const* images, int count, Sprite* outSprites,
+	const TextureAtlasSettings& settings)
+{
+	LX_CHECK_NULL_ARG(outSprites);
+
+	core::Array<StrongRef<Image>> pages;
+	core::Array<TextureAtlasEntry> entries;
+	entries.Resize(count);
+	BuildTextureAtlas(images, count, settings, pages, entries.Data());
+
+	core::Array<StrongRef<Texture>> textures;
+	for(auto& page : pages) {
+		auto& size = page->GetSize();
+		auto texture = ImageSystem::Instance()->CreateFittingTexture(size, page->GetColorFormat());
+		if(texture->GetSize().width < size.width || texture->GetSize().height < size.height)
+			throw core::GenericRuntimeException("Atlas page is larger than the texture");
+
+		ImageLock lock(page);
+		TextureLock texLock(texture, BaseTexture::ELockMode::Overwrite);
+		ColorConverter::ConvertByFormat(
+			lock.data, page->GetColorFormat(),
+			texLock.data, texture->GetColorFormat(),
+			size.width, size.height,
+			lock.pitch, texLock.pitch);
+		textures.PushBack(texture);
+	}
+
+	for(int i = 0; i < count; ++i)
+		outSprites[i] = AddSprite(textures[entries[i].page], entries[i].rect);
+}
+
 void SpriteBank::Clear()
 {
 	m_Sprites.Clear();
@@ -4,6 +4,7 @@
 #include "core/Logger.h"
 #include "video/VertexBuffer.h"
 #include "video/IndexBuffer.h"
+#include "video/RenderStatistics.h"
 
 #include "VideoDriverD3D9.h"
 #include "video/d3d9/D3DHelper.h"
@@ -14,6 +15,50 @@ namespace lux
 namespace video
 {
 
+namespace
+{
+const u32 STREAM_VERTEX_BUFFER_SIZE = 1024 * 1024;
+const u32 STREAM_INDEX_BUFFER_SIZE = 256 * 1024;
+
+u32 GetStreamBufferSize(u32 minSize, u32 bytes)
+{
+	u32 size = minSize;
+	while(size < bytes)
+		size *= 2;
+	return size;
+}
+
+//! Append data to a streaming buffer.
+/**
+\return The offset in bytes of the written data inside the buffer.
+*/
+template <typename RingT>
+u32 WriteStreamRing(RingT& ring, const void* data, u32 bytes, u32 alignment)
+{
+	u32 offset = ((ring.cursor + alignment - 1) / alignment) * alignment;
+	DWORD flags = D3DLOCK_NOOVERWRITE;
+	if(offset + bytes > ring.size) {
+		// Wrap around, the driver hands out fresh memory for the discarded buffer.
+		offset = 0;
+		flags = D3DLOCK_DISCARD;
+	}
+
+	HRESULT hr;
+	void* dst;
+	if(FAILED(hr = ring.buffer->Lock(offset, bytes, &dst, flags)))
+		throw core::D3D9Exception(hr);
+	memcpy(dst, data, bytes);
+	if(FAILED(hr = ring.buffer->Unlock()))
+		throw core::D3D9Exception(hr);
+
+	ring.cursor = offset + bytes;
+	RenderStatistics::Instance()->AddStreamedBytes(bytes);
+
+	return offset;
+}
+
+}
+
 BufferManagerD3D9::BufferManagerD3D9(VideoDriver* driver) :
 	BufferManagerNull(driver)
 {
@@ -108,11 +153,16 @@ void* BufferManagerD3D9::UpdateVertexBuffer(VertexBuffer* buffer, void* handle)
 		d3dBuffer = newD3DBuffer;
 	}
 
+	// A dynamic buffer which is rewritten completly doesn't have to wait for the device.
+	DWORD lockFlags = 0;
+	if(HWMapping == EHardwareBufferMapping::Dynamic && beginDirty == 0 && (UINT)endDirty + 1 >= size)
+		lockFlags = D3DLOCK_DISCARD;
+
 	void* data;
 	if(FAILED(hr = d3dBuffer->Lock(beginDirty * stride,
 		(endDirty - beginDirty + 1) * stride,
 		&data,
-		0))) {
+		lockFlags))) {
 		throw core::D3D9Exception(hr);
 	}
 
@@ -175,11 +225,16 @@ void* BufferManagerD3D9::UpdateIndexBuffer(IndexBuffer* buffer, void* handle)
 		d3dBuffer = newD3DBuffer;
 	}
 
+	// A dynamic buffer which is rewritten completly doesn't have to wait for the device.
+	DWORD lockFlags = 0;
+	if(HWMapping == EHardwareBufferMapping::Dynamic && beginDirty == 0 && (UINT)endDirty + 1 >= size)
+		lockFlags = D3DLOCK_DISCARD;
+
 	void* data;
 	if(FAILED(hr = d3dBuffer->Lock(beginDirty * stride,
 		(endDirty - beginDirty + 1) * stride,
 		&data,
-		0))) {
+		lockFlags))) {
 		throw core::D3D9Exception(hr);
 	}
 
@@ -277,11 +332,70 @@ void BufferManagerD3D9::ResetStreams()
 	m_D3DDevice->SetStreamSource(0, nullptr, 0, 0);
 }
 
+void BufferManagerD3D9::StreamVertices(const void* data, u32 count, u32 stride, IDirect3DVertexBuffer9*& outBuffer, u32& outFirstVertex)
+{
+	u32 bytes = count * stride;
+	auto& ring = m_StreamVertices;
+	if(!ring.buffer || bytes + stride > ring.size) {
+		u32 size = GetStreamBufferSize(STREAM_VERTEX_BUFFER_SIZE, bytes + stride);
+		IDirect3DVertexBuffer9* newD3DBuffer;
+		HRESULT hr;
+		if(FAILED(hr = m_D3DDevice->CreateVertexBuffer(size,
+			D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY,
+			0,
+			D3DPOOL_DEFAULT,
+			&newD3DBuffer,
+			nullptr))) {
+			throw core::D3D9Exception(hr);
+		}
+		ring.buffer.TakeOwnership(newD3DBuffer);
+		ring.size = size;
+		ring.cursor = 0;
+	}
+
+	// Align to the stride, so the data can be adressed by a vertex index.
+	u32 offset = WriteStreamRing(ring, data, bytes, stride);
+	outBuffer = ring.buffer;
+	outFirstVertex = offset / stride;
+}
+
+void BufferManagerD3D9::StreamIndices(const void* data, u32 count, EIndexFormat format, IDirect3DIndexBuffer9*& outBuffer, u32& outFirstIndex)
+{
+	u32 stride = format == EIndexFormat::Bit16 ? 2 : 4;
+	u32 bytes = count * stride;
+	auto& ring = format == EIndexFormat::Bit16 ? m_StreamIndices16 : m_StreamIndices32;
+	if(!ring.buffer || bytes > ring.size) {
+		u32 size = GetStreamBufferSize(STREAM_INDEX_BUFFER_SIZE, bytes);
+		IDirect3DIndexBuffer9* newD3DBuffer;
+		HRESULT hr;
+		if(FAILED(hr = m_D3DDevice->CreateIndexBuffer(size,
+			D3DUSAGE_DYNAMIC | D3DUSAGE_WRITEONLY,
+			format == EIndexFormat::Bit16 ? D3DFMT_INDEX16 : D3DFMT_INDEX32,
+			D3DPOOL_DEFAULT,
+			&newD3DBuffer,
+			nullptr))) {
+			throw core::D3D9Exception(hr);
+		}
+		ring.buffer.TakeOwnership(newD3DBuffer);
+		ring.size = size;
+		ring.cursor = 0;
+	}
+
+	u32 offset = WriteStreamRing(ring, data, bytes, stride);
+	outBuffer = ring.buffer;
+	outFirstIndex = offset / stride;
+}
+
 void BufferManagerD3D9::ReleaseHardwareBuffers()
 {
 	m_D3DDevice->SetStreamSource(0, nullptr, 0, 0);
 	m_D3DDevice->SetIndices(nullptr);
 
+	// The streaming buffers are recreated on their next use.
+	m_StreamVertices = StreamRing<IDirect3DVertexBuffer9>();
+	m_StreamIndices16 = StreamRing<IDirect3DIndexBuffer9>();
+	m_StreamIndices32 = StreamRing<IDirect3DIndexBuffer9>();
+
 	for(auto hb : m_HardwareBuffers) {
 		auto unknown = reinterpret_cast<IUnknown*>(hb->GetHandle());
 		unknown->Release();
@@ -38,6 +38,20 @@ public:
 		}
 	};
 
+	//! A dynamic buffer filled like a ring.
+	/**
+	New data is appended without overwriting data still used by the device,
+	when the end is reached the whole buffer is discarded and writing restarts
+	at the beginning.
+	*/
+	template <typename BufferT>
+	struct StreamRing
+	{
+		UnknownRefCounted<BufferT> buffer;
+		u32 size = 0;
+		u32 cursor = 0;
+	};
+
 public:
 	BufferManagerD3D9(VideoDriver* driver);
 	~BufferManagerD3D9();
@@ -53,6 +67,26 @@ public:
 	void ReleaseHardwareBuffers();
 	void RestoreHardwareBuffers();
 
+	//! Copy transient vertex data into the streaming vertex buffer.
+	/**
+	\param data The vertices to copy.
+	\param count The number of vertices to copy.
+	\param stride The size of a single vertex in bytes.
+	\param outBuffer Receives the buffer containing the vertices.
+	\param outFirstVertex Receives the index of the first copied vertex inside the buffer.
+	*/
+	void StreamVertices(const void* data, u32 count, u32 stride, IDirect3DVertexBuffer9*& outBuffer, u32& outFirstVertex);
+
+	//! Copy transient index data into the streaming index buffer.
+	/**
+	\param data The indices to copy.
+	\param count The number of indices to copy.
+	\param format The format of the indices.
+	\param outBuffer Receives the buffer containing the indices.
+	\param outFirstIndex Receives the index of the first copied index inside the buffer.
+	*/
+	void StreamIndices(const void* data, u32 count, EIndexFormat format, IDirect3DIndexBuffer9*& outBuffer, u32& outFirstIndex);
+
 private:
 	UnknownRefCounted<IDirect3DDevice9> m_D3DDevice;
 
@@ -61,6 +95,10 @@ private:
 	bool m_AllowStreamOffset;
 
 	core::Array<HardwareBuffer*> m_HardwareBuffers;
+
+	StreamRing<IDirect3DVertexBuffer9> m_StreamVertices;
+	StreamRing<IDirect3DIndexBuffer9> m_StreamIndices16;
+	StreamRing<IDirect3DIndexBuffer9> m_StreamIndices32;
 };
 
 } // namespace video
@@ -351,15 +351,29 @@ void RendererD3D9::Draw(const RenderRequest& rq)
 
 	HRESULT hr = E_FAIL;
 	if(rq.userPointer) {
+		// Copy user data into the streaming buffers, this avoids the
+		// internal copy and synchronization of the *UP draw calls.
+		BufferManagerD3D9* d3d9Manager = m_Driver->GetBufferManager().As<BufferManagerD3D9>();
 		DWORD stride = (DWORD)vformat->GetStride();
+		IDirect3DVertexBuffer9* vertexBuffer;
+		u32 firstVertex;
 		if(rq.indexed) {
 			DWORD indexStride = iformat == EIndexFormat::Bit16 ? 2 : 4;
-			D3DFORMAT d3dIndexFormat = GetD3DIndexFormat(iformat);
 			auto indexData = (u8*)rq.userData.indexData + indexOffset * indexStride;
-			hr = m_Device->DrawIndexedPrimitiveUP(d3dPrimitiveType, 0, vertexCount, rq.primitiveCount, indexData, d3dIndexFormat, rq.userData.vertexData, stride);
+			u32 indexCount = video::GetPointCount(rq.primitiveType, rq.primitiveCount);
+			IDirect3DIndexBuffer9* indexBuffer;
+			u32 firstIndex;
+			d3d9Manager->StreamVertices(rq.userData.vertexData, vertexCount, stride, vertexBuffer, firstVertex);
+			d3d9Manager->StreamIndices(indexData, indexCount, iformat, indexBuffer, firstIndex);
+			if(SUCCEEDED(hr = m_Device->SetStreamSource(0, vertexBuffer, 0, stride)) &&
+				SUCCEEDED(hr = m_Device->SetIndices(indexBuffer)))
+				hr = m_Device->DrawIndexedPrimitive(d3dPrimitiveType, firstVertex, 0, vertexCount, firstIndex, rq.primitiveCount);
 		} else {
 			auto vertexData = (u8*)rq.userData.vertexData + vertexOffset * stride;
-			hr = m_Device->DrawPrimitiveUP(d3dPrimitiveType, rq.primitiveCount, vertexData, stride);
+			u32 streamCount = video::GetPointCount(rq.primitiveType, rq.primitiveCount);
+			d3d9Manager->StreamVertices(vertexData, streamCount, stride, vertexBuffer, firstVertex);
+			if(SUCCEEDED(hr = m_Device->SetStreamSource(0, vertexBuffer, 0, stride)))
+				hr = m_Device->DrawPrimitive(d3dPrimitiveType, firstVertex, rq.primitiveCount);
 		}
 	} else {
 		if(rq.indexed)
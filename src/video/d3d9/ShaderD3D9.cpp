@@ -547,7 +547,7 @@ ShaderD3D9::ShaderD3D9(
 	m_ParamPackage(paramPackage),
 	m_CurAttributes(nullptr)
 {
-	m_SceneValueAttributeCache.Resize(sceneParams.Size());
+	m_SceneValueSlotCache.Resize(sceneParams.Size(), -1);
 }
 
 ShaderD3D9::~ShaderD3D9()
@@ -572,13 +572,11 @@ void ShaderD3D9::LoadSceneParams(core::AttributeList sceneAttributes, const Pass
 		// Link with scene values.
 		int i = 0;
 		for(auto& sv : m_SceneValues) {
-			core::AttributePtr ptr;
-			ptr = sceneAttributes.Pointer(sv.name);
+			int slot = sceneAttributes.FindSlot(sv.name);
+			if(slot >= 0 && GetCoreType(sv.type) != sceneAttributes.GetAttribute(slot)->GetType())
+				slot = -1;
 
-			if(ptr && GetCoreType(sv.type) != ptr->GetType())
-				ptr = core::AttributePtr(nullptr);
-
-			m_SceneValueAttributeCache[i] = ptr;
+			m_SceneValueSlotCache[i] = slot;
 			++i;
 		}
 		m_CurAttributes = sceneAttributes;
@@ -586,8 +584,9 @@ void ShaderD3D9::LoadSceneParams(core::AttributeList sceneAttributes, const Pass
 
 	LUX_UNUSED(pass);
 	for(int i = 0; i < m_SceneValues.Size(); ++i) {
-		if(m_SceneValueAttributeCache[i])
-			SetShaderValue(m_SceneValues[i], m_SceneValueAttributeCache[i]->GetValuePointer());
+		int slot = m_SceneValueSlotCache[i];
+		if(slot >= 0)
+			SetShaderValue(m_SceneValues[i], sceneAttributes.GetAttribute(slot)->GetValuePointer());
 	}
 }
 
@@ -121,7 +121,7 @@ private:
 	core::ParamPackage m_ParamPackage;
 
 	mutable core::AttributeList m_CurAttributes;
-	mutable core::Array<core::AttributePtr> m_SceneValueAttributeCache;
+	mutable core::Array<int> m_SceneValueSlotCache;
 };
 
 } // namespace video
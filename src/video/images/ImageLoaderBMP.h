@@ -9,7 +9,7 @@ namespace lux
 namespace video
 {
 
-class ImageLoaderBMP : public core::ResourceLoader
+class LUX_API ImageLoaderBMP : public core::ResourceLoader
 {
 public:
 	void LoadResource(io::File* file, core::Referable* dst);
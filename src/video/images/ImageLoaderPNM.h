@@ -7,7 +7,7 @@ namespace lux
 namespace video
 {
 
-class ImageLoaderPNM : public core::ResourceLoader
+class LUX_API ImageLoaderPNM : public core::ResourceLoader
 {
 public:
 	core::Name GetResourceType(io::File* file, core::Name requestedType);
@@ -7,7 +7,7 @@ namespace lux
 namespace video
 {
 
-class ImageLoaderTGA : public core::ResourceLoader
+class LUX_API ImageLoaderTGA : public core::ResourceLoader
 {
 public:
 	const core::String& GetName() const;
@@ -7,7 +7,7 @@ namespace lux
 namespace video
 {
 
-class ImageWriterBMP : public ImageWriter
+class LUX_API ImageWriterBMP : public ImageWriter
 {
 public:
 	const core::String& GetName() const
@@ -7,7 +7,7 @@ namespace lux
 namespace video
 {
 
-class ImageWriterTGA : public video::ImageWriter
+class LUX_API ImageWriterTGA : public video::ImageWriter
 {
 public:
 	const core::String& GetName() const
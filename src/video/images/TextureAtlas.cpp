@@ -0,0 +1,241 @@
+#include "video/images/TextureAtlas.h"
+#include "video/images/ImageSystem.h"
+#include "video/ColorConverter.h"
+#include "core/lxSort.h"
+#include "math/lxMath.h"
+#include <cstring>
+
+namespace lux
+{
+namespace video
+{
+
+TextureAtlasPacker::TextureAtlasPacker(const TextureAtlasSettings& settings) :
+	m_Settings(settings)
+{
+	if(m_Settings.pageSize.width <= 0 || m_Settings.pageSize.height <= 0)
+		throw core::GenericInvalidArgumentException("settings", "Atlas pages must not be empty");
+	if(m_Settings.gutter < 0 || m_Settings.padding < 0 || m_Settings.alignment < 1)
+		throw core::GenericInvalidArgumentException("settings", "Invalid gutter, padding or alignment");
+}
+
+void TextureAtlasPacker::Pack(const math::Dimension2I* sizes, int count, TextureAtlasEntry* out)
+{
+	const int gutter = m_Settings.gutter;
+	for(int i = 0; i < count; ++i) {
+		if(sizes[i].width < 0 || sizes[i].height < 0)
+			throw core::GenericInvalidArgumentException("sizes", "Sprite sizes must not be negative");
+		if(sizes[i].width + 2 * gutter > m_Settings.pageSize.width ||
+			sizes[i].height + 2 * gutter > m_Settings.pageSize.height)
+			throw core::GenericInvalidArgumentException("sizes", "A sprite is larger than an atlas page");
+	}
+
+	core::Array<int> order;
+	order.Resize(count);
+	for(int i = 0; i < count; ++i)
+		order[i] = i;
+	core::Sort(order, core::CompareTypeFromSmaller<int>([sizes](int a, int b) {
+		if(sizes[a].height != sizes[b].height)
+			return sizes[a].height > sizes[b].height;
+		if(sizes[a].width != sizes[b].width)
+			return sizes[a].width > sizes[b].width;
+		return a < b;
+	}));
+
+	for(int i : order) {
+		// The sprite and its gutter must fit, the padding and the alignment
+		// may be cut off at the border of the page.
+		const int width = sizes[i].width + 2 * gutter;
+		const int height = sizes[i].height + 2 * gutter;
+
+		const int cellWidth = Align(width + m_Settings.padding);
+		const int cellHeight = Align(height + m_Settings.padding);
+
+		int page = 0;
+		int node = -1;
+		int y = 0;
+		for(; page < m_Pages.Size(); ++page) {
+			if(FindPosition(m_Pages[page], width, height, cellWidth, node, y))
+				break;
+		}
+		if(page == m_Pages.Size()) {
+			auto& newPage = m_Pages.EmplaceBack();
+			newPage.skyline.PushBack(SkylineNode{0, 0, m_Settings.pageSize.width});
+			node = 0;
+			y = 0;
+		}
+
+		const int x = m_Pages[page].skyline[node].x;
+		Place(m_Pages[page], node, y, cellWidth, cellHeight);
+
+		out[i].page = page;
+		out[i].rect = math::RectI(
+			x + gutter, y + gutter,
+			x + gutter + sizes[i].width, y + gutter + sizes[i].height);
+	}
+}
+
+int TextureAtlasPacker::GetPageCount() const
+{
+	return m_Pages.Size();
+}
+
+const TextureAtlasSettings& TextureAtlasPacker::GetSettings() const
+{
+	return m_Settings;
+}
+
+void TextureAtlasPacker::Clear()
+{
+	m_Pages.Clear();
+}
+
+bool TextureAtlasPacker::FindPosition(const Page& page, int width, int height, int cellWidth, int& outNode, int& outY) const
+{
+	const auto& skyline = page.skyline;
+	int bestTop = m_Settings.pageSize.height + 1;
+	for(int i = 0; i < skyline.Size(); ++i) {
+		if(skyline[i].x + width > m_Settings.pageSize.width)
+			break;
+
+		// The cell lies on the highest node below it.
+		const int span = math::Min(cellWidth, m_Settings.pageSize.width - skyline[i].x);
+		int y = 0;
+		int covered = 0;
+		for(int j = i; covered < span; ++j) {
+			y = math::Max(y, skyline[j].y);
+			covered += skyline[j].width;
+		}
+
+		if(y + height < bestTop) {
+			bestTop = y + height;
+			outNode = i;
+			outY = y;
+		}
+	}
+
+	return bestTop <= m_Settings.pageSize.height;
+}
+
+void TextureAtlasPacker::Place(Page& page, int node, int y, int width, int height)
+{
+	auto& skyline = page.skyline;
+	const int x = skyline[node].x;
+	width = math::Min(width, m_Settings.pageSize.width - x);
+	skyline.Insert(SkylineNode{x, y + height, width}, node);
+
+	// Cut the nodes below the new one.
+	const int right = x + width;
+	int i = node + 1;
+	while(i < skyline.Size() && skyline[i].x < right) {
+		const int shrink = right - skyline[i].x;
+		if(shrink < skyline[i].width) {
+			skyline[i].x += shrink;
+			skyline[i].width -= shrink;
+			break;
+		}
+		skyline.EraseHoldOrder(i);
+	}
+
+	// Merge neighbours with the same height.
+	for(int j = 0; j + 1 < skyline.Size();) {
+		if(skyline[j].y == skyline[j + 1].y) {
+			skyline[j].width += skyline[j + 1].width;
+			skyline.EraseHoldOrder(j + 1);
+		} else {
+			++j;
+		}
+	}
+}
+
+int TextureAtlasPacker::Align(int value) const
+{
+	const int a = m_Settings.alignment;
+	return ((value + a - 1) / a) * a;
+}
+
+void FillAtlasGutter(
+	u8* data, int pitch, const math::Dimension2I& pageSize, int bytesPerPixel,
+	const math::RectI& rect, int gutter)
+{
+	if(rect.IsEmpty() || gutter <= 0)
+		return;
+
+	const int left = math::Max(rect.left - gutter, 0);
+	const int right = math::Min(rect.right + gutter, pageSize.width);
+	const int top = math::Max(rect.top - gutter, 0);
+	const int bottom = math::Min(rect.bottom + gutter, pageSize.height);
+
+	// Extend each row to the left and right.
+	for(int y = rect.top; y < rect.bottom; ++y) {
+		u8* row = data + y * pitch;
+		const u8* first = row + rect.left * bytesPerPixel;
+		const u8* last = row + (rect.right - 1) * bytesPerPixel;
+		for(int x = left; x < rect.left; ++x)
+			memcpy(row + x * bytesPerPixel, first, bytesPerPixel);
+		for(int x = rect.right; x < right; ++x)
+			memcpy(row + x * bytesPerPixel, last, bytesPerPixel);
+	}
+
+	// Copy the extended first and last row, this fills the corners too.
+	const int rowBytes = (right - left) * bytesPerPixel;
+	const u8* first = data + rect.top * pitch + left * bytesPerPixel;
+	const u8* last = data + (rect.bottom - 1) * pitch + left * bytesPerPixel;
+	for(int y = top; y < rect.top; ++y)
+		memcpy(data + y * pitch + left * bytesPerPixel, first, rowBytes);
+	for(int y = rect.bottom; y < bottom; ++y)
+		memcpy(data + y * pitch + left * bytesPerPixel, last, rowBytes);
+}
+
+void BuildTextureAtlas(
+	Image* const* images, int count,
+	const TextureAtlasSettings& settings,
+	core::Array<StrongRef<Image>>& outPages,
+	TextureAtlasEntry* outEntries)
+{
+	outPages.Clear();
+	if(count == 0)
+		return;
+
+	core::Array<math::Dimension2I> sizes;
+	sizes.Reserve(count);
+	for(int i = 0; i < count; ++i) {
+		if(!images[i])
+			throw core::GenericInvalidArgumentException("images", "Images must not be null");
+		sizes.PushBack(images[i]->GetSize());
+	}
+
+	const ColorFormat format = images[0]->GetColorFormat();
+	for(int i = 0; i < count; ++i) {
+		if(!ColorConverter::IsConvertable(images[i]->GetColorFormat(), format))
+			throw core::GenericInvalidArgumentException("images", "Image format can't be converted to the atlas format");
+	}
+
+	TextureAtlasPacker packer(settings);
+	packer.Pack(sizes.Data(), count, outEntries);
+
+	for(int p = 0; p < packer.GetPageCount(); ++p) {
+		auto page = ImageSystem::Instance()->CreateImage(settings.pageSize, format);
+		ImageLock pageLock(page);
+		for(int i = 0; i < count; ++i) {
+			const auto& entry = outEntries[i];
+			if(entry.page != p)
+				continue;
+
+			ImageLock lock(images[i]);
+			u8* dst = pageLock.data + entry.rect.top * pageLock.pitch + entry.rect.left * format.GetBytePerPixel();
+			ColorConverter::ConvertByFormat(
+				lock.data, images[i]->GetColorFormat(),
+				dst, format,
+				entry.rect.GetWidth(), entry.rect.GetHeight(),
+				lock.pitch, pageLock.pitch);
+			FillAtlasGutter(pageLock.data, pageLock.pitch, settings.pageSize,
+				format.GetBytePerPixel(), entry.rect, settings.gutter);
+		}
+		pageLock.Unlock();
+		outPages.PushBack(page);
+	}
+}
+
+} // namespace video
+} // namespace lux
@@ -0,0 +1,143 @@
+#include "video/mesh/MeshLOD.h"
+#include "video/mesh/MeshOptimizer.h"
+#include "video/VertexBuffer.h"
+#include "video/IndexBuffer.h"
+#include "video/HardwareBufferManager.h"
+#include "video/VideoDriver.h"
+#include <cmath>
+#include <cstring>
+
+namespace lux
+{
+namespace video
+{
+
+StrongRef<MeshExDataLOD> GenerateLODs(
+	Mesh* mesh,
+	int levelCount,
+	float reduction,
+	float maxError,
+	float errorTolerance)
+{
+	LX_CHECK_NULL_ARG(mesh);
+	if(reduction <= 0 || reduction >= 1)
+		throw core::GenericInvalidArgumentException("reduction", "Reduction must be between 0 and 1");
+
+	auto existing = mesh->GetExData<MeshExDataLOD>();
+	if(existing.HasValue())
+		mesh->RemoveExData(existing.GetValue());
+
+	auto geo = mesh->GetGeometry();
+	if(!geo || geo->GetPrimitiveType() != EPrimitiveType::Triangles)
+		return nullptr;
+	auto vb = geo->GetVertices();
+	auto ib = geo->GetIndices();
+	if(!vb || !ib)
+		return nullptr;
+	auto posElem = vb->GetFormat().GetElement(VertexElement::EUsage::Position);
+	if(!posElem.IsValid() || posElem.GetType() != VertexElement::EType::Float3)
+		return nullptr;
+	const float radius = mesh->GetBoundingBox().GetExtent().GetLength() * 0.5f;
+	if(radius <= 0)
+		return nullptr;
+
+	const int vertexCount = vb->GetSize();
+	const int stride = vb->GetStride();
+	core::Array<math::Vector3F> positions;
+	positions.Resize(vertexCount);
+	const u8* posData = (const u8*)vb->Pointer_c() + posElem.GetOffset();
+	for(int i = 0; i < vertexCount; ++i)
+		std::memcpy(&positions[i], posData + i * stride, sizeof(math::Vector3F));
+
+	const int indexCount = geo->GetPrimitiveCount() * 3;
+	core::Array<u32> indices;
+	indices.Resize(indexCount);
+	for(int i = 0; i < indexCount; ++i)
+		indices[i] = (u32)ib->GetIndex(i);
+
+	// Vertices on the border between two materials must stay in place, or
+	// the ranges would tear apart.
+	const int rangeCount = mesh->GetRangeCount();
+	core::Array<int> rangeBegins;
+	core::Array<int> rangeEnds;
+	core::Array<int> owners;
+	core::Array<u8> locked;
+	owners.Resize(vertexCount, -1);
+	locked.Resize(vertexCount, 0);
+	for(int r = 0; r < rangeCount; ++r) {
+		int material, first, last;
+		mesh->GetMaterialRange(r, material, first, last);
+		rangeBegins.PushBack(first * 3);
+		rangeEnds.PushBack((last + 1) * 3);
+		for(int i = first * 3; i < (last + 1) * 3; ++i) {
+			const u32 v = indices[i];
+			if(owners[v] == -1)
+				owners[v] = r;
+			else if(owners[v] != r)
+				locked[v] = 1;
+		}
+	}
+
+	StrongRef<MeshExDataLOD> data = LUX_NEW(MeshExDataLOD);
+	auto driver = VideoDriver::Instance();
+	core::Array<u32> simplified;
+	core::Array<u32> levelIndices;
+	simplified.Resize(indexCount);
+	int lastCount = indexCount;
+	float targetFraction = 1.0f;
+	for(int level = 0; level < levelCount; ++level) {
+		targetFraction *= reduction;
+
+		MeshLODLevel lod;
+		float levelError = 0;
+		levelIndices.Clear();
+		for(int r = 0; r < rangeCount; ++r) {
+			const int begin = rangeBegins[r];
+			const int count = rangeEnds[r] - begin;
+			const int target = (int)(count / 3 * targetFraction) * 3;
+			float rangeError = 0;
+			const int newCount = SimplifyMesh(
+				simplified.Data(), indices.Data() + begin, count,
+				positions.Data(), vertexCount,
+				target, maxError * radius,
+				locked.Data(), &rangeError);
+			levelError = math::Max(levelError, rangeError);
+
+			const int firstPrimitive = levelIndices.Size() / 3;
+			lod.firstPrimitives.PushBack(firstPrimitive);
+			lod.lastPrimitives.PushBack(firstPrimitive + newCount / 3 - 1);
+			for(int i = 0; i < newCount; ++i)
+				levelIndices.PushBack(simplified[i]);
+		}
+
+		// Stop when the error bound doesn't allow any more simplification.
+		const int newIndexCount = levelIndices.Size();
+		if(newIndexCount == 0 || newIndexCount >= lastCount)
+			break;
+		lastCount = newIndexCount;
+
+		StrongRef<IndexBuffer> newIb = driver->GetBufferManager()->CreateIndexBuffer();
+		newIb->SetFormat(ib->GetFormat(), false);
+		newIb->SetSize(newIndexCount, false);
+		newIb->SetIndices32(levelIndices.Data(), newIndexCount, 0);
+		newIb->Update();
+
+		lod.geometry = driver->CreateEmptyGeometry(EPrimitiveType::Triangles);
+		lod.geometry->SetBuffer(vb, newIb, EPrimitiveType::Triangles);
+		lod.geometry->SetFrontFaceWinding(geo->GetFrontFaceWinding());
+		lod.geometry->SetBoundingBox(geo->GetBoundingBox());
+
+		lod.error = levelError / radius;
+		lod.screenSize = lod.error > 0 ? errorTolerance / lod.error : math::Constants<float>::infinity();
+		data->levels.PushBack(lod);
+	}
+
+	if(data->levels.IsEmpty())
+		return nullptr;
+
+	mesh->AddExData(data);
+	return data;
+}
+
+} // namespace video
+} // namespace lux
@@ -1,8 +1,10 @@
 #include "MeshLoaderOBJ.h"
+#include "ObjParser.h"
 
 #include "core/ResourceSystem.h"
 
 #include "core/Logger.h"
+#include "core/StringConverter.h"
 
 #include "video/MaterialLibrary.h"
 #include "video/VideoDriver.h"
@@ -10,6 +12,7 @@
 #include "video/VertexTypes.h"
 #include "video/mesh/VideoMesh.h"
 #include "video/mesh/Geometry.h"
+#include "video/mesh/MeshManipulator.h"
 
 #include "io/FileSystem.h"
 #include "io/File.h"
@@ -20,10 +23,11 @@
 
 #include "core/lxMemory.h"
 #include "core/lxHashMap.h"
+#include "core/lxProfiler.h"
+#include "core/threading/lxThreadPool.h"
 
-#include <sstream>
-#include <vector>
-#include <tinyobjloader/tiny_obj_loader.h>
+#include <cstring>
+#include <thread>
 
 namespace lux
 {
@@ -32,6 +36,28 @@ namespace video
 
 ///////////////////////////////////////////////////////////////////////////////
 
+MeshLoaderOBJ::MeshLoaderOBJ() :
+	m_ParsePool(nullptr)
+{
+}
+
+MeshLoaderOBJ::~MeshLoaderOBJ()
+{
+	delete m_ParsePool;
+}
+
+core::ThreadPool* MeshLoaderOBJ::GetParsePool()
+{
+	// Meshes can be loaded from multiple threads.
+	std::lock_guard<std::mutex> lock(m_ParsePoolLock);
+	if(!m_ParsePool) {
+		// The calling thread parses a chunk itself.
+		const int threadCount = math::Max((int)std::thread::hardware_concurrency() - 1, 1);
+		m_ParsePool = new core::ThreadPool(threadCount);
+	}
+	return m_ParsePool;
+}
+
 core::Name MeshLoaderOBJ::GetResourceType(io::File* file, core::Name requestedType)
 {
 	if(!requestedType.IsEmpty() && requestedType != core::ResourceType::Mesh)
@@ -50,142 +76,64 @@ const core::String& MeshLoaderOBJ::GetName() const
 	return name;
 }
 
-class LuxObjMaterialReader : public tinyobj::MaterialReader
+namespace
 {
-public:
-	LuxObjMaterialReader(const io::Path& baseDir)
-		: m_BaseDir(baseDir)
-	{
-	}
-	virtual ~LuxObjMaterialReader() {}
-	virtual bool operator()(const std::string &matId,
-		std::vector<tinyobj::material_t> *materials,
-		std::map<std::string, int> *matMap, std::string *err)
-	{
-		StrongRef<io::File> mtlFile;
-		io::Path matPath(matId.data());
-
-		auto fileSys = io::FileSystem::Instance();
-		if(fileSys->ExistFile(matPath))
-			mtlFile = fileSys->OpenFile(matPath);
-		if(!mtlFile) {
-			auto newFile = matPath.GetResolved(m_BaseDir);
-			mtlFile = fileSys->OpenFile(newFile);
-		}
-
-		if(!mtlFile) {
-			std::stringstream ss;
-			ss << "WARN: Material file [ " << matId << " ] not found." << std::endl;
-			if(err) {
-				(*err) += ss.str();
-			}
-			return false;
-		}
-
-		auto filesize = mtlFile->GetSize();
-		if(!filesize)
-			throw core::FileFormatException("Can't load streaming file", "obj");
-
-		core::RawMemory memory(core::SafeCast<size_t>(filesize));
-		mtlFile->ReadBinary(filesize, memory);
-		std::stringstream fileStream;
-		fileStream.write(memory, filesize);
-
-		std::string warning;
-		tinyobj::LoadMtl(matMap, materials, &fileStream, &warning);
 
-		if(!warning.empty()) {
-			if(err) {
-				(*err) += warning;
-			}
-		}
-
-		return true;
+struct ObjCornerHasher
+{
+	unsigned int operator()(const ObjCorner& corner) const
+	{
+		core::SequenceHasher hasher;
+		hasher.Add((unsigned int)corner.position);
+		hasher.Add((unsigned int)corner.texcoord);
+		hasher.Add((unsigned int)corner.normal);
+		return core::IntHashFunc(hasher.GetHash());
 	}
-
-private:
-	io::Path m_BaseDir;
 };
 
+}
+
 struct ObjLoader
 {
 public:
-	ObjLoader(io::File* file, core::Referable* resource)
+	ObjLoader(io::File* file, core::Referable* resource, MeshLoaderOBJ* owner) :
+		loader(owner)
 	{
 		auto mesh = dynamic_cast<video::Mesh*>(resource);
 		if(!mesh)
 			throw core::InvalidOperationException("Wrong resource type passed");
 
 		basePath = file->GetPath().GetFileDir();
+
+		// Parse in place if the file is in memory.
 		auto filesize = file->GetSize();
-		core::RawMemory memory(core::SafeCast<size_t>(filesize));
-		file->ReadBinary(filesize, memory);
-		std::stringstream fileStream;
-		fileStream.write(memory, filesize);
-
-		LuxObjMaterialReader mtlReader(basePath);
-		std::string error;
-		bool result = tinyobj::LoadObj(&attrib, &shapes, &materials, &error, &fileStream, &mtlReader, true);
-		if(!result)
-			throw core::FileFormatException("Invalid file format", "obj");
-
-		if(shapes.empty())
-			throw core::FileFormatException("File contains no geometry", "obj");
+		const char* data = (const char*)file->GetBuffer();
+		core::RawMemory memory;
+		if(!data) {
+			memory.SetSize(core::SafeCast<size_t>(filesize));
+			file->ReadBinary(filesize, memory);
+			data = memory;
+		}
 
-		ConvertMaterials();
+		ParseChunks(data, data + filesize);
+		LoadMaterials();
 		invalidMaterial = video::MaterialLibrary::Instance()->CloneMaterial(video::MaterialLibrary::DebugOverlayName);
 		invalidMaterial->SetDiffuse(video::Color::Pink);
 
-		size_t indexCount = 0;
-		for(const auto& s : shapes)
-			indexCount += s.mesh.indices.size();
-		if(indexCount > INT_MAX)
-			throw core::FileFormatException("To many indices", "obj");
-
-		bool use32BitIndices = attrib.vertices.size() > std::numeric_limits<u16>::max();
+		BuildGeometry();
 
 		auto geo = video::VideoDriver::Instance()->CreateGeometry();
-		vertexBuffer = geo->GetVertices();
-		indexBuffer = geo->GetIndices();
-		if(use32BitIndices)
-			indexBuffer->SetFormat(video::EIndexFormat::Bit32);
+		auto vertexBuffer = geo->GetVertices();
+		auto indexBuffer = geo->GetIndices();
+		lxAssert(vertexBuffer->GetStride() == sizeof(video::Vertex3D));
+		vertexBuffer->SetSize(vertices.Size(), false);
+		std::memcpy(vertexBuffer->Pointer(), vertices.Data(), vertices.Size() * sizeof(video::Vertex3D));
+		if(vertices.Size() > math::Constants<u16>::max())
+			indexBuffer->SetFormat(video::EIndexFormat::Bit32, false);
 		else
-			indexBuffer->SetFormat(video::EIndexFormat::Bit16);
-		indexBuffer->Reserve((int)indexCount);
-
-		u32 realFaceId = 0;
-		int prevMaterialId = -1;
-		for(const auto& s : shapes) {
-			const auto& objmesh = s.mesh;
-			u32 faceId = 0;
-			u32 indexCounter = 0;
-			for(auto i : objmesh.indices) {
-				int matId = objmesh.material_ids[faceId];
-
-				auto mat = GetMaterial(matId);
-				u32 index32 = GetIndex(i, mat);
-				u16 index16 = (u16)index32;
-				if(use32BitIndices)
-					indexBuffer->AddIndex(&index32);
-				else
-					indexBuffer->AddIndex(&index16);
-				indexCounter = (indexCounter + 1) % 3;
-				if(indexCounter == 0) {
-					if(materialRanges.IsEmpty() || matId != prevMaterialId) {
-						MaterialRange newRange;
-						newRange.first = realFaceId;
-						newRange.last = realFaceId;
-						newRange.matId = matId;
-						materialRanges.PushBack(newRange);
-						prevMaterialId = matId;
-					} else {
-						materialRanges.Back().last++;
-					}
-					++faceId;
-					++realFaceId;
-				}
-			}
-		}
+			indexBuffer->SetFormat(video::EIndexFormat::Bit16, false);
+		indexBuffer->SetSize(indices.Size(), false);
+		indexBuffer->SetIndices32(indices.Data(), indices.Size(), 0);
 
 		indexBuffer->Update();
 		vertexBuffer->Update();
@@ -200,51 +148,147 @@ public:
 			if(matRange.matId != -1)
 				mesh->SetMaterialRange(GetMaterial(matRange.matId), matRange.first, matRange.last);
 		}
+
+		// Obj files store the faces in modeling order, which is bad for the vertex cache.
+		video::MeshManipulatorOptimize()(mesh);
 	}
 
-	u32 GetIndex(tinyobj::index_t idx, const video::Material* material)
+	//! Parse the file, large files are split at line breaks and parsed in parallel.
+	void ParseChunks(const char* begin, const char* end)
 	{
-		auto it = indexMap.find(idx);
-		if(it == indexMap.end()) {
-			u32 newIdx = vertexBuffer->GetCursor();
-			video::Vertex3D vert;
-			if(idx.vertex_index != -1)
-				vert.position.Set(attrib.vertices[3 * idx.vertex_index], attrib.vertices[3 * idx.vertex_index + 1], attrib.vertices[3 * idx.vertex_index + 2]);
-			if(idx.normal_index != -1)
-				vert.normal.Set(attrib.normals[3 * idx.normal_index], attrib.normals[3 * idx.normal_index + 1], attrib.normals[3 * idx.normal_index + 2]);
-			if(idx.texcoord_index != -1)
-				vert.texture.Set(attrib.texcoords[2 * idx.texcoord_index], attrib.texcoords[2 * idx.texcoord_index + 1]);
-			if(material)
-				vert.color = material->GetDiffuse().ToHex();
-			else
-				vert.color = video::Color::Pink;
-			vertexBuffer->AddVertex(&vert);
-
-			indexMap[idx] = newIdx;
-			return newIdx;
-		} else {
-			return it->second;
+		// Smaller files are parsed on the calling thread, handing them to
+		// the pool costs more than it saves.
+		const s64 MIN_CHUNK_SIZE = 1 << 20;
+		const int threadCount = math::Max((int)std::thread::hardware_concurrency(), 1);
+		const int chunkCount = (int)math::Clamp<s64>((end - begin) / MIN_CHUNK_SIZE, 1, threadCount);
+		ParseObjGeometry(begin, end, chunkCount, geometry, chunkCount > 1 ? loader->GetParsePool() : nullptr);
+	}
+
+	//! Create the vertices and indices, equal corners share a vertex.
+	void BuildGeometry()
+	{
+		LX_PROFILE_SCOPE("ObjLoader::BuildGeometry");
+		s64 cornerCount = 0;
+		for(auto& chunk : geometry.chunks)
+			cornerCount += chunk.corners.Size();
+		if(cornerCount == 0)
+			throw core::FileFormatException("File contains no geometry", "obj");
+		if(cornerCount > INT_MAX)
+			throw core::FileFormatException("To many indices", "obj");
+
+		core::FlatHashMap<ObjCorner, u32, ObjCornerHasher> vertexMap;
+		vertexMap.Reserve(geometry.positions.Size());
+		vertices.Reserve(geometry.positions.Size());
+		indices.Reserve((int)cornerCount);
+
+		int matId = -1;
+		video::Color color = GetMaterial(matId)->GetDiffuse().ToHex();
+		int faceId = 0;
+		for(auto& chunk : geometry.chunks) {
+			int nextUse = 0;
+			for(int i = 0; i < chunk.corners.Size(); i += 3) {
+				while(nextUse < chunk.materialUses.Size() && chunk.materialUses[nextUse].triangle == i / 3) {
+					matId = FindMaterial(chunk.materialUses[nextUse].name);
+					color = GetMaterial(matId)->GetDiffuse().ToHex();
+					++nextUse;
+				}
+
+				for(int j = 0; j < 3; ++j) {
+					const auto& corner = chunk.corners[i + j];
+					auto result = vertexMap.SetIfNotExist(corner, (u32)vertices.Size());
+					if(result.addedNew)
+						vertices.PushBack(MakeVertex(corner, color));
+					indices.PushBack(result.GetValue());
+				}
+
+				if(materialRanges.IsEmpty() || matId != materialRanges.Back().matId) {
+					MaterialRange newRange;
+					newRange.first = faceId;
+					newRange.last = faceId;
+					newRange.matId = matId;
+					materialRanges.PushBack(newRange);
+				} else {
+					materialRanges.Back().last++;
+				}
+				++faceId;
+			}
+			// Material changes after the last face of the chunk.
+			for(; nextUse < chunk.materialUses.Size(); ++nextUse) {
+				matId = FindMaterial(chunk.materialUses[nextUse].name);
+				color = GetMaterial(matId)->GetDiffuse().ToHex();
+			}
+		}
+	}
+
+	video::Vertex3D MakeVertex(const ObjCorner& corner, video::Color color)
+	{
+		video::Vertex3D vert;
+		vert.position = geometry.positions[corner.position];
+		vert.normal = corner.normal >= 0 ? geometry.normals[corner.normal] : math::Vector3F(0, 0, 0);
+		vert.texture = corner.texcoord >= 0 ? geometry.texcoords[corner.texcoord] : math::Vector2F(0, 0);
+		vert.color = color;
+		return vert;
+	}
+
+	void LoadMaterials()
+	{
+		// Only the first material library which can be loaded is used.
+		for(auto& chunk : geometry.chunks) {
+			for(auto& lib : chunk.materialLibs) {
+				if(LoadMaterialLibrary(lib))
+					return;
+			}
 		}
 	}
 
-	struct IndexTLess
+	bool LoadMaterialLibrary(core::StringView name)
 	{
-		bool operator()(const tinyobj::index_t& a, const tinyobj::index_t& b) const
-		{
-			if(a.vertex_index != b.vertex_index)
-				return a.vertex_index < b.vertex_index;
-			if(a.normal_index != b.normal_index)
-				return a.normal_index < b.normal_index;
-			if(a.texcoord_index != b.texcoord_index)
-				return a.texcoord_index < b.texcoord_index;
+		StrongRef<io::File> mtlFile;
+		io::Path matPath(name);
+
+		auto fileSys = io::FileSystem::Instance();
+		if(fileSys->ExistFile(matPath))
+			mtlFile = fileSys->OpenFile(matPath);
+		if(!mtlFile) {
+			auto newFile = matPath.GetResolved(basePath);
+			if(fileSys->ExistFile(newFile))
+				mtlFile = fileSys->OpenFile(newFile);
+		}
+
+		if(!mtlFile) {
+			log::Warning("Material file [ {} ] not found.", name);
 			return false;
 		}
-	};
 
-	void ConvertMaterials()
+		auto filesize = mtlFile->GetSize();
+		if(!filesize)
+			throw core::FileFormatException("Can't load streaming file", "obj");
+
+		const char* data = (const char*)mtlFile->GetBuffer();
+		core::RawMemory memory;
+		if(!data) {
+			memory.SetSize(core::SafeCast<size_t>(filesize));
+			mtlFile->ReadBinary(filesize, memory);
+			data = memory;
+		}
+
+		ParseMaterialLibrary(data, data + filesize);
+		return true;
+	}
+
+	void ParseMaterialLibrary(const char* begin, const char* end)
 	{
-		for(auto& mat : materials)
+		core::Array<ObjMaterial> materials;
+		ParseObjMaterialLibrary(begin, end, materials);
+		for(auto& mat : materials) {
+			materialIds.SetIfNotExist(mat.name, luxMaterials.Size());
 			luxMaterials.PushBack(ConvertMaterial(mat));
+		}
+	}
+
+	int FindMaterial(core::StringView name)
+	{
+		return materialIds.Get(core::String(name), -1);
 	}
 
 	StrongRef<Texture> LoadTexture(const io::Path& path)
@@ -262,7 +306,7 @@ public:
 		return texture;
 	}
 
-	StrongRef<video::Material> ConvertMaterial(const tinyobj::material_t& mat)
+	StrongRef<video::Material> ConvertMaterial(const ObjMaterial& mat)
 	{
 		StrongRef<Material> lxm;
 		if(mat.dissolve != 1)
@@ -281,8 +325,8 @@ public:
 			lxm->SetSpecularHardness(mat.shininess);
 		}
 
-		if(!mat.diffuse_texname.empty()) {
-			io::Path texname = mat.diffuse_texname.data();
+		if(!mat.diffuseTexture.IsEmpty()) {
+			io::Path texname = mat.diffuseTexture;
 			lxm->SetTexture(0, LoadTexture(texname));
 		}
 
@@ -296,10 +340,11 @@ public:
 		return invalidMaterial;
 	}
 
-	std::map<tinyobj::index_t, u32, IndexTLess> indexMap;
-	tinyobj::attrib_t attrib;
-	std::vector<tinyobj::shape_t> shapes;
-	std::vector<tinyobj::material_t> materials;
+	ObjGeometry geometry;
+	core::Array<video::Vertex3D> vertices;
+	core::Array<u32> indices;
+
+	core::HashMap<core::String, int> materialIds;
 	core::Array<StrongRef<Material>> luxMaterials;
 	StrongRef<Material> invalidMaterial;
 
@@ -312,15 +357,13 @@ public:
 
 	core::Array<MaterialRange> materialRanges;
 
-	IndexBuffer* indexBuffer;
-	VertexBuffer* vertexBuffer;
-
 	io::Path basePath;
+	MeshLoaderOBJ* loader;
 };
 
 void MeshLoaderOBJ::LoadResource(io::File* file, core::Referable* dst)
 {
-	ObjLoader(file, dst);
+	ObjLoader(file, dst, this);
 }
 
 }
@@ -1,18 +1,33 @@
 #ifndef INCLUDED_LUX_OBJ_MESHLOADER_H
 #define INCLUDED_LUX_OBJ_MESHLOADER_H
 #include "core/ResourceLoader.h"
+#include <mutex>
 
 namespace lux
 {
+namespace core
+{
+class ThreadPool;
+}
 namespace video
 {
 
 class MeshLoaderOBJ : public core::ResourceLoader
 {
 public:
+	MeshLoaderOBJ();
+	~MeshLoaderOBJ();
+
 	core::Name GetResourceType(io::File* file, core::Name requestedType);
 	void LoadResource(io::File* file, core::Referable* dst);
 	const core::String& GetName() const;
+
+	//! The pool used to parse large files, created on first use.
+	core::ThreadPool* GetParsePool();
+
+private:
+	core::ThreadPool* m_ParsePool;
+	std::mutex m_ParsePoolLock;
 };
 
 }
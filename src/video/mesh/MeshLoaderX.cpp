@@ -2,6 +2,8 @@
 #include "math/Matrix4.h"
 #include "video/mesh/VideoMesh.h"
 #include "video/mesh/Geometry.h"
+#include "video/mesh/Skeleton.h"
+#include "video/mesh/MeshManipulator.h"
 #include "video/VertexBuffer.h"
 #include "video/IndexBuffer.h"
 #include "video/VideoDriver.h"
@@ -15,8 +17,6 @@
 #include "core/lxException.h"
 #include "core/lxGUID.h"
 
-// TODO: Merging of skinning data.
-
 namespace lux
 {
 namespace video
@@ -443,41 +443,37 @@ private:
 		}
 
 		if(c == '-' || c == '+' || (c >= '0' && c <= '9')) {
-			bool sign = false;
-			if(c == '-') {
-				sign = true;
-				c = ReadChar();
-			} else if(c == '+') {
-				sign = false;
-				c = ReadChar();
-			}
-			int iValue = 0;
-			while(c >= '0' && c <= '9') {
-				iValue *= 10;
-				iValue += c - '0';
+			// Collect the number and let the string converter parse it.
+			char number[64];
+			int size = 0;
+			bool isFloat = false;
+			int prev = 0;
+			while((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' ||
+				((c == '-' || c == '+') && (size == 0 || prev == 'e' || prev == 'E'))) {
+				if(c == '.' || c == 'e' || c == 'E')
+					isFloat = true;
+				if(size == (int)sizeof(number)) {
+					m_CurToken.type = TOKEN_INVALID;
+					return m_CurToken;
+				}
+				number[size++] = (char)c;
+				prev = c;
 				c = ReadChar();
 			}
-			if(c == '.') {
-				c = ReadChar();
-				double dValue = iValue;
-				iValue = 0;
-				int power = 1;
-				while(c >= '0' && c <= '9') {
-					iValue *= 10;
-					iValue += c - '0';
-					power *= 10;
-					c = ReadChar();
-				}
-				dValue += (double)iValue / power;
-				dValue = sign ? -dValue : dValue;
+			PushChar(c);
+
+			int nextChar;
+			core::StringConverter::EParseError error;
+			core::StringView str(number, size);
+			if(isFloat) {
 				m_CurToken.type = TOKEN_FLOAT;
-				*((float*)valueDstBuffer) = (float)dValue;
+				*((float*)valueDstBuffer) = core::StringConverter::ParseFloat(str, 0.0f, &nextChar, &error);
 			} else {
 				m_CurToken.type = TOKEN_INTEGER;
-				iValue = sign ? -iValue : iValue;
-				*((int*)valueDstBuffer) = iValue;
+				*((int*)valueDstBuffer) = core::StringConverter::ParseInt(str, 0, &nextChar, &error);
 			}
-			PushChar(c);
+			if(error != core::StringConverter::EParseError::OK || nextChar != size)
+				m_CurToken.type = TOKEN_INVALID;
 			return m_CurToken;
 		}
 
@@ -849,6 +845,18 @@ public:
 		m_Mesh.ResetFull(dst);
 		m_MeshToLoad = meshToLoad;
 		m_MergeMeshes = merge;
+		m_Skeleton = LUX_NEW(Skeleton);
+	}
+
+	void EnterScope(const Scope& scope)
+	{
+		BaseVisitor::EnterScope(scope);
+
+		// Each frame is a joint of the skeleton.
+		if(scope.type == g_GUIDFrame) {
+			int parent = m_JointStack.IsEmpty() ? -1 : m_JointStack.Back();
+			m_JointStack.PushBack(m_Skeleton->AddJoint(scope.identName, parent));
+		}
 	}
 
 	bool OnObject(const Scope& scope)
@@ -872,6 +880,7 @@ public:
 			// Replace default identity matrix.
 			m_MatrixStack.Pop();
 			m_MatrixStack.Push(m);
+			m_Skeleton->SetBindPose(m_JointStack.Back(), m);
 			parser->MatchTextOnly(TOKEN_SEMICOLON);
 		} else if(scope.type == g_GUIDMesh) {
 			/*
@@ -885,7 +894,7 @@ public:
 			if(!InScope(g_GUIDFrame))
 				throw XFileFormatException("Meshes only inside frame");
 
-			if(!m_MergeMeshes && scope.identName != m_MeshToLoad)
+			if(!IsMeshToLoad(scope))
 				return false;
 
 			u32 nVertices = parser->ReadDWORD();
@@ -1057,6 +1066,7 @@ public:
 			if(boneId == -1) {
 				boneId = m_Mesh.boneNames.Size();
 				m_Mesh.boneNames.PushBack(boneName);
+				m_Mesh.boneOffsets.PushBack(math::Matrix4::IDENTITY);
 			}
 
 			if(m_Mesh.boneIndices.IsEmpty()) {
@@ -1071,40 +1081,33 @@ public:
 			auto nWeights = parser->ReadDWORD();
 			buffer.Resize(nWeights * 4);
 			auto vertexIndices = parser->ReadDWORDArray(nWeights, buffer.Data());
+			auto weights = parser->ReadFloatArray(nWeights, nullptr);
 			const int MAX_BONES_PER_VERTEX = 4;
 			for(u32 i = 0; i < nWeights; ++i) {
 				auto vid = vertexIndices[i];
-				auto id = m_Mesh.vertexBoneAffectCount[vid];
-				m_Mesh.boneIndices[vid][id] = (u8)boneId;
-			}
-
-			auto weights = parser->ReadFloatArray(nWeights, nullptr);
-			int i = 0;
-			for(auto f : core::MakeRange(weights, weights + nWeights)) {
-				auto vid = vertexIndices[i];
-				auto& id = m_Mesh.vertexBoneAffectCount[vid];
-				if(id == MAX_BONES_PER_VERTEX) {
-					u8 minValue = (u8)(f * 255);
+				if(vid >= (u32)m_Mesh.positions.Size())
+					throw XFileFormatException("Invalid vertex index in SkinWeights");
+				auto weight = (u8)(math::Clamp(weights[i], 0.0f, 1.0f) * 255 + 0.5f);
+				auto& count = m_Mesh.vertexBoneAffectCount[vid];
+				if(count < MAX_BONES_PER_VERTEX) {
+					m_Mesh.boneIndices[vid][count] = (u8)boneId;
+					m_Mesh.boneWeights[vid][count] = weight;
+					++count;
+				} else {
+					// Replace the smallest weight, if the new one is bigger.
 					int min = 0;
-					for(; min < MAX_BONES_PER_VERTEX; ++min) {
-						if(m_Mesh.boneWeights[vid][min] < minValue) {
-							minValue = m_Mesh.boneWeights[vid][min];
-							break;
-						}
+					for(int j = 1; j < MAX_BONES_PER_VERTEX; ++j) {
+						if(m_Mesh.boneWeights[vid][j] < m_Mesh.boneWeights[vid][min])
+							min = j;
 					}
-					if(min < MAX_BONES_PER_VERTEX) {
-						m_Mesh.boneWeights[vid][min] = (u8)(f * 255);
-						m_Mesh.boneIndices[vid][min] = m_Mesh.boneIndices[vid][id];
+					if(m_Mesh.boneWeights[vid][min] < weight) {
+						m_Mesh.boneIndices[vid][min] = (u8)boneId;
+						m_Mesh.boneWeights[vid][min] = weight;
 					}
-				} else {
-					m_Mesh.boneWeights[vid][id] = (u8)(f * 255);
-					++id;
 				}
-				++i;
 			}
 
-			math::Matrix4 matrixOffset;
-			parser->ReadFloatArray(16, matrixOffset.DataRowMajor());
+			parser->ReadFloatArray(16, m_Mesh.boneOffsets[boneId].DataRowMajor());
 			parser->MatchTextOnly(TOKEN_SEMICOLON);
 		} else {
 			return false;
@@ -1114,9 +1117,10 @@ public:
 
 	void LeaveScope(const Scope& scope)
 	{
-		if(scope.type == g_GUIDMesh) {
-			if(!m_MergeMeshes && scope.identName != m_MeshToLoad)
-				return;
+		if(scope.type == g_GUIDFrame)
+			m_JointStack.PopBack();
+
+		if(scope.type == g_GUIDMesh && IsMeshToLoad(scope)) {
 			// Create final mesh.
 			StrongRef<video::Geometry> geo = m_Mesh.dst->GetGeometry();
 			if(!geo) {
@@ -1230,24 +1234,49 @@ public:
 
 			// Write Skinning extradata
 			if(m_Mesh.boneNames.Size()) {
-				StrongRef<video::MeshExDataBoneTable> bonetable = LUX_NEW(video::MeshExDataBoneTable);
+				auto bonetableOpt = m_Mesh.dst->GetExData<video::MeshExDataBoneTable>();
+				StrongRef<video::MeshExDataBoneTable> bonetable = bonetableOpt.HasValue() ? bonetableOpt.GetValue() : nullptr;
+				if(!bonetable) {
+					bonetable = LUX_NEW(video::MeshExDataBoneTable);
+					m_Mesh.dst->AddExData(bonetable);
+
+					StrongRef<video::MeshExDataSkeleton> skeleton = LUX_NEW(video::MeshExDataSkeleton);
+					skeleton->skeleton = m_Skeleton;
+					m_Mesh.dst->AddExData(skeleton);
+				}
 				bonetable->boneNames = m_Mesh.boneNames;
 				bonetable->maxSkinWeightPerVertex = 4;
-				m_Mesh.dst->AddExData(bonetable);
+
+				// The offsets expect vertices in mesh space, but the frame
+				// transform was already applied to the vertices.
+				auto meshToFrame = m_MatrixStack.PeekAbs().GetTransformInverted();
+				for(int i = bonetable->offsetMatrices.Size(); i < m_Mesh.boneOffsets.Size(); ++i) {
+					math::Matrix4 offset;
+					offset.SetByProduct(m_Mesh.boneOffsets[i], meshToFrame);
+					bonetable->offsetMatrices.PushBack(offset);
+				}
 			}
 
 			if(m_MergeMeshes) {
 				m_Mesh.Reset();
 				m_Mesh.indexOffset = ib->GetSize();
 				m_Mesh.vertexOffset = vb->GetSize();
-			} else {
+			} else if(m_Mesh.boneNames.IsEmpty()) {
 				traverser->Abort();
+			} else {
+				// Keep reading the frames, they are the joints of the skeleton.
+				m_MeshLoaded = true;
 			}
 		}
 
 		BaseVisitor::LeaveScope(scope);
 	}
 
+	bool IsMeshToLoad(const Scope& scope) const
+	{
+		return !m_MeshLoaded && (m_MergeMeshes || scope.identName == m_MeshToLoad);
+	}
+
 	StrongRef<io::File> FindFile(const io::Path& path)
 	{
 		auto fileSys = io::FileSystem::Instance();
@@ -1313,6 +1342,7 @@ private:
 		video::Mesh* dst;
 
 		core::Array<core::String> boneNames;
+		core::Array<math::Matrix4> boneOffsets;
 
 		// Vertex elements
 		core::Array<u8> vertexBoneAffectCount;
@@ -1384,9 +1414,12 @@ private:
 
 	core::Array<u8> buffer;
 	XMeshData m_Mesh;
+	StrongRef<Skeleton> m_Skeleton;
+	core::Array<int> m_JointStack;
 	io::Path m_BaseDir;
 	bool m_MergeMeshes = true;
 	core::String m_MeshToLoad;
+	bool m_MeshLoaded = false;
 };
 
 } //namespace xfile_loader_impl
@@ -1478,6 +1511,9 @@ void MeshLoaderX::LoadMesh(io::File* file, video::Mesh* dst, const core::String&
 	MeshLoadVisitor meshLoader(dst, &traverser, file->GetPath(), meshToLoad, mergeMeshes);
 	traverser.Traverse(&meshLoader, file, &errReporter);
 
+	if(dst->GetGeometry())
+		MeshManipulatorOptimize()(dst);
+
 	if(dst->GetMaterialCount() == 0) {
 		dst->SetMaterial(
 			video::MaterialLibrary::Instance()->GetMaterial(
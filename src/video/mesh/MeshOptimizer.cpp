@@ -0,0 +1,716 @@
+#include "video/mesh/MeshOptimizer.h"
+#include "core/lxArray.h"
+#include "core/lxSort.h"
+#include <cmath>
+#include <cstring>
+
+namespace lux
+{
+namespace video
+{
+
+namespace
+{
+//! Simulated FIFO cache, the cache is emptied by advancing the time.
+class FifoCache
+{
+public:
+	FifoCache(int vertexCount, int cacheSize) :
+		m_Time(cacheSize + 1),
+		m_Size(cacheSize)
+	{
+		m_Stamps.Resize(vertexCount, 0);
+	}
+
+	//! Returns the number of missed vertices of a triangle.
+	int AddTriangle(const u32* tri)
+	{
+		int misses = 0;
+		for(int k = 0; k < 3; ++k) {
+			// Each miss pushes a new vertex, so a vertex is still cached
+			// if less than size vertices were pushed since it was added.
+			int& stamp = m_Stamps[tri[k]];
+			if(m_Time - stamp > m_Size) {
+				stamp = m_Time++;
+				++misses;
+			}
+		}
+		return misses;
+	}
+
+	void Clear()
+	{
+		m_Time += m_Size + 1;
+	}
+
+private:
+	core::Array<int> m_Stamps;
+	int m_Time;
+	int m_Size;
+};
+
+// Parameters from Forsyth's article.
+const int FORSYTH_CACHE_SIZE = 32;
+const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+const float FORSYTH_LAST_TRI_SCORE = 0.75f;
+const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+const int FORSYTH_VALENCE_TABLE_SIZE = 32;
+
+class ForsythScores
+{
+public:
+	ForsythScores()
+	{
+		for(int i = 0; i < FORSYTH_CACHE_SIZE; ++i) {
+			if(i < 3) {
+				// The vertices of the last triangle get a fixed score, so
+				// it doesn't matter in which order it was added.
+				m_Cache[i] = FORSYTH_LAST_TRI_SCORE;
+			} else {
+				const float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+				m_Cache[i] = std::pow(1.0f - (i - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+			}
+		}
+		m_Valence[0] = 0;
+		for(int i = 1; i < FORSYTH_VALENCE_TABLE_SIZE; ++i)
+			m_Valence[i] = FORSYTH_VALENCE_BOOST_SCALE * std::pow((float)i, -FORSYTH_VALENCE_BOOST_POWER);
+	}
+
+	float Get(int cachePos, int remaining) const
+	{
+		// Vertices without triangles are never chosen again.
+		if(remaining == 0)
+			return -1.0f;
+		float score = cachePos >= 0 ? m_Cache[cachePos] : 0.0f;
+		if(remaining < FORSYTH_VALENCE_TABLE_SIZE)
+			score += m_Valence[remaining];
+		else
+			score += FORSYTH_VALENCE_BOOST_SCALE * std::pow((float)remaining, -FORSYTH_VALENCE_BOOST_POWER);
+		return score;
+	}
+
+private:
+	float m_Cache[FORSYTH_CACHE_SIZE];
+	float m_Valence[FORSYTH_VALENCE_TABLE_SIZE];
+};
+//! Sum of squared distances to a set of weighted planes.
+struct Quadric
+{
+	double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+	double b0 = 0, b1 = 0, b2 = 0;
+	double c = 0;
+	double weight = 0;
+
+	void AddPlane(double nx, double ny, double nz, double d, double w)
+	{
+		a00 += w * nx * nx;
+		a01 += w * nx * ny;
+		a02 += w * nx * nz;
+		a11 += w * ny * ny;
+		a12 += w * ny * nz;
+		a22 += w * nz * nz;
+		b0 += w * nx * d;
+		b1 += w * ny * d;
+		b2 += w * nz * d;
+		c += w * d * d;
+		weight += w;
+	}
+
+	void Add(const Quadric& q)
+	{
+		a00 += q.a00;
+		a01 += q.a01;
+		a02 += q.a02;
+		a11 += q.a11;
+		a12 += q.a12;
+		a22 += q.a22;
+		b0 += q.b0;
+		b1 += q.b1;
+		b2 += q.b2;
+		c += q.c;
+		weight += q.weight;
+	}
+
+	//! The weighted sum of squared distances of a point.
+	double Evaluate(const math::Vector3F& p) const
+	{
+		const double x = p.x, y = p.y, z = p.z;
+		return x * x * a00 + y * y * a11 + z * z * a22 +
+			2 * (x * y * a01 + x * z * a02 + y * z * a12) +
+			2 * (x * b0 + y * b1 + z * b2) + c;
+	}
+};
+
+//! The squared error of moving a vertex onto another.
+double CollapseError(const Quadric& from, const Quadric& to, const math::Vector3F& p)
+{
+	Quadric q = from;
+	q.Add(to);
+	if(q.weight <= 0)
+		return 0;
+	// Planes are weighted by area, divide by the weight to get a distance.
+	return math::Max(q.Evaluate(p) / q.weight, 0.0);
+}
+} // anonymous namespace
+
+VertexCacheStatistics AnalyzeVertexCache(const u32* indices, int indexCount, int vertexCount, int cacheSize)
+{
+	VertexCacheStatistics stats;
+	const int triCount = indexCount / 3;
+	if(triCount == 0)
+		return stats;
+
+	FifoCache cache(vertexCount, cacheSize);
+	core::Array<bool> used;
+	used.Resize(vertexCount, false);
+	int usedCount = 0;
+	for(int i = 0; i < triCount * 3; ++i) {
+		if(!used[indices[i]]) {
+			used[indices[i]] = true;
+			++usedCount;
+		}
+	}
+	for(int t = 0; t < triCount; ++t)
+		stats.vertexTransforms += cache.AddTriangle(indices + 3 * t);
+
+	stats.acmr = (float)stats.vertexTransforms / triCount;
+	stats.atvr = (float)stats.vertexTransforms / usedCount;
+	return stats;
+}
+
+void OptimizeVertexCache(u32* dst, const u32* indices, int indexCount, int vertexCount)
+{
+	LX_CHECK_NULL_ARG(dst);
+	LX_CHECK_NULL_ARG(indices);
+
+	const int triCount = indexCount / 3;
+	if(triCount == 0)
+		return;
+
+	// The triangles of each vertex, the first remaining[v] entries of each
+	// list are the triangles not emitted yet.
+	core::Array<int> offsets;
+	core::Array<int> remaining;
+	core::Array<int> adjacency;
+	offsets.Resize(vertexCount + 1, 0);
+	remaining.Resize(vertexCount, 0);
+	adjacency.Resize(triCount * 3);
+	for(int i = 0; i < triCount * 3; ++i)
+		++remaining[indices[i]];
+	for(int v = 0; v < vertexCount; ++v)
+		offsets[v + 1] = offsets[v] + remaining[v];
+	{
+		core::Array<int> fill;
+		fill.Resize(vertexCount, 0);
+		for(int i = 0; i < triCount * 3; ++i) {
+			const u32 v = indices[i];
+			adjacency[offsets[v] + fill[v]++] = i / 3;
+		}
+	}
+
+	const ForsythScores scores;
+	core::Array<float> vertexScores;
+	core::Array<int> cachePos;
+	vertexScores.Resize(vertexCount);
+	cachePos.Resize(vertexCount, -1);
+	for(int v = 0; v < vertexCount; ++v)
+		vertexScores[v] = scores.Get(-1, remaining[v]);
+
+	core::Array<bool> emitted;
+	emitted.Resize(triCount, false);
+	int best = 0;
+	float bestScore = -1;
+	for(int t = 0; t < triCount; ++t) {
+		const u32* tri = indices + 3 * t;
+		const float score = vertexScores[tri[0]] + vertexScores[tri[1]] + vertexScores[tri[2]];
+		if(score > bestScore) {
+			bestScore = score;
+			best = t;
+		}
+	}
+
+	int cache[FORSYTH_CACHE_SIZE + 3];
+	int cacheCount = 0;
+	int scanPos = 0;
+	for(int out = 0; out < triCount; ++out) {
+		if(best < 0) {
+			// No triangle touches the cache, continue with the next unused one.
+			while(emitted[scanPos])
+				++scanPos;
+			best = scanPos;
+		}
+
+		const u32* tri = indices + 3 * best;
+		dst[3 * out + 0] = tri[0];
+		dst[3 * out + 1] = tri[1];
+		dst[3 * out + 2] = tri[2];
+		emitted[best] = true;
+
+		for(int k = 0; k < 3; ++k) {
+			const u32 v = tri[k];
+			int* list = adjacency.Data() + offsets[v];
+			int last = remaining[v] - 1;
+			for(int j = 0; j <= last; ++j) {
+				if(list[j] == best) {
+					list[j] = list[last];
+					list[last] = best;
+					--remaining[v];
+					break;
+				}
+			}
+		}
+
+		// Move the vertices of the triangle to the front of the cache.
+		int newCache[FORSYTH_CACHE_SIZE + 3];
+		int newCount = 0;
+		for(int k = 0; k < 3; ++k) {
+			const int v = (int)tri[k];
+			bool present = false;
+			for(int i = 0; i < newCount; ++i)
+				present |= newCache[i] == v;
+			if(!present)
+				newCache[newCount++] = v;
+		}
+		for(int i = 0; i < cacheCount; ++i) {
+			const int v = cache[i];
+			if(v != (int)tri[0] && v != (int)tri[1] && v != (int)tri[2])
+				newCache[newCount++] = v;
+		}
+
+		for(int i = 0; i < newCount; ++i) {
+			const int v = newCache[i];
+			cachePos[v] = i < FORSYTH_CACHE_SIZE ? i : -1;
+			vertexScores[v] = scores.Get(cachePos[v], remaining[v]);
+		}
+		cacheCount = math::Min(newCount, FORSYTH_CACHE_SIZE);
+		std::memcpy(cache, newCache, cacheCount * sizeof(int));
+
+		// Only the triangles of changed vertices change their score, the
+		// next triangle is chosen from them.
+		best = -1;
+		bestScore = -1;
+		for(int i = 0; i < newCount; ++i) {
+			const int v = newCache[i];
+			const int* list = adjacency.Data() + offsets[v];
+			for(int j = 0; j < remaining[v]; ++j) {
+				const int t = list[j];
+				const u32* other = indices + 3 * t;
+				const float score = vertexScores[other[0]] + vertexScores[other[1]] + vertexScores[other[2]];
+				if(score > bestScore) {
+					bestScore = score;
+					best = t;
+				}
+			}
+		}
+	}
+}
+
+void OptimizeOverdraw(
+	u32* dst, const u32* indices, int indexCount,
+	const math::Vector3F* positions, int vertexCount,
+	EFaceWinding frontFace, float threshold)
+{
+	LX_CHECK_NULL_ARG(dst);
+	LX_CHECK_NULL_ARG(indices);
+	LX_CHECK_NULL_ARG(positions);
+
+	const int triCount = indexCount / 3;
+	if(triCount == 0)
+		return;
+	const int CACHE_SIZE = 16;
+
+	// Hard boundaries: A triangle missing all vertices starts a new strip
+	// of the cache optimized order, reordering there costs nothing.
+	core::Array<int> hardClusters;
+	{
+		FifoCache cache(vertexCount, CACHE_SIZE);
+		for(int t = 0; t < triCount; ++t) {
+			if(cache.AddTriangle(indices + 3 * t) == 3 || t == 0)
+				hardClusters.PushBack(t);
+		}
+		hardClusters.PushBack(triCount);
+	}
+
+	// Soft boundaries: Split each hard cluster as soon as the cache
+	// efficiency of the part is within the threshold of the whole cluster.
+	core::Array<int> clusters;
+	{
+		FifoCache cache(vertexCount, CACHE_SIZE);
+		for(int c = 0; c + 1 < hardClusters.Size(); ++c) {
+			const int begin = hardClusters[c];
+			const int end = hardClusters[c + 1];
+
+			cache.Clear();
+			int clusterMisses = 0;
+			for(int t = begin; t < end; ++t)
+				clusterMisses += cache.AddTriangle(indices + 3 * t);
+			const float clusterThreshold = threshold * clusterMisses / (end - begin);
+
+			clusters.PushBack(begin);
+			cache.Clear();
+			int misses = 0;
+			int count = 0;
+			for(int t = begin; t < end; ++t) {
+				misses += cache.AddTriangle(indices + 3 * t);
+				++count;
+				if((float)misses / count <= clusterThreshold) {
+					clusters.PushBack(t + 1);
+					cache.Clear();
+					misses = 0;
+					count = 0;
+				}
+			}
+			// The last part is usually small and inefficient, merge it with
+			// the one before it. If the last split is at the end it's
+			// removed too.
+			if(clusters.Back() != begin)
+				clusters.PopBack();
+		}
+		clusters.PushBack(triCount);
+	}
+
+	// Sort the clusters by how much they face outward.
+	const bool flip = frontFace == EFaceWinding::CW;
+	math::Vector3F meshCenter(0, 0, 0);
+	float meshArea = 0;
+	for(int t = 0; t < triCount; ++t) {
+		const u32* tri = indices + 3 * t;
+		const auto& a = positions[tri[0]];
+		const auto& b = positions[tri[1]];
+		const auto& c = positions[tri[2]];
+		const float area = (b - a).Cross(c - a).GetLength();
+		meshCenter += (a + b + c) * (area / 3);
+		meshArea += area;
+	}
+	if(meshArea > 0)
+		meshCenter /= meshArea;
+
+	struct Cluster
+	{
+		int begin;
+		int end;
+		float sortKey;
+	};
+	core::Array<Cluster> sorted;
+	sorted.Reserve(clusters.Size() - 1);
+	for(int i = 0; i + 1 < clusters.Size(); ++i) {
+		Cluster cluster;
+		cluster.begin = clusters[i];
+		cluster.end = clusters[i + 1];
+
+		math::Vector3F center(0, 0, 0);
+		math::Vector3F normal(0, 0, 0);
+		float area = 0;
+		for(int t = cluster.begin; t < cluster.end; ++t) {
+			const u32* tri = indices + 3 * t;
+			const auto& a = positions[tri[0]];
+			const auto& b = positions[tri[1]];
+			const auto& c = positions[tri[2]];
+			// The length of the cross product is twice the area, it's used
+			// as weight.
+			const auto cross = (b - a).Cross(c - a);
+			const float triArea = cross.GetLength();
+			center += (a + b + c) * (triArea / 3);
+			normal += cross;
+			area += triArea;
+		}
+		if(area > 0)
+			center /= area;
+		const float normalLen = normal.GetLength();
+		if(normalLen > 0)
+			normal /= normalLen;
+		if(flip)
+			normal = -normal;
+		cluster.sortKey = (center - meshCenter).Dot(normal);
+		sorted.PushBack(cluster);
+	}
+	core::Sort(sorted, core::CompareTypeFromSmaller<Cluster>([](const Cluster& a, const Cluster& b) {
+		return a.sortKey > b.sortKey;
+	}), core::ESortAlgorithm::MergeSort);
+
+	u32* out = dst;
+	for(auto& cluster : sorted) {
+		const int size = 3 * (cluster.end - cluster.begin);
+		std::memcpy(out, indices + 3 * cluster.begin, size * sizeof(u32));
+		out += size;
+	}
+}
+
+int OptimizeVertexFetch(u32* remap, u32* indices, int indexCount, int vertexCount)
+{
+	LX_CHECK_NULL_ARG(remap);
+	LX_CHECK_NULL_ARG(indices);
+
+	for(int v = 0; v < vertexCount; ++v)
+		remap[v] = ~0u;
+
+	u32 next = 0;
+	for(int i = 0; i < indexCount; ++i) {
+		u32& r = remap[indices[i]];
+		if(r == ~0u)
+			r = next++;
+		indices[i] = r;
+	}
+	return (int)next;
+}
+
+int WeldVertices(u32* remap, const void* vertices, int vertexCount, int stride)
+{
+	LX_CHECK_NULL_ARG(remap);
+	LX_CHECK_NULL_ARG(vertices);
+
+	const u8* data = (const u8*)vertices;
+	int bucketCount = 1;
+	while(bucketCount < vertexCount * 2)
+		bucketCount *= 2;
+	const int mask = bucketCount - 1;
+
+	// Open addressing table, storing the first vertex with some data.
+	core::Array<int> buckets;
+	buckets.Resize(bucketCount, -1);
+	int unique = 0;
+	for(int v = 0; v < vertexCount; ++v) {
+		const u8* vertex = data + v * stride;
+		// FNV-1a over the bytes of the vertex.
+		u32 hash = 2166136261u;
+		for(int b = 0; b < stride; ++b)
+			hash = (hash ^ vertex[b]) * 16777619u;
+
+		int bucket = (int)(hash & mask);
+		while(true) {
+			const int other = buckets[bucket];
+			if(other < 0) {
+				buckets[bucket] = v;
+				remap[v] = (u32)unique++;
+				break;
+			}
+			if(std::memcmp(data + other * stride, vertex, stride) == 0) {
+				remap[v] = remap[other];
+				break;
+			}
+			bucket = (bucket + 1) & mask;
+		}
+	}
+	return unique;
+}
+
+void RemapVertices(void* dst, const void* src, int vertexCount, int stride, const u32* remap)
+{
+	LX_CHECK_NULL_ARG(dst);
+	LX_CHECK_NULL_ARG(src);
+	LX_CHECK_NULL_ARG(remap);
+
+	for(int v = 0; v < vertexCount; ++v) {
+		if(remap[v] != ~0u)
+			std::memcpy((u8*)dst + remap[v] * stride, (const u8*)src + v * stride, stride);
+	}
+}
+
+void RemapIndices(u32* indices, int indexCount, const u32* remap)
+{
+	LX_CHECK_NULL_ARG(indices);
+	LX_CHECK_NULL_ARG(remap);
+
+	for(int i = 0; i < indexCount; ++i)
+		indices[i] = remap[indices[i]];
+}
+
+int SimplifyMesh(
+	u32* dst, const u32* indices, int indexCount,
+	const math::Vector3F* positions, int vertexCount,
+	int targetIndexCount, float targetError,
+	const u8* locked, float* resultError)
+{
+	LX_CHECK_NULL_ARG(dst);
+	LX_CHECK_NULL_ARG(indices);
+	LX_CHECK_NULL_ARG(positions);
+
+	indexCount -= indexCount % 3;
+	if(dst != indices)
+		std::memcpy(dst, indices, indexCount * sizeof(u32));
+	if(resultError)
+		*resultError = 0;
+
+	// The triangles of each vertex.
+	core::Array<int> offsets;
+	core::Array<int> adjacency;
+	auto buildAdjacency = [&](int count) {
+		offsets.Clear();
+		offsets.Resize(vertexCount + 1, 0);
+		for(int i = 0; i < count; ++i)
+			++offsets[dst[i] + 1];
+		for(int v = 0; v < vertexCount; ++v)
+			offsets[v + 1] += offsets[v];
+		adjacency.Resize(count);
+		core::Array<int> fill;
+		fill.Resize(vertexCount, 0);
+		for(int i = 0; i < count; ++i) {
+			const u32 v = dst[i];
+			adjacency[offsets[v] + fill[v]++] = i / 3;
+		}
+	};
+	buildAdjacency(indexCount);
+
+	// Lock vertices on edges without exactly two triangles, these are open
+	// borders, seams or non-manifold edges.
+	core::Array<u8> isLocked;
+	isLocked.Resize(vertexCount, 0);
+	for(int v = 0; v < vertexCount; ++v) {
+		if(locked && locked[v]) {
+			isLocked[v] = 1;
+			continue;
+		}
+		for(int j = offsets[v]; j < offsets[v + 1] && !isLocked[v]; ++j) {
+			const u32* tri = dst + 3 * adjacency[j];
+			for(int k = 0; k < 3; ++k) {
+				const u32 other = tri[k];
+				if(other == (u32)v)
+					continue;
+				int edgeCount = 0;
+				for(int l = offsets[v]; l < offsets[v + 1]; ++l) {
+					const u32* t = dst + 3 * adjacency[l];
+					if(t[0] == other || t[1] == other || t[2] == other)
+						++edgeCount;
+				}
+				if(edgeCount != 2) {
+					isLocked[v] = 1;
+					break;
+				}
+			}
+		}
+	}
+
+	core::Array<Quadric> quadrics;
+	quadrics.Resize(vertexCount);
+	for(int i = 0; i < indexCount; i += 3) {
+		const auto& a = positions[dst[i]];
+		const auto& b = positions[dst[i + 1]];
+		const auto& c = positions[dst[i + 2]];
+		auto normal = (b - a).Cross(c - a);
+		const float area = normal.GetLength();
+		if(area <= 0)
+			continue;
+		normal /= area;
+		const double d = -(double)normal.Dot(a);
+		for(int k = 0; k < 3; ++k)
+			quadrics[dst[i + k]].AddPlane(normal.x, normal.y, normal.z, d, area);
+	}
+
+	struct Collapse
+	{
+		u32 from;
+		u32 to;
+		double error;
+	};
+	core::Array<Collapse> collapses;
+	core::Array<u32> remap;
+	core::Array<u8> touched;
+	remap.Resize(vertexCount);
+	touched.Resize(vertexCount);
+	const double maxError = (double)targetError * targetError;
+	double worstError = 0;
+	while(indexCount > targetIndexCount) {
+		// Find the best collapse of each edge, each inner edge is seen once
+		// in each direction, only one of them is used.
+		collapses.Clear();
+		for(int i = 0; i < indexCount; i += 3) {
+			for(int k = 0; k < 3; ++k) {
+				const u32 a = dst[i + k];
+				const u32 b = dst[i + (k + 1) % 3];
+				if(a >= b || (isLocked[a] && isLocked[b]))
+					continue;
+				Collapse collapse;
+				const double errorAB = isLocked[a] ? math::Constants<double>::infinity() : CollapseError(quadrics[a], quadrics[b], positions[b]);
+				const double errorBA = isLocked[b] ? math::Constants<double>::infinity() : CollapseError(quadrics[b], quadrics[a], positions[a]);
+				if(errorAB <= errorBA) {
+					collapse.from = a;
+					collapse.to = b;
+					collapse.error = errorAB;
+				} else {
+					collapse.from = b;
+					collapse.to = a;
+					collapse.error = errorBA;
+				}
+				if(collapse.error <= maxError)
+					collapses.PushBack(collapse);
+			}
+		}
+		if(collapses.IsEmpty())
+			break;
+		core::Sort(collapses, core::SortByKey([](const Collapse& c) { return c.error; }));
+
+		for(int v = 0; v < vertexCount; ++v) {
+			remap[v] = (u32)v;
+			touched[v] = 0;
+		}
+
+		// Collapses next to each other would invalidate the flip checks,
+		// so each vertex takes part in at most one collapse per pass.
+		int removedIndices = 0;
+		int done = 0;
+		for(auto& collapse : collapses) {
+			if(indexCount - removedIndices <= targetIndexCount)
+				break;
+			if(touched[collapse.from] || touched[collapse.to])
+				continue;
+
+			// Moving the vertex must not flip any remaining triangle.
+			bool flips = false;
+			int removedTris = 0;
+			const auto& target = positions[collapse.to];
+			for(int j = offsets[collapse.from]; j < offsets[collapse.from + 1] && !flips; ++j) {
+				const u32* tri = dst + 3 * adjacency[j];
+				if(tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to) {
+					++removedTris;
+					continue;
+				}
+				math::Vector3F p[3];
+				math::Vector3F q[3];
+				for(int k = 0; k < 3; ++k) {
+					p[k] = positions[tri[k]];
+					q[k] = tri[k] == collapse.from ? target : p[k];
+				}
+				const auto before = (p[1] - p[0]).Cross(p[2] - p[0]);
+				const auto after = (q[1] - q[0]).Cross(q[2] - q[0]);
+				flips = before.Dot(after) <= 0;
+			}
+			if(flips)
+				continue;
+
+			remap[collapse.from] = collapse.to;
+			quadrics[collapse.to].Add(quadrics[collapse.from]);
+			for(int j = offsets[collapse.from]; j < offsets[collapse.from + 1]; ++j) {
+				const u32* tri = dst + 3 * adjacency[j];
+				touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+			}
+			worstError = math::Max(worstError, collapse.error);
+			removedIndices += 3 * removedTris;
+			++done;
+		}
+		if(done == 0)
+			break;
+
+		// Apply the collapses and remove the degenerated triangles.
+		int newCount = 0;
+		for(int i = 0; i < indexCount; i += 3) {
+			const u32 a = remap[dst[i]];
+			const u32 b = remap[dst[i + 1]];
+			const u32 c = remap[dst[i + 2]];
+			if(a == b || b == c || c == a)
+				continue;
+			dst[newCount++] = a;
+			dst[newCount++] = b;
+			dst[newCount++] = c;
+		}
+		indexCount = newCount;
+		buildAdjacency(indexCount);
+	}
+
+	if(resultError)
+		*resultError = (float)std::sqrt(worstError);
+	return indexCount;
+}
+
+} // namespace video
+} // namespace lux
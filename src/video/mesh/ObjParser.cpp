@@ -0,0 +1,323 @@
+#include "video/mesh/ObjParser.h"
+
+#include "core/StringConverter.h"
+#include "core/lxException.h"
+#include "core/lxProfiler.h"
+#include "core/threading/lxThreadPool.h"
+#include "math/lxMath.h"
+
+#include <cstring>
+
+namespace lux
+{
+namespace video
+{
+
+namespace
+{
+
+inline bool IsSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* SkipSpace(const char* cur, const char* end)
+{
+	while(cur != end && IsSpace(*cur))
+		++cur;
+	return cur;
+}
+
+//! Splits text into lines, without copying it.
+class LineReader
+{
+public:
+	LineReader(const char* begin, const char* end) :
+		m_Cur(begin),
+		m_End(end)
+	{
+	}
+
+	//! Get the next line, without surrounding whitespace and line break.
+	bool Next(const char*& lineBegin, const char*& lineEnd)
+	{
+		if(m_Cur == m_End)
+			return false;
+		auto newLine = (const char*)std::memchr(m_Cur, '\n', m_End - m_Cur);
+		lineBegin = SkipSpace(m_Cur, newLine ? newLine : m_End);
+		lineEnd = newLine ? newLine : m_End;
+		while(lineEnd != lineBegin && IsSpace(lineEnd[-1]))
+			--lineEnd;
+		m_Cur = newLine ? newLine + 1 : m_End;
+		return true;
+	}
+
+private:
+	const char* m_Cur;
+	const char* m_End;
+};
+
+//! Does the line start with the keyword, the cursor is moved behind the keyword.
+bool MatchKeyword(const char*& cur, const char* end, const char* keyword)
+{
+	const size_t length = std::strlen(keyword);
+	if((size_t)(end - cur) < length || std::memcmp(cur, keyword, length) != 0)
+		return false;
+	if(cur + length != end && !IsSpace(cur[length]))
+		return false;
+	cur = SkipSpace(cur + length, end);
+	return true;
+}
+
+core::StringView MakeView(const char* begin, const char* end)
+{
+	return core::StringView(begin, int(end - begin));
+}
+
+}
+
+void ObjChunk::Parse()
+{
+	LX_PROFILE_SCOPE("ObjChunk::Parse");
+	core::Array<ObjCorner> face;
+	core::Array<u8> faceRelative;
+	LineReader reader(begin, end);
+	const char* cur;
+	const char* lineEnd;
+	while(reader.Next(cur, lineEnd)) {
+		if(cur == lineEnd || *cur == '#')
+			continue;
+
+		if(MatchKeyword(cur, lineEnd, "v")) {
+			float v[3] = {0, 0, 0};
+			if(core::StringConverter::ParseFloatArray(MakeView(cur, lineEnd), v, 3) != 3)
+				isValid = false;
+			positions.EmplaceBack(v[0], v[1], v[2]);
+		} else if(MatchKeyword(cur, lineEnd, "vn")) {
+			float v[3] = {0, 0, 0};
+			if(core::StringConverter::ParseFloatArray(MakeView(cur, lineEnd), v, 3) != 3)
+				isValid = false;
+			normals.EmplaceBack(v[0], v[1], v[2]);
+		} else if(MatchKeyword(cur, lineEnd, "vt")) {
+			float v[2] = {0, 0};
+			if(core::StringConverter::ParseFloatArray(MakeView(cur, lineEnd), v, 2) == 0)
+				isValid = false;
+			texcoords.EmplaceBack(v[0], v[1]);
+		} else if(MatchKeyword(cur, lineEnd, "f")) {
+			ParseFace(cur, lineEnd, face, faceRelative);
+		} else if(MatchKeyword(cur, lineEnd, "usemtl")) {
+			materialUses.PushBack({corners.Size() / 3, MakeView(cur, lineEnd)});
+		} else if(MatchKeyword(cur, lineEnd, "mtllib")) {
+			while(cur != lineEnd) {
+				const char* nameEnd = cur;
+				while(nameEnd != lineEnd && !IsSpace(*nameEnd))
+					++nameEnd;
+				materialLibs.PushBack(MakeView(cur, nameEnd));
+				cur = SkipSpace(nameEnd, lineEnd);
+			}
+		}
+		// Groups, objects, smoothing groups, lines and points are ignored.
+	}
+}
+
+void ObjChunk::ParseFace(const char* cur, const char* end, core::Array<ObjCorner>& face, core::Array<u8>& faceRelative)
+{
+	face.Clear();
+	faceRelative.Clear();
+	const int counts[3] = {positions.Size(), texcoords.Size(), normals.Size()};
+	while(cur != end) {
+		int indices[3] = {-1, -1, -1};
+		u8 relativeBits = 0;
+		for(int i = 0; i < 3; ++i) {
+			if(i > 0) {
+				if(cur == end || *cur != '/')
+					break;
+				++cur;
+				if(cur != end && *cur == '/')
+					continue;
+			}
+			int nextChar;
+			core::StringConverter::EParseError error;
+			int index = core::StringConverter::ParseInt(MakeView(cur, end), 0, &nextChar, &error);
+			if(error != core::StringConverter::EParseError::OK || index == 0) {
+				isValid = false;
+				return;
+			}
+			cur += nextChar;
+			if(index > 0) {
+				indices[i] = index - 1;
+			} else {
+				indices[i] = counts[i] + index;
+				relativeBits |= 1 << i;
+			}
+		}
+		if(cur != end && !IsSpace(*cur)) {
+			isValid = false;
+			return;
+		}
+		cur = SkipSpace(cur, end);
+		face.PushBack({indices[0], indices[1], indices[2]});
+		faceRelative.PushBack(relativeBits);
+	}
+
+	if(face.Size() < 3)
+		return;
+	bool hasRelative = !relative.IsEmpty();
+	for(u8 bits : faceRelative)
+		hasRelative |= bits != 0;
+	if(hasRelative && relative.Size() < corners.Size())
+		relative.Resize(corners.Size(), 0);
+	for(int i = 2; i < face.Size(); ++i) {
+		const int fan[3] = {0, i - 1, i};
+		for(int j : fan) {
+			corners.PushBack(face[j]);
+			if(hasRelative)
+				relative.PushBack(faceRelative[j]);
+		}
+	}
+}
+
+void ObjChunk::Resolve(int positionBase, int texcoordBase, int normalBase, int positionCount, int texcoordCount, int normalCount)
+{
+	const int bases[3] = {positionBase, texcoordBase, normalBase};
+	for(int i = 0; i < corners.Size(); ++i) {
+		auto& c = corners[i];
+		int* indices[3] = {&c.position, &c.texcoord, &c.normal};
+		const u8 bits = i < relative.Size() ? relative[i] : 0;
+		for(int j = 0; j < 3; ++j) {
+			if(bits & (1 << j))
+				*indices[j] += bases[j];
+		}
+		if(c.position < 0 || c.position >= positionCount ||
+			c.texcoord < -1 || c.texcoord >= texcoordCount ||
+			c.normal < -1 || c.normal >= normalCount) {
+			isValid = false;
+			return;
+		}
+	}
+}
+
+void ParseObjGeometry(const char* begin, const char* end, int chunkCount, ObjGeometry& out, core::ThreadPool* pool)
+{
+	const s64 size = end - begin;
+	chunkCount = math::Max(chunkCount, 1);
+	auto& chunks = out.chunks;
+	auto& positions = out.positions;
+	auto& texcoords = out.texcoords;
+	auto& normals = out.normals;
+	chunks.Clear();
+	positions.Clear();
+	texcoords.Clear();
+	normals.Clear();
+
+	chunks.Resize(chunkCount);
+	const char* chunkBegin = begin;
+	for(int i = 0; i < chunkCount; ++i) {
+		const char* chunkEnd = end;
+		if(i + 1 < chunkCount) {
+			chunkEnd = math::Max(begin + size * (i + 1) / chunkCount, chunkBegin);
+			auto newLine = (const char*)std::memchr(chunkEnd, '\n', end - chunkEnd);
+			chunkEnd = newLine ? newLine + 1 : end;
+		}
+		chunks[i].begin = chunkBegin;
+		chunks[i].end = chunkEnd;
+		chunkBegin = chunkEnd;
+	}
+
+	if(chunkCount == 1 || !pool) {
+		for(auto& chunk : chunks)
+			chunk.Parse();
+	} else {
+		// The chunks don't throw, errors are reported after all are done.
+		core::Array<std::future<void>> futures;
+		for(int i = 1; i < chunkCount; ++i) {
+			auto chunk = &chunks[i];
+			futures.PushBack(pool->Push([chunk]() { chunk->Parse(); }));
+		}
+		chunks[0].Parse();
+		for(auto& f : futures)
+			f.get();
+	}
+
+	int positionCount = 0;
+	int texcoordCount = 0;
+	int normalCount = 0;
+	for(auto& chunk : chunks) {
+		if(!chunk.isValid)
+			throw core::FileFormatException("Invalid file format", "obj");
+		positionCount += chunk.positions.Size();
+		texcoordCount += chunk.texcoords.Size();
+		normalCount += chunk.normals.Size();
+	}
+
+	positions.Reserve(positionCount);
+	texcoords.Reserve(texcoordCount);
+	normals.Reserve(normalCount);
+	for(auto& chunk : chunks) {
+		chunk.Resolve(positions.Size(), texcoords.Size(), normals.Size(), positionCount, texcoordCount, normalCount);
+		if(!chunk.isValid)
+			throw core::FileFormatException("Invalid vertex index", "obj");
+		for(auto& p : chunk.positions)
+			positions.PushBack(p);
+		for(auto& t : chunk.texcoords)
+			texcoords.PushBack(t);
+		for(auto& n : chunk.normals)
+			normals.PushBack(n);
+		chunk.positions.Clear();
+		chunk.texcoords.Clear();
+		chunk.normals.Clear();
+	}
+}
+
+void ParseObjMaterialLibrary(const char* begin, const char* end, core::Array<ObjMaterial>& materials)
+{
+	materials.Clear();
+	bool hasDissolve = false;
+	LineReader reader(begin, end);
+	const char* cur;
+	const char* lineEnd;
+	while(reader.Next(cur, lineEnd)) {
+		if(cur == lineEnd || *cur == '#')
+			continue;
+
+		if(MatchKeyword(cur, lineEnd, "newmtl")) {
+			materials.EmplaceBack();
+			materials.Back().name = MakeView(cur, lineEnd);
+			hasDissolve = false;
+			continue;
+		}
+		if(materials.IsEmpty())
+			continue;
+
+		auto& mat = materials.Back();
+		if(MatchKeyword(cur, lineEnd, "Kd")) {
+			core::StringConverter::ParseFloatArray(MakeView(cur, lineEnd), mat.diffuse, 3);
+		} else if(MatchKeyword(cur, lineEnd, "Ks")) {
+			core::StringConverter::ParseFloatArray(MakeView(cur, lineEnd), mat.specular, 3);
+		} else if(MatchKeyword(cur, lineEnd, "Ke")) {
+			core::StringConverter::ParseFloatArray(MakeView(cur, lineEnd), mat.emission, 3);
+		} else if(MatchKeyword(cur, lineEnd, "Ns")) {
+			core::StringConverter::ParseFloatArray(MakeView(cur, lineEnd), &mat.shininess, 1);
+		} else if(MatchKeyword(cur, lineEnd, "d")) {
+			// d is preferred over Tr.
+			core::StringConverter::ParseFloatArray(MakeView(cur, lineEnd), &mat.dissolve, 1);
+			hasDissolve = true;
+		} else if(MatchKeyword(cur, lineEnd, "Tr")) {
+			float transparency;
+			if(!hasDissolve && core::StringConverter::ParseFloatArray(MakeView(cur, lineEnd), &transparency, 1) == 1)
+				mat.dissolve = 1 - transparency;
+		} else if(MatchKeyword(cur, lineEnd, "map_Kd")) {
+			// The texture name is the last argument, the others are options.
+			const char* nameBegin = cur;
+			if(cur != lineEnd && *cur == '-') {
+				nameBegin = lineEnd;
+				while(nameBegin != cur && !IsSpace(nameBegin[-1]))
+					--nameBegin;
+			}
+			mat.diffuseTexture = MakeView(nameBegin, lineEnd);
+		}
+	}
+}
+
+} // namespace video
+} // namespace lux
@@ -0,0 +1,117 @@
+#ifndef INCLUDED_LUX_OBJ_PARSER_H
+#define INCLUDED_LUX_OBJ_PARSER_H
+#include "core/lxArray.h"
+#include "core/lxString.h"
+#include "math/Vector2.h"
+#include "math/Vector3.h"
+
+namespace lux
+{
+namespace core
+{
+class ThreadPool;
+}
+namespace video
+{
+
+//! A corner of a face, the indices are zero based, -1 if not used.
+struct ObjCorner
+{
+	int position;
+	int texcoord;
+	int normal;
+
+	bool operator==(const ObjCorner& other) const
+	{
+		return position == other.position && texcoord == other.texcoord && normal == other.normal;
+	}
+};
+
+//! The data of a range of lines of an obj file.
+/**
+Relative indices can point into earlier chunks, they are stored relative to
+the first element of the chunk, and resolved when all chunks are parsed.
+*/
+struct ObjChunk
+{
+	struct MaterialUse
+	{
+		int triangle; //!< The first triangle using the material.
+		core::StringView name;
+	};
+
+	const char* begin;
+	const char* end;
+
+	core::Array<math::Vector3F> positions;
+	core::Array<math::Vector3F> normals;
+	core::Array<math::Vector2F> texcoords;
+	//! Three corners for each triangle, polygons are triangulated as fan.
+	core::Array<ObjCorner> corners;
+	//! For each corner, the bits of the indices relative to the chunk, empty if there are none.
+	core::Array<u8> relative;
+	core::Array<MaterialUse> materialUses;
+	core::Array<core::StringView> materialLibs;
+
+	bool isValid = true;
+
+	void Parse();
+
+	//! Make all indices absolute, and check them.
+	void Resolve(int positionBase, int texcoordBase, int normalBase, int positionCount, int texcoordCount, int normalCount);
+
+private:
+	void ParseFace(const char* cur, const char* end, core::Array<ObjCorner>& face, core::Array<u8>& faceRelative);
+};
+
+//! The geometry of an obj file.
+struct ObjGeometry
+{
+	//! The chunks in file order, the indices are resolved and the vertex data is moved out.
+	core::Array<ObjChunk> chunks;
+	core::Array<math::Vector3F> positions;
+	core::Array<math::Vector3F> normals;
+	core::Array<math::Vector2F> texcoords;
+};
+
+//! Parse the geometry of an obj file
+/**
+The text is split at line breaks into chunks, which are parsed in parallel
+if a pool is passed.
+The chunks reference the text, it must stay alive while they are used.
+The calling thread blocks until all chunks are parsed, so this must not be
+called from a job running on the same pool.
+\param begin The text of the file.
+\param end The end of the text.
+\param chunkCount The number of chunks to split the text into, at least one.
+\param [out] out Receives the geometry.
+\param pool The first chunk is parsed on the calling thread, the others on
+	this pool. If nullptr all chunks are parsed on the calling thread.
+\throws FileFormatException If the file is invalid or an index is out of range.
+*/
+LUX_API void ParseObjGeometry(const char* begin, const char* end, int chunkCount, ObjGeometry& out, core::ThreadPool* pool = nullptr);
+
+//! The material properties used from a mtl file.
+struct ObjMaterial
+{
+	core::String name;
+	float diffuse[3] = {0, 0, 0};
+	float specular[3] = {0, 0, 0};
+	float emission[3] = {0, 0, 0};
+	float shininess = 0;
+	float dissolve = 1;
+	core::String diffuseTexture;
+};
+
+//! Parse the materials of a mtl file
+/**
+\param begin The text of the file.
+\param end The end of the text.
+\param [out] out Receives the materials in file order.
+*/
+LUX_API void ParseObjMaterialLibrary(const char* begin, const char* end, core::Array<ObjMaterial>& out);
+
+} // namespace video
+} // namespace lux
+
+#endif // #ifndef INCLUDED_LUX_OBJ_PARSER_H
@@ -0,0 +1,280 @@
+#include "video/mesh/Skeleton.h"
+#include "video/mesh/Geometry.h"
+#include "video/VertexBuffer.h"
+#include "math/Transformation.h"
+#include "math/SIMD.h"
+#include <cmath>
+#include <climits>
+#include <cstring>
+
+namespace lux
+{
+namespace video
+{
+
+int Skeleton::AddJoint(const core::String& name, int parent, const math::Matrix4& bindPose)
+{
+	LX_CHECK_BOUNDS(parent, -1, GetJointCount());
+
+	m_Names.PushBack(name);
+	m_Parents.PushBack(parent);
+	m_BindPoses.PushBack(bindPose);
+	return m_Parents.Size() - 1;
+}
+
+void Skeleton::SetBindPose(int joint, const math::Matrix4& bindPose)
+{
+	m_BindPoses.At(joint) = bindPose;
+}
+
+int Skeleton::FindJoint(core::StringView name) const
+{
+	for(int i = 0; i < m_Names.Size(); ++i) {
+		if(m_Names[i] == name)
+			return i;
+	}
+	return -1;
+}
+
+SkeletalClip::SkeletalClip(float frameRate, int frameCount) :
+	m_FrameRate(frameRate),
+	m_FrameCount(frameCount)
+{
+	if(frameRate <= 0)
+		throw core::FloatArgumentOutOfRangeException("frameRate", 0, INFINITY, frameRate);
+	if(frameCount < 1)
+		throw core::ArgumentOutOfRangeException("frameCount", 1, INT_MAX, frameCount);
+}
+
+void SkeletalClip::AddTrack(int joint, const math::Vector3F* translations, const math::QuaternionF* rotations, const float* scales)
+{
+	LX_CHECK_BOUNDS(joint, 0, INT_MAX);
+	LX_CHECK_NULL_ARG(translations);
+	LX_CHECK_NULL_ARG(rotations);
+
+	m_Joints.PushBack(joint);
+	m_Translations.PushBack(translations, m_FrameCount);
+	m_Rotations.PushBack(rotations, m_FrameCount);
+	if(scales) {
+		m_Scales.PushBack(scales, m_FrameCount);
+	} else {
+		for(int i = 0; i < m_FrameCount; ++i)
+			m_Scales.PushBack(1.0f);
+	}
+}
+
+void SkeletalClip::Sample(const float* times, int poseCount, int jointCount, math::Matrix4* poses, bool loop) const
+{
+	struct Key
+	{
+		int frame;
+		int next;
+		float alpha;
+	};
+
+	// The keys of a pose are the same for each track, so they are found
+	// once per block of poses, and the tracks are then walked one after
+	// another.
+	const int BLOCK_SIZE = 64;
+	Key keys[BLOCK_SIZE];
+	const float lastFrame = float(m_FrameCount - 1);
+	for(int blockBegin = 0; blockBegin < poseCount; blockBegin += BLOCK_SIZE) {
+		const int blockSize = math::Min(BLOCK_SIZE, poseCount - blockBegin);
+		for(int p = 0; p < blockSize; ++p) {
+			float f = times[blockBegin + p] * m_FrameRate;
+			if(loop && lastFrame > 0) {
+				f = std::fmod(f, lastFrame);
+				if(f < 0)
+					f += lastFrame;
+			} else {
+				f = math::Clamp(f, 0.0f, lastFrame);
+			}
+			auto& key = keys[p];
+			key.frame = math::Min((int)f, m_FrameCount - 1);
+			key.next = math::Min(key.frame + 1, m_FrameCount - 1);
+			key.alpha = f - key.frame;
+		}
+
+		for(int t = 0; t < m_Joints.Size(); ++t) {
+			const int joint = m_Joints[t];
+			if(joint >= jointCount)
+				continue;
+			const math::Vector3F* translations = m_Translations.Data() + t * m_FrameCount;
+			const math::QuaternionF* rotations = m_Rotations.Data() + t * m_FrameCount;
+			const float* scales = m_Scales.Data() + t * m_FrameCount;
+			math::Matrix4* out = poses + blockBegin * jointCount + joint;
+			for(int p = 0; p < blockSize; ++p) {
+				const auto& key = keys[p];
+				const float alpha = key.alpha;
+				math::Transformation transform;
+				transform.translation = translations[key.frame] + (translations[key.next] - translations[key.frame]) * alpha;
+				transform.scale = scales[key.frame] + (scales[key.next] - scales[key.frame]) * alpha;
+
+				// Interpolate on the shorter arc.
+				const math::QuaternionF& a = rotations[key.frame];
+				const math::QuaternionF& b = rotations[key.next];
+				const float bWeight = a.Dot(b) < 0 ? -alpha : alpha;
+				transform.orientation = a * (1 - alpha) + b * bWeight;
+				transform.orientation.Normalize();
+
+				transform.ToMatrix(out[p * jointCount]);
+			}
+		}
+	}
+}
+
+void SolveJointHierarchy(const int* parents, const math::Matrix4* local, math::Matrix4* world, int jointCount)
+{
+	for(int i = 0; i < jointCount; ++i) {
+		const int parent = parents[i];
+		if(parent < 0) {
+			world[i] = local[i];
+		} else {
+			lxAssert(parent < i);
+			world[i].SetByProduct(world[parent], local[i]);
+		}
+	}
+}
+
+void SkinVertices(
+	const math::Matrix4* matrices,
+	const math::Vector3F* positions,
+	const math::Vector3F* normals,
+	const SkinVertex* skin,
+	int count,
+	void* dst, int stride, int positionOffset, int normalOffset)
+{
+	namespace simd = math::simd;
+
+	u8* out = (u8*)dst;
+	for(int i = 0; i < count; ++i) {
+		// Blend the rows of the influencing matrices.
+		const SkinVertex& s = skin[i];
+		const math::Matrix4& first = matrices[s.bones[0]];
+		simd::Float4 w = simd::Splat(s.weights[0]);
+		simd::Float4 r0 = simd::Mul(w, simd::Load(first.m[0]));
+		simd::Float4 r1 = simd::Mul(w, simd::Load(first.m[1]));
+		simd::Float4 r2 = simd::Mul(w, simd::Load(first.m[2]));
+		simd::Float4 r3 = simd::Mul(w, simd::Load(first.m[3]));
+		for(int k = 1; k < 4; ++k) {
+			if(s.weights[k] == 0)
+				continue;
+			const math::Matrix4& m = matrices[s.bones[k]];
+			w = simd::Splat(s.weights[k]);
+			r0 = simd::MulAdd(w, simd::Load(m.m[0]), r0);
+			r1 = simd::MulAdd(w, simd::Load(m.m[1]), r1);
+			r2 = simd::MulAdd(w, simd::Load(m.m[2]), r2);
+			r3 = simd::MulAdd(w, simd::Load(m.m[3]), r3);
+		}
+
+		const math::Vector3F& p = positions[i];
+		simd::Float4 v = simd::MulAdd(simd::Splat(p.x), r0, r3);
+		v = simd::MulAdd(simd::Splat(p.y), r1, v);
+		v = simd::MulAdd(simd::Splat(p.z), r2, v);
+		simd::Store3((float*)(out + positionOffset), v);
+
+		if(normals) {
+			const math::Vector3F& n = normals[i];
+			simd::Float4 vn = simd::Mul(simd::Splat(n.x), r0);
+			vn = simd::MulAdd(simd::Splat(n.y), r1, vn);
+			vn = simd::MulAdd(simd::Splat(n.z), r2, vn);
+			const float lenSq = simd::Dot3(vn, vn);
+			if(lenSq > 0)
+				vn = simd::Mul(vn, simd::Splat(1 / std::sqrt(lenSq)));
+			simd::Store3((float*)(out + normalOffset), vn);
+		}
+
+		out += stride;
+	}
+}
+
+void MeshExDataSkinning::GetSkinningMatrices(const math::Matrix4* world, math::Matrix4* out) const
+{
+	for(int i = 0; i < boneOffsets.Size(); ++i) {
+		const int joint = boneJoints[i];
+		if(joint < 0)
+			out[i] = math::Matrix4::IDENTITY;
+		else
+			out[i].SetByProduct(world[joint], boneOffsets[i]);
+	}
+	out[boneOffsets.Size()] = math::Matrix4::IDENTITY;
+}
+
+StrongRef<MeshExDataSkinning> GetSkinningData(Mesh* mesh)
+{
+	LX_CHECK_NULL_ARG(mesh);
+
+	auto existing = mesh->GetExData<MeshExDataSkinning>();
+	if(existing.HasValue())
+		return existing.GetValue();
+
+	auto boneTableOpt = mesh->GetExData<MeshExDataBoneTable>();
+	auto skeletonOpt = mesh->GetExData<MeshExDataSkeleton>();
+	auto geo = mesh->GetGeometry();
+	if(!boneTableOpt.HasValue() || !skeletonOpt.HasValue() || !geo)
+		return nullptr;
+	auto boneTable = boneTableOpt.GetValue();
+	auto skeleton = skeletonOpt.GetValue()->skeleton;
+
+	const VertexBuffer* vb = geo->GetVertices();
+	const auto& format = vb->GetFormat();
+	auto posElem = format.GetElement(VertexElement::EUsage::Position);
+	auto normalElem = format.GetElement(VertexElement::EUsage::Normal);
+	auto indexElem = format.GetElement(VertexElement::EUsage::BlendIndices);
+	auto weightElem = format.GetElement(VertexElement::EUsage::BlendWeight);
+	if(!posElem.IsValid() || posElem.GetType() != VertexElement::EType::Float3 ||
+		!indexElem.IsValid() || indexElem.GetType() != VertexElement::EType::Byte4 ||
+		!weightElem.IsValid() || weightElem.GetType() != VertexElement::EType::Byte4)
+		return nullptr;
+	const bool hasNormals = normalElem.IsValid() && normalElem.GetType() == VertexElement::EType::Float3;
+
+	StrongRef<MeshExDataSkinning> data = LUX_NEW(MeshExDataSkinning);
+	data->skeleton = skeleton;
+	// The blend indices are bytes, and one index is needed for the identity.
+	const int boneCount = boneTable->boneNames.Size();
+	if(boneCount > 255)
+		return nullptr;
+	data->boneJoints.Resize(boneCount);
+	data->boneOffsets.Resize(boneCount);
+	for(int i = 0; i < boneCount; ++i) {
+		data->boneJoints[i] = skeleton ? skeleton->FindJoint(boneTable->boneNames[i]) : -1;
+		data->boneOffsets[i] = i < boneTable->offsetMatrices.Size() ? boneTable->offsetMatrices[i] : math::Matrix4::IDENTITY;
+	}
+
+	const int vertexCount = vb->GetSize();
+	const int stride = vb->GetStride();
+	const u8* vertices = (const u8*)vb->Pointer_c(0, vertexCount);
+	data->positions.Resize(vertexCount);
+	if(hasNormals)
+		data->normals.Resize(vertexCount);
+	data->skin.Resize(vertexCount);
+	for(int i = 0; i < vertexCount; ++i) {
+		const u8* vertex = vertices + i * stride;
+		std::memcpy(&data->positions[i], vertex + posElem.GetOffset(), sizeof(math::Vector3F));
+		if(hasNormals)
+			std::memcpy(&data->normals[i], vertex + normalElem.GetOffset(), sizeof(math::Vector3F));
+
+		// Normalize the weights, and send vertices without a valid
+		// influence to the identity matrix.
+		const u8* bones = vertex + indexElem.GetOffset();
+		const u8* weights = vertex + weightElem.GetOffset();
+		auto& s = data->skin[i];
+		int total = 0;
+		for(int k = 0; k < 4; ++k) {
+			s.bones[k] = bones[k] < boneCount ? bones[k] : (u8)boneCount;
+			total += weights[k];
+		}
+		for(int k = 0; k < 4; ++k)
+			s.weights[k] = total ? weights[k] / (float)total : 0.0f;
+		if(!total) {
+			s.bones[0] = (u8)boneCount;
+			s.weights[0] = 1.0f;
+		}
+	}
+
+	mesh->AddExData(data);
+	return data;
+}
+
+} // namespace video
+} // namespace lux
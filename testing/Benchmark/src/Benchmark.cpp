@@ -0,0 +1,360 @@
+#include "Benchmark.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace Benchmarking
+{
+
+namespace Internal
+{
+volatile const void* g_Sink = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+	// Linear interpolation between the closest ranks.
+	double pos = p * (sorted.size() - 1);
+	size_t low = (size_t)pos;
+	size_t high = std::min(low + 1, sorted.size() - 1);
+	double t = pos - low;
+	return sorted[low] * (1 - t) + sorted[high] * t;
+}
+
+Statistics Statistics::FromSamples(std::vector<double> samples)
+{
+	Statistics s;
+	if(samples.empty())
+		return s;
+
+	std::sort(samples.begin(), samples.end());
+	double sum = 0;
+	for(double v : samples)
+		sum += v;
+	s.mean = sum / samples.size();
+	double sq = 0;
+	for(double v : samples)
+		sq += (v - s.mean) * (v - s.mean);
+	s.stddev = samples.size() > 1 ? std::sqrt(sq / (samples.size() - 1)) : 0;
+
+	s.min = samples.front();
+	s.max = samples.back();
+	s.median = Percentile(samples, 0.5);
+	s.p10 = Percentile(samples, 0.1);
+	s.p25 = Percentile(samples, 0.25);
+	s.p75 = Percentile(samples, 0.75);
+	s.p90 = Percentile(samples, 0.9);
+	s.p99 = Percentile(samples, 0.99);
+	return s;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Context::Context(const Settings& settings, const Case& c, std::vector<Result>& results) :
+	m_Settings(settings),
+	m_Case(c),
+	m_Results(results),
+	m_Items(0)
+{
+}
+
+int Context::GetGrowthFactor(double seconds) const
+{
+	if(seconds <= 0)
+		return 100;
+	// Aim a bit above the minimum, to not end just below it.
+	double factor = 1.2 * m_Settings.minSampleSeconds / seconds;
+	return (int)std::max(2.0, std::min(100.0, factor));
+}
+
+void Context::SetReference(const char* variant)
+{
+	if(variant)
+		m_Reference = m_Case.GetFullName() + "/" + variant;
+	else
+		m_Reference.clear();
+}
+
+static const Result* FindResult(const std::vector<Result>& results, const std::string& name)
+{
+	for(auto& r : results) {
+		if(r.name == name)
+			return &r;
+	}
+	return nullptr;
+}
+
+// The speedup of a result over its reference, 0 if there is none.
+static double GetSpeedup(const std::vector<Result>& results, const Result& r)
+{
+	if(r.reference.empty() || r.stats.median <= 0)
+		return 0;
+	auto ref = FindResult(results, r.reference);
+	return ref ? ref->stats.median / r.stats.median : 0;
+}
+
+void Context::AddResult(const std::string& name, int iterations, std::vector<double>& samples)
+{
+	Result r;
+	r.name = name;
+	r.iterations = iterations;
+	r.samples = (int)samples.size();
+	r.itemsPerIteration = m_Items;
+	if(m_Reference != name)
+		r.reference = m_Reference;
+	r.stats = Statistics::FromSamples(samples);
+	m_Results.push_back(r);
+
+	std::cout << "   " << name << " --> " << std::fixed << std::setprecision(1) << r.stats.median << " ns";
+	double speedup = GetSpeedup(m_Results, r);
+	if(speedup > 0)
+		std::cout << " (" << std::setprecision(2) << speedup << "x " << r.reference << ")";
+	std::cout << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Case::Case(Suite& suite, BenchmarkFunction func, const std::string& name) :
+	m_Suite(suite),
+	m_Func(func),
+	m_Name(name)
+{
+	m_Suite.m_Cases.push_back(this);
+}
+
+const std::string& Case::GetName() const
+{
+	return m_Name;
+}
+
+const Suite& Case::GetSuite() const
+{
+	return m_Suite;
+}
+
+std::string Case::GetFullName() const
+{
+	return m_Suite.GetName() + "." + m_Name;
+}
+
+void Case::Run(Context& ctx) const
+{
+	m_Func(ctx);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Suite::Suite(const std::string& name) :
+	m_Name(name)
+{
+	Environment::Instance().m_Suites.push_back(this);
+}
+
+const std::string& Suite::GetName() const
+{
+	return m_Name;
+}
+
+size_t Suite::GetCaseCount() const
+{
+	return m_Cases.size();
+}
+
+const Case& Suite::GetCase(size_t i) const
+{
+	return *m_Cases.at(i);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Environment& Environment::Instance()
+{
+	static Environment theInstance;
+	return theInstance;
+}
+
+size_t Environment::GetSuiteCount() const
+{
+	return m_Suites.size();
+}
+
+const Suite& Environment::GetSuite(size_t i) const
+{
+	return *m_Suites.at(i);
+}
+
+std::vector<Result> Environment::Run(const Settings& settings)
+{
+	std::vector<Result> results;
+	for(auto suite : m_Suites) {
+		bool printed = false;
+		for(auto c : suite->m_Cases) {
+			if(!settings.filter.empty() && c->GetFullName().find(settings.filter) == std::string::npos)
+				continue;
+
+			if(!printed) {
+				std::cout << "Run benchmark suite \"" << suite->GetName() << "\":" << std::endl;
+				printed = true;
+			}
+
+			Context ctx(settings, *c, results);
+			try {
+				c->Run(ctx);
+			} catch(...) {
+				std::cout << "   " << c->GetFullName() << " --> Exception was thrown." << std::endl;
+			}
+		}
+	}
+	return results;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static bool ReadString(const std::string& line, const char* key, std::string& out)
+{
+	std::string pattern = std::string("\"") + key + "\":\"";
+	auto pos = line.find(pattern);
+	if(pos == std::string::npos)
+		return false;
+	pos += pattern.size();
+	auto end = line.find('"', pos);
+	if(end == std::string::npos)
+		return false;
+	out = line.substr(pos, end - pos);
+	return true;
+}
+
+static bool ReadNumber(const std::string& line, const char* key, double& out)
+{
+	std::string pattern = std::string("\"") + key + "\":";
+	auto pos = line.find(pattern);
+	if(pos == std::string::npos)
+		return false;
+	out = std::strtod(line.c_str() + pos + pattern.size(), nullptr);
+	return true;
+}
+
+bool Baseline::Load(const std::string& path)
+{
+	std::ifstream file(path);
+	if(!file)
+		return false;
+
+	m_Entries.clear();
+	std::string line;
+	while(std::getline(file, line)) {
+		std::string name;
+		if(!ReadString(line, "name", name))
+			continue;
+		Statistics s;
+		ReadNumber(line, "min", s.min);
+		ReadNumber(line, "max", s.max);
+		ReadNumber(line, "mean", s.mean);
+		ReadNumber(line, "stddev", s.stddev);
+		ReadNumber(line, "median", s.median);
+		ReadNumber(line, "p10", s.p10);
+		ReadNumber(line, "p25", s.p25);
+		ReadNumber(line, "p75", s.p75);
+		ReadNumber(line, "p90", s.p90);
+		ReadNumber(line, "p99", s.p99);
+		m_Entries[name] = s;
+	}
+	return true;
+}
+
+std::vector<Baseline::Comparison> Baseline::Compare(const std::vector<Result>& results, double threshold) const
+{
+	std::vector<Comparison> out;
+	for(auto& r : results) {
+		auto it = m_Entries.find(r.name);
+		if(it == m_Entries.end() || it->second.median <= 0)
+			continue;
+		auto& base = it->second;
+		Comparison c;
+		c.name = r.name;
+		c.change = r.stats.median / base.median - 1;
+		c.regression = c.change > threshold && r.stats.p25 > base.p75;
+		c.improvement = c.change < -threshold && r.stats.p75 < base.p25;
+		out.push_back(c);
+	}
+	return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool WriteJSON(const std::string& path, const std::vector<Result>& results)
+{
+	FILE* file = fopen(path.c_str(), "wb");
+	if(!file)
+		return false;
+
+	fputs("{\"unit\":\"ns\",\"benchmarks\":[\n", file);
+	for(size_t i = 0; i < results.size(); ++i) {
+		auto& r = results[i];
+		auto& s = r.stats;
+		// Benchmark names never contain quotes or backslashes.
+		fprintf(file, "{\"name\":\"%s\",\"reference\":\"%s\",\"iterations\":%d,\"samples\":%d,\"items\":%g,"
+			"\"min\":%.3f,\"max\":%.3f,\"mean\":%.3f,\"stddev\":%.3f,\"median\":%.3f,"
+			"\"p10\":%.3f,\"p25\":%.3f,\"p75\":%.3f,\"p90\":%.3f,\"p99\":%.3f}%s\n",
+			r.name.c_str(), r.reference.c_str(), r.iterations, r.samples, r.itemsPerIteration,
+			s.min, s.max, s.mean, s.stddev, s.median,
+			s.p10, s.p25, s.p75, s.p90, s.p99,
+			i + 1 < results.size() ? "," : "");
+	}
+	fputs("]}\n", file);
+	fclose(file);
+	return true;
+}
+
+static std::string FormatTime(double ns)
+{
+	char buffer[32];
+	if(ns < 1e3)
+		snprintf(buffer, sizeof(buffer), "%.1f ns", ns);
+	else if(ns < 1e6)
+		snprintf(buffer, sizeof(buffer), "%.2f us", ns / 1e3);
+	else
+		snprintf(buffer, sizeof(buffer), "%.2f ms", ns / 1e6);
+	return buffer;
+}
+
+void PrintResults(std::ostream& out, const std::vector<Result>& results)
+{
+	size_t width = 10;
+	for(auto& r : results)
+		width = std::max(width, r.name.size());
+
+	out << std::left << std::setw(width + 2) << "Benchmark"
+		<< std::right << std::setw(12) << "Median"
+		<< std::setw(12) << "p10"
+		<< std::setw(12) << "p90"
+		<< std::setw(8) << "CV"
+		<< std::setw(16) << "Items/s"
+		<< std::setw(10) << "Speedup" << std::endl;
+	for(auto& r : results) {
+		auto& s = r.stats;
+		char cv[16];
+		snprintf(cv, sizeof(cv), "%.1f%%", s.mean > 0 ? 100 * s.stddev / s.mean : 0.0);
+		char items[32] = "";
+		if(r.itemsPerIteration > 0 && s.median > 0)
+			snprintf(items, sizeof(items), "%.3g", r.itemsPerIteration * 1e9 / s.median);
+		char speedup[16] = "";
+		double factor = GetSpeedup(results, r);
+		if(factor > 0)
+			snprintf(speedup, sizeof(speedup), "%.2fx", factor);
+		out << std::left << std::setw(width + 2) << r.name
+			<< std::right << std::setw(12) << FormatTime(s.median)
+			<< std::setw(12) << FormatTime(s.p10)
+			<< std::setw(12) << FormatTime(s.p90)
+			<< std::setw(8) << cv
+			<< std::setw(16) << items
+			<< std::setw(10) << speedup << std::endl;
+	}
+}
+
+}
@@ -0,0 +1,284 @@
+#ifndef INCLUDED_BENCHMARKING_H
+#define INCLUDED_BENCHMARKING_H
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+namespace Benchmarking
+{
+
+class Context;
+class Suite;
+class Case;
+typedef void(*BenchmarkFunction)(Context&);
+
+//! Distribution of the measured samples, all times are in nanoseconds per iteration.
+struct Statistics
+{
+	double min = 0;
+	double max = 0;
+	double mean = 0;
+	double stddev = 0;
+	double median = 0;
+	double p10 = 0;
+	double p25 = 0;
+	double p75 = 0;
+	double p90 = 0;
+	double p99 = 0;
+
+	static Statistics FromSamples(std::vector<double> samples);
+};
+
+struct Result
+{
+	std::string name; //!< Suite.Case or Suite.Case/Variant
+	int iterations = 0; //!< Iterations per sample
+	int samples = 0;
+	double itemsPerIteration = 0; //!< Processed items per iteration, 0 if unknown
+	std::string reference; //!< Name of the result this one is compared with, empty if none
+	Statistics stats;
+};
+
+struct Settings
+{
+	std::string filter; //!< Only run cases whose name Suite.Case contains this string
+	int samples = 31;
+	double minSampleSeconds = 0.002; //!< The iteration count is chosen to fill at least this time per sample
+	double warmupSeconds = 0.05;
+
+	static Settings Quick()
+	{
+		Settings s;
+		s.samples = 7;
+		s.minSampleSeconds = 0.0005;
+		s.warmupSeconds = 0.005;
+		return s;
+	}
+};
+
+//! Measures the timed sections of a single benchmark case
+/**
+A case can time multiple variants, each one produces its own result.
+*/
+class Context
+{
+public:
+	Context(const Settings& settings, const Case& c, std::vector<Result>& results);
+
+	//! Time a function, which is called repeatedly.
+	template <typename FuncT>
+	void Run(const char* variant, FuncT&& func)
+	{
+		Measure(variant, [&](int iterations) {
+			auto begin = Clock::now();
+			for(int i = 0; i < iterations; ++i)
+				func();
+			return Seconds(Clock::now() - begin);
+		});
+	}
+
+	template <typename FuncT>
+	void Run(FuncT&& func)
+	{
+		Run("", func);
+	}
+
+	//! Time a function, which needs fresh state for each call.
+	/**
+	setup is called before each call of func and isn't timed.
+	Only useful for functions taking at least some microseconds.
+	*/
+	template <typename SetupT, typename FuncT>
+	void RunWithSetup(const char* variant, SetupT&& setup, FuncT&& func)
+	{
+		Measure(variant, [&](int iterations) {
+			double total = 0;
+			for(int i = 0; i < iterations; ++i) {
+				setup();
+				auto begin = Clock::now();
+				func();
+				total += Seconds(Clock::now() - begin);
+			}
+			return total;
+		});
+	}
+
+	//! Set the number of items processed per iteration for the following runs.
+	void SetItemsPerIteration(double items) { m_Items = items; }
+
+	//! Compare the following runs with an earlier variant of the same case.
+	/**
+	Used to show the gain of an optimized path over a reference implementation
+	in the same binary. The speedup is printed with the results.
+	\param variant The reference variant, nullptr to stop comparing.
+	*/
+	void SetReference(const char* variant);
+
+	const Settings& GetSettings() const { return m_Settings; }
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	static double Seconds(Clock::duration d)
+	{
+		return std::chrono::duration<double>(d).count();
+	}
+
+	template <typename LoopT>
+	void Measure(const char* variant, LoopT&& loop);
+
+	int GetGrowthFactor(double seconds) const;
+	void AddResult(const std::string& name, int iterations, std::vector<double>& samples);
+
+private:
+	const Settings& m_Settings;
+	const Case& m_Case;
+	std::vector<Result>& m_Results;
+	double m_Items;
+	std::string m_Reference;
+};
+
+class Case
+{
+public:
+	Case(Suite& suite, BenchmarkFunction func, const std::string& name);
+	const std::string& GetName() const;
+	const Suite& GetSuite() const;
+	std::string GetFullName() const;
+	void Run(Context& ctx) const;
+
+private:
+	Suite& m_Suite;
+	BenchmarkFunction m_Func;
+	std::string m_Name;
+};
+
+class Suite
+{
+	friend class Case;
+	friend class Environment;
+public:
+	Suite(const std::string& name);
+	const std::string& GetName() const;
+	size_t GetCaseCount() const;
+	const Case& GetCase(size_t i) const;
+
+private:
+	std::string m_Name;
+	std::vector<Case*> m_Cases;
+};
+
+//! Runs all registered benchmarks
+class Environment
+{
+	friend class Suite;
+public:
+	static Environment& Instance();
+
+	size_t GetSuiteCount() const;
+	const Suite& GetSuite(size_t i) const;
+
+	std::vector<Result> Run(const Settings& settings);
+
+private:
+	std::vector<Suite*> m_Suites;
+};
+
+//! Compares results against an older run
+/**
+A benchmark counts as regression if the median got slower by more than the
+threshold and the distributions are clearly separated, i.e. the lower quartile
+of the new run is above the upper quartile of the baseline.
+*/
+class Baseline
+{
+public:
+	struct Comparison
+	{
+		std::string name;
+		double change; //!< Relative change of the median, positive if slower
+		bool regression;
+		bool improvement;
+	};
+
+	//! Load a file written by WriteJSON.
+	/**
+	\return False if the file can't be read.
+	*/
+	bool Load(const std::string& path);
+
+	std::vector<Comparison> Compare(const std::vector<Result>& results, double threshold) const;
+
+private:
+	std::map<std::string, Statistics> m_Entries;
+};
+
+//! Write results as JSON, one benchmark per line
+bool WriteJSON(const std::string& path, const std::vector<Result>& results);
+
+//! Print results as table
+void PrintResults(std::ostream& out, const std::vector<Result>& results);
+
+namespace Internal
+{
+extern volatile const void* g_Sink;
+}
+
+//! Prevents the compiler from removing the computation of a value.
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	Internal::g_Sink = &value;
+#endif
+}
+
+template <typename LoopT>
+void Context::Measure(const char* variant, LoopT&& loop)
+{
+	std::string name = m_Case.GetFullName();
+	if(variant && *variant)
+		name = name + "/" + variant;
+
+	// Warm up caches, branch predictors and the clock speed.
+	double warmup = 0;
+	do {
+		warmup += loop(1);
+	} while(warmup < m_Settings.warmupSeconds);
+
+	int iterations = 1;
+	double time = loop(1);
+	while(time < m_Settings.minSampleSeconds && iterations < (1 << 30)) {
+		long long next = (long long)iterations * GetGrowthFactor(time);
+		iterations = (int)std::min<long long>(next, 1 << 30);
+		time = loop(iterations);
+	}
+
+	std::vector<double> samples;
+	samples.reserve(m_Settings.samples);
+	for(int i = 0; i < m_Settings.samples; ++i)
+		samples.push_back(loop(iterations) * 1e9 / iterations);
+
+	AddResult(name, iterations, samples);
+}
+
+}
+
+#define BENCH_SUITE(name) \
+namespace BenchSuite_##name \
+{ \
+static Benchmarking::Suite Suite(#name); \
+} \
+namespace BenchSuite_##name
+
+#define BENCH_CASE(name) \
+void BenchFunc_##name(Benchmarking::Context&); \
+static Benchmarking::Case Case_##name(Suite, &BenchFunc_##name, #name); \
+void BenchFunc_##name(Benchmarking::Context& ctx)
+
+#endif // #ifndef INCLUDED_BENCHMARKING_H
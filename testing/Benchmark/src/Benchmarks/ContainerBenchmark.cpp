@@ -0,0 +1,132 @@
+#include "stdafx.h"
+#include "core/lxSort.h"
+#include "core/lxHashMap.h"
+#include "core/threading/lxThreadPool.h"
+#include <thread>
+
+BENCH_SUITE(Container)
+{
+	static const int COUNT = 100000;
+
+	core::Array<u32> RandomKeys(int count, u32 seed)
+	{
+		core::Randomizer rand(seed);
+		core::Array<u32> keys;
+		keys.Reserve(count);
+		for(int i = 0; i < count; ++i)
+			keys.PushBack((u32)rand.GetInt(0, 0x7FFFFFFF));
+		return keys;
+	}
+
+	BENCH_CASE(ArrayPushBack)
+	{
+		ctx.SetItemsPerIteration(COUNT);
+		ctx.Run("Grow", []() {
+			core::Array<int> a;
+			for(int i = 0; i < COUNT; ++i)
+				a.PushBack(i);
+			Benchmarking::DoNotOptimize(a.Data());
+		});
+		ctx.Run("Reserved", []() {
+			core::Array<int> a;
+			a.Reserve(COUNT);
+			for(int i = 0; i < COUNT; ++i)
+				a.PushBack(i);
+			Benchmarking::DoNotOptimize(a.Data());
+		});
+	}
+
+	template <typename MapT>
+	void RunMap(Benchmarking::Context& ctx, const char* insert, const char* lookup)
+	{
+		auto keys = RandomKeys(COUNT, 1);
+		auto missing = RandomKeys(COUNT, 2);
+		ctx.SetItemsPerIteration(COUNT);
+		ctx.Run(insert, [&]() {
+			MapT map;
+			for(auto k : keys)
+				map.SetAndReplace(k, k);
+			Benchmarking::DoNotOptimize(map.Size());
+		});
+
+		MapT map;
+		for(auto k : keys)
+			map.SetAndReplace(k, k);
+		ctx.SetItemsPerIteration(2 * COUNT);
+		ctx.Run(lookup, [&]() {
+			int found = 0;
+			for(int i = 0; i < COUNT; ++i) {
+				found += map.HasKey(keys[i]) ? 1 : 0;
+				found += map.HasKey(missing[i]) ? 1 : 0;
+			}
+			Benchmarking::DoNotOptimize(found);
+		});
+	}
+
+	BENCH_CASE(HashMap)
+	{
+		RunMap<core::HashMap<u32, u32>>(ctx, "ChainedInsert", "ChainedLookup");
+		RunMap<core::FlatHashMap<u32, u32>>(ctx, "FlatInsert", "FlatLookup");
+	}
+
+	BENCH_CASE(Sort)
+	{
+		auto source = RandomKeys(COUNT, 3);
+		core::Array<u32> data;
+		auto reset = [&]() { data = source; };
+		auto less = core::CompareTypeFromSmaller<u32>([](u32 a, u32 b) { return a < b; });
+
+		ctx.SetItemsPerIteration(COUNT);
+		ctx.RunWithSetup("Heapsort", reset, [&]() {
+			core::Sort(data, less, core::ESortAlgorithm::Heapsort);
+		});
+		ctx.SetReference("Heapsort");
+		ctx.RunWithSetup("Introsort", reset, [&]() {
+			core::Sort(data, less, core::ESortAlgorithm::Introsort);
+		});
+		ctx.RunWithSetup("MergeSort", reset, [&]() {
+			core::Sort(data, less, core::ESortAlgorithm::MergeSort);
+		});
+		ctx.RunWithSetup("Radix", reset, [&]() {
+			core::Sort(data, core::SortByKey([](u32 v) { return v; }));
+		});
+
+		// COUNT is far above the size the parallel sort needs to split the
+		// range, so this doesn't measure the serial fallback.
+		core::ThreadPool pool(math::Max(2, (int)std::thread::hardware_concurrency()));
+		ctx.RunWithSetup("ParallelMergeSort", reset, [&]() {
+			core::Sort(data, less, pool);
+		});
+	}
+
+	BENCH_CASE(SortByDepth)
+	{
+		// Draw items sorted back to front by their distance to the camera.
+		struct DepthItem
+		{
+			float depth;
+			u32 index;
+		};
+
+		core::Randomizer rand(4);
+		core::Array<DepthItem> source;
+		source.Reserve(COUNT);
+		for(int i = 0; i < COUNT; ++i)
+			source.PushBack(DepthItem{rand.GetFloat(0.1f, 1000.0f), (u32)i});
+		core::Array<DepthItem> data;
+		auto reset = [&]() { data = source; };
+		auto less = core::CompareTypeFromSmaller<DepthItem>([](const DepthItem& a, const DepthItem& b) { return a.depth < b.depth; });
+
+		ctx.SetItemsPerIteration(COUNT);
+		ctx.RunWithSetup("Heapsort", reset, [&]() {
+			core::Sort(data, less, core::ESortAlgorithm::Heapsort);
+		});
+		ctx.SetReference("Heapsort");
+		ctx.RunWithSetup("Introsort", reset, [&]() {
+			core::Sort(data, less, core::ESortAlgorithm::Introsort);
+		});
+		ctx.RunWithSetup("Radix", reset, [&]() {
+			core::Sort(data, core::SortByKey([](const DepthItem& item) { return item.depth; }));
+		});
+	}
+}
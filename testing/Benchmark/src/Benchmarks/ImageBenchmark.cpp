@@ -0,0 +1,102 @@
+#include "stdafx.h"
+#include "video/images/ImageLoaderBMP.h"
+#include "video/images/ImageLoaderPNM.h"
+#include "video/images/ImageLoaderTGA.h"
+#include "video/images/ImageWriterBMP.h"
+#include "video/images/ImageWriterTGA.h"
+
+// The loaders are used directly, the image system needs a video driver.
+BENCH_SUITE(Image)
+{
+	static const int WIDTH = 512;
+	static const int HEIGHT = 512;
+
+	core::Array<u8> RandomPixels(int bytePerPixel)
+	{
+		core::Randomizer rand(1);
+		core::Array<u8> out;
+		out.Resize(WIDTH * HEIGHT * bytePerPixel);
+		// Smooth gradients with noise, like photos.
+		for(int i = 0; i < out.Size(); ++i)
+			out[i] = (u8)((i / bytePerPixel) % WIDTH / 2 + rand.GetInt(0, 15));
+		return out;
+	}
+
+	BENCH_CASE(ColorConvert)
+	{
+		auto src = RandomPixels(4);
+		core::Array<u8> dst;
+		dst.Resize(WIDTH * HEIGHT * 4);
+
+		struct Conversion
+		{
+			const char* name;
+			video::ColorFormat from;
+			video::ColorFormat to;
+		};
+		const Conversion conversions[] = {
+			{"A8R8G8B8_R8G8B8", video::ColorFormat::A8R8G8B8, video::ColorFormat::R8G8B8},
+			{"R8G8B8_A8R8G8B8", video::ColorFormat::R8G8B8, video::ColorFormat::A8R8G8B8},
+			{"A8R8G8B8_R5G6B5", video::ColorFormat::A8R8G8B8, video::ColorFormat::R5G6B5},
+			{"R5G6B5_X8R8G8B8", video::ColorFormat::R5G6B5, video::ColorFormat::X8R8G8B8},
+		};
+
+		ctx.SetItemsPerIteration(WIDTH * HEIGHT);
+		for(auto& c : conversions) {
+			ctx.Run(c.name, [&]() {
+				video::ColorConverter::ConvertByFormat(src.Data(), c.from, dst.Data(), c.to, WIDTH, HEIGHT);
+				Benchmarking::DoNotOptimize(dst.Data());
+			});
+		}
+	}
+
+	// Write the pixels with an image writer into memory.
+	core::Array<u8> WriteImage(StrongRef<video::ImageWriter> writer, const char* name)
+	{
+		auto pixels = RandomPixels(3);
+		core::Array<u8> buffer;
+		buffer.Resize(pixels.Size() + 4096);
+		auto file = io::FileSystem::Instance()->OpenVirtualFile(buffer.Data(), buffer.Size(), io::Path(name));
+		writer->WriteFile(file, pixels.Data(), video::ColorFormat::R8G8B8, math::Dimension2I(WIDTH, HEIGHT), WIDTH * 3, 0);
+		buffer.Resize((int)file->GetCursor());
+		return buffer;
+	}
+
+	core::Array<u8> WritePNM()
+	{
+		auto pixels = RandomPixels(3);
+		core::String header = "P6\n";
+		core::StringConverter::AppendIntToString(header, WIDTH);
+		header += " ";
+		core::StringConverter::AppendIntToString(header, HEIGHT);
+		header += "\n255\n";
+
+		core::Array<u8> buffer;
+		buffer.Resize(header.Size() + pixels.Size());
+		memcpy(buffer.Data(), header.Data(), header.Size());
+		memcpy(buffer.Data() + header.Size(), pixels.Data(), pixels.Size());
+		return buffer;
+	}
+
+	void RunLoader(Benchmarking::Context& ctx, const char* variant, StrongRef<core::ResourceLoader> loader, const core::Array<u8>& data, const char* name)
+	{
+		auto file = io::FileSystem::Instance()->OpenVirtualFile((const void*)data.Data(), data.Size(), io::Path(name));
+		StrongRef<video::Image> image = LUX_NEW(video::Image);
+		ctx.SetItemsPerIteration(WIDTH * HEIGHT);
+		ctx.Run(variant, [&]() {
+			file->Seek(0, io::ESeekOrigin::Start);
+			loader->LoadResource(file, image);
+		});
+	}
+
+	BENCH_CASE(Load)
+	{
+		auto bmp = WriteImage(LUX_NEW(video::ImageWriterBMP), "bench.bmp");
+		auto tga = WriteImage(LUX_NEW(video::ImageWriterTGA), "bench.tga");
+		auto pnm = WritePNM();
+
+		RunLoader(ctx, "BMP", LUX_NEW(video::ImageLoaderBMP), bmp, "bench.bmp");
+		RunLoader(ctx, "TGA", LUX_NEW(video::ImageLoaderTGA), tga, "bench.tga");
+		RunLoader(ctx, "PNM", LUX_NEW(video::ImageLoaderPNM), pnm, "bench.pnm");
+	}
+}
@@ -0,0 +1,120 @@
+#include "stdafx.h"
+#include "math/FreeMathFunctions.h"
+
+BENCH_SUITE(Math)
+{
+	static const int COUNT = 4096;
+
+	core::Array<math::Vector3F> RandomVectors(core::Randomizer& rand)
+	{
+		core::Array<math::Vector3F> out;
+		for(int i = 0; i < COUNT; ++i)
+			out.PushBack(math::Vector3F(rand.GetFloat(-100, 100), rand.GetFloat(-100, 100), rand.GetFloat(-100, 100)));
+		return out;
+	}
+
+	math::QuaternionF RandomRotation(core::Randomizer& rand)
+	{
+		math::Vector3F axis(rand.GetFloat(-1, 1), rand.GetFloat(-1, 1), rand.GetFloat(-1, 1) + 2);
+		return math::QuaternionF(axis.Normal(), math::AngleF::Degree(rand.GetFloat(0, 360)));
+	}
+
+	// The matrix product used before the SIMD kernels, as reference.
+	void MultiplyScalar(const math::Matrix4& a, const math::Matrix4& b, math::Matrix4& out)
+	{
+		for(int r = 0; r < 4; ++r) {
+			for(int c = 0; c < 4; ++c) {
+				float s = 0;
+				for(int k = 0; k < 4; ++k)
+					s += a(k, c) * b(r, k);
+				out(r, c) = s;
+			}
+		}
+	}
+
+	BENCH_CASE(TransformVectors)
+	{
+		core::Randomizer rand(1);
+		auto in = RandomVectors(rand);
+		core::Array<math::Vector3F> out;
+		out.Resize(COUNT);
+
+		math::Matrix4 matrix;
+		matrix.BuildCameraLookAt(math::Vector3F(1, 2, 3), math::Vector3F(0, 0, 0));
+		auto q = RandomRotation(rand);
+
+		ctx.SetItemsPerIteration(COUNT);
+		ctx.Run("MatrixScalar", [&]() {
+			for(int i = 0; i < COUNT; ++i)
+				out[i] = matrix.TransformVector(in[i]);
+			Benchmarking::DoNotOptimize(out.Data());
+		});
+		ctx.SetReference("MatrixScalar");
+		ctx.Run("Matrix", [&]() {
+			matrix.TransformVectorArray(in.Data(), out.Data(), COUNT);
+			Benchmarking::DoNotOptimize(out.Data());
+		});
+
+		ctx.SetReference(nullptr);
+		ctx.Run("QuaternionScalar", [&]() {
+			for(int i = 0; i < COUNT; ++i)
+				out[i] = q.Transform(in[i]);
+			Benchmarking::DoNotOptimize(out.Data());
+		});
+		ctx.SetReference("QuaternionScalar");
+		ctx.Run("Quaternion", [&]() {
+			math::TransformVectorArray(q, in.Data(), out.Data(), COUNT);
+			Benchmarking::DoNotOptimize(out.Data());
+		});
+	}
+
+	BENCH_CASE(Combine)
+	{
+		core::Randomizer rand(2);
+		core::Array<math::QuaternionF> a, b, out;
+		core::Array<math::Transformation> ta, tb, tout;
+		core::Array<math::Matrix4> ma, mb, mout;
+		for(int i = 0; i < COUNT; ++i) {
+			a.PushBack(RandomRotation(rand));
+			b.PushBack(RandomRotation(rand));
+			ta.PushBack(math::Transformation(math::Vector3F(rand.GetFloat(), rand.GetFloat(), rand.GetFloat()), a.Back()));
+			tb.PushBack(math::Transformation(math::Vector3F(rand.GetFloat(), rand.GetFloat(), rand.GetFloat()), b.Back()));
+			ma.PushBack(ta.Back().ToMatrix());
+			mb.PushBack(tb.Back().ToMatrix());
+		}
+		out.Resize(COUNT);
+		tout.Resize(COUNT);
+		mout.Resize(COUNT);
+
+		ctx.SetItemsPerIteration(COUNT);
+		ctx.Run("QuaternionScalar", [&]() {
+			for(int i = 0; i < COUNT; ++i)
+				out[i] = a[i] * b[i];
+			Benchmarking::DoNotOptimize(out.Data());
+		});
+		ctx.SetReference("QuaternionScalar");
+		ctx.Run("Quaternion", [&]() {
+			math::MultiplyQuaternionArray(a.Data(), b.Data(), out.Data(), COUNT);
+			Benchmarking::DoNotOptimize(out.Data());
+		});
+
+		ctx.SetReference(nullptr);
+		ctx.Run("Transformation", [&]() {
+			for(int i = 0; i < COUNT; ++i)
+				tout[i] = ta[i].CombineLeft(tb[i]);
+			Benchmarking::DoNotOptimize(tout.Data());
+		});
+
+		ctx.Run("MatrixScalar", [&]() {
+			for(int i = 0; i < COUNT; ++i)
+				MultiplyScalar(ma[i], mb[i], mout[i]);
+			Benchmarking::DoNotOptimize(mout.Data());
+		});
+		ctx.SetReference("MatrixScalar");
+		ctx.Run("Matrix", [&]() {
+			for(int i = 0; i < COUNT; ++i)
+				mout[i].SetByProduct(ma[i], mb[i]);
+			Benchmarking::DoNotOptimize(mout.Data());
+		});
+	}
+}
@@ -0,0 +1,61 @@
+#include "stdafx.h"
+#include "scene/Scene.h"
+#include "scene/Node.h"
+#include "scene/particle/ParticleSystemComponent.h"
+#include "scene/particle/ParticleSystemTemplate.h"
+#include "scene/particle/BuiltinEmitters.h"
+
+BENCH_SUITE(Particle)
+{
+	static const int COUNT = 50000;
+	static const float FRAME_TIME = 1.0f / 60;
+
+	// A scene with a single particle system, whose pool is kept full.
+	struct BenchParticles
+	{
+		StrongRef<scene::Scene> scene;
+		StrongRef<scene::Node> node;
+
+		BenchParticles(scene::ParticleModel* model)
+		{
+			model->SetLifetime(core::Distribution::Uniform(1.0f, 3.0f));
+			model->SetGravity(math::Vector3F(0, -9.81f, 0));
+
+			scene::ParticleSystemTemplateBuilder builder;
+			auto emitter = LUX_NEW(scene::StraightEmitter)(math::Vector3F::UNIT_Y);
+			emitter->SetModel(model);
+			emitter->SetForce(core::Distribution::Uniform(2.0f, 5.0f));
+			// The mean lifetime is two seconds, so this replaces every dying particle.
+			emitter->SetFlow(COUNT / 2.0f);
+			builder.AddEmitter(emitter);
+			builder.capacities[model] = COUNT;
+
+			auto system = LUX_NEW(scene::ParticleSystem);
+			system->SetTemplate(builder.MakeTemplate());
+
+			scene = LUX_NEW(scene::Scene);
+			node = scene->AddNode(system);
+
+			// Run until particles of all ages exist, so particles die in every frame.
+			for(int i = 0; i < 240; ++i)
+				scene->AnimateAll(FRAME_TIME);
+		}
+	};
+
+	BENCH_CASE(Update)
+	{
+		ctx.SetItemsPerIteration(COUNT);
+		{
+			BenchParticles bench(LUX_NEW(scene::ParticleModel));
+			ctx.Run("Fixed", [&]() { bench.scene->AnimateAll(FRAME_TIME); });
+		}
+		{
+			auto model = LUX_NEW(scene::ParticleModel);
+			model->SetParam(scene::ParticleParam::Alpha, scene::ParticleParam::Changing(1.0f, 0.0f));
+			model->SetParam(scene::ParticleParam::Size, scene::ParticleParam::Random(0.5f, 2.0f));
+			model->SetParam(scene::ParticleParam::Angle, scene::ParticleParam::ChangingRandom(0.0f, 1.0f, 2.0f, 6.0f));
+			BenchParticles bench(model);
+			ctx.Run("Changing", [&]() { bench.scene->AnimateAll(FRAME_TIME); });
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#include "stdafx.h"
+#include "core/lxProfiler.h"
+
+BENCH_SUITE(Profiler)
+{
+	static const int ZONES = 1000;
+	static const core::ProfileZone EMPTY_ZONE = {"Empty", __FILE__, __LINE__};
+
+	BENCH_CASE(EmptyZone)
+	{
+		ctx.SetItemsPerIteration(ZONES);
+
+		// What LX_PROFILE_SCOPE expands to without LUX_ENABLE_PROFILER.
+		ctx.Run("Disabled", []() {
+			for(int i = 0; i < ZONES; ++i) {
+				((void)0);
+				Benchmarking::DoNotOptimize(i);
+			}
+		});
+
+		// The two timer reads of a zone, the lower bound for Enabled.
+		ctx.Run("Timestamps", []() {
+			for(int i = 0; i < ZONES; ++i) {
+				u64 begin = core::Profiler::GetTimestamp();
+				u64 end = core::Profiler::GetTimestamp();
+				Benchmarking::DoNotOptimize(begin);
+				Benchmarking::DoNotOptimize(end);
+			}
+		});
+
+		// What LX_PROFILE_SCOPE expands to with LUX_ENABLE_PROFILER, independent
+		// of the build type. The zones are collected before each run, so the
+		// thread buffer never gets full and no zone is dropped.
+		ctx.RunWithSetup("Enabled", []() { core::Profiler::NextFrame(); }, []() {
+			for(int i = 0; i < ZONES; ++i) {
+				core::ProfileScope scope(EMPTY_ZONE);
+				Benchmarking::DoNotOptimize(i);
+			}
+		});
+	}
+}
@@ -0,0 +1,82 @@
+#include "stdafx.h"
+#include "scene/Scene.h"
+#include "scene/Node.h"
+#include "math/FreeMathFunctions.h"
+#include "math/ViewFrustum.h"
+
+BENCH_SUITE(Scene)
+{
+	struct BenchScene
+	{
+		StrongRef<scene::Scene> scene;
+		core::Array<StrongRef<scene::Node>> nodes;
+		core::Array<StrongRef<scene::Node>> topLevel;
+		core::Array<math::AABBoxF> localBoxes;
+
+		// A random tree with the given number of nodes spread over a large area.
+		BenchScene(int count, u32 seed)
+		{
+			scene = LUX_NEW(scene::Scene);
+			core::Randomizer rand(seed);
+			for(int i = 0; i < count; ++i) {
+				// Most nodes are near the root, like objects with some attachments.
+				int parent = i == 0 ? -1 : rand.GetInt(math::Max(0, i - 8), i - 1);
+				if(i > 0 && rand.GetBool(0.7f))
+					parent = -1;
+				auto node = scene->AddNode(nullptr, parent < 0 ? nullptr : nodes[parent].Raw());
+				float range = parent < 0 ? 1000.0f : 5.0f;
+				node->SetPosition(rand.GetFloat(-range, range), rand.GetFloat(-range / 10, range / 10), rand.GetFloat(-range, range));
+				node->SetOrientation(math::QuaternionF(math::Vector3F::UNIT_Y, math::AngleF::Degree(rand.GetFloat(0, 360))));
+				nodes.PushBack(node);
+				if(parent < 0)
+					topLevel.PushBack(node);
+				float size = rand.GetFloat(0.5f, 4.0f);
+				localBoxes.PushBack(math::AABBoxF(-size, -size, -size, size, size, size));
+			}
+			scene->UpdateTransforms();
+		}
+	};
+
+	void RunScene(Benchmarking::Context& ctx, int count)
+	{
+		BenchScene bench(count, 1);
+
+		math::QuaternionF step(math::Vector3F::UNIT_Y, math::AngleF::Degree(0.1f));
+		ctx.SetItemsPerIteration(count);
+		ctx.Run("UpdateTransforms", [&]() {
+			// Rotate all top level nodes, like animated objects.
+			for(auto& node : bench.topLevel)
+				node->Rotate(step);
+			bench.scene->UpdateTransforms();
+		});
+
+		// Scene::Cull needs a camera and renderable components, so only the
+		// culling kernel is measured, on the world boxes of the nodes.
+		core::Array<math::AABBoxF> worldBoxes;
+		worldBoxes.Resize(count);
+		for(int i = 0; i < count; ++i)
+			worldBoxes[i] = math::TransformAABox(bench.localBoxes[i], bench.nodes[i]->GetAbsoluteTransform());
+
+		math::Matrix4 view;
+		view.BuildCameraLookAt(math::Vector3F(0, 50, -600), math::Vector3F(0, 0, 0));
+		auto frustum = math::ViewFrustum::FromPerspCam(view, math::AngleF::Degree(60), 16.0f / 9.0f, 0.1f, 2000.0f);
+		core::Array<bool> visible;
+		core::Array<u8> hints;
+		visible.Resize(count);
+		hints.Resize(count, 0);
+		ctx.Run("CullKernel", [&]() {
+			math::AreAABoxesMaybeVisible(frustum, worldBoxes.Data(), count, visible.Data(), hints.Data());
+			Benchmarking::DoNotOptimize(visible.Data());
+		});
+	}
+
+	BENCH_CASE(Small)
+	{
+		RunScene(ctx, 1000);
+	}
+
+	BENCH_CASE(Large)
+	{
+		RunScene(ctx, 100000);
+	}
+}
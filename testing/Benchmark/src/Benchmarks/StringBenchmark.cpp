@@ -0,0 +1,147 @@
+#include "stdafx.h"
+#include "format/sinks/SinkStdString.h"
+#include "format/sinks/SinkCString.h"
+#include "core/lxUnicodeConversion.h"
+
+BENCH_SUITE(String)
+{
+	BENCH_CASE(Format)
+	{
+		char buffer[128];
+		ctx.Run("Int", [&]() {
+			format::format(buffer, "{}", 1234567);
+			Benchmarking::DoNotOptimize(buffer);
+		});
+		ctx.Run("Float", [&]() {
+			format::format(buffer, "{}", 3.14159f);
+			Benchmarking::DoNotOptimize(buffer);
+		});
+		ctx.Run("FloatRoundTrip", [&]() {
+			format::format(buffer, "{!r}", 0.1 + 0.2);
+			Benchmarking::DoNotOptimize(buffer);
+		});
+		ctx.Run("Mixed", [&]() {
+			format::format(buffer, "Node {} at ({}, {}, {}) is {}", 42, 1.5f, -2.25f, 100.0f, "visible");
+			Benchmarking::DoNotOptimize(buffer);
+		});
+
+		std::string str;
+		ctx.Run("StdString", [&]() {
+			format::format(str, "Frame {}: {} draw calls, {} ms", 1000, 1532, 16.6f);
+			Benchmarking::DoNotOptimize(str.data());
+		});
+	}
+
+	BENCH_CASE(FormatPlan)
+	{
+		static constexpr auto INT_PLAN = format::MakePlan("{}");
+		static constexpr auto NAME_PLAN = format::MakePlan("light{}");
+		static constexpr auto MIXED_PLAN = format::MakePlan("Node {} at ({}, {}, {}) is {}");
+
+		char buffer[128];
+		ctx.Run("Int", [&]() {
+			format::format(buffer, INT_PLAN, 1234567);
+			Benchmarking::DoNotOptimize(buffer);
+		});
+		ctx.Run("Name", [&]() {
+			format::format(buffer, NAME_PLAN, 7);
+			Benchmarking::DoNotOptimize(buffer);
+		});
+		// Floats use the formatting context.
+		ctx.Run("Mixed", [&]() {
+			format::format(buffer, MIXED_PLAN, 42, 1.5f, -2.25f, 100.0f, "visible");
+			Benchmarking::DoNotOptimize(buffer);
+		});
+	}
+
+	BENCH_CASE(Parse)
+	{
+		static const char* FLOATS = "0.5 -12.25 3.1415927 1e-3 6.02214076e23 100 -0.0001 42.125";
+		float floats[8];
+		ctx.SetItemsPerIteration(8);
+		ctx.Run("FloatArray", [&]() {
+			core::StringConverter::ParseFloatArray(FLOATS, floats, 8);
+			Benchmarking::DoNotOptimize(floats);
+		});
+
+		static const char* INTS = "0, 1, 2, 65535, 123456789, -42, 7, 1000";
+		int ints[8];
+		ctx.Run("IntArray", [&]() {
+			core::StringConverter::ParseIntArray(INTS, ints, 8);
+			Benchmarking::DoNotOptimize(ints);
+		});
+		ctx.SetItemsPerIteration(0);
+	}
+
+	BENCH_CASE(Unicode)
+	{
+		core::String text;
+		for(int i = 0; i < 64; ++i)
+			text.Append("assets/textures/terrain/grass_diffuse.png ");
+		text.Append("\xE2\x82\xAC");
+		ctx.SetItemsPerIteration(text.Size());
+
+		ctx.Run("Validate", [&]() {
+			Benchmarking::DoNotOptimize(core::IsValidUTF8(text.Data(), text.Size()));
+		});
+		ctx.Run("CodePointCount", [&]() {
+			Benchmarking::DoNotOptimize(text.CodePointCount());
+		});
+		core::Array<u16> utf16;
+		ctx.Run("UTF8ToUTF16", [&]() {
+			utf16.Clear();
+			core::UTF8ToUTF16(text.Data(), text.Size(), utf16);
+			Benchmarking::DoNotOptimize(utf16.Data());
+		});
+		ctx.Run("Iterate", [&]() {
+			u32 sum = 0;
+			for(u32 c : text.CodePoints())
+				sum += c;
+			Benchmarking::DoNotOptimize(sum);
+		});
+		ctx.SetItemsPerIteration(0);
+	}
+
+	BENCH_CASE(Interning)
+	{
+		static const int COUNT = 1000;
+		core::Array<core::String> strings;
+		for(int i = 0; i < COUNT; ++i) {
+			core::String s = "BenchmarkName_";
+			core::StringConverter::AppendIntToString(s, i);
+			strings.PushBack(s);
+		}
+
+		// Repeated lookups of names already in the table, the common case.
+		for(auto& s : strings)
+			core::StringTable::GlobalInstance().AddString(s.AsView());
+		ctx.SetItemsPerIteration(COUNT);
+		ctx.Run("Existing", [&]() {
+			for(auto& s : strings) {
+				core::Name name(s.AsView());
+				Benchmarking::DoNotOptimize(name);
+			}
+		});
+
+		ctx.Run("FindOnly", [&]() {
+			int found = 0;
+			for(auto& s : strings)
+				found += core::StringTable::GlobalInstance().FindString(s.AsView()) != core::StringTableHandle::INVALID ? 1 : 0;
+			Benchmarking::DoNotOptimize(found);
+		});
+
+		// New tables, so every string is inserted.
+		ctx.Run("Insert", [&]() {
+			core::StringTable table;
+			for(auto& s : strings)
+				table.AddString(s.AsView());
+		});
+
+		core::Name a("BenchmarkName_1");
+		core::Name b("BenchmarkName_2");
+		ctx.SetItemsPerIteration(0);
+		ctx.Run("Compare", [&]() {
+			Benchmarking::DoNotOptimize(a == b);
+		});
+	}
+}
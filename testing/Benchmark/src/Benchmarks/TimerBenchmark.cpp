@@ -0,0 +1,127 @@
+#include "stdafx.h"
+#include "core/Clock.h"
+
+BENCH_SUITE(Timer)
+{
+	// The timer list used before the timing wheel, as the baseline.
+	// Every tick walks all timers.
+	class ListTimerManager
+	{
+	public:
+		struct ListTimer
+		{
+			core::Signal<> event;
+			core::Duration remain;
+			core::Duration period;
+			ListTimer* next;
+			ListTimer* prev;
+		};
+
+		~ListTimerManager()
+		{
+			while(m_First)
+				Kill(m_First);
+		}
+
+		ListTimer* CreateTimer(core::Duration period)
+		{
+			auto t = new ListTimer;
+			t->remain = period;
+			t->period = period;
+			t->next = m_First;
+			t->prev = nullptr;
+			if(m_First)
+				m_First->prev = t;
+			m_First = t;
+			return t;
+		}
+
+		void Kill(ListTimer* t)
+		{
+			if(t->next)
+				t->next->prev = t->prev;
+			if(t->prev)
+				t->prev->next = t->next;
+			else
+				m_First = t->next;
+			delete t;
+		}
+
+		void Tick(core::Duration passed)
+		{
+			for(auto t = m_First; t; t = t->next) {
+				if(t->remain > passed) {
+					t->remain -= passed;
+				} else {
+					t->event.Broadcast();
+					t->remain = t->period;
+				}
+			}
+		}
+
+	private:
+		ListTimer* m_First = nullptr;
+	};
+
+	BENCH_CASE(CreateKill)
+	{
+		static const int COUNT = 10000;
+		ctx.SetItemsPerIteration(COUNT);
+
+		core::TimerManager manager;
+		core::Array<core::Timer> timers;
+		timers.Resize(COUNT);
+		ctx.Run("Wheel", [&]() {
+			for(int i = 0; i < COUNT; ++i)
+				timers[i] = manager.CreateTimer(core::Duration::Micros(1000ll * (1 + i % 5000)));
+			for(auto& t : timers)
+				t.Kill();
+		});
+
+		ListTimerManager list;
+		core::Array<ListTimerManager::ListTimer*> listTimers;
+		listTimers.Resize(COUNT);
+		ctx.Run("List", [&]() {
+			for(int i = 0; i < COUNT; ++i)
+				listTimers[i] = list.CreateTimer(core::Duration::Micros(1000ll * (1 + i % 5000)));
+			for(auto t : listTimers)
+				list.Kill(t);
+		});
+	}
+
+	BENCH_CASE(Tick)
+	{
+		// Many timers with different periods, only a few expire in each tick.
+		static const int COUNT = 100000;
+		int fired = 0;
+
+		core::TimerManager manager;
+		core::Array<core::Timer> timers;
+		core::Randomizer rand(1);
+		for(int i = 0; i < COUNT; ++i) {
+			timers.PushBack(manager.CreateTimer(core::Duration::Micros(1000ll * rand.GetInt(16, 60000))));
+			timers.Back().Event().Connect([&]() { ++fired; });
+		}
+		ctx.Run("WheelFrame", [&]() {
+			manager.Tick(core::Duration::Micros(16667ll));
+		});
+		ctx.Run("WheelIdle", [&]() {
+			manager.Tick(core::Duration::Micros(1ll));
+		});
+
+		// The same periods in the list.
+		ListTimerManager list;
+		core::Randomizer listRand(1);
+		for(int i = 0; i < COUNT; ++i) {
+			auto t = list.CreateTimer(core::Duration::Micros(1000ll * listRand.GetInt(16, 60000)));
+			t->event.Connect([&]() { ++fired; });
+		}
+		ctx.Run("ListFrame", [&]() {
+			list.Tick(core::Duration::Micros(16667ll));
+		});
+		ctx.Run("ListIdle", [&]() {
+			list.Tick(core::Duration::Micros(1ll));
+		});
+		Benchmarking::DoNotOptimize(fired);
+	}
+}
@@ -0,0 +1,94 @@
+#include "stdafx.h"
+#include <cstdlib>
+#include <cstring>
+
+using namespace Benchmarking;
+
+static void PrintUsage()
+{
+	std::cout <<
+		"Usage: Benchmark [options]\n"
+		"  --filter <text>      Only run cases whose name Suite.Case contains text\n"
+		"  --list               Print all cases and exit\n"
+		"  --quick              Less samples, for smoke tests\n"
+		"  --json <file>        Write the results as JSON\n"
+		"  --baseline <file>    Compare with the JSON output of an older run\n"
+		"  --threshold <pct>    Allowed slowdown of the median in percent, default 5\n";
+}
+
+int main(int argc, const char* argv[])
+{
+	Settings settings;
+	std::string jsonPath;
+	std::string baselinePath;
+	double threshold = 5.0;
+	bool list = false;
+
+	for(int i = 1; i < argc; ++i) {
+		bool hasValue = i + 1 < argc;
+		if(strcmp(argv[i], "--filter") == 0 && hasValue) {
+			settings.filter = argv[++i];
+		} else if(strcmp(argv[i], "--json") == 0 && hasValue) {
+			jsonPath = argv[++i];
+		} else if(strcmp(argv[i], "--baseline") == 0 && hasValue) {
+			baselinePath = argv[++i];
+		} else if(strcmp(argv[i], "--threshold") == 0 && hasValue) {
+			threshold = atof(argv[++i]);
+		} else if(strcmp(argv[i], "--quick") == 0) {
+			std::string filter = settings.filter;
+			settings = Settings::Quick();
+			settings.filter = filter;
+		} else if(strcmp(argv[i], "--list") == 0) {
+			list = true;
+		} else {
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	auto& env = Environment::Instance();
+	if(list) {
+		for(size_t i = 0; i < env.GetSuiteCount(); ++i) {
+			auto& suite = env.GetSuite(i);
+			for(size_t j = 0; j < suite.GetCaseCount(); ++j)
+				std::cout << suite.GetCase(j).GetFullName() << std::endl;
+		}
+		return 0;
+	}
+
+	// The image benchmarks read from memory files.
+	io::FileSystem::Initialize();
+
+	auto results = env.Run(settings);
+	std::cout << std::endl;
+	PrintResults(std::cout, results);
+
+	if(!jsonPath.empty() && !WriteJSON(jsonPath, results)) {
+		std::cout << "Can't write \"" << jsonPath << "\"." << std::endl;
+		return 2;
+	}
+
+	int regressions = 0;
+	if(!baselinePath.empty()) {
+		Baseline baseline;
+		if(!baseline.Load(baselinePath)) {
+			std::cout << "Can't read \"" << baselinePath << "\"." << std::endl;
+			return 2;
+		}
+
+		std::cout << std::endl << "Compared with \"" << baselinePath << "\":" << std::endl;
+		for(auto& c : baseline.Compare(results, threshold / 100)) {
+			if(!c.regression && !c.improvement)
+				continue;
+			if(c.regression)
+				++regressions;
+			std::cout << "   " << c.name << (c.regression ? " --> Slower by " : " --> Faster by ")
+				<< std::fixed << std::setprecision(1) << std::abs(c.change) * 100 << "%" << std::endl;
+		}
+		std::cout << "====== " << regressions << " regressions =======" << std::endl;
+	}
+
+	io::FileSystem::Destroy();
+
+	return regressions ? 1 : 0;
+}
@@ -0,0 +1,10 @@
+#ifndef INCLUDED_BENCHMARK_STDAFX_H
+#define INCLUDED_BENCHMARK_STDAFX_H
+#include "Benchmark.h"
+#include "Lux.h"
+#include <iomanip>
+#include <cmath>
+
+using namespace lux;
+
+#endif // #ifndef INCLUDED_BENCHMARK_STDAFX_H
@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include "core/threading/lxThreadPool.h"
 
 UNIT_SUITE(algorithm)
 {
@@ -30,6 +31,81 @@ UNIT_SUITE(algorithm)
 		UNIT_ASSERT(sorted);
 	}
 
+	UNIT_TEST(sort_algorithms)
+	{
+		core::Array<int> input;
+		srand(0);
+		for(int i = 0; i < 1000; ++i)
+			input.PushBack(rand() % 100);
+
+		core::ESortAlgorithm algorithms[] = {core::ESortAlgorithm::Introsort, core::ESortAlgorithm::MergeSort, core::ESortAlgorithm::Heapsort};
+		for(auto algo : algorithms) {
+			core::Array<int> arr = input;
+			core::Sort(arr, core::CompareType<int>(), algo);
+			bool sorted = true;
+			for(int i = 1; i < arr.Size(); ++i) {
+				if(arr[i-1] > arr[i])
+					sorted = false;
+			}
+			UNIT_ASSERT(sorted);
+		}
+	}
+
+	UNIT_TEST(sort_by_key_stable)
+	{
+		struct Entry
+		{
+			float key;
+			int id;
+		};
+		core::Array<Entry> arr;
+		for(int i = 0; i < 500; ++i)
+			arr.PushBack({float(i % 7) - 3.5f, i});
+
+		core::Sort(arr, core::SortByKey([](const Entry& e) { return e.key; }));
+
+		bool sorted = true;
+		for(int i = 1; i < arr.Size(); ++i) {
+			if(arr[i-1].key > arr[i].key)
+				sorted = false;
+			if(arr[i-1].key == arr[i].key && arr[i-1].id > arr[i].id)
+				sorted = false;
+		}
+		UNIT_ASSERT(sorted);
+	}
+
+	UNIT_TEST(sort_parallel_stable)
+	{
+		struct Entry
+		{
+			int key;
+			int id;
+		};
+		auto compare = core::CompareTypeFromSmaller<Entry>([](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+		core::ThreadPool pool(4);
+		// Large enough to be split into parts, and small enough for the calling thread.
+		int sizes[] = {20000, 1000};
+		srand(0);
+		for(int size : sizes) {
+			core::Array<Entry> arr;
+			for(int i = 0; i < size; ++i)
+				arr.PushBack({rand() % 100, i});
+
+			core::Sort(arr, compare, pool);
+
+			bool sorted = true;
+			for(int i = 1; i < arr.Size(); ++i) {
+				if(arr[i-1].key > arr[i].key)
+					sorted = false;
+				if(arr[i-1].key == arr[i].key && arr[i-1].id > arr[i].id)
+					sorted = false;
+			}
+			UNIT_ASSERT(sorted);
+			UNIT_ASSERT_EQUAL(arr.Size(), size);
+		}
+	}
+
 	UNIT_TEST(binary_search)
 	{
 		int array[10] = {1, 3, 4,6, 8, 32, 46, 122, 467, 543};
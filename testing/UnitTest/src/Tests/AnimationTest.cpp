@@ -0,0 +1,128 @@
+#include "stdafx.h"
+
+namespace
+{
+class AnimatedTestObject : public scene::AnimatedObject
+{
+public:
+	static scene::AnimatedValueHandle POSITION;
+	static scene::AnimatedValueHandle ALPHA;
+
+	math::Vector3F position;
+	float alpha = 0;
+	int setCalls = 0;
+
+	void SetAnimatedValue(scene::AnimatedValueHandle handle, const core::VariableAccess& data)
+	{
+		++setCalls;
+		if(handle == ALPHA)
+			alpha = data.Get<float>();
+		else if(handle == POSITION)
+			position = data.Get<math::Vector3F>();
+	}
+	void GetAnimatedValue(scene::AnimatedValueHandle handle, const core::VariableAccess& data)
+	{
+		if(handle == ALPHA)
+			data.Set(alpha);
+		else if(handle == POSITION)
+			data.Set(position);
+	}
+	void* GetAnimatedValuePointer(scene::AnimatedValueHandle handle)
+	{
+		return handle == POSITION ? &position : nullptr;
+	}
+
+protected:
+	void InitSharedAnimatedValues() const
+	{
+		POSITION = AddSharedAnimatedValue("position", core::Types::Vector3F());
+		ALPHA = AddSharedAnimatedValue("alpha", core::Types::Float());
+	}
+};
+
+scene::AnimatedValueHandle AnimatedTestObject::POSITION;
+scene::AnimatedValueHandle AnimatedTestObject::ALPHA;
+}
+
+UNIT_SUITE(AnimationTest)
+{
+	UNIT_TEST(BakedCurve)
+	{
+		auto curve = scene::MakeKeyFrameCurve(core::Types::Vector3F());
+		curve->AddSample(0.0f, math::Vector3F(0, 1, 2));
+		curve->AddSample(0.5f, math::Vector3F(3, -1, 0));
+		curve->AddSample(2.0f, math::Vector3F(1, 1, 1));
+		curve->AddSample(3.0f, math::Vector3F(-2, 4, 0));
+
+		scene::BakedCurve baked;
+		UNIT_ASSERT(curve->Bake(baked));
+		UNIT_ASSERT_EQUAL(baked.componentCount, 3);
+
+		u32 token = 0;
+		u32 bakedToken = 0;
+		for(float t = -1; t < 4; t += 0.1f) {
+			math::Vector3F expected;
+			curve->Evaluate(t, core::VariableAccess(core::Types::Vector3F(), &expected), &token);
+			math::Vector3F value;
+			baked.Evaluate(t, &value.x, &bakedToken);
+			UNIT_ASSERT_APPROX(value, expected);
+		}
+		// The token remembers the last segment.
+		UNIT_ASSERT_EQUAL(bakedToken, 2u);
+	}
+
+	UNIT_TEST(TickBatch)
+	{
+		StrongRef<scene::Animation> animation = LUX_NEW(scene::Animation);
+		auto position = scene::MakeKeyFrameCurve(core::Types::Vector3F());
+		position->SetInterpolation(math::EInterpolation::Linear);
+		position->AddSample(0.0f, math::Vector3F(0, 0, 0));
+		position->AddSample(2.0f, math::Vector3F(4, 2, 0));
+		auto alpha = scene::MakeKeyFrameCurve(core::Types::Float());
+		alpha->SetInterpolation(math::EInterpolation::Linear);
+		alpha->AddSample(0.0f, 0.0f);
+		alpha->AddSample(2.0f, 1.0f);
+		animation->AddTrack("position", position);
+		animation->AddTrack("alpha", alpha);
+		animation->SetStartEndAuto();
+
+		StrongRef<AnimatedTestObject> objects[2] = {
+			LUX_NEW(AnimatedTestObject),
+			LUX_NEW(AnimatedTestObject)};
+		scene::AnimationController controllers[2];
+		controllers[0].Reset(objects[0], animation);
+		controllers[1].Reset(objects[1], animation);
+		controllers[1].SetSpeed(0.5f);
+
+		scene::AnimationController* batch[2] = {&controllers[0], &controllers[1]};
+		scene::AnimationController::TickBatch(batch, 2, 1.0f);
+
+		UNIT_ASSERT_APPROX(objects[0]->position, math::Vector3F(2, 1, 0));
+		UNIT_ASSERT_APPROX(objects[0]->alpha, 0.5f);
+		UNIT_ASSERT_APPROX(objects[1]->position, math::Vector3F(1, 0.5f, 0));
+		UNIT_ASSERT_APPROX(objects[1]->alpha, 0.25f);
+		// The position is written directly.
+		UNIT_ASSERT_EQUAL(objects[0]->setCalls, 1);
+	}
+
+	UNIT_TEST(RebakeChangedCurve)
+	{
+		StrongRef<scene::Animation> animation = LUX_NEW(scene::Animation);
+		auto alpha = scene::MakeKeyFrameCurve(core::Types::Float());
+		alpha->AddSample(0.0f, 0.0f);
+		alpha->AddSample(2.0f, 1.0f);
+		animation->AddTrack("alpha", alpha);
+
+		UNIT_ASSERT_EQUAL(animation->GetBakedCurves()[0].values[1], 1.0f);
+
+		alpha->Samples<float>()[1].value = 3.0f;
+		UNIT_ASSERT_EQUAL(animation->GetBakedCurves()[0].values[1], 3.0f);
+
+		alpha->AddSample(3.0f, 4.0f);
+		UNIT_ASSERT_EQUAL(animation->GetBakedCurves()[0].times.Size(), 3);
+
+		alpha->SetInterpolation(math::EInterpolation::Linear);
+		UNIT_ASSERT(animation->GetBakedCurves()[0].interpolation == math::EInterpolation::Linear);
+		UNIT_ASSERT(animation->GetBakedCurves()[0].tangents.IsEmpty());
+	}
+}
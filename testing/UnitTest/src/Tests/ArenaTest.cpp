@@ -0,0 +1,73 @@
+#include "stdafx.h"
+#include "core/lxArena.h"
+
+UNIT_SUITE(Arena)
+{
+	UNIT_TEST(Alignment)
+	{
+		core::Arena arena(128);
+		arena.Allocate(3, 1);
+		void* a = arena.Allocate(16, 16);
+		UNIT_ASSERT_EQUAL((size_t)a % 16, 0);
+
+		// Bigger than a single block
+		void* b = arena.Allocate(1000, 64);
+		UNIT_ASSERT_EQUAL((size_t)b % 64, 0);
+		UNIT_ASSERT(arena.GetUsedBytes() >= 1019);
+	}
+
+	UNIT_TEST(ResetReusesMemory)
+	{
+		core::Arena arena(256);
+		for(int i = 0; i < 100; ++i)
+			arena.Allocate(100);
+		arena.Reset();
+		UNIT_ASSERT_EQUAL(arena.GetUsedBytes(), 0);
+
+		// After the reset everything fits into the merged block.
+		size_t reserved = arena.GetReservedBytes();
+		for(int i = 0; i < 100; ++i)
+			arena.Allocate(100);
+		UNIT_ASSERT_EQUAL(arena.GetReservedBytes(), reserved);
+	}
+
+	UNIT_TEST(FrameArray)
+	{
+		core::FrameScope frame;
+		core::FrameArray<core::String> array;
+		UNIT_ASSERT(array.GetAllocator() != nullptr);
+		for(int i = 0; i < 100; ++i)
+			array.PushBack(core::StringConverter::IntToString(i));
+
+		UNIT_ASSERT_EQUAL(array.Size(), 100);
+		for(int i = 0; i < 100; ++i)
+			UNIT_ASSERT_EQUAL(array[i], core::StringConverter::IntToString(i));
+
+		// The memory is reused after clearing.
+		const core::String* data = array.Data();
+		array.Clear();
+		array.PushBack("x");
+		UNIT_ASSERT(array.Data() == data);
+	}
+
+	UNIT_TEST(FrameScopes)
+	{
+		auto& arena = core::FrameArena::Get();
+		{
+			core::FrameScope outer;
+			{
+				core::FrameScope inner;
+				core::FrameArray<int> array(16);
+			}
+			// Only the outermost frame resets the arena.
+			UNIT_ASSERT(arena.GetUsedBytes() >= 16 * sizeof(int));
+		}
+		UNIT_ASSERT_EQUAL(arena.GetUsedBytes(), 0);
+
+		// Without a frame the heap is used.
+		UNIT_ASSERT(!core::FrameArena::IsFrameOpen());
+		core::FrameArray<int> array(16);
+		UNIT_ASSERT(array.GetAllocator() == nullptr);
+		UNIT_ASSERT_EQUAL(arena.GetUsedBytes(), 0);
+	}
+}
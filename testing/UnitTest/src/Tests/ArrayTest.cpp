@@ -136,4 +136,45 @@ UNIT_SUITE(Array)
 		UNIT_ASSERT(refCount2 == 0);
 		UNIT_ASSERT(refCount3 == 0);
 	}
+
+	UNIT_TEST(SmallArray)
+	{
+		int refCount = 0;
+		{
+			core::SmallArray<Type, 4> arr;
+			const Type* inlineData = arr.Data();
+			for(int i = 0; i < 4; ++i)
+				arr.PushBack(Type(refCount, i));
+			UNIT_ASSERT(arr.Data() == inlineData);
+
+			arr.PushBack(Type(refCount, 4));
+			UNIT_ASSERT(arr.Data() != inlineData);
+			UNIT_ASSERT(refCount == 5);
+
+			arr.Resize(2, Type(refCount, 0));
+			arr.ShrinkToFit();
+			UNIT_ASSERT(arr.Data() == inlineData);
+
+			core::Array<Type>& base = arr;
+			UNIT_ASSERT(base.Size() == 2);
+			UNIT_ASSERT(base[1].value == 1);
+
+			core::Array<Type> moved(std::move(arr));
+			UNIT_ASSERT(moved.Size() == 2);
+			UNIT_ASSERT(arr.IsEmpty());
+		}
+		UNIT_ASSERT(refCount == 0);
+	}
+
+	UNIT_TEST(Allocator)
+	{
+		core::Arena arena;
+		core::ArenaAllocator allocator(arena);
+		core::Array<int> arr(&allocator);
+		for(int i = 0; i < 100; ++i)
+			arr.PushBack(i);
+
+		UNIT_ASSERT(arena.GetUsedBytes() >= 100 * sizeof(int));
+		UNIT_ASSERT(arr[99] == 99);
+	}
 }
@@ -0,0 +1,56 @@
+#include "stdafx.h"
+
+UNIT_SUITE(AttributesTest)
+{
+	UNIT_TEST(FindSlot)
+	{
+		core::AttributeListBuilder builder;
+		builder.AddAttribute("a", 1);
+		builder.AddAttribute("b", 2.0f);
+		auto list = builder.BuildAndReset();
+
+		UNIT_ASSERT_EQUAL(list.GetSlotCount(), 2);
+		int a = list.FindSlot("a");
+		int b = list.FindSlot("b");
+		UNIT_ASSERT(a >= 0 && a < 2);
+		UNIT_ASSERT(b >= 0 && b < 2);
+		UNIT_ASSERT(a != b);
+		UNIT_ASSERT_EQUAL(list.FindSlot("missing"), -1);
+		UNIT_ASSERT(!list.Pointer(-1));
+		UNIT_ASSERT(!list.Pointer(2));
+
+		// Slots and names access the same attribute.
+		const core::AttributeList& constList = list;
+		UNIT_ASSERT_EQUAL(constList.GetValue<int>(a), 1);
+		list.SetValue(b, 3.0f);
+		UNIT_ASSERT_EQUAL(list.GetValue<float>("b"), 3.0f);
+		UNIT_ASSERT(list.Pointer(a) == list.Pointer("a"));
+	}
+
+	UNIT_TEST(BaseSlotsStayValid)
+	{
+		core::AttributeListBuilder baseBuilder;
+		baseBuilder.AddAttribute("x", 1);
+		baseBuilder.AddAttribute("y", 2);
+		auto base = baseBuilder.BuildAndReset();
+		int x = base.FindSlot("x");
+		int y = base.FindSlot("y");
+
+		core::AttributeListBuilder builder;
+		builder.SetBase(base);
+		builder.AddAttribute("z", 3);
+		auto list = builder.BuildAndReset();
+
+		UNIT_ASSERT_EQUAL(list.GetSlotCount(), 3);
+		UNIT_ASSERT_EQUAL(list.FindSlot("x"), x);
+		UNIT_ASSERT_EQUAL(list.FindSlot("y"), y);
+		int z = list.FindSlot("z");
+		UNIT_ASSERT(z != x && z != y && z >= 0);
+		UNIT_ASSERT_EQUAL(base.FindSlot("z"), -1);
+
+		// The derived list shares the attributes of the base.
+		list.SetValue(x, 5);
+		UNIT_ASSERT_EQUAL(base.GetValue<int>(x), 5);
+		UNIT_ASSERT_EQUAL(list.GetValue<int>(z), 3);
+	}
+}
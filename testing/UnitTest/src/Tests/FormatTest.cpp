@@ -56,4 +56,130 @@ UNIT_SUITE(format)
 		format::format(buffer, "{}", nan(""));
 		UNIT_ASSERT_CSTR(buffer, "nan");
 	}
-}
\ No newline at end of file
+
+	UNIT_TEST(FloatRounding)
+	{
+		char buffer[32];
+		format::format(buffer, "{:.2}", 2.675);
+		UNIT_ASSERT_CSTR(buffer, "2.68");
+
+		format::format(buffer, "{:.2}", 9.999);
+		UNIT_ASSERT_CSTR(buffer, "10");
+
+		format::format(buffer, "{:.3*}", 0.5);
+		UNIT_ASSERT_CSTR(buffer, "0.500");
+
+		format::format(buffer, "{}", 0.00006);
+		UNIT_ASSERT_CSTR(buffer, "0.0001");
+
+		format::format(buffer, "{}", 1.5e20);
+		UNIT_ASSERT_CSTR(buffer, "1.5e+20");
+
+		format::format(buffer, "{}", 2.5e-12f);
+		UNIT_ASSERT_CSTR(buffer, "2.5e-12");
+	}
+
+	UNIT_TEST(FloatRoundTrip)
+	{
+		char buffer[32];
+		format::format(buffer, "{!r}", 0.1 + 0.2);
+		UNIT_ASSERT_CSTR(buffer, "0.30000000000000004");
+
+		format::format(buffer, "{!r}", 1.0f / 3.0f);
+		UNIT_ASSERT_CSTR(buffer, "0.33333334");
+
+		format::format(buffer, "{!r}", 5e-324);
+		UNIT_ASSERT_CSTR(buffer, "5e-324");
+
+		format::format(buffer, "{!r}", -1.7976931348623157e308);
+		UNIT_ASSERT_CSTR(buffer, "-1.7976931348623157e+308");
+
+		core::Randomizer rand(3);
+		for(int i = 0; i < 1000; ++i) {
+			double d = rand.GetFloat(-1000.0f, 1000.0f) * std::pow(10.0, rand.GetInt(-20, 20));
+			format::format(buffer, "{!r}", d);
+			UNIT_ASSERT_EQUAL(std::strtod(buffer, nullptr), d);
+
+			float f = (float)d;
+			format::format(buffer, "{!r}", f);
+			UNIT_ASSERT_EQUAL(std::strtof(buffer, nullptr), f);
+		}
+	}
+
+	UNIT_TEST(IntToStringLimits)
+	{
+		char buffer[32];
+		format::format(buffer, "{}", std::numeric_limits<long long>::min());
+		UNIT_ASSERT_CSTR(buffer, "-9223372036854775808");
+
+		format::format(buffer, "{}", std::numeric_limits<unsigned long long>::max());
+		UNIT_ASSERT_CSTR(buffer, "18446744073709551615");
+
+		format::format(buffer, "{!h}", 255u);
+		UNIT_ASSERT_CSTR(buffer, "FF");
+	}
+
+	UNIT_TEST(ExplicitArgId)
+	{
+		std::string str;
+		format::format(str, "{1}{0}{}", 1, 2);
+		UNIT_ASSERT_EQUAL(str, "212");
+	}
+
+	UNIT_TEST(PlanDirect)
+	{
+		static constexpr auto PLAN = format::MakePlan("light{} {}");
+		static_assert(PLAN.GetArgCount() == 2, "Wrong argument count");
+		static_assert(PLAN.IsDirect(), "Plan must be direct");
+
+		std::string str;
+		format::format(str, PLAN, -321, "abc");
+		UNIT_ASSERT_EQUAL(str, "light-321 abc");
+
+		format::format(str, PLAN, 0u, std::string("x"));
+		UNIT_ASSERT_EQUAL(str, "light0 x");
+
+		char buffer[8];
+		format::format(buffer, PLAN, 12345, "abc");
+		UNIT_ASSERT_CSTR(buffer, "light12");
+
+		format::formatln(str, PLAN, 1, 2);
+		UNIT_ASSERT_EQUAL(str, "light1 2\n");
+	}
+
+	UNIT_TEST(PlanMatchesString)
+	{
+		static constexpr auto PLAN = format::MakePlan("{{{1}}{0} {} {!d:.3}");
+		static_assert(PLAN.GetArgCount() == 3, "Wrong argument count");
+		static_assert(!PLAN.IsDirect(), "Plan can't be direct");
+
+		std::string planStr;
+		std::string str;
+		format::format(planStr, PLAN, 1, 2.5f, 7);
+		format::format(str, "{{{1}}{0} {} {!d:.3}", 1, 2.5f, 7);
+		UNIT_ASSERT_EQUAL(planStr, str);
+		UNIT_ASSERT_EQUAL(planStr, "{2.5}1 2.5 007");
+	}
+
+	UNIT_TEST(PlanFallback)
+	{
+		static constexpr auto PLAN = format::MakePlan("value: {}");
+
+		// Floats and long output use the formatting context.
+		std::string str;
+		format::format(str, PLAN, 1.5f);
+		UNIT_ASSERT_EQUAL(str, "value: 1.5");
+
+		std::string longStr(300, 'a');
+		format::format(str, PLAN, longStr);
+		UNIT_ASSERT_EQUAL(str, "value: " + longStr);
+
+		bool thrown = false;
+		try {
+			format::format(str, format::MakePlan("{} {}"), 1);
+		} catch(format::format_exception&) {
+			thrown = true;
+		}
+		UNIT_ASSERT(thrown);
+	}
+}
@@ -146,4 +146,79 @@ UNIT_SUITE(HashMap)
 		}
 		UNIT_ASSERT(success);
 	}
-}
\ No newline at end of file
+}
+
+UNIT_SUITE(FlatHashMap)
+{
+	UNIT_TEST(AddKey)
+	{
+		core::FlatHashMap<u32, u32> map;
+		map.SetAndReplace(1, 2);
+		map.SetAndReplace(2, 1);
+		UNIT_ASSERT(map.Size() == 2);
+		UNIT_ASSERT(map.At(1) == 2);
+		UNIT_ASSERT(map.At(2) == 1);
+		UNIT_ASSERT(!map.HasKey(3));
+	}
+
+	UNIT_TEST(EraseMany)
+	{
+		core::FlatHashMap<u32, u32> map;
+		for(u32 i = 0; i < 1000; ++i)
+			map[i] = i * i;
+		for(u32 i = 0; i < 1000; i += 2)
+			map.Erase(i);
+
+		UNIT_ASSERT_EQUAL(map.Size(), 500);
+		bool success = true;
+		for(u32 i = 0; i < 1000; ++i) {
+			if(map.HasKey(i) != (i % 2 == 1))
+				success = false;
+			if(i % 2 == 1 && map.Get(i) != i * i)
+				success = false;
+		}
+		UNIT_ASSERT(success);
+	}
+
+	UNIT_TEST(ReuseErasedSlots)
+	{
+		core::FlatHashMap<u32, u32> map;
+		map.Reserve(100);
+		for(u32 i = 0; i < 100000; ++i) {
+			map[i] = i;
+			if(i >= 50)
+				map.Erase(i - 50);
+		}
+
+		UNIT_ASSERT_EQUAL(map.Size(), 50);
+		UNIT_ASSERT(map.HasKey(99999));
+		UNIT_ASSERT(!map.HasKey(0));
+	}
+
+	UNIT_TEST(StringViewLookup)
+	{
+		core::FlatHashMap<core::String, int> map;
+		map["hello"] = 1;
+		map["world"] = 2;
+
+		core::StringView view("hello world");
+		auto it = map.Find(view.SubString(6, 5));
+		UNIT_ASSERT(it.HasValue());
+		UNIT_ASSERT_EQUAL(it.GetValue()->value, 2);
+		UNIT_ASSERT_EQUAL(map.Get(view.SubString(0, 5)), 1);
+		UNIT_ASSERT(!map.Find(view).HasValue());
+	}
+
+	UNIT_TEST(Set)
+	{
+		core::FlatHashSet<int> set;
+		UNIT_ASSERT(set.AddIfNotExist(5).addedNew);
+		UNIT_ASSERT(!set.AddIfNotExist(5).addedNew);
+		set.AddIfNotExist(7);
+		set.Erase(5);
+
+		UNIT_ASSERT_EQUAL(set.Size(), 1);
+		UNIT_ASSERT(set.Exists(7));
+		UNIT_ASSERT(!set.Exists(5));
+	}
+}
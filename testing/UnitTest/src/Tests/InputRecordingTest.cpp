@@ -0,0 +1,183 @@
+#include "stdafx.h"
+#include "input/InputRecording.h"
+
+UNIT_SUITE(InputRecording)
+{
+	// A mouse with two buttons, a wheel and a position.
+	class TestMouseDesc : public input::InputDeviceDesc
+	{
+	public:
+		input::EDeviceType GetType() const override { return input::EDeviceType::Mouse; }
+		core::StringView GetName() const override { return "TestMouse"; }
+		core::StringView GetGUID() const override { return "TestMouseGUID"; }
+
+		int GetElementCount(input::EDeviceEventType type) const override
+		{
+			return type == input::EDeviceEventType::Button ? 2 : 1;
+		}
+		core::StringView GetElementName(input::EDeviceEventType type, int id) const override
+		{
+			LUX_UNUSED(type);
+			LUX_UNUSED(id);
+			return "Element";
+		}
+		input::EDeviceElementType GetElementType(input::EDeviceEventType type, int id) const override
+		{
+			LUX_UNUSED(id);
+			if(type == input::EDeviceEventType::Button)
+				return CombineFlags(input::EDeviceElementType::Input, input::EDeviceElementType::Button);
+			if(type == input::EDeviceEventType::Axis)
+				return CombineFlags(input::EDeviceElementType::Input, input::EDeviceElementType::Axis, input::EDeviceElementType::Rel);
+			return CombineFlags(input::EDeviceElementType::Input, input::EDeviceElementType::Area, input::EDeviceElementType::Rel);
+		}
+	};
+
+	UNIT_SUITE_INIT()
+	{
+		io::FileSystem::Initialize();
+	}
+
+	UNIT_SUITE_EXIT()
+	{
+		io::FileSystem::Destroy();
+	}
+
+	void SendButton(input::InputSystem* system, input::InputDevice* device, int code, bool down)
+	{
+		input::ButtonEvent event;
+		event.device = device;
+		event.code = code;
+		event.pressedDown = down;
+		system->Update(event);
+	}
+
+	void SendMove(input::InputSystem* system, input::InputDevice* device, float x, float y)
+	{
+		input::AreaEvent event;
+		event.device = device;
+		event.code = 0;
+		event.rel = math::Vector2F(x, y);
+		system->Update(event);
+	}
+
+	// Record three frames and an unfinished one, returns the stream.
+	core::Array<u8> Record(UnitTesting::TestContext& ctx)
+	{
+		StrongRef<input::InputSystem> system = LUX_NEW(input::InputSystem);
+		auto mouse = system->FindDevice(LUX_NEW(TestMouseDesc));
+
+		core::Array<u8> buffer;
+		buffer.Resize(4096);
+		auto file = io::FileSystem::Instance()->OpenVirtualFile(buffer.Data(), buffer.Size(), io::Path("input.lxir"));
+		StrongRef<input::InputRecorder> recorder = LUX_NEW(input::InputRecorder)(system, file);
+
+		SendButton(system, mouse, 0, true);
+		SendMove(system, mouse, 3, 4);
+		recorder->NextFrame(0.016f);
+
+		recorder->NextFrame(0.02f);
+
+		SendMove(system, mouse, -1, 1);
+		SendButton(system, mouse, 0, false);
+		SendButton(system, mouse, 1, true);
+		recorder->NextFrame(0.01f);
+
+		// Written as last frame by Finish.
+		SendButton(system, mouse, 1, false);
+		recorder->Finish();
+
+		UNIT_ASSERT_EQUAL(recorder->GetFrameCount(), 4);
+		UNIT_ASSERT_FALSE(recorder->IsRecording());
+		buffer.Resize((int)file->GetCursor());
+		return buffer;
+	}
+
+	UNIT_TEST(Replay)
+	{
+		auto stream = Record(ctx);
+
+		StrongRef<input::InputSystem> system = LUX_NEW(input::InputSystem);
+		system->SetLiveInputBlocked(true);
+		int eventCount = 0;
+		system->GetEventSignal().Connect([&](const input::Event&) { ++eventCount; });
+
+		auto file = io::FileSystem::Instance()->OpenVirtualFile((const void*)stream.Data(), stream.Size(), io::Path("input.lxir"));
+		StrongRef<input::InputReplay> replay = LUX_NEW(input::InputReplay)(system, file);
+		UNIT_ASSERT_EQUAL(replay->GetFrameCount(), 4);
+
+		float secsPassed;
+		UNIT_ASSERT(replay->NextFrame(secsPassed));
+		UNIT_ASSERT_EQUAL(secsPassed, 0.016f);
+		UNIT_ASSERT_EQUAL(eventCount, 2);
+		auto mouse = system->GetMouse();
+		UNIT_ASSERT(mouse != nullptr);
+		UNIT_ASSERT(mouse->GetButtonState(0));
+		UNIT_ASSERT(mouse->GetAreaState(0) == math::Vector2F(3, 4));
+
+		// The real devices are ignored while replaying.
+		SendButton(system, mouse, 0, false);
+		UNIT_ASSERT(mouse->GetButtonState(0));
+
+		UNIT_ASSERT(replay->NextFrame(secsPassed));
+		UNIT_ASSERT_EQUAL(secsPassed, 0.02f);
+		UNIT_ASSERT_EQUAL(eventCount, 2);
+
+		UNIT_ASSERT(replay->NextFrame(secsPassed));
+		UNIT_ASSERT_EQUAL(secsPassed, 0.01f);
+		UNIT_ASSERT_EQUAL(eventCount, 5);
+		UNIT_ASSERT(!mouse->GetButtonState(0));
+		UNIT_ASSERT(mouse->GetButtonState(1));
+		UNIT_ASSERT(mouse->GetAreaState(0) == math::Vector2F(2, 5));
+
+		UNIT_ASSERT(replay->NextFrame(secsPassed));
+		UNIT_ASSERT(secsPassed >= 0.0f);
+		UNIT_ASSERT_EQUAL(eventCount, 6);
+		UNIT_ASSERT(!mouse->GetButtonState(1));
+
+		UNIT_ASSERT(replay->IsFinished());
+		UNIT_ASSERT_FALSE(replay->NextFrame(secsPassed));
+		UNIT_ASSERT(!mouse->GetButtonState(1));
+	}
+
+	UNIT_TEST(TruncatedStream)
+	{
+		auto stream = Record(ctx);
+		StrongRef<input::InputSystem> system = LUX_NEW(input::InputSystem);
+		system->SetLiveInputBlocked(true);
+
+		// Cut inside the last frame, the complete frames are still replayed.
+		auto file = io::FileSystem::Instance()->OpenVirtualFile((const void*)stream.Data(), stream.Size() - 3, io::Path("input.lxir"));
+		StrongRef<input::InputReplay> replay = LUX_NEW(input::InputReplay)(system, file);
+		UNIT_ASSERT_EQUAL(replay->GetFrameCount(), 3);
+
+		float secsPassed;
+		for(int i = 0; i < 3; ++i)
+			UNIT_ASSERT(replay->NextFrame(secsPassed));
+		UNIT_ASSERT_EQUAL(secsPassed, 0.01f);
+		UNIT_ASSERT(system->GetMouse()->GetButtonState(1));
+		UNIT_ASSERT_FALSE(replay->NextFrame(secsPassed));
+
+		// Without the end tag all frames are replayed.
+		auto file2 = io::FileSystem::Instance()->OpenVirtualFile((const void*)stream.Data(), stream.Size() - 1, io::Path("input.lxir"));
+		StrongRef<input::InputReplay> replay2 = LUX_NEW(input::InputReplay)(system, file2);
+		UNIT_ASSERT_EQUAL(replay2->GetFrameCount(), 4);
+	}
+
+	UNIT_TEST(InvalidStream)
+	{
+		auto stream = Record(ctx);
+		StrongRef<input::InputSystem> system = LUX_NEW(input::InputSystem);
+
+		// An unknown record in the first frame.
+		stream[8] = 0x7F;
+		auto file = io::FileSystem::Instance()->OpenVirtualFile((const void*)stream.Data(), stream.Size(), io::Path("input.lxir"));
+		bool thrown = false;
+		try {
+			StrongRef<input::InputReplay> replay = LUX_NEW(input::InputReplay)(system, file);
+		} catch(core::FileFormatException&) {
+			thrown = true;
+		}
+		UNIT_ASSERT(thrown);
+		UNIT_ASSERT(system->GetMouse() == nullptr);
+	}
+}
@@ -279,4 +279,67 @@ UNIT_SUITE(MatrixTest)
 		}
 		UNIT_ASSERT(compare);
 	}
+
+	UNIT_TEST(InvertTransform)
+	{
+		math::Matrix4 a;
+		a.BuildWorld(
+			math::Vector3F(2.0f, 0.5f, 3.0f),
+			math::QuaternionF::FromEuler(math::Vector3F(0.3f, 1.2f, -0.7f)),
+			math::Vector3F(10.0f, -4.0f, 7.5f));
+
+		bool result;
+		math::Matrix4 b = a.GetTransformInverted(&result);
+		UNIT_ASSERT(result);
+		UNIT_ASSERT(math::IsEqual(a * b, math::Matrix4::IDENTITY, 0.0001f));
+		UNIT_ASSERT(math::IsEqual(b * a, math::Matrix4::IDENTITY, 0.0001f));
+
+		// Multiply into one of the factors.
+		math::Matrix4 c = a;
+		c.SetByProduct(c, b);
+		UNIT_ASSERT(math::IsEqual(c, a * b, 0.0001f));
+	}
+
+	UNIT_TEST(ArrayFunctions)
+	{
+		math::Matrix4 a;
+		a.BuildWorld(
+			math::Vector3F(2.0f, 0.5f, 3.0f),
+			math::Vector3F(0.3f, 1.2f, -0.7f),
+			math::Vector3F(10.0f, -4.0f, 7.5f));
+
+		// More than four points, to test the batched and the remaining ones.
+		math::Vector3F points[7] = {
+			math::Vector3F(1.0f, 0.0f, 0.0f),
+			math::Vector3F(0.0f, -2.0f, 3.0f),
+			math::Vector3F(4.0f, 5.0f, -6.0f),
+			math::Vector3F(-1.5f, 0.25f, 8.0f),
+			math::Vector3F(0.0f, 0.0f, 1.0f),
+			math::Vector3F(-7.0f, 3.0f, 2.5f),
+			math::Vector3F(0.5f, -0.5f, -0.5f)};
+		math::Vector3F transformed[7];
+		math::Vector3F rotated[7];
+		a.TransformVectorArray(points, transformed, 7);
+		a.RotateVectorArray(points, rotated, 7);
+		for(int i = 0; i < 7; ++i) {
+			UNIT_ASSERT_APPROX(transformed[i], a.TransformVector(points[i]));
+			UNIT_ASSERT_APPROX(rotated[i], a.RotateVector(points[i]));
+		}
+
+		// Transform in place.
+		a.TransformVectorArray(points, points, 7);
+		for(int i = 0; i < 7; ++i)
+			UNIT_ASSERT_APPROX(points[i], transformed[i]);
+
+		math::PlaneF planes[2];
+		planes[0].SetPlane(math::Vector3F(1.0f, 2.0f, 3.0f), math::Vector3F(0.0f, 1.0f, 0.0f));
+		planes[1].SetPlane(math::Vector3F(-1.0f, 0.0f, 5.0f), math::Vector3F(1.0f, 1.0f, 0.0f).Normalize());
+		math::PlaneF transformedPlanes[2];
+		a.TransformPlaneArray(planes, transformedPlanes, 2);
+		for(int i = 0; i < 2; ++i) {
+			auto p = a.TransformPlane(planes[i]);
+			UNIT_ASSERT_APPROX(transformedPlanes[i].normal, p.normal);
+			UNIT_ASSERT(math::IsEqual(transformedPlanes[i].d, p.d));
+		}
+	}
 }
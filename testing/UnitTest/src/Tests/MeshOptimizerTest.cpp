@@ -0,0 +1,188 @@
+#include "stdafx.h"
+
+namespace
+{
+// A grid of quads, with the triangles in a scattered order.
+void MakeGrid(int size, core::Array<math::Vector3F>& positions, core::Array<u32>& indices)
+{
+	for(int y = 0; y <= size; ++y) {
+		for(int x = 0; x <= size; ++x)
+			positions.PushBack(math::Vector3F((float)x, (float)y, 0));
+	}
+	const int quadCount = size * size;
+	for(int i = 0; i < quadCount; ++i) {
+		// 7 and the quad count have no common divisor, so each quad is used once.
+		const int q = (i * 7) % quadCount;
+		const u32 a = (q / size) * (size + 1) + q % size;
+		const u32 b = a + 1;
+		const u32 c = a + size + 1;
+		const u32 d = c + 1;
+		u32 quad[6] = {a, b, c, b, d, c};
+		for(auto index : quad)
+			indices.PushBack(index);
+	}
+}
+
+int CountTriangle(const core::Array<u32>& indices, const u32* tri)
+{
+	int count = 0;
+	for(int i = 0; i < indices.Size(); i += 3) {
+		for(int r = 0; r < 3; ++r) {
+			if(indices[i] == tri[r] && indices[i + 1] == tri[(r + 1) % 3] && indices[i + 2] == tri[(r + 2) % 3])
+				++count;
+		}
+	}
+	return count;
+}
+}
+
+UNIT_SUITE(MeshOptimizerTest)
+{
+	UNIT_TEST(AnalyzeVertexCache)
+	{
+		u32 quad[6] = {0, 1, 2, 2, 1, 3};
+		auto stats = video::AnalyzeVertexCache(quad, 6, 4);
+		UNIT_ASSERT_EQUAL(stats.vertexTransforms, 4);
+		UNIT_ASSERT_APPROX(stats.acmr, 2.0f);
+		UNIT_ASSERT_APPROX(stats.atvr, 1.0f);
+	}
+
+	UNIT_TEST(VertexCacheAndOverdraw)
+	{
+		core::Array<math::Vector3F> positions;
+		core::Array<u32> indices;
+		MakeGrid(20, positions, indices);
+
+		core::Array<u32> cacheOptimized;
+		cacheOptimized.Resize(indices.Size());
+		video::OptimizeVertexCache(cacheOptimized.Data(), indices.Data(), indices.Size(), positions.Size());
+
+		core::Array<u32> overdrawOptimized;
+		overdrawOptimized.Resize(indices.Size());
+		video::OptimizeOverdraw(
+			overdrawOptimized.Data(), cacheOptimized.Data(), indices.Size(),
+			positions.Data(), positions.Size(), video::EFaceWinding::CCW, 1.05f);
+
+		// All triangles are kept, with their winding.
+		for(int i = 0; i < indices.Size(); i += 3) {
+			UNIT_ASSERT_EQUAL(CountTriangle(cacheOptimized, indices.Data() + i), 1);
+			UNIT_ASSERT_EQUAL(CountTriangle(overdrawOptimized, indices.Data() + i), 1);
+		}
+
+		auto before = video::AnalyzeVertexCache(indices.Data(), indices.Size(), positions.Size());
+		auto after = video::AnalyzeVertexCache(cacheOptimized.Data(), indices.Size(), positions.Size());
+		auto overdraw = video::AnalyzeVertexCache(overdrawOptimized.Data(), indices.Size(), positions.Size());
+		UNIT_ASSERT(after.acmr < 0.8f);
+		UNIT_ASSERT(after.acmr < before.acmr);
+		UNIT_ASSERT(overdraw.acmr <= after.acmr * 1.05f + 0.01f);
+	}
+
+	UNIT_TEST(VertexFetch)
+	{
+		u32 indices[6] = {4, 2, 5, 5, 2, 0};
+		u32 remap[6];
+		int used = video::OptimizeVertexFetch(remap, indices, 6, 6);
+		UNIT_ASSERT_EQUAL(used, 4);
+		UNIT_ASSERT_EQUAL(indices[0], 0u);
+		UNIT_ASSERT_EQUAL(indices[1], 1u);
+		UNIT_ASSERT_EQUAL(indices[2], 2u);
+		UNIT_ASSERT_EQUAL(indices[5], 3u);
+		UNIT_ASSERT_EQUAL(remap[1], ~0u);
+		UNIT_ASSERT_EQUAL(remap[3], ~0u);
+	}
+
+	UNIT_TEST(WeldVertices)
+	{
+		math::Vector3F vertices[5] = {
+			math::Vector3F(1, 2, 3),
+			math::Vector3F(4, 5, 6),
+			math::Vector3F(1, 2, 3),
+			math::Vector3F(7, 8, 9),
+			math::Vector3F(4, 5, 6)};
+		u32 remap[5];
+		int unique = video::WeldVertices(remap, vertices, 5, sizeof(math::Vector3F));
+		UNIT_ASSERT_EQUAL(unique, 3);
+		UNIT_ASSERT_EQUAL(remap[0], 0u);
+		UNIT_ASSERT_EQUAL(remap[1], 1u);
+		UNIT_ASSERT_EQUAL(remap[2], 0u);
+		UNIT_ASSERT_EQUAL(remap[3], 2u);
+		UNIT_ASSERT_EQUAL(remap[4], 1u);
+
+		math::Vector3F welded[3];
+		video::RemapVertices(welded, vertices, 5, sizeof(math::Vector3F), remap);
+		UNIT_ASSERT(welded[2] == vertices[3]);
+	}
+
+	UNIT_TEST(SimplifyFlatGrid)
+	{
+		const int size = 10;
+		core::Array<math::Vector3F> positions;
+		core::Array<u32> indices;
+		MakeGrid(size, positions, indices);
+
+		// A flat grid can be simplified without error, until only the border is left.
+		core::Array<u32> simplified;
+		simplified.Resize(indices.Size());
+		float error = -1;
+		int count = video::SimplifyMesh(
+			simplified.Data(), indices.Data(), indices.Size(),
+			positions.Data(), positions.Size(),
+			0, 0.001f, nullptr, &error);
+		UNIT_ASSERT_EQUAL(count, (4 * size - 2) * 3);
+		UNIT_ASSERT_APPROX(error, 0.0f);
+
+		// The area is unchanged, and no triangle is flipped.
+		float area = 0;
+		for(int i = 0; i < count; i += 3) {
+			auto& a = positions[simplified[i]];
+			auto& b = positions[simplified[i + 1]];
+			auto& c = positions[simplified[i + 2]];
+			auto normal = (b - a).Cross(c - a);
+			UNIT_ASSERT(normal.z > 0);
+			area += normal.z * 0.5f;
+		}
+		UNIT_ASSERT_APPROX(area, (float)(size * size));
+
+		// Locked vertices are kept.
+		core::Array<u8> locked;
+		locked.Resize(positions.Size(), 0);
+		const u32 center = (size / 2) * (size + 1) + size / 2;
+		locked[center] = 1;
+		count = video::SimplifyMesh(
+			simplified.Data(), indices.Data(), indices.Size(),
+			positions.Data(), positions.Size(),
+			0, 0.001f, locked.Data());
+		bool found = false;
+		for(int i = 0; i < count; ++i)
+			found |= simplified[i] == center;
+		UNIT_ASSERT(found);
+	}
+
+	UNIT_TEST(SimplifyTarget)
+	{
+		core::Array<math::Vector3F> positions;
+		core::Array<u32> indices;
+		MakeGrid(20, positions, indices);
+		for(auto& p : positions)
+			p.z = std::sin(p.x * 0.3f) + std::sin(p.y * 0.3f);
+
+		// The error bound stops the simplification before the target.
+		core::Array<u32> simplified;
+		simplified.Resize(indices.Size());
+		float error;
+		int boundCount = video::SimplifyMesh(
+			simplified.Data(), indices.Data(), indices.Size(),
+			positions.Data(), positions.Size(),
+			0, 0.001f, nullptr, &error);
+		UNIT_ASSERT(error <= 0.001f);
+		UNIT_ASSERT(boundCount > indices.Size() / 2);
+
+		int count = video::SimplifyMesh(
+			simplified.Data(), indices.Data(), indices.Size(),
+			positions.Data(), positions.Size(),
+			indices.Size() / 2, 1.0f, nullptr, &error);
+		UNIT_ASSERT(count <= indices.Size() / 2);
+		UNIT_ASSERT(count > 0);
+		UNIT_ASSERT(error < 0.1f);
+	}
+}
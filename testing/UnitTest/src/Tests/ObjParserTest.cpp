@@ -0,0 +1,133 @@
+#include "stdafx.h"
+#include "video/mesh/ObjParser.h"
+#include "core/threading/lxThreadPool.h"
+#include <string>
+
+UNIT_SUITE(ObjParserTest)
+{
+	core::Array<video::ObjCorner> GetCorners(const video::ObjGeometry& geo)
+	{
+		core::Array<video::ObjCorner> out;
+		for(auto& chunk : geo.chunks) {
+			for(auto& c : chunk.corners)
+				out.PushBack(c);
+		}
+		return out;
+	}
+
+	video::ObjGeometry Parse(const std::string& text, int chunkCount, core::ThreadPool* pool = nullptr)
+	{
+		video::ObjGeometry geo;
+		video::ParseObjGeometry(text.data(), text.data() + text.size(), chunkCount, geo, pool);
+		return geo;
+	}
+
+	bool ParseThrows(const std::string& text, int chunkCount)
+	{
+		try {
+			Parse(text, chunkCount);
+		} catch(core::FileFormatException&) {
+			return true;
+		}
+		return false;
+	}
+
+	UNIT_TEST(ChunksWithRelativeIndices)
+	{
+		// All vertices are at the start, so the faces in the later chunks
+		// only reference vertices of the first chunk.
+		std::string text =
+			"# test\n"
+			"mtllib test.mtl\n"
+			"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 0 0 1\nv 1 0 1\nv 1 1 1\nv 0 1 1\n"
+			"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+			"vn 0 0 1\nvn 0 1 0\n"
+			"usemtl a\n";
+		for(int i = 0; i < 30; ++i)
+			text += "f -8/-4/-2 -7/-3/-2 -6/-2/-2\n";
+		text +=
+			"f 1//1 2//2 3//1\n"
+			"f 4/1 5/2 6/3 7/4\n"
+			"v 2 2 2\n"
+			"f -1 -9 -8\n";
+
+		const video::ObjCorner expected[] = {
+			{0, -1, 0}, {1, -1, 1}, {2, -1, 0},
+			{3, 0, -1}, {4, 1, -1}, {5, 2, -1},
+			{3, 0, -1}, {5, 2, -1}, {6, 3, -1},
+			{8, -1, -1}, {0, -1, -1}, {1, -1, -1}};
+
+		// The chunks are parsed one after another or on a pool.
+		core::ThreadPool pool(2);
+		for(int chunkCount : {1, 4}) {
+			for(auto usedPool : {(core::ThreadPool*)nullptr, &pool}) {
+				auto geo = Parse(text, chunkCount, usedPool);
+				UNIT_ASSERT_EQUAL(geo.chunks.Size(), chunkCount);
+				UNIT_ASSERT_EQUAL(geo.positions.Size(), 9);
+				UNIT_ASSERT_EQUAL(geo.texcoords.Size(), 4);
+				UNIT_ASSERT_EQUAL(geo.normals.Size(), 2);
+				UNIT_ASSERT(geo.positions[8] == math::Vector3F(2, 2, 2));
+				UNIT_ASSERT_EQUAL(geo.chunks[0].materialLibs.Size(), 1);
+				UNIT_ASSERT(core::String(geo.chunks[0].materialLibs[0]) == "test.mtl");
+				UNIT_ASSERT_EQUAL(geo.chunks[0].materialUses.Size(), 1);
+				UNIT_ASSERT(core::String(geo.chunks[0].materialUses[0].name) == "a");
+				UNIT_ASSERT_EQUAL(geo.chunks[0].materialUses[0].triangle, 0);
+
+				auto corners = GetCorners(geo);
+				UNIT_ASSERT_EQUAL(corners.Size(), 3 * 30 + 12);
+				for(int i = 0; i < 30; ++i) {
+					UNIT_ASSERT(corners[3 * i] == video::ObjCorner({0, 0, 0}));
+					UNIT_ASSERT(corners[3 * i + 1] == video::ObjCorner({1, 1, 0}));
+					UNIT_ASSERT(corners[3 * i + 2] == video::ObjCorner({2, 2, 0}));
+				}
+				for(int i = 0; i < 12; ++i)
+					UNIT_ASSERT(corners[90 + i] == expected[i]);
+			}
+		}
+	}
+
+	UNIT_TEST(InvalidIndices)
+	{
+		UNIT_ASSERT(ParseThrows("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n", 1));
+		UNIT_ASSERT(ParseThrows("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 0\n", 1));
+		UNIT_ASSERT(ParseThrows("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/1 2/1 3/1\n", 1));
+
+		// A relative index before the first vertex, in a later chunk.
+		std::string text = "v 0 0 0\nv 1 0 0\nv 0 1 0\n";
+		for(int i = 0; i < 20; ++i)
+			text += "f -3 -2 -1\n";
+		UNIT_ASSERT_FALSE(ParseThrows(text, 4));
+		text += "f -4 -2 -1\n";
+		UNIT_ASSERT(ParseThrows(text, 4));
+	}
+
+	UNIT_TEST(MaterialLibrary)
+	{
+		std::string text =
+			"newmtl tr_then_d\n"
+			"Tr 0.75\n"
+			"d 0.5\n"
+			"newmtl d_then_tr\n"
+			"d 0.25\n"
+			"Tr 0.5\n"
+			"newmtl only_tr\n"
+			"Tr 0.25\n"
+			"newmtl textured\n"
+			"Kd 1 0.5 0\n"
+			"map_Kd -s 1 1 1 tex.png\n";
+		core::Array<video::ObjMaterial> materials;
+		video::ParseObjMaterialLibrary(text.data(), text.data() + text.size(), materials);
+
+		UNIT_ASSERT_EQUAL(materials.Size(), 4);
+		UNIT_ASSERT(materials[0].name == "tr_then_d");
+
+		// d is preferred over Tr, in any order.
+		UNIT_ASSERT_APPROX(materials[0].dissolve, 0.5f);
+		UNIT_ASSERT_APPROX(materials[1].dissolve, 0.25f);
+		UNIT_ASSERT_APPROX(materials[2].dissolve, 0.75f);
+		UNIT_ASSERT_APPROX(materials[3].dissolve, 1.0f);
+
+		UNIT_ASSERT_APPROX(materials[3].diffuse[1], 0.5f);
+		UNIT_ASSERT(materials[3].diffuseTexture == "tex.png");
+	}
+}
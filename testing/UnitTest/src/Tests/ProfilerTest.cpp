@@ -0,0 +1,82 @@
+#include "stdafx.h"
+#include "core/lxProfiler.h"
+#include <cstring>
+#include <thread>
+
+#ifdef LUX_ENABLE_PROFILER
+
+static int FindNode(const core::ProfileFrame& frame, const char* name, int parent)
+{
+	for(int i = 0; i < frame.nodes.Size(); ++i) {
+		if(frame.nodes[i].parent == parent && strcmp(frame.nodes[i].zone->name, name) == 0)
+			return i;
+	}
+	return -1;
+}
+
+UNIT_SUITE(Profiler)
+{
+	UNIT_TEST(Hierarchy)
+	{
+		core::Profiler::NextFrame();
+		for(int i = 0; i < 3; ++i) {
+			LX_PROFILE_SCOPE("Outer");
+			for(int j = 0; j < 2; ++j) {
+				LX_PROFILE_SCOPE("Inner");
+			}
+		}
+		{
+			LX_PROFILE_SCOPE("Other");
+		}
+		core::Profiler::NextFrame();
+
+		auto& frame = core::Profiler::GetLastFrame();
+		int outer = FindNode(frame, "Outer", -1);
+		UNIT_ASSERT(outer >= 0);
+		UNIT_ASSERT_EQUAL(frame.nodes[outer].calls, 3);
+		UNIT_ASSERT_EQUAL(frame.nodes[outer].depth, 0);
+
+		int inner = FindNode(frame, "Inner", outer);
+		UNIT_ASSERT(inner >= 0);
+		UNIT_ASSERT_EQUAL(frame.nodes[inner].calls, 6);
+		UNIT_ASSERT_EQUAL(frame.nodes[inner].depth, 1);
+		UNIT_ASSERT(frame.nodes[inner].totalMicros <= frame.nodes[outer].totalMicros);
+
+		UNIT_ASSERT(FindNode(frame, "Other", -1) >= 0);
+		UNIT_ASSERT_EQUAL(FindNode(frame, "Inner", -1), -1);
+	}
+
+	UNIT_TEST(FramesAreSeparate)
+	{
+		core::Profiler::NextFrame();
+		{
+			LX_PROFILE_SCOPE("Once");
+		}
+		core::Profiler::NextFrame();
+		UNIT_ASSERT(FindNode(core::Profiler::GetLastFrame(), "Once", -1) >= 0);
+		core::Profiler::NextFrame();
+		UNIT_ASSERT_EQUAL(FindNode(core::Profiler::GetLastFrame(), "Once", -1), -1);
+	}
+
+	UNIT_TEST(ExitedThreads)
+	{
+		// The buffers of exited threads are reused, the names stay.
+		core::Profiler::NextFrame();
+		for(int frame = 0; frame < 2; ++frame) {
+			core::String name = frame == 0 ? "Worker A" : "Worker B";
+			std::thread worker([name]() {
+				core::Profiler::SetThreadName(name);
+				LX_PROFILE_SCOPE("Worker");
+			});
+			worker.join();
+			core::Profiler::NextFrame();
+
+			int node = FindNode(core::Profiler::GetLastFrame(), "Worker", -1);
+			UNIT_ASSERT(node >= 0);
+			int thread = core::Profiler::GetLastFrame().nodes[node].thread;
+			UNIT_ASSERT(core::Profiler::GetThreadName(thread) == name);
+		}
+	}
+}
+
+#endif
@@ -78,4 +78,29 @@ UNIT_SUITE(QuaternionTest)
 
 		UNIT_ASSERT_APPROX(Point, math::Vector3F(1.0f, 0.0f, 0.0f));
 	}
+
+	UNIT_TEST(ArrayFunctions)
+	{
+		math::QuaternionF q2 = math::QuaternionF::FromEuler(math::Vector3F(0.5f, -1.0f, 2.0f));
+		math::QuaternionF a[2] = {q1, q2};
+		math::QuaternionF b[2] = {q2, q1};
+		math::QuaternionF products[2];
+		math::MultiplyQuaternionArray(a, b, products, 2);
+		UNIT_ASSERT_APPROX(products[0], q1 * q2);
+		UNIT_ASSERT_APPROX(products[1], q2 * q1);
+
+		// More than four points, to test the batched and the remaining ones.
+		math::Vector3F points[7] = {
+			math::Vector3F(1.0f, 0.0f, 0.0f),
+			math::Vector3F(0.0f, -2.0f, 3.0f),
+			math::Vector3F(4.0f, 5.0f, -6.0f),
+			math::Vector3F(-1.5f, 0.25f, 8.0f),
+			math::Vector3F(0.0f, 0.0f, 1.0f),
+			math::Vector3F(-7.0f, 3.0f, 2.5f),
+			math::Vector3F(0.5f, -0.5f, -0.5f)};
+		math::Vector3F transformed[7];
+		math::TransformVectorArray(q1, points, transformed, 7);
+		for(int i = 0; i < 7; ++i)
+			UNIT_ASSERT_APPROX(transformed[i], q1.Transform(points[i]));
+	}
 }
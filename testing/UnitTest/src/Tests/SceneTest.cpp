@@ -0,0 +1,68 @@
+#include "stdafx.h"
+#include "scene/Scene.h"
+#include "scene/Node.h"
+
+UNIT_SUITE(SceneTest)
+{
+	UNIT_TEST(UpdateTransformsParentMove)
+	{
+		StrongRef<scene::Scene> scene = LUX_NEW(scene::Scene);
+		auto parent = scene->AddNode();
+		auto child = scene->AddNode(nullptr, parent);
+		auto leaf = scene->AddNode(nullptr, child);
+		auto other = scene->AddNode();
+		parent->SetPosition(1, 0, 0);
+		child->SetPosition(0, 2, 0);
+		leaf->SetPosition(0, 0, 3);
+		other->SetPosition(5, 5, 5);
+		scene->UpdateTransforms();
+
+		UNIT_ASSERT_APPROX(leaf->GetAbsolutePosition(), math::Vector3F(1, 2, 3));
+
+		// Moving and scaling the parent moves the whole subtree, but nothing else.
+		parent->SetPosition(-1, 0, 0);
+		parent->SetScale(2);
+		scene->UpdateTransforms();
+
+		UNIT_ASSERT_APPROX(parent->GetAbsolutePosition(), math::Vector3F(-1, 0, 0));
+		UNIT_ASSERT_APPROX(child->GetAbsolutePosition(), math::Vector3F(-1, 4, 0));
+		UNIT_ASSERT_APPROX(leaf->GetAbsolutePosition(), math::Vector3F(-1, 4, 6));
+		UNIT_ASSERT_APPROX(leaf->GetAbsoluteTransform().scale, 2.0f);
+		UNIT_ASSERT_APPROX(other->GetAbsolutePosition(), math::Vector3F(5, 5, 5));
+	}
+
+	UNIT_TEST(UpdateTransformsReparent)
+	{
+		StrongRef<scene::Scene> scene = LUX_NEW(scene::Scene);
+		auto a = scene->AddNode();
+		auto b = scene->AddNode();
+		auto child = scene->AddNode(nullptr, a);
+		auto leaf = scene->AddNode(nullptr, child);
+		a->SetPosition(1, 0, 0);
+		b->SetPosition(0, 10, 0);
+		auto rotation = math::QuaternionF::FromAngleAxis(math::AngleF::Degree(90.0f), math::Vector3F(0, 0, 1));
+		b->SetOrientation(rotation);
+		child->SetPosition(2, 0, 0);
+		leaf->SetPosition(0, 0, 1);
+		scene->UpdateTransforms();
+
+		UNIT_ASSERT_APPROX(leaf->GetAbsolutePosition(), math::Vector3F(3, 0, 1));
+
+		// The subtree follows its new parent.
+		child->SetParent(b);
+		scene->UpdateTransforms();
+
+		const math::Vector3F childPos = math::Vector3F(0, 10, 0) + rotation.Transform(math::Vector3F(2, 0, 0));
+		UNIT_ASSERT(child->GetParent() == b);
+		UNIT_ASSERT_APPROX(child->GetAbsolutePosition(), childPos);
+		UNIT_ASSERT_APPROX(leaf->GetAbsolutePosition(), childPos + math::Vector3F(0, 0, 1));
+
+		// Moves of the old parent don't affect it anymore, moves of the new one do.
+		a->SetPosition(7, 7, 7);
+		b->Translate(0, 0, 1);
+		scene->UpdateTransforms();
+
+		UNIT_ASSERT_APPROX(leaf->GetAbsolutePosition(), childPos + math::Vector3F(0, 0, 2));
+		UNIT_ASSERT_APPROX(a->GetAbsolutePosition(), math::Vector3F(7, 7, 7));
+	}
+}
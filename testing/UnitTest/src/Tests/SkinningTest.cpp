@@ -0,0 +1,103 @@
+#include "stdafx.h"
+
+UNIT_SUITE(SkinningTest)
+{
+	UNIT_TEST(HierarchySolve)
+	{
+		StrongRef<video::Skeleton> skeleton = LUX_NEW(video::Skeleton);
+		math::Transformation root;
+		root.translation = math::Vector3F(1, 2, 3);
+		root.orientation = math::QuaternionF::FromAngleAxis(math::AngleF::Degree(90.0f), math::Vector3F(0, 0, 1));
+		math::Transformation child(math::Vector3F(4, 0, 0));
+		skeleton->AddJoint("root", -1, root.ToMatrix());
+		skeleton->AddJoint("child", 0, child.ToMatrix());
+		skeleton->AddJoint("leaf", 1);
+
+		UNIT_ASSERT_EQUAL(skeleton->FindJoint("child"), 1);
+		UNIT_ASSERT_EQUAL(skeleton->FindJoint("missing"), -1);
+
+		math::Matrix4 world[3];
+		video::SolveJointHierarchy(skeleton->GetParents(), skeleton->GetBindPoses(), world, 3);
+
+		// The child is moved by its parent.
+		auto expected = child.CombineRight(root).ToMatrix();
+		UNIT_ASSERT_APPROX(world[1], expected);
+		UNIT_ASSERT_APPROX(world[2], expected);
+
+		bool thrown = false;
+		try {
+			skeleton->AddJoint("invalid", 3);
+		} catch(core::ArgumentOutOfRangeException&) {
+			thrown = true;
+		}
+		UNIT_ASSERT(thrown);
+	}
+
+	UNIT_TEST(ClipSample)
+	{
+		math::Vector3F translations[3] = {
+			math::Vector3F(0, 0, 0),
+			math::Vector3F(2, 0, 0),
+			math::Vector3F(2, 4, 0)};
+		math::QuaternionF rotations[3];
+		StrongRef<video::SkeletalClip> clip = LUX_NEW(video::SkeletalClip)(2.0f, 3);
+		clip->AddTrack(1, translations, rotations);
+		UNIT_ASSERT_EQUAL(clip->GetDuration(), 1.0f);
+
+		// Two joints, the first one isn't animated.
+		float times[3] = {0.25f, 0.75f, 1.25f};
+		math::Matrix4 poses[6];
+		for(auto& pose : poses)
+			pose = math::Matrix4::IDENTITY;
+		clip->Sample(times, 3, 2, poses);
+
+		UNIT_ASSERT(poses[0] == math::Matrix4::IDENTITY);
+		UNIT_ASSERT(poses[1].GetTranslation() == math::Vector3F(1, 0, 0));
+		UNIT_ASSERT(poses[3].GetTranslation() == math::Vector3F(2, 2, 0));
+		UNIT_ASSERT(poses[5].GetTranslation() == math::Vector3F(1, 0, 0));
+
+		// Without looping the last key is held.
+		clip->Sample(times + 2, 1, 2, poses, false);
+		UNIT_ASSERT(poses[1].GetTranslation() == math::Vector3F(2, 4, 0));
+	}
+
+	UNIT_TEST(SkinVertices)
+	{
+		struct Vertex
+		{
+			math::Vector3F position;
+			math::Vector3F normal;
+			float pad;
+		};
+
+		math::Matrix4 matrices[3];
+		matrices[0] = math::Matrix4::IDENTITY;
+		matrices[1] = math::Transformation(math::Vector3F(2, 0, 0)).ToMatrix();
+		matrices[2] = math::Transformation(
+			math::Vector3F(0, 0, 0),
+			math::QuaternionF::FromAngleAxis(math::AngleF::Degree(90.0f), math::Vector3F(0, 0, 1))).ToMatrix();
+
+		math::Vector3F positions[3] = {
+			math::Vector3F(1, 1, 1),
+			math::Vector3F(1, 1, 1),
+			math::Vector3F(1, 0, 0)};
+		math::Vector3F normals[3] = {
+			math::Vector3F(0, 1, 0),
+			math::Vector3F(0, 1, 0),
+			math::Vector3F(1, 0, 0)};
+		video::SkinVertex skin[3] = {
+			{{1, 0, 0, 0}, {0, 0, 0, 0}},
+			{{0.5f, 0.5f, 0, 0}, {0, 1, 0, 0}},
+			{{0, 0, 1, 0}, {0, 0, 2, 0}}};
+
+		Vertex out[3];
+		video::SkinVertices(matrices, positions, normals, skin, 3, out, sizeof(Vertex), 0, sizeof(math::Vector3F));
+
+		UNIT_ASSERT_APPROX(out[0].position, positions[0]);
+		UNIT_ASSERT_APPROX(out[0].normal, normals[0]);
+		UNIT_ASSERT_APPROX(out[1].position, math::Vector3F(2, 1, 1));
+		UNIT_ASSERT_APPROX(out[1].normal, normals[1]);
+		UNIT_ASSERT_APPROX(out[2].position, matrices[2].TransformVector(positions[2]));
+		UNIT_ASSERT_APPROX(out[2].normal, matrices[2].TransformVector(normals[2]));
+	}
+}
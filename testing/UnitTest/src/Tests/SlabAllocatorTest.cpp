@@ -0,0 +1,49 @@
+#include "stdafx.h"
+#include "core/lxSlabAllocator.h"
+
+UNIT_SUITE(SlabAllocator)
+{
+	UNIT_TEST(AllocateFree)
+	{
+		core::SlabAllocator allocator(24, 4);
+		core::Array<void*> ptrs;
+		for(int i = 0; i < 10; ++i)
+			ptrs.PushBack(allocator.Allocate());
+
+		auto stats = allocator.GetStatistics();
+		UNIT_ASSERT_EQUAL(stats.used, 10);
+		UNIT_ASSERT_EQUAL(stats.slabCount, 3);
+		UNIT_ASSERT_EQUAL(stats.capacity, 12);
+
+		for(int i = 0; i < 10; ++i)
+			UNIT_ASSERT(allocator.Owns(ptrs[i]));
+
+		for(auto p : ptrs)
+			allocator.Free(p);
+		UNIT_ASSERT_EQUAL(allocator.GetStatistics().used, 0);
+
+		allocator.ReleaseEmptySlabs();
+		UNIT_ASSERT_EQUAL(allocator.GetStatistics().slabCount, 0);
+	}
+
+	UNIT_TEST(Neighbour)
+	{
+		core::SlabAllocator allocator(16, 8);
+		core::Array<void*> ptrs;
+		for(int i = 0; i < 8; ++i)
+			ptrs.PushBack(allocator.Allocate());
+		void* second = allocator.Allocate(); // First object in a new slab
+
+		// Without hint the freed place in the first slab would be reused.
+		allocator.Free(ptrs[3]);
+		void* near = allocator.Allocate(second);
+		UNIT_ASSERT(near > second && (u8*)near < (u8*)second + 16 * 8);
+
+		allocator.Free(near);
+		allocator.Free(second);
+		ptrs.Erase(3);
+		for(auto p : ptrs)
+			allocator.Free(p);
+		UNIT_ASSERT_EQUAL(allocator.GetStatistics().used, 0);
+	}
+}
@@ -37,4 +37,75 @@ UNIT_SUITE(ParseTest)
 		value = lux::core::StringConverter::ParseFloat("-inf");
 		UNIT_ASSERT(math::IsEqual(value, -std::numeric_limits<float>::infinity()));
 	}
+	UNIT_TEST(IntegerLimits)
+	{
+		using namespace lux::core::StringConverter;
+		int nextChar;
+		EParseError error;
+
+		UNIT_ASSERT_EQUAL(ParseInt("2147483647"), 2147483647);
+		UNIT_ASSERT_EQUAL(ParseInt("-2147483648"), (-2147483647 - 1));
+		UNIT_ASSERT_EQUAL(ParseInt("000000000000012"), 12);
+
+		UNIT_ASSERT_EQUAL(ParseInt("2147483648", -1, &nextChar, &error), -1);
+		UNIT_ASSERT(error == EParseError::Overflow);
+		UNIT_ASSERT_EQUAL(nextChar, 10);
+
+		UNIT_ASSERT_EQUAL(ParseInt("", -1, &nextChar, &error), -1);
+		UNIT_ASSERT(error == EParseError::EmptyInput);
+
+		UNIT_ASSERT_EQUAL(ParseInt("-x", -1, &nextChar, &error), -1);
+		UNIT_ASSERT(error == EParseError::Error);
+	}
+
+	UNIT_TEST(FloatExact)
+	{
+		using namespace lux::core::StringConverter;
+		int nextChar;
+		EParseError error;
+
+		UNIT_ASSERT_EQUAL(ParseFloat("0.1"), 0.1f);
+		UNIT_ASSERT_EQUAL(ParseFloat("1.5e-5x", 0.0f, &nextChar), 1.5e-5f);
+		UNIT_ASSERT_EQUAL(nextChar, 6);
+		UNIT_ASSERT_EQUAL(ParseFloat("3.4028235e38"), 3.4028235e38f);
+		UNIT_ASSERT_EQUAL(ParseFloat("1.4e-45"), 1.4e-45f);
+		UNIT_ASSERT_EQUAL(ParseFloat("123456789012345678901234567890"), 123456789012345678901234567890.0f);
+		// Exactly between two floats, rounded to even.
+		UNIT_ASSERT_EQUAL(ParseFloat("1.000000059604644775390625"), 1.0f);
+		UNIT_ASSERT_EQUAL(ParseFloat("1.0000000596046447753906250001"), 1.00000012f);
+
+		ParseFloat("1e39", 0.0f, &nextChar, &error);
+		UNIT_ASSERT(error == EParseError::Overflow);
+		UNIT_ASSERT(std::isnan(ParseFloat("NaN")));
+	}
+
+	UNIT_TEST(FloatRoundTrip)
+	{
+		core::Randomizer rand(3);
+		core::String str;
+		for(int i = 0; i < 10000; ++i) {
+			u32 bits = rand.GetInt(0, 0x7F7FFFFF);
+			float value;
+			std::memcpy(&value, &bits, sizeof(value));
+			str.Clear();
+			core::StringConverter::Append(str, value);
+			UNIT_ASSERT_EQUAL(lux::core::StringConverter::ParseFloat(str), value);
+		}
+	}
+
+	UNIT_TEST(Array)
+	{
+		using namespace lux::core::StringConverter;
+		float floats[4];
+		int nextChar;
+		UNIT_ASSERT_EQUAL(ParseFloatArray(" 1.5, 2 ,3\t-4e2;5", floats, 4, &nextChar), 4);
+		UNIT_ASSERT_EQUAL(nextChar, 15);
+		UNIT_ASSERT_EQUAL(floats[0], 1.5f);
+		UNIT_ASSERT_EQUAL(floats[3], -400.0f);
+
+		int ints[4];
+		UNIT_ASSERT_EQUAL(ParseIntArray("1,2,,3", ints, 4, &nextChar), 2);
+		UNIT_ASSERT_EQUAL(nextChar, 3);
+		UNIT_ASSERT_EQUAL(ints[1], 2);
+	}
 }
\ No newline at end of file
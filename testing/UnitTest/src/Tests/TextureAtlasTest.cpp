@@ -0,0 +1,86 @@
+#include "stdafx.h"
+
+UNIT_SUITE(TextureAtlasTest)
+{
+	UNIT_TEST(PackNoOverlap)
+	{
+		video::TextureAtlasSettings settings;
+		settings.pageSize = math::Dimension2I(128, 128);
+		settings.gutter = 2;
+		settings.padding = 1;
+		settings.alignment = 4;
+		video::TextureAtlasPacker packer(settings);
+
+		core::Array<math::Dimension2I> sizes;
+		for(int i = 0; i < 60; ++i)
+			sizes.PushBack(math::Dimension2I(5 + (i * 7) % 23, 3 + (i * 11) % 29));
+		core::Array<video::TextureAtlasEntry> entries;
+		entries.Resize(sizes.Size());
+		packer.Pack(sizes.Data(), sizes.Size(), entries.Data());
+
+		// More than one page is needed.
+		UNIT_ASSERT(packer.GetPageCount() > 1);
+
+		const int g = settings.gutter;
+		for(int i = 0; i < entries.Size(); ++i) {
+			auto& a = entries[i];
+			UNIT_ASSERT(a.page >= 0 && a.page < packer.GetPageCount());
+			UNIT_ASSERT_EQUAL(a.rect.GetWidth(), sizes[i].width);
+			UNIT_ASSERT_EQUAL(a.rect.GetHeight(), sizes[i].height);
+
+			// The gutter lies inside the page and starts on the alignment.
+			UNIT_ASSERT(a.rect.left - g >= 0 && a.rect.top - g >= 0);
+			UNIT_ASSERT(a.rect.right + g <= 128 && a.rect.bottom + g <= 128);
+			UNIT_ASSERT_EQUAL((a.rect.left - g) % 4, 0);
+			UNIT_ASSERT_EQUAL((a.rect.top - g) % 4, 0);
+
+			// Sprites and gutters never overlap, with the padding between them.
+			for(int j = 0; j < i; ++j) {
+				auto& b = entries[j];
+				if(a.page != b.page)
+					continue;
+				bool separated =
+					a.rect.right + g + settings.padding <= b.rect.left - g ||
+					b.rect.right + g + settings.padding <= a.rect.left - g ||
+					a.rect.bottom + g + settings.padding <= b.rect.top - g ||
+					b.rect.bottom + g + settings.padding <= a.rect.top - g;
+				UNIT_ASSERT(separated);
+			}
+		}
+
+		bool thrown = false;
+		try {
+			math::Dimension2I tooLarge(126, 10);
+			packer.Pack(&tooLarge, 1, entries.Data());
+		} catch(core::GenericInvalidArgumentException&) {
+			thrown = true;
+		}
+		UNIT_ASSERT(thrown);
+	}
+
+	UNIT_TEST(FillGutter)
+	{
+		// A 2x2 sprite at (2, 2) in a 6x6 page with one byte per pixel.
+		u8 page[36] = {};
+		page[2 * 6 + 2] = 1;
+		page[2 * 6 + 3] = 2;
+		page[3 * 6 + 2] = 3;
+		page[3 * 6 + 3] = 4;
+		video::FillAtlasGutter(page, 6, math::Dimension2I(6, 6), 1, math::RectI(2, 2, 4, 4), 1);
+
+		const u8 expected[36] = {
+			0, 0, 0, 0, 0, 0,
+			0, 1, 1, 2, 2, 0,
+			0, 1, 1, 2, 2, 0,
+			0, 3, 3, 4, 4, 0,
+			0, 3, 3, 4, 4, 0,
+			0, 0, 0, 0, 0, 0};
+		for(int i = 0; i < 36; ++i)
+			UNIT_ASSERT_EQUAL(page[i], expected[i]);
+
+		// The gutter is clipped at the border of the page.
+		video::FillAtlasGutter(page, 6, math::Dimension2I(6, 6), 1, math::RectI(2, 2, 4, 4), 3);
+		UNIT_ASSERT_EQUAL(page[0], 1);
+		UNIT_ASSERT_EQUAL(page[35], 4);
+	}
+}
@@ -0,0 +1,89 @@
+#include "stdafx.h"
+#include "core/Clock.h"
+
+UNIT_SUITE(Timer)
+{
+	UNIT_TEST(RepeatCount)
+	{
+		core::TimerManager manager;
+		int fired = 0;
+		core::Timer timer = manager.CreateTimer(core::TimerSettings(core::Duration::Seconds(1ll), 3));
+		timer.Event().Connect([&]() { ++fired; });
+
+		for(int i = 0; i < 10; ++i)
+			manager.Tick(core::Duration::Seconds(1ll));
+		UNIT_ASSERT_EQUAL(fired, 3);
+		UNIT_ASSERT_EQUAL(manager.GetTimerCount(), 0);
+
+		// The handle of a finished timer stays valid.
+		UNIT_ASSERT(timer.IsValid());
+		UNIT_ASSERT(timer.GetRemainingTime() == core::Duration(0));
+	}
+
+	UNIT_TEST(PauseResume)
+	{
+		core::TimerManager manager;
+		int fired = 0;
+		core::Timer timer = manager.CreateTimer(core::Duration::Seconds(1ll));
+		timer.Event().Connect([&]() { ++fired; });
+
+		manager.Tick(core::Duration::Micros(400000ll));
+		timer.Pause();
+		UNIT_ASSERT(timer.GetRemainingTime() == core::Duration::Micros(600000ll));
+		manager.Tick(core::Duration::Seconds(5ll));
+		UNIT_ASSERT_EQUAL(fired, 0);
+
+		timer.Resume();
+		manager.Tick(core::Duration::Micros(500000ll));
+		UNIT_ASSERT_EQUAL(fired, 0);
+		manager.Tick(core::Duration::Micros(100000ll));
+		UNIT_ASSERT_EQUAL(fired, 1);
+	}
+
+	UNIT_TEST(KillInCallback)
+	{
+		core::TimerManager manager;
+		int firedA = 0;
+		int firedB = 0;
+		core::Timer a = manager.CreateTimer(core::Duration::Micros(1000ll));
+		core::Timer b = manager.CreateTimer(core::Duration::Micros(1500ll));
+		a.Event().Connect([&]() { ++firedA; a.Kill(); b.Kill(); });
+		b.Event().Connect([&]() { ++firedB; });
+
+		manager.Tick(core::Duration::Micros(2000ll));
+		UNIT_ASSERT_EQUAL(firedA, 1);
+		UNIT_ASSERT_EQUAL(firedB, 0);
+		UNIT_ASSERT_EQUAL(manager.GetTimerCount(), 0);
+	}
+
+	UNIT_TEST(OrderInBatch)
+	{
+		core::TimerManager manager;
+		core::Array<int> order;
+		core::Timer timers[4];
+		for(int i = 0; i < 4; ++i) {
+			timers[i] = manager.CreateTimer(core::Duration::Micros(5000ll - i * 1000));
+			timers[i].Event().Connect([&order, i]() { order.PushBack(i); });
+		}
+
+		manager.Tick(core::Duration::Micros(10000ll));
+		UNIT_ASSERT_EQUAL(order.Size(), 4);
+		for(int i = 0; i < 4; ++i)
+			UNIT_ASSERT_EQUAL(order[i], 3 - i);
+	}
+
+	UNIT_TEST(FarFuture)
+	{
+		core::TimerManager manager;
+		int fired = 0;
+		// Further away than the range of the wheel.
+		core::Timer timer = manager.CreateTimer(core::Duration::Minutes(60ll * 24 * 60));
+		timer.Event().Connect([&]() { ++fired; });
+
+		for(int i = 0; i < 24 * 60 - 1; ++i)
+			manager.Tick(core::Duration::Minutes(60ll));
+		UNIT_ASSERT_EQUAL(fired, 0);
+		manager.Tick(core::Duration::Minutes(60ll));
+		UNIT_ASSERT_EQUAL(fired, 1);
+	}
+}
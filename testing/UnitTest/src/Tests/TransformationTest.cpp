@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include "math/FreeMathFunctions.h"
 
 using namespace lux;
 
@@ -98,4 +99,40 @@ UNIT_SUITE(TransformationTest)
 		// Relativ viele Rechungen darum hhere Abweichung mglich
 		UNIT_ASSERT(math::IsEqual(x, b, 0.0001f));
 	}
+
+	UNIT_TEST(TransformAABox)
+	{
+		math::AABBoxF box(-1.0f, 0.0f, 2.0f, 3.0f, 1.0f, 4.0f);
+		math::AABBoxF world = math::TransformAABox(box, t2);
+
+		math::Vector3F corners[8];
+		math::GetAABoxCorners(box, corners);
+		math::AABBoxF expected(t2.TransformPoint(corners[0]));
+		for(int i = 1; i < 8; ++i)
+			expected.AddPoint(t2.TransformPoint(corners[i]));
+
+		UNIT_ASSERT(math::IsEqual(world.minCorner, expected.minCorner, 0.0001f));
+		UNIT_ASSERT(math::IsEqual(world.maxCorner, expected.maxCorner, 0.0001f));
+	}
+
+	UNIT_TEST(AreAABoxesMaybeVisible)
+	{
+		math::Matrix4 view;
+		view.BuildCameraLookAt(math::Vector3F(0.0f, 0.0f, -10.0f), math::Vector3F(0.0f, 0.0f, 0.0f));
+		auto frustum = math::ViewFrustum::FromPerspCam(view, math::AngleF::Degree(60.0f), 1.0f, 1.0f, 100.0f);
+
+		math::AABBoxF boxes[7];
+		for(int i = 0; i < 7; ++i) {
+			math::Vector3F center(-30.0f + 10.0f * i, 0.0f, 20.0f * i - 20.0f);
+			boxes[i] = math::AABBoxF(center - math::Vector3F(1.0f), center + math::Vector3F(1.0f));
+		}
+
+		bool visible[7];
+		u8 hints[7] = {0};
+		for(int run = 0; run < 2; ++run) {
+			math::AreAABoxesMaybeVisible(frustum, boxes, 7, visible, hints);
+			for(int i = 0; i < 7; ++i)
+				UNIT_ASSERT_EQUAL(visible[i], math::IsAABoxMaybeVisible(frustum, boxes[i]));
+		}
+	}
 }
\ No newline at end of file
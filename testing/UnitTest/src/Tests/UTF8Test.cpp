@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include "core/lxUnicodeConversion.h"
 
 UNIT_SUITE(unicode)
 {
@@ -47,4 +48,59 @@ UNIT_SUITE(unicode)
 
 		UNIT_ASSERT_EQUAL(length, 3);
 	}
+	UNIT_TEST(CodePointCountTest)
+	{
+		core::StringView str = "a☠b\xF0\xA4\xAD\xA2 and some more ascii text";
+		UNIT_ASSERT_EQUAL(str.CodePointCount(), 29);
+		UNIT_ASSERT_EQUAL(core::String(str).CodePointCount(), 29);
+	}
+
+	UNIT_TEST(UTF8ToUTF16Test)
+	{
+		// Long enough for the vectorized ascii path.
+		const char* str = "Path/To/Some/Directory/\xE2\x82\xAC/\xF0\xA4\xAD\xA2.txt";
+		core::Array<u16> utf16;
+		core::UTF8ToUTF16(str, -1, utf16);
+		UNIT_ASSERT_EQUAL(utf16.Size(), 31);
+		UNIT_ASSERT_EQUAL(utf16[0], 'P');
+		UNIT_ASSERT_EQUAL(utf16[23], 0x20AC);
+		UNIT_ASSERT_EQUAL(utf16[25], 0xD852);
+		UNIT_ASSERT_EQUAL(utf16[26], 0xDF62);
+
+		core::String back = core::UTF16ToString(utf16.Data(), utf16.Size() * 2);
+		UNIT_ASSERT_EQUAL(back, str);
+		auto bytes = core::UTF16ToUTF8(utf16.Data(), utf16.Size() * 2);
+		UNIT_ASSERT_EQUAL(bytes.Size(), (int)strlen(str));
+	}
+
+	UNIT_TEST(UTF8ToUTF32Test)
+	{
+		const char* str = "a☠b\xF0\xA4\xAD\xA2";
+		core::Array<u32> codepoints;
+		core::UTF8ToUTF32(str, -1, codepoints);
+		UNIT_ASSERT_EQUAL(codepoints.Size(), 4);
+		UNIT_ASSERT_EQUAL(codepoints[1], 0x2620);
+		UNIT_ASSERT_EQUAL(codepoints[3], 0x24B62);
+	}
+
+	UNIT_TEST(ValidateUTF8Test)
+	{
+		const char* valid = "Some ascii text followed by a☠b\xF0\xA4\xAD\xA2";
+		UNIT_ASSERT(core::IsValidUTF8(valid, (int)strlen(valid)));
+
+		int offset;
+		// Overlong encoding of '/'
+		UNIT_ASSERT_FALSE(core::IsValidUTF8("0123456789abcdef\xC0\xAF", 18, &offset));
+		UNIT_ASSERT_EQUAL(offset, 16);
+		// Surrogate
+		UNIT_ASSERT_FALSE(core::IsValidUTF8("a\xED\xA0\x80", 4, &offset));
+		UNIT_ASSERT_EQUAL(offset, 1);
+		// Above 0x10FFFF
+		UNIT_ASSERT_FALSE(core::IsValidUTF8("\xF4\x90\x80\x80", 4));
+		// Truncated
+		UNIT_ASSERT_FALSE(core::IsValidUTF8("ab\xE2\x82", 4, &offset));
+		UNIT_ASSERT_EQUAL(offset, 2);
+		// Lonely continuation byte
+		UNIT_ASSERT_FALSE(core::IsValidUTF8("\x80", 1));
+	}
 }
\ No newline at end of file